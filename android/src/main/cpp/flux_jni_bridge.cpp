@@ -1,6 +1,10 @@
 #include <jni.h>
-#include <string>
+#include <atomic>
+#include <cstdint>
 #include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
 #include <dlfcn.h>
 #include <android/log.h>
 
@@ -19,28 +23,66 @@ extern "C" {
     typedef char* (*flux_behavior_processor_process_t)(void* processor, const char* json);
     typedef char* (*flux_behavior_processor_save_baselines_t)(void* processor);
     typedef int (*flux_behavior_processor_load_baselines_t)(void* processor, const char* json);
+
+    // Optional entry points; newer libsynheart_flux.so builds may export these
+    typedef void* (*flux_behavior_stream_new_t)(const char* header_json);
+    typedef int (*flux_behavior_stream_push_t)(void* stream, const char* event_json);
+    typedef char* (*flux_behavior_stream_finish_t)(void* stream);
+    typedef void (*flux_behavior_stream_free_t)(void* stream);
+    typedef uint8_t* (*flux_behavior_to_hsi_binary_t)(const uint8_t* data, size_t len, size_t* out_len);
+    typedef void (*flux_free_bytes_t)(uint8_t* bytes, size_t len);
+}
+
+// Capability table. Bits record which optional Flux entry points the loaded library exports;
+// the table version sits in the top byte so Kotlin can tell layouts apart as bits are added.
+// A batch bit joins the table once synheart_flux.h documents a batch entry point to bind against.
+static constexpr jint kCapabilityTableVersion = 1;
+static constexpr jint kCapVersion = 1 << 0;   // flux_version
+static constexpr jint kCapStreaming = 1 << 1; // flux_behavior_stream_{new,push,finish,free}
+static constexpr jint kCapBinary = 1 << 2;    // flux_behavior_to_hsi_binary + flux_free_bytes
+
+// Function pointers, bound once in JNI_OnLoad
+struct FluxApi {
+    flux_behavior_to_hsi_t behavior_to_hsi = nullptr;
+    flux_free_string_t free_string = nullptr;
+    flux_last_error_t last_error = nullptr;
+    flux_behavior_processor_new_t processor_new = nullptr;
+    flux_behavior_processor_free_t processor_free = nullptr;
+    flux_behavior_processor_process_t processor_process = nullptr;
+    flux_behavior_processor_save_baselines_t processor_save_baselines = nullptr;
+    flux_behavior_processor_load_baselines_t processor_load_baselines = nullptr;
+
+    flux_version_t version = nullptr;
+    flux_behavior_stream_new_t stream_new = nullptr;
+    flux_behavior_stream_push_t stream_push = nullptr;
+    flux_behavior_stream_finish_t stream_finish = nullptr;
+    flux_behavior_stream_free_t stream_free = nullptr;
+    flux_behavior_to_hsi_binary_t behavior_to_hsi_binary = nullptr;
+    flux_free_bytes_t free_bytes = nullptr;
+};
+
+static FluxApi g_flux;
+static std::once_flag g_flux_once;
+static std::atomic<bool> g_flux_bound{false};
+static std::atomic<jint> g_capabilities{0};
+
+// Cached JNI references (global refs and IDs, valid for the lifetime of the VM), set in
+// JNI_OnLoad. JNI's own string functions speak modified UTF-8, which differs from the standard
+// UTF-8 Flux reads and writes for NUL and supplementary characters; those strings go through
+// String(byte[], Charset) and String.getBytes(Charset) instead.
+static jclass g_string_class = nullptr;
+static jmethodID g_string_from_bytes = nullptr; // String(byte[], Charset)
+static jmethodID g_string_get_bytes = nullptr;  // String.getBytes(Charset)
+static jobject g_utf8_charset = nullptr;        // StandardCharsets.UTF_8
+
+template <typename T>
+static void bind(void* handle, const char* name, T& out) {
+    out = reinterpret_cast<T>(dlsym(handle, name));
 }
 
-// Function pointers (loaded once)
-static flux_behavior_to_hsi_t g_flux_behavior_to_hsi = nullptr;
-static flux_free_string_t g_flux_free_string = nullptr;
-static flux_last_error_t g_flux_last_error = nullptr;
-static flux_behavior_processor_new_t g_flux_behavior_processor_new = nullptr;
-static flux_behavior_processor_free_t g_flux_behavior_processor_free = nullptr;
-static flux_behavior_processor_process_t g_flux_behavior_processor_process = nullptr;
-static flux_behavior_processor_save_baselines_t g_flux_behavior_processor_save_baselines = nullptr;
-static flux_behavior_processor_load_baselines_t g_flux_behavior_processor_load_baselines = nullptr;
-static flux_version_t g_flux_version = nullptr;
-static bool g_functions_loaded = false;
-
-// Load function pointers from libsynheart_flux.so
-static bool load_flux_functions() {
-    if (g_functions_loaded) {
-        return true;
-    }
-
-    // libsynheart_flux.so should already be loaded by System.loadLibrary()
-    // We can use dlopen with RTLD_LAZY | RTLD_NOLOAD to get handle to already loaded library
+// Bind function pointers from libsynheart_flux.so. Runs once via std::call_once.
+static void bind_flux_functions() {
+    // libsynheart_flux.so is loaded by System.loadLibrary() before this bridge
     void* handle = dlopen("libsynheart_flux.so", RTLD_LAZY | RTLD_NOLOAD);
     if (!handle) {
         // Try loading it explicitly
@@ -49,88 +91,140 @@ static bool load_flux_functions() {
 
     if (!handle) {
         LOGE("Failed to load libsynheart_flux.so: %s", dlerror());
-        return false;
+        return;
     }
 
-    // Load function pointers
-    g_flux_behavior_to_hsi = (flux_behavior_to_hsi_t)dlsym(handle, "flux_behavior_to_hsi");
-    g_flux_free_string = (flux_free_string_t)dlsym(handle, "flux_free_string");
-    g_flux_last_error = (flux_last_error_t)dlsym(handle, "flux_last_error");
-    g_flux_behavior_processor_new = (flux_behavior_processor_new_t)dlsym(handle, "flux_behavior_processor_new");
-    g_flux_behavior_processor_free = (flux_behavior_processor_free_t)dlsym(handle, "flux_behavior_processor_free");
-    g_flux_behavior_processor_process = (flux_behavior_processor_process_t)dlsym(handle, "flux_behavior_processor_process");
-    g_flux_behavior_processor_save_baselines = (flux_behavior_processor_save_baselines_t)dlsym(handle, "flux_behavior_processor_save_baselines");
-    g_flux_behavior_processor_load_baselines = (flux_behavior_processor_load_baselines_t)dlsym(handle, "flux_behavior_processor_load_baselines");
-    g_flux_version = (flux_version_t)dlsym(handle, "flux_version");
-
-    // Check if all required functions were loaded (flux_version is optional for backward compat)
-    if (!g_flux_behavior_to_hsi || !g_flux_free_string || !g_flux_last_error ||
-        !g_flux_behavior_processor_new || !g_flux_behavior_processor_free ||
-        !g_flux_behavior_processor_process || !g_flux_behavior_processor_save_baselines ||
-        !g_flux_behavior_processor_load_baselines) {
+    FluxApi api;
+    bind(handle, "flux_behavior_to_hsi", api.behavior_to_hsi);
+    bind(handle, "flux_free_string", api.free_string);
+    bind(handle, "flux_last_error", api.last_error);
+    bind(handle, "flux_behavior_processor_new", api.processor_new);
+    bind(handle, "flux_behavior_processor_free", api.processor_free);
+    bind(handle, "flux_behavior_processor_process", api.processor_process);
+    bind(handle, "flux_behavior_processor_save_baselines", api.processor_save_baselines);
+    bind(handle, "flux_behavior_processor_load_baselines", api.processor_load_baselines);
+
+    if (!api.behavior_to_hsi || !api.free_string || !api.last_error ||
+        !api.processor_new || !api.processor_free || !api.processor_process ||
+        !api.processor_save_baselines || !api.processor_load_baselines) {
         LOGE("Failed to load some Flux functions");
-        return false;
+        return;
+    }
+
+    bind(handle, "flux_version", api.version);
+    bind(handle, "flux_behavior_stream_new", api.stream_new);
+    bind(handle, "flux_behavior_stream_push", api.stream_push);
+    bind(handle, "flux_behavior_stream_finish", api.stream_finish);
+    bind(handle, "flux_behavior_stream_free", api.stream_free);
+    bind(handle, "flux_behavior_to_hsi_binary", api.behavior_to_hsi_binary);
+    bind(handle, "flux_free_bytes", api.free_bytes);
+
+    jint caps = 0;
+    if (api.version) caps |= kCapVersion;
+    if (api.stream_new && api.stream_push && api.stream_finish && api.stream_free) {
+        caps |= kCapStreaming;
     }
+    if (api.behavior_to_hsi_binary && api.free_bytes) caps |= kCapBinary;
+
+    g_flux = api;
+    g_capabilities.store((kCapabilityTableVersion << 24) | caps, std::memory_order_relaxed);
+    g_flux_bound.store(true, std::memory_order_release);
 
-    g_functions_loaded = true;
-    LOGI("Successfully loaded all Flux functions");
-    if (g_flux_version) {
-        const char* ver = g_flux_version();
+    LOGI("Successfully loaded all Flux functions (capabilities 0x%x)", caps);
+    if (api.version) {
+        const char* ver = api.version();
         if (ver) {
             LOGI("synheart-flux version: %s", ver);
         }
     }
-    return true;
 }
 
-// Helper to convert jstring to C string
-static char* jstring_to_cstring(JNIEnv* env, jstring jstr) {
-    if (!jstr) {
-        return nullptr;
+// True when modified UTF-8 text contains an encoded NUL (C0 80) or surrogate (ED A0..BF),
+// i.e. when it is not also valid standard UTF-8
+static bool needs_standard_utf8(const char* chars) {
+    for (const unsigned char* p = reinterpret_cast<const unsigned char*>(chars); *p; ++p) {
+        if ((p[0] == 0xC0 && p[1] == 0x80) || (p[0] == 0xED && p[1] >= 0xA0)) {
+            return true;
+        }
     }
-    const char* utf8 = env->GetStringUTFChars(jstr, nullptr);
-    if (!utf8) {
-        return nullptr;
+    return false;
+}
+
+// Standard UTF-8 view of a jstring, released on scope exit. Borrows the JNI chars, which are
+// already standard UTF-8 unless the string holds NUL or supplementary characters; those are
+// re-encoded through String.getBytes(UTF_8).
+class ScopedUtfChars {
+public:
+    ScopedUtfChars(JNIEnv* env, jstring str)
+        : env_(env), str_(str), chars_(str ? env->GetStringUTFChars(str, nullptr) : nullptr) {
+        if (chars_ && needs_standard_utf8(chars_)) {
+            reencode();
+        }
     }
-    size_t len = strlen(utf8);
-    char* result = (char*)malloc(len + 1);
-    if (result) {
-        strcpy(result, utf8);
+    ~ScopedUtfChars() {
+        if (chars_) {
+            env_->ReleaseStringUTFChars(str_, chars_);
+        }
     }
-    env->ReleaseStringUTFChars(jstr, utf8);
-    return result;
-}
+    ScopedUtfChars(const ScopedUtfChars&) = delete;
+    ScopedUtfChars& operator=(const ScopedUtfChars&) = delete;
+
+    const char* c_str() const { return copied_ ? standard_.c_str() : chars_; }
+
+private:
+    void reencode() {
+        auto bytes = static_cast<jbyteArray>(
+            env_->CallObjectMethod(str_, g_string_get_bytes, g_utf8_charset));
+        if (!bytes) {
+            // Exception pending: read as a null string, so the caller returns straight away
+            env_->ReleaseStringUTFChars(str_, chars_);
+            chars_ = nullptr;
+            return;
+        }
+        jsize len = env_->GetArrayLength(bytes);
+        standard_.resize(len);
+        env_->GetByteArrayRegion(bytes, 0, len, reinterpret_cast<jbyte*>(&standard_[0]));
+        env_->DeleteLocalRef(bytes);
+        copied_ = true;
+    }
+
+    JNIEnv* env_;
+    jstring str_;
+    const char* chars_;
+    std::string standard_;
+    bool copied_ = false;
+};
 
-// Helper to convert C string to jstring
+// Standard UTF-8 C string to jstring. ASCII and other text that is also valid modified UTF-8
+// takes NewStringUTF; NUL-free text with 4-byte sequences is decoded by String(byte[], UTF_8).
 static jstring cstring_to_jstring(JNIEnv* env, const char* cstr) {
     if (!cstr) {
         return nullptr;
     }
-    return env->NewStringUTF(cstr);
-}
-
-// JNI: Java_ai_synheart_behavior_FluxBridge_nativeBehaviorToHsi
-extern "C" JNIEXPORT jstring JNICALL
-Java_ai_synheart_behavior_FluxBridge_nativeBehaviorToHsi(
-    JNIEnv* env,
-    jclass clazz,
-    jstring json
-) {
-    if (!load_flux_functions()) {
-        return nullptr;
+    size_t len = 0;
+    bool supplementary = false;
+    for (const unsigned char* p = reinterpret_cast<const unsigned char*>(cstr); *p; ++p, ++len) {
+        supplementary |= *p >= 0xF0;
+    }
+    if (!supplementary) {
+        return env->NewStringUTF(cstr);
     }
 
-    char* json_cstr = jstring_to_cstring(env, json);
-    if (!json_cstr) {
+    jbyteArray bytes = env->NewByteArray(static_cast<jsize>(len));
+    if (!bytes) {
         return nullptr;
     }
+    env->SetByteArrayRegion(bytes, 0, static_cast<jsize>(len), reinterpret_cast<const jbyte*>(cstr));
+    auto result = static_cast<jstring>(
+        env->NewObject(g_string_class, g_string_from_bytes, bytes, g_utf8_charset));
+    env->DeleteLocalRef(bytes);
+    return result;
+}
 
-    char* result_cstr = g_flux_behavior_to_hsi(json_cstr);
-    free(json_cstr);
-
+// Hand a Flux-owned result string to Java and free it; logs the Flux error on null
+static jstring take_flux_string(JNIEnv* env, char* result_cstr) {
     if (!result_cstr) {
-        // Get error message
-        const char* error = g_flux_last_error();
+        const char* error = g_flux.last_error();
         if (error) {
             LOGE("Flux error: %s", error);
         }
@@ -138,163 +232,327 @@ Java_ai_synheart_behavior_FluxBridge_nativeBehaviorToHsi(
     }
 
     jstring result = cstring_to_jstring(env, result_cstr);
-    g_flux_free_string(result_cstr);
+    g_flux.free_string(result_cstr);
     return result;
 }
 
-// JNI: Java_ai_synheart_behavior_FluxBridge_nativeProcessorNew
-extern "C" JNIEXPORT jlong JNICALL
-Java_ai_synheart_behavior_FluxBridge_nativeProcessorNew(
-    JNIEnv* env,
-    jclass clazz,
-    jint baselineWindowSessions
-) {
-    if (!load_flux_functions()) {
-        return 0;
+// The native methods below are only registered once Flux is bound (see JNI_OnLoad), so they
+// call through g_flux without re-checking.
+
+// FluxBridge.nativeBehaviorToHsi
+static jstring native_behavior_to_hsi(JNIEnv* env, jobject /* thiz */, jstring json) {
+    ScopedUtfChars json_chars(env, json);
+    if (!json_chars.c_str()) {
+        return nullptr;
     }
+    return take_flux_string(env, g_flux.behavior_to_hsi(json_chars.c_str()));
+}
 
-    void* processor = g_flux_behavior_processor_new(baselineWindowSessions);
+// FluxBridge.nativeProcessorNew
+static jlong native_processor_new(JNIEnv* /* env */, jobject /* thiz */, jint baselineWindowSessions) {
+    void* processor = g_flux.processor_new(baselineWindowSessions);
     return reinterpret_cast<jlong>(processor);
 }
 
-// JNI: Java_ai_synheart_behavior_FluxBridge_nativeProcessorFree
-extern "C" JNIEXPORT void JNICALL
-Java_ai_synheart_behavior_FluxBridge_nativeProcessorFree(
-    JNIEnv* env,
-    jclass clazz,
-    jlong handle
-) {
-    if (!load_flux_functions() || handle == 0) {
+// FluxBridge.nativeProcessorFree
+static void native_processor_free(JNIEnv* /* env */, jobject /* thiz */, jlong handle) {
+    if (handle == 0) {
         return;
     }
-
-    void* processor = reinterpret_cast<void*>(handle);
-    g_flux_behavior_processor_free(processor);
+    g_flux.processor_free(reinterpret_cast<void*>(handle));
 }
 
-// JNI: Java_ai_synheart_behavior_FluxBridge_nativeProcessorProcess
-extern "C" JNIEXPORT jstring JNICALL
-Java_ai_synheart_behavior_FluxBridge_nativeProcessorProcess(
-    JNIEnv* env,
-    jclass clazz,
-    jlong handle,
-    jstring json
-) {
-    if (!load_flux_functions() || handle == 0) {
+// FluxBridge.nativeProcessorProcess
+static jstring native_processor_process(JNIEnv* env, jobject /* thiz */, jlong handle, jstring json) {
+    if (handle == 0) {
         return nullptr;
     }
 
-    char* json_cstr = jstring_to_cstring(env, json);
-    if (!json_cstr) {
+    ScopedUtfChars json_chars(env, json);
+    if (!json_chars.c_str()) {
         return nullptr;
     }
 
     void* processor = reinterpret_cast<void*>(handle);
-    char* result_cstr = g_flux_behavior_processor_process(processor, json_cstr);
-    free(json_cstr);
+    return take_flux_string(env, g_flux.processor_process(processor, json_chars.c_str()));
+}
 
-    if (!result_cstr) {
-        const char* error = g_flux_last_error();
-        if (error) {
-            LOGE("Flux error: %s", error);
-        }
+// FluxBridge.nativeProcessorSaveBaselines
+static jstring native_processor_save_baselines(JNIEnv* env, jobject /* thiz */, jlong handle) {
+    if (handle == 0) {
         return nullptr;
     }
 
-    jstring result = cstring_to_jstring(env, result_cstr);
-    g_flux_free_string(result_cstr);
-    return result;
+    void* processor = reinterpret_cast<void*>(handle);
+    return take_flux_string(env, g_flux.processor_save_baselines(processor));
 }
 
-// JNI: Java_ai_synheart_behavior_FluxBridge_nativeProcessorSaveBaselines
-extern "C" JNIEXPORT jstring JNICALL
-Java_ai_synheart_behavior_FluxBridge_nativeProcessorSaveBaselines(
-    JNIEnv* env,
-    jclass clazz,
-    jlong handle
-) {
-    if (!load_flux_functions() || handle == 0) {
-        return nullptr;
+// FluxBridge.nativeProcessorLoadBaselines
+static jint native_processor_load_baselines(JNIEnv* env, jobject /* thiz */, jlong handle, jstring json) {
+    if (handle == 0) {
+        return -1;
+    }
+
+    ScopedUtfChars json_chars(env, json);
+    if (!json_chars.c_str()) {
+        return -1;
     }
 
     void* processor = reinterpret_cast<void*>(handle);
-    char* result_cstr = g_flux_behavior_processor_save_baselines(processor);
+    int result = g_flux.processor_load_baselines(processor, json_chars.c_str());
 
-    if (!result_cstr) {
-        const char* error = g_flux_last_error();
+    if (result != 0) {
+        const char* error = g_flux.last_error();
         if (error) {
             LOGE("Flux error: %s", error);
         }
-        return nullptr;
     }
 
-    jstring result = cstring_to_jstring(env, result_cstr);
-    g_flux_free_string(result_cstr);
     return result;
 }
 
-// JNI: Java_ai_synheart_behavior_FluxBridge_nativeProcessorLoadBaselines
-extern "C" JNIEXPORT jint JNICALL
-Java_ai_synheart_behavior_FluxBridge_nativeProcessorLoadBaselines(
+// FluxBridge.nativeFluxVersion
+static jstring native_flux_version(JNIEnv* env, jobject /* thiz */) {
+    if (!g_flux.version) {
+        return nullptr;
+    }
+    return cstring_to_jstring(env, g_flux.version());
+}
+
+// FluxBridge.nativeLastError
+static jstring native_last_error(JNIEnv* env, jobject /* thiz */) {
+    return cstring_to_jstring(env, g_flux.last_error());
+}
+
+// Batch payloads arrive as one UTF-8 buffer plus count + 1 offsets; payload i is
+// data[offsets[i], offsets[i + 1]). Copy each into its own NUL-terminated string for Flux.
+static bool read_batch_payloads(
     JNIEnv* env,
-    jclass clazz,
-    jlong handle,
-    jstring json
+    jbyteArray data,
+    jintArray offsets,
+    std::vector<std::string>& payloads
 ) {
-    if (!load_flux_functions() || handle == 0) {
-        return -1;
+    if (!data || !offsets) {
+        return false;
+    }
+    jsize offset_count = env->GetArrayLength(offsets);
+    if (offset_count < 1) {
+        return false;
     }
+    jsize data_len = env->GetArrayLength(data);
+
+    std::vector<jint> bounds(offset_count);
+    env->GetIntArrayRegion(offsets, 0, offset_count, bounds.data());
+    std::vector<jbyte> bytes(data_len);
+    env->GetByteArrayRegion(data, 0, data_len, bytes.data());
+
+    payloads.resize(offset_count - 1);
+    for (jsize i = 0; i + 1 < offset_count; ++i) {
+        jint start = bounds[i];
+        jint end = bounds[i + 1];
+        if (start < 0 || end < start || end > data_len) {
+            LOGE("Invalid batch offsets at %d", static_cast<int>(i));
+            return false;
+        }
+        payloads[i].assign(reinterpret_cast<const char*>(bytes.data()) + start, end - start);
+    }
+    return true;
+}
 
-    char* json_cstr = jstring_to_cstring(env, json);
-    if (!json_cstr) {
-        return -1;
+// Pack Flux results into count + 1 little-endian int32 offsets followed by the UTF-8 bytes.
+// A failed entry packs as zero length. Takes ownership of the Flux strings.
+static jbyteArray pack_batch_results(JNIEnv* env, std::vector<char*>& results) {
+    size_t count = results.size();
+    std::vector<size_t> lengths(count);
+    size_t header_size = (count + 1) * sizeof(int32_t);
+    size_t total = header_size;
+    for (size_t i = 0; i < count; ++i) {
+        lengths[i] = results[i] ? strlen(results[i]) : 0;
+        total += lengths[i];
     }
 
-    void* processor = reinterpret_cast<void*>(handle);
-    int result = g_flux_behavior_processor_load_baselines(processor, json_cstr);
-    free(json_cstr);
+    std::vector<uint8_t> packed(total);
+    size_t offset = 0;
+    for (size_t i = 0; i <= count; ++i) {
+        uint32_t value = static_cast<uint32_t>(offset);
+        uint8_t* slot = packed.data() + i * sizeof(int32_t);
+        slot[0] = value & 0xff;
+        slot[1] = (value >> 8) & 0xff;
+        slot[2] = (value >> 16) & 0xff;
+        slot[3] = (value >> 24) & 0xff;
+        if (i < count) {
+            if (lengths[i] > 0) {
+                memcpy(packed.data() + header_size + offset, results[i], lengths[i]);
+            }
+            offset += lengths[i];
+        }
+    }
 
-    if (result != 0) {
-        const char* error = g_flux_last_error();
-        if (error) {
-            LOGE("Flux error: %s", error);
+    for (char* result : results) {
+        if (result) {
+            g_flux.free_string(result);
         }
     }
+    results.clear();
 
-    return result;
+    jbyteArray array = env->NewByteArray(static_cast<jsize>(total));
+    if (!array) {
+        return nullptr;
+    }
+    env->SetByteArrayRegion(array, 0, static_cast<jsize>(total), reinterpret_cast<const jbyte*>(packed.data()));
+    return array;
 }
 
-// JNI: Java_ai_synheart_behavior_FluxBridge_nativeFluxVersion
-extern "C" JNIEXPORT jstring JNICALL
-Java_ai_synheart_behavior_FluxBridge_nativeFluxVersion(
+// Stateless batch, run in order on the calling thread. synheart_flux.h promises only
+// thread-local error state, not that flux_behavior_to_hsi is reentrant, so payloads are never
+// scored concurrently; the batch still saves the per-session JNI crossings and string copies.
+static void run_stateless_batch(const std::vector<std::string>& payloads, std::vector<char*>& results) {
+    results.assign(payloads.size(), nullptr);
+    for (size_t i = 0; i < payloads.size(); ++i) {
+        results[i] = g_flux.behavior_to_hsi(payloads[i].c_str());
+        if (!results[i]) {
+            const char* error = g_flux.last_error();
+            if (error) {
+                LOGE("Flux error (batch item %zu): %s", i, error);
+            }
+        }
+    }
+}
+
+// FluxBridge.nativeBehaviorToHsiBatch
+static jbyteArray native_behavior_to_hsi_batch(
     JNIEnv* env,
-    jclass clazz
+    jobject /* thiz */,
+    jbyteArray data,
+    jintArray offsets
 ) {
-    if (!load_flux_functions() || !g_flux_version) {
-        return nullptr;
-    }
-    const char* ver = g_flux_version();
-    if (!ver) {
+    std::vector<std::string> payloads;
+    if (!read_batch_payloads(env, data, offsets, payloads)) {
         return nullptr;
     }
-    return cstring_to_jstring(env, ver);
+
+    std::vector<char*> results;
+    run_stateless_batch(payloads, results);
+    return pack_batch_results(env, results);
 }
 
-// JNI: Java_ai_synheart_behavior_FluxBridge_nativeLastError
-extern "C" JNIEXPORT jstring JNICALL
-Java_ai_synheart_behavior_FluxBridge_nativeLastError(
+// FluxBridge.nativeProcessorProcessBatch. Baselines update session by session, so the
+// stateful processor runs the batch in order on the calling thread.
+static jbyteArray native_processor_process_batch(
     JNIEnv* env,
-    jclass clazz
+    jobject /* thiz */,
+    jlong handle,
+    jbyteArray data,
+    jintArray offsets
 ) {
-    if (!load_flux_functions()) {
+    if (handle == 0) {
         return nullptr;
     }
 
-    const char* error = g_flux_last_error();
-    if (!error) {
+    std::vector<std::string> payloads;
+    if (!read_batch_payloads(env, data, offsets, payloads)) {
         return nullptr;
     }
 
-    return cstring_to_jstring(env, error);
+    void* processor = reinterpret_cast<void*>(handle);
+    std::vector<char*> results(payloads.size(), nullptr);
+    for (size_t i = 0; i < payloads.size(); ++i) {
+        results[i] = g_flux.processor_process(processor, payloads[i].c_str());
+        if (!results[i]) {
+            const char* error = g_flux.last_error();
+            if (error) {
+                LOGE("Flux error (batch item %zu): %s", i, error);
+            }
+        }
+    }
+    return pack_batch_results(env, results);
+}
+
+// FluxBridge.nativeCapabilities
+static jint native_capabilities(JNIEnv* /* env */, jobject /* thiz */) {
+    return g_capabilities.load(std::memory_order_relaxed);
+}
+
+static const JNINativeMethod kFluxBridgeMethods[] = {
+    {"nativeBehaviorToHsi", "(Ljava/lang/String;)Ljava/lang/String;",
+     reinterpret_cast<void*>(native_behavior_to_hsi)},
+    {"nativeProcessorNew", "(I)J", reinterpret_cast<void*>(native_processor_new)},
+    {"nativeProcessorFree", "(J)V", reinterpret_cast<void*>(native_processor_free)},
+    {"nativeProcessorProcess", "(JLjava/lang/String;)Ljava/lang/String;",
+     reinterpret_cast<void*>(native_processor_process)},
+    {"nativeProcessorSaveBaselines", "(J)Ljava/lang/String;",
+     reinterpret_cast<void*>(native_processor_save_baselines)},
+    {"nativeProcessorLoadBaselines", "(JLjava/lang/String;)I",
+     reinterpret_cast<void*>(native_processor_load_baselines)},
+    {"nativeFluxVersion", "()Ljava/lang/String;", reinterpret_cast<void*>(native_flux_version)},
+    {"nativeLastError", "()Ljava/lang/String;", reinterpret_cast<void*>(native_last_error)},
+    {"nativeCapabilities", "()I", reinterpret_cast<void*>(native_capabilities)},
+    {"nativeBehaviorToHsiBatch", "([B[I)[B", reinterpret_cast<void*>(native_behavior_to_hsi_batch)},
+    {"nativeProcessorProcessBatch", "(J[B[I)[B",
+     reinterpret_cast<void*>(native_processor_process_batch)},
+};
+
+// Look up the String class, its UTF-8 constructor and getBytes, and StandardCharsets.UTF_8
+static bool cache_string_refs(JNIEnv* env) {
+    jclass string_class = env->FindClass("java/lang/String");
+    if (!string_class) {
+        return false;
+    }
+    g_string_class = static_cast<jclass>(env->NewGlobalRef(string_class));
+    env->DeleteLocalRef(string_class);
+    g_string_from_bytes =
+        env->GetMethodID(g_string_class, "<init>", "([BLjava/nio/charset/Charset;)V");
+    g_string_get_bytes =
+        env->GetMethodID(g_string_class, "getBytes", "(Ljava/nio/charset/Charset;)[B");
+
+    jclass charsets_class = env->FindClass("java/nio/charset/StandardCharsets");
+    if (!charsets_class) {
+        return false;
+    }
+    jfieldID utf8_field =
+        env->GetStaticFieldID(charsets_class, "UTF_8", "Ljava/nio/charset/Charset;");
+    jobject utf8 = utf8_field ? env->GetStaticObjectField(charsets_class, utf8_field) : nullptr;
+    env->DeleteLocalRef(charsets_class);
+    if (!utf8) {
+        return false;
+    }
+    g_utf8_charset = env->NewGlobalRef(utf8);
+    env->DeleteLocalRef(utf8);
+    return g_string_class && g_string_from_bytes && g_string_get_bytes && g_utf8_charset;
 }
 
+// Bind Flux and register the FluxBridge natives. If Flux cannot be bound nothing is registered,
+// so FluxBridge sees UnsatisfiedLinkError and reports the bridge as unavailable.
+extern "C" JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* vm, void* /* reserved */) {
+    JNIEnv* env = nullptr;
+    if (vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6) != JNI_OK) {
+        return JNI_ERR;
+    }
+
+    std::call_once(g_flux_once, bind_flux_functions);
+    if (!g_flux_bound.load(std::memory_order_acquire)) {
+        return JNI_VERSION_1_6;
+    }
+
+    if (!cache_string_refs(env)) {
+        LOGE("Failed to cache java/lang/String references");
+        return JNI_ERR;
+    }
+
+    jclass bridge_class = env->FindClass("ai/synheart/behavior/FluxBridge");
+    if (!bridge_class) {
+        LOGE("FluxBridge class not found");
+        return JNI_ERR;
+    }
+    jint status = env->RegisterNatives(
+        bridge_class,
+        kFluxBridgeMethods,
+        sizeof(kFluxBridgeMethods) / sizeof(kFluxBridgeMethods[0]));
+    env->DeleteLocalRef(bridge_class);
+    if (status != JNI_OK) {
+        LOGE("RegisterNatives failed for FluxBridge");
+        return JNI_ERR;
+    }
+
+    return JNI_VERSION_1_6;
+}
@@ -0,0 +1,339 @@
+package ai.synheart.behavior
+
+import android.os.Process
+import java.util.concurrent.Callable
+import java.util.concurrent.ConcurrentLinkedDeque
+import java.util.concurrent.ConcurrentLinkedQueue
+import java.util.concurrent.ExecutionException
+import java.util.concurrent.FutureTask
+import java.util.concurrent.ScheduledFuture
+import java.util.concurrent.ScheduledThreadPoolExecutor
+import java.util.concurrent.TimeUnit
+import java.util.concurrent.atomic.AtomicBoolean
+import java.util.concurrent.atomic.AtomicInteger
+import java.util.concurrent.atomic.AtomicLong
+import java.util.concurrent.atomic.AtomicReference
+import java.util.concurrent.locks.LockSupport
+
+/**
+ * Process-wide executor shared by the SDK's native subsystems, with three QoS classes.
+ *
+ * A small pool of workers (started on first use) each own one deque per [QoS]. Tasks submitted from
+ * a worker go to the head of its own deque, and tasks from other threads are spread round-robin
+ * over the tails. An idle worker first pops its own deques, then steals from the tails of the
+ * others. Every source is searched for a higher class before any lower one, so a queued
+ * [QoS.INTERACTIVE] task is never behind background work that has not started yet.
+ *
+ * Android offers no public core-affinity API (pinning needs `sched_setaffinity` through JNI, and
+ * would fight the energy-aware scheduler). Instead, a worker switches its thread priority to the
+ * class of the task it runs. The scheduler maps priorities onto its cpusets and utilization
+ * clamps, so placement on big or little cores is left to the platform.
+ *
+ * Work that must not run concurrently goes through a [SerialQueue], which runs its tasks in order
+ * on the shared workers. A caller waiting on a queue lends it its own class, so the main thread is
+ * never left waiting behind background work, and an idle queue runs a call on the caller's own
+ * thread without a hand-off.
+ */
+object BehaviorExecutor {
+
+    enum class QoS(val key: String, val threadPriority: Int) {
+        /** Short, latency-sensitive work a caller is waiting on (queries from Dart). */
+        INTERACTIVE("interactive", Process.THREAD_PRIORITY_FOREGROUND),
+
+        /** Results the user will see soon (session summaries, live snapshots). */
+        USER_VISIBLE("user_visible", Process.THREAD_PRIORITY_DEFAULT),
+
+        /** Bulk work nobody is waiting on (feature extraction, precompute, checkpoints). */
+        BACKGROUND("background", Process.THREAD_PRIORITY_BACKGROUND)
+    }
+
+    private class Task(val qos: QoS, val runnable: Runnable) {
+        val enqueuedNanos = System.nanoTime()
+    }
+
+    /** Result of [SerialQueue.call]; wakes the worker waiting on it when it completes. */
+    private class CallTask<T>(callable: Callable<T>) : FutureTask<T>(callable) {
+        @Volatile var waiter: Thread? = null
+
+        override fun done() {
+            waiter?.let { LockSupport.unpark(it) }
+        }
+    }
+
+    private class Worker(val index: Int) : Thread("BehaviorExecutor-$index") {
+        val deques = Array(QOS_COUNT) { ConcurrentLinkedDeque<Task>() }
+        var currentPriority = Int.MIN_VALUE
+        var currentQoS: QoS? = null // Class of the task running now
+
+        override fun run() {
+            while (true) {
+                val task = findTask(this)
+                if (task != null) {
+                    runTask(this, task)
+                    continue
+                }
+                // Announce idleness, then look once more so a concurrent submit is not missed
+                idle.add(this)
+                val late = findTask(this)
+                if (late != null) {
+                    idle.remove(this)
+                    runTask(this, late)
+                    continue
+                }
+                LockSupport.park(this)
+                idle.remove(this)
+            }
+        }
+    }
+
+    private val QOS_COUNT = QoS.values().size
+
+    private val workerCount = (Runtime.getRuntime().availableProcessors() - 1).coerceIn(2, 4)
+    private val workers: Array<Worker> by lazy {
+        Array(workerCount) { index ->
+            Worker(index).also {
+                it.isDaemon = true
+                it.start()
+            }
+        }
+    }
+    private val idle = ConcurrentLinkedQueue<Worker>()
+    private val helping = ConcurrentLinkedQueue<Worker>() // Parked in await until work arrives
+    // The queue whose task is running on this thread, so a nested call on it can run inline
+    private val activeQueue = ThreadLocal<SerialQueue?>()
+    private val nextWorker = AtomicInteger()
+    private val steals = AtomicLong()
+    private val latency = Array(QOS_COUNT) { LatencyHistogram() }
+
+    // Delayed tasks wait here, then are submitted at their class
+    private val timer by lazy {
+        val executor =
+                ScheduledThreadPoolExecutor(1) { runnable ->
+                    Thread(runnable, "BehaviorTimer").also { it.isDaemon = true }
+                }
+        executor.removeOnCancelPolicy = true
+        executor
+    }
+
+    /** Run [task] on a worker at [qos]. */
+    fun execute(qos: QoS, task: Runnable) {
+        val entry = Task(qos, task)
+        val current = Thread.currentThread()
+        if (current is Worker) {
+            current.deques[qos.ordinal].addFirst(entry)
+        } else {
+            val index = Math.floorMod(nextWorker.getAndIncrement(), workers.size)
+            workers[index].deques[qos.ordinal].addLast(entry)
+        }
+        idle.poll()?.let { LockSupport.unpark(it) }
+        while (true) LockSupport.unpark(helping.poll() ?: break)
+    }
+
+    /** Run [task] at [qos] after [delayMs]. Cancelling the future before then drops it. */
+    fun schedule(qos: QoS, delayMs: Long, task: Runnable): ScheduledFuture<*> =
+            timer.schedule({ execute(qos, task) }, delayMs, TimeUnit.MILLISECONDS)
+
+    /** QoS of the task running on the calling thread, or null off the executor. */
+    fun currentQoS(): QoS? = (Thread.currentThread() as? Worker)?.currentQoS
+
+    /** Tasks waiting to start, per class. */
+    fun queueDepths(): Map<String, Int> =
+            QoS.values().associate { qos ->
+                qos.key to workers.sumOf { it.deques[qos.ordinal].size }
+            }
+
+    /** Per-class task counts and queueing latency (submit to start), plus steal count. */
+    fun getStats(): Map<String, Any> {
+        val stats = LinkedHashMap<String, Any>()
+        stats["workers"] = workerCount
+        stats["steals"] = steals.get()
+        for (qos in QoS.values()) {
+            val classStats = latency[qos.ordinal]
+            stats[qos.key] =
+                    mapOf(
+                            "tasks" to classStats.size,
+                            "queue_avg_us" to classStats.averageMicros(),
+                            "queue_p95_us" to classStats.quantileMicros(0.95),
+                            "queue_max_us" to classStats.maxMicros()
+                    )
+        }
+        return stats
+    }
+
+    /** Next task for [worker], searching classes from the highest down to [lowest]. */
+    private fun findTask(worker: Worker, lowest: QoS = QoS.BACKGROUND): Task? {
+        for (q in 0..lowest.ordinal) {
+            worker.deques[q].pollFirst()?.let {
+                return it
+            }
+            for (offset in 1 until workers.size) {
+                val victim = workers[(worker.index + offset) % workers.size]
+                victim.deques[q].pollLast()?.let {
+                    steals.incrementAndGet()
+                    return it
+                }
+            }
+        }
+        return null
+    }
+
+    private fun runTask(worker: Worker, task: Task) {
+        latency[task.qos.ordinal].record(System.nanoTime() - task.enqueuedNanos)
+        if (worker.currentPriority != task.qos.threadPriority) {
+            Process.setThreadPriority(task.qos.threadPriority)
+            worker.currentPriority = task.qos.threadPriority
+        }
+        val outer = worker.currentQoS // Set when helping from inside another task
+        worker.currentQoS = task.qos
+        try {
+            task.runnable.run()
+        } catch (e: Throwable) {
+            android.util.Log.e("BehaviorExecutor", "Task failed: ${e.message}", e)
+        } finally {
+            worker.currentQoS = outer
+        }
+    }
+
+    /**
+     * Wait for [future], queued on [queue]. On a worker, run other queued tasks of the worker's
+     * class or higher meanwhile instead of blocking, so tasks waiting on each other cannot starve
+     * the pool, and park when there are none until a submit or the result wakes it. Inside a
+     * [SerialQueue] task only [queue] itself is drained: another task could need the queue this
+     * thread already holds. Other threads (the main thread) block without running anything else.
+     */
+    private fun <T> await(future: CallTask<T>, queue: SerialQueue): T {
+        val current = Thread.currentThread()
+        if (current is Worker) {
+            val priority = current.currentPriority
+            val lowest = current.currentQoS ?: QoS.BACKGROUND
+            future.waiter = current
+            while (!future.isDone) {
+                if (help(current, queue, lowest)) continue
+                // Announce, then look once more so a concurrent submit is not missed
+                helping.add(current)
+                if (!future.isDone && !help(current, queue, lowest)) LockSupport.park(this)
+                helping.remove(current)
+            }
+            if (current.currentPriority != priority) {
+                Process.setThreadPriority(priority)
+                current.currentPriority = priority
+            }
+        }
+        try {
+            return future.get()
+        } catch (e: ExecutionException) {
+            throw e.cause ?: e
+        }
+    }
+
+    /** Run one piece of work on [worker] while it waits on [queue]; false when there was none. */
+    private fun help(worker: Worker, queue: SerialQueue, lowest: QoS): Boolean {
+        if (activeQueue.get() != null) return queue.drainHere(lowest)
+        val task = findTask(worker, lowest) ?: return false
+        runTask(worker, task)
+        return true
+    }
+
+    /**
+     * Runs its tasks one at a time, in submission order, on the shared workers at [qos]. Replaces a
+     * dedicated HandlerThread for state that is only touched from one thread at a time.
+     *
+     * [call] inherits priority: when the caller's class is higher than [qos] (any thread off the
+     * executor counts as [QoS.INTERACTIVE]), the queue is drained at the caller's class until the
+     * call completes. A drain already running at [qos] yields after its current task.
+     */
+    class SerialQueue(private val qos: QoS) {
+        private val tasks = ConcurrentLinkedQueue<Runnable>()
+        private val scheduled = AtomicBoolean(false) // A drain at [qos] is queued
+        private val running = AtomicBoolean(false) // A drain holds the queue
+        private val boost = AtomicReference<QoS?>() // Class a waiting caller needs, above [qos]
+
+        private val drain = Runnable {
+            scheduled.set(false)
+            drainBatch(qos)
+        }
+
+        /** Run a batch at [drainQoS] on the calling thread; false when another drain holds it. */
+        private fun drainBatch(drainQoS: QoS): Boolean {
+            if (!running.compareAndSet(false, true)) {
+                // The holder resubmits when it releases; make sure it does so at this class
+                if (drainQoS != qos) {
+                    boost.set(drainQoS)
+                    if (!running.get()) submitDrain()
+                }
+                return false
+            }
+            val outer = activeQueue.get()
+            activeQueue.set(this)
+            // A bounded batch, so one busy queue cannot hold a worker indefinitely
+            var count = 0
+            while (count < DRAIN_BATCH) {
+                val waiting = boost.get()
+                if (waiting != null && waiting < drainQoS) break // Hand over to a boosted drain
+                val task = tasks.poll() ?: break
+                try {
+                    task.run()
+                } catch (e: Throwable) {
+                    android.util.Log.e("BehaviorExecutor", "Task failed: ${e.message}", e)
+                }
+                count++
+            }
+            activeQueue.set(outer)
+            running.set(false)
+            submitDrain()
+            return true
+        }
+
+        /** Drain on the calling worker while it waits on this queue; false when nothing ran. */
+        internal fun drainHere(drainQoS: QoS): Boolean =
+                !tasks.isEmpty() && !running.get() && drainBatch(drainQoS)
+
+        fun execute(task: Runnable) {
+            tasks.add(task)
+            submitDrain()
+        }
+
+        fun schedule(delayMs: Long, task: Runnable): ScheduledFuture<*> =
+                timer.schedule({ execute(task) }, delayMs, TimeUnit.MILLISECONDS)
+
+        /**
+         * Run [block] on this queue and wait for its result, at the caller's class when that is
+         * higher than the queue's. Runs inline when called from one of this queue's own tasks, and
+         * on the calling thread when the queue is idle.
+         */
+        fun <T> call(block: () -> T): T {
+            val outer = activeQueue.get()
+            if (outer === this) return block()
+            if (tasks.isEmpty() && running.compareAndSet(false, true)) {
+                activeQueue.set(this)
+                try {
+                    return block()
+                } finally {
+                    activeQueue.set(outer)
+                    running.set(false)
+                    submitDrain()
+                }
+            }
+            val future = CallTask(Callable { block() })
+            tasks.add(future)
+            val callerQoS = currentQoS() ?: QoS.INTERACTIVE
+            if (callerQoS < qos) boost.set(callerQoS)
+            submitDrain()
+            return await(future, this)
+        }
+
+        private fun submitDrain() {
+            if (tasks.isEmpty()) return
+            val boosted = boost.getAndSet(null)
+            if (boosted != null) {
+                BehaviorExecutor.execute(boosted) { drainBatch(boosted) }
+            } else if (scheduled.compareAndSet(false, true)) {
+                BehaviorExecutor.execute(qos, drain)
+            }
+        }
+
+        private companion object {
+            const val DRAIN_BATCH = 64
+        }
+    }
+}
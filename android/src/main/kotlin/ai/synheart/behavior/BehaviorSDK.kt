@@ -6,26 +6,39 @@ import android.net.ConnectivityManager
 import android.net.NetworkCapabilities
 import android.os.BatteryManager
 import android.os.Build
+import android.os.Debug
 import android.os.Handler
 import android.os.Looper
 import android.provider.Settings
+import android.system.Os
+import android.system.OsConstants
 import android.view.View
+import android.view.Window
 import androidx.lifecycle.Lifecycle
 import androidx.lifecycle.LifecycleObserver
 import androidx.lifecycle.OnLifecycleEvent
 import androidx.lifecycle.ProcessLifecycleOwner
+import java.io.File
 import java.time.Instant
 import java.util.concurrent.ConcurrentHashMap
+import java.util.concurrent.CopyOnWriteArrayList
+import java.util.concurrent.ScheduledFuture
+import javax.crypto.SecretKey
 
 /**
  * Main BehaviorSDK class for collecting behavioral signals. Privacy-first: No text content, no PII
  * - only timing and interaction patterns.
  */
-class BehaviorSDK(private val context: Context, private val config: BehaviorConfig) :
-        LifecycleObserver {
+class BehaviorSDK(
+        private val context: Context,
+        private val config: BehaviorConfig,
+        checkpointKey: SecretKey? = null // Required when config.encryptSessionCheckpoints is set
+) : LifecycleObserver {
 
     private var eventHandler: ((BehaviorEvent) -> Unit)? = null
-    private var currentSessionId: String? = null
+    private var currentSessionId: String? = null // Most recently started active session
+    // Active session shards in start order. Events fan out to every shard in this list.
+    private val activeSessionIds = CopyOnWriteArrayList<String>()
     private val sessionData = ConcurrentHashMap<String, SessionData>()
     private val sessionMotionData =
             ConcurrentHashMap<String, List<MotionSignalCollector.MotionDataPoint>>()
@@ -37,7 +50,8 @@ class BehaviorSDK(private val context: Context, private val config: BehaviorConf
     private val gestureCollector = GestureCollector(config)
     private val notificationCollector = NotificationCollector(config)
     private val callCollector = CallCollector(context, config)
-    private val motionSignalCollector = MotionSignalCollector(context, config)
+    private val energyMeter = EnergyMeter(config.powerTable)
+    private val motionSignalCollector = MotionSignalCollector(context, config, energyMeter)
 
     // Lifecycle tracking
     private var appInForeground = true
@@ -45,12 +59,90 @@ class BehaviorSDK(private val context: Context, private val config: BehaviorConf
     private var lastAppUseTime: Long? = null // For session spacing calculation
     private val handler = Handler(Looper.getMainLooper())
 
+    // Live snapshot scoring (enabled when config.liveSnapshotIntervalSeconds > 0)
+    private var snapshotHandler: ((Map<String, Any>) -> Unit)? = null
+    private val liveSnapshotScorers = ConcurrentHashMap<String, LiveSnapshotScorer>()
+    // Live snapshots and speculative summary precomputation run on the shared executor
+    private val snapshotQueue = BehaviorExecutor.SerialQueue(BehaviorExecutor.QoS.USER_VISIBLE)
+    private val precomputeQueue = BehaviorExecutor.SerialQueue(BehaviorExecutor.QoS.BACKGROUND)
+    @Volatile private var liveSnapshotFuture: ScheduledFuture<*>? = null
+    private val liveSnapshotRunnable =
+            object : Runnable {
+                override fun run() {
+                    emitLiveSnapshot()
+                    if (liveSnapshotScorers.isNotEmpty()) {
+                        liveSnapshotFuture =
+                                snapshotQueue.schedule(
+                                        config.liveSnapshotIntervalSeconds * 1000L,
+                                        this
+                                )
+                    }
+                }
+            }
+
+    // Speculative end-of-session work, computed on background/idle
+    private val sessionPrecomputers = ConcurrentHashMap<String, SessionPrecomputer>()
+    private var idlePrecomputeInteractionTime = 0L // lastInteractionTime already precomputed for
+    private val performanceMonitor = PerformanceMonitor(context)
+    private val latencyTracer = EventLatencyTracer()
+
+    // Synthetic input for stress tests (startSyntheticWorkload)
+    @Volatile private var workloadRun: WorkloadGenerator.Run? = null
+    // Soak test (startSoakTest): its monitor and the session it rotates on the main thread
+    @Volatile private var soakMonitor: SoakMonitor? = null
+    @Volatile private var soakSessionId: String? = null
+    @Volatile private var soakSessionCount = 0
+    @Volatile private var soakSessionErrors = 0
+
+    // Cross-session hourly/daily rollups (opt-in, saved in app-private storage). They follow the
+    // checkpoint encryption setting; encrypted rollups without a key are kept in memory only.
+    private val rollupStore =
+            when {
+                config.rollupRetentionDays <= 0 -> null
+                !config.encryptSessionCheckpoints ->
+                        RollupStore(
+                                config.rollupRetentionDays,
+                                File(context.noBackupFilesDir, "synheart_behavior_rollups")
+                        )
+                checkpointKey == null -> RollupStore(config.rollupRetentionDays)
+                else ->
+                        RollupStore(
+                                config.rollupRetentionDays,
+                                File(context.noBackupFilesDir, "synheart_behavior_rollups"),
+                                SegmentCipher(checkpointKey)
+                        )
+            }
+
+    // Crash-safe checkpoints of active sessions (opt-in, app-private storage). Encrypted
+    // checkpoints without a key are not written at all rather than written in plaintext.
+    private val checkpointer =
+            when {
+                !config.enableSessionCheckpoints -> null
+                !config.encryptSessionCheckpoints ->
+                        SessionCheckpointer(
+                                File(context.noBackupFilesDir, "synheart_behavior_checkpoints"),
+                                energyMeter
+                        )
+                checkpointKey == null -> {
+                    android.util.Log.w(
+                            "BehaviorSDK",
+                            "Encrypted checkpoints requested without a key; checkpoints disabled"
+                    )
+                    null
+                }
+                else ->
+                        SessionCheckpointer(
+                                File(context.noBackupFilesDir, "synheart_behavior_checkpoints"),
+                                energyMeter,
+                                SegmentCipher(checkpointKey)
+                        )
+            }
+
     // Device context tracking
     private var startScreenBrightness: Float = 0f
     private var startOrientation: Int = Configuration.ORIENTATION_PORTRAIT
     private var lastOrientation: Int =
             Configuration.ORIENTATION_PORTRAIT // Track last orientation to detect all changes
-    private var orientationChangeCount: Int = 0
 
     // System state tracking
     private var startInternetState: Boolean = false
@@ -69,7 +161,11 @@ class BehaviorSDK(private val context: Context, private val config: BehaviorConf
         ProcessLifecycleOwner.get().lifecycle.addObserver(this)
     }
 
-    fun initialize() {
+    /**
+     * Start collection. Returns the sessions restored from checkpoints (ID and start time), which
+     * are active again as if the process had never been killed.
+     */
+    fun initialize(): List<Map<String, Any>> {
         // Start idle detection
         handler.post(idleCheckRunnable)
 
@@ -79,29 +175,17 @@ class BehaviorSDK(private val context: Context, private val config: BehaviorConf
                     "BehaviorSDK",
                     "InputSignalCollector event received: eventType=${event.eventType}, sessionId=${event.sessionId}, currentSessionId=$currentSessionId"
             )
-            emitEvent(event)
-            statsCollector.recordEvent(event)
+            ingest(event)
         }
 
-        attentionSignalCollector.setEventHandler { event ->
-            emitEvent(event)
-            statsCollector.recordEvent(event)
-        }
+        attentionSignalCollector.setEventHandler { event -> ingest(event) }
 
-        gestureCollector.setEventHandler { event ->
-            emitEvent(event)
-            statsCollector.recordEvent(event)
-        }
+        gestureCollector.setEventHandler { event -> ingest(event) }
+        gestureCollector.setTouchHandler { onUserInteraction() }
 
-        notificationCollector.setEventHandler { event ->
-            emitEvent(event)
-            statsCollector.recordEvent(event)
-        }
+        notificationCollector.setEventHandler { event -> ingest(event) }
 
-        callCollector.setEventHandler { event ->
-            emitEvent(event)
-            statsCollector.recordEvent(event)
-        }
+        callCollector.setEventHandler { event -> ingest(event) }
 
         // Set notification collector for the service
         SynheartNotificationListenerService.setNotificationCollector(notificationCollector)
@@ -113,33 +197,99 @@ class BehaviorSDK(private val context: Context, private val config: BehaviorConf
 
         // Start call monitoring
         callCollector.startMonitoring()
+
+        rollupStore?.load()
+        return restoreCheckpoints()
+    }
+
+    /**
+     * Re-activate the sessions checkpointed by a previous process. Events are replayed through the
+     * normal append path, so counters, posting lists and speculative summaries match an
+     * uninterrupted session. Motion windows restart from now.
+     */
+    private fun restoreCheckpoints(): List<Map<String, Any>> {
+        val store = checkpointer ?: return emptyList()
+        val now = System.currentTimeMillis()
+        val restored = store.restore()
+        for (session in restored) {
+            val sessionId = session.data.sessionId
+            // Continue counting app switches from the restored count
+            val data =
+                    session.data.copy(
+                            appSwitchBaseline =
+                                    attentionSignalCollector.getAppSwitchCount() -
+                                            session.data.appSwitchCount
+                    )
+            sessionData[sessionId] = data
+            activeSessionIds.add(sessionId)
+            currentSessionId = sessionId
+            motionSignalCollector.startSession(sessionId, now)
+            startLiveSnapshots(sessionId, data.startTime)
+            sessionPrecomputers[sessionId] =
+                    SessionPrecomputer(sessionId, data.startTime, data.events)
+            for (event in session.events) {
+                appendToSession(data, event)
+                liveSnapshotScorers[sessionId]?.append(event)
+                sessionPrecomputers[sessionId]?.append(event)
+            }
+            store.begin(data)
+        }
+        if (restored.isNotEmpty()) {
+            lastInteractionTime = now
+            android.util.Log.d(
+                    "BehaviorSDK",
+                    "Restored ${restored.size} session(s) from checkpoints: ${store.getStats()}"
+            )
+        }
+        return restored.map {
+            mapOf("sessionId" to it.data.sessionId, "startTimestamp" to it.data.startTime)
+        }
     }
 
     fun setEventHandler(handler: (BehaviorEvent) -> Unit) {
         this.eventHandler = handler
     }
 
+    /** Receives live HSI snapshots on an executor worker thread. */
+    fun setSnapshotHandler(handler: (Map<String, Any>) -> Unit) {
+        this.snapshotHandler = handler
+    }
+
     fun startSession(sessionId: String) {
-        // Clear previous session data when starting a new session
-        // This ensures data persists until the next session starts, allowing
-        // calculateMetricsForTimeRange to access it for ended sessions
-        val previousSessionId = currentSessionId
-        if (previousSessionId != null && previousSessionId != sessionId) {
-            sessionData.remove(previousSessionId)
-            sessionMotionData.remove(previousSessionId)
+        // Clear data of sessions that have already ended when starting a new session
+        // This ensures ended data persists until the next session starts, allowing
+        // calculateMetricsForTimeRange to access it for ended sessions. Sessions that are
+        // still active keep running alongside the new one.
+        for (endedSessionId in sessionData.keys) {
+            if (endedSessionId != sessionId && !activeSessionIds.contains(endedSessionId)) {
+                sessionData.remove(endedSessionId)
+                sessionMotionData.remove(endedSessionId)
+            }
         }
+        // Restarting an active session ID replaces its shard
+        if (activeSessionIds.remove(sessionId)) {
+            stopLiveSnapshots(sessionId)
+            sessionPrecomputers.remove(sessionId)
+            motionSignalCollector.stopSession(sessionId)
+        }
+        val firstActiveSession = activeSessionIds.isEmpty()
 
         currentSessionId = sessionId
         val now = System.currentTimeMillis()
 
-        // Reset app switch count for new session
-        attentionSignalCollector.resetAppSwitchCount()
+        // App switches are counted per session against a baseline; the shared counter is
+        // only reset when no other session is using it
+        if (firstActiveSession) {
+            attentionSignalCollector.resetAppSwitchCount()
+        }
+        val appSwitchBaseline = attentionSignalCollector.getAppSwitchCount()
 
         // Capture device context at session start
         startScreenBrightness = getScreenBrightness()
         startOrientation = context.resources.configuration.orientation
-        lastOrientation = startOrientation // Initialize last orientation to start orientation
-        orientationChangeCount = 0
+        if (firstActiveSession) {
+            lastOrientation = startOrientation // Initialize last orientation to start orientation
+        }
 
         // Capture system state at session start
         startInternetState = isInternetConnected()
@@ -155,7 +305,7 @@ class BehaviorSDK(private val context: Context, private val config: BehaviorConf
                     0L
                 }
 
-        sessionData[sessionId] =
+        val data =
                 SessionData(
                         sessionId = sessionId,
                         startTime = now,
@@ -164,14 +314,25 @@ class BehaviorSDK(private val context: Context, private val config: BehaviorConf
                         startOrientation = startOrientation,
                         startInternetState = startInternetState,
                         startDoNotDisturb = startDoNotDisturb,
-                        startCharging = startCharging
+                        startCharging = startCharging,
+                        appSwitchBaseline = appSwitchBaseline
                 )
+        sessionData[sessionId] = data
+        activeSessionIds.add(sessionId)
+        checkpointer?.begin(data)
 
         lastInteractionTime = now
         // Don't update lastAppUseTime here - it will be updated when session ends
 
         // Start motion data collection if enabled
-        motionSignalCollector.startSession(now)
+        motionSignalCollector.startSession(sessionId, now)
+
+        // Start live snapshots if a cadence is configured
+        startLiveSnapshots(sessionId, now)
+
+        // Fold event counters into the speculative summary as they arrive; Flux JSON is built
+        // from the session's event log off the main thread
+        sessionPrecomputers[sessionId] = SessionPrecomputer(sessionId, now, data.events)
 
         // Register orientation change listener
         registerOrientationListener()
@@ -262,16 +423,19 @@ class BehaviorSDK(private val context: Context, private val config: BehaviorConf
         val currentOrientation = context.resources.configuration.orientation
         if (currentOrientation != lastOrientation &&
                         currentOrientation != Configuration.ORIENTATION_UNDEFINED &&
-                        currentSessionId != null
+                        activeSessionIds.isNotEmpty()
         ) {
-            orientationChangeCount++
             lastOrientation = currentOrientation
-            sessionData[currentSessionId]?.let { data ->
-                data.orientationChangeCount = orientationChangeCount
+            // Every active session observes the change
+            for (activeId in activeSessionIds) {
+                sessionData[activeId]?.let { data ->
+                    data.orientationChangeCount++
+                    checkpointer?.updateCounters(data)
+                }
             }
             android.util.Log.d(
                     "BehaviorSDK",
-                    "Orientation changed: count=$orientationChangeCount, current=$currentOrientation"
+                    "Orientation changed: current=$currentOrientation, active sessions=${activeSessionIds.size}"
             )
         }
     }
@@ -282,16 +446,19 @@ class BehaviorSDK(private val context: Context, private val config: BehaviorConf
         // This ensures we count all changes (portrait->landscape->portrait = 2 changes)
         if (currentOrientation != lastOrientation &&
                         currentOrientation != Configuration.ORIENTATION_UNDEFINED &&
-                        currentSessionId != null
+                        activeSessionIds.isNotEmpty()
         ) {
-            orientationChangeCount++
             lastOrientation = currentOrientation // Update last orientation
-            sessionData[currentSessionId]?.let { data ->
-                data.orientationChangeCount = orientationChangeCount
+            // Every active session observes the change
+            for (activeId in activeSessionIds) {
+                sessionData[activeId]?.let { data ->
+                    data.orientationChangeCount++
+                    checkpointer?.updateCounters(data)
+                }
             }
             android.util.Log.d(
                     "BehaviorSDK",
-                    "Orientation changed: count=$orientationChangeCount, current=$currentOrientation"
+                    "Orientation changed: current=$currentOrientation, active sessions=${activeSessionIds.size}"
             )
         }
     }
@@ -299,8 +466,22 @@ class BehaviorSDK(private val context: Context, private val config: BehaviorConf
     fun endSession(sessionId: String): Map<String, Any> {
         val data = sessionData[sessionId] ?: throw IllegalStateException("Session not found")
 
+        // End only this shard; other active sessions keep collecting
+        activeSessionIds.remove(sessionId)
+        if (currentSessionId == sessionId && activeSessionIds.isNotEmpty()) {
+            currentSessionId = activeSessionIds.last()
+        }
+
+        // The final summary supersedes live snapshots
+        stopLiveSnapshots(sessionId)
+
+        // Release the motion shard before anything below can fail, so its sensors and buffers
+        // never outlive the session
+        val motionData = motionSignalCollector.stopSession(sessionId)
+
         // Sync app switch count from AttentionSignalCollector before ending session
-        val currentAppSwitchCount = attentionSignalCollector.getAppSwitchCount()
+        val currentAppSwitchCount =
+                attentionSignalCollector.getAppSwitchCount() - data.appSwitchBaseline
         if (currentAppSwitchCount > data.appSwitchCount) {
             data.appSwitchCount = currentAppSwitchCount
         }
@@ -347,11 +528,22 @@ class BehaviorSDK(private val context: Context, private val config: BehaviorConf
         val endDoNotDisturb = isDoNotDisturbEnabled()
         val endCharging = isCharging()
 
+        // Counters and Flux metrics: reuse the speculative summary when it is current,
+        // otherwise serialize the events logged since the last pass and rerun Flux
+        val precomputer = sessionPrecomputers.remove(sessionId)
+        val precomputed =
+                precomputer?.let {
+                    energyMeter.measure(EnergyMeter.Stage.FLUX) { it.finish(data.endTime) }
+                }
+
         // Compute notification summary from events
-        val notificationEvents = data.events.filter { it.eventType == "notification" }
+        val notificationEvents =
+                precomputed?.notificationEvents
+                        ?: data.events.ofType("notification")
         val notificationCount = notificationEvents.size
-        val notificationIgnored = notificationEvents.count { it.metrics["action"] == "ignored" }
-        val notificationOpened = notificationEvents.count { it.metrics["action"] == "opened" }
+        val notificationIgnored =
+                precomputed?.notificationIgnored
+                        ?: notificationEvents.count { it.metrics["action"] == "ignored" }
         val notificationIgnoreRate =
                 if (notificationCount > 0) {
                     notificationIgnored.toDouble() / notificationCount
@@ -361,21 +553,59 @@ class BehaviorSDK(private val context: Context, private val config: BehaviorConf
         val notificationClusteringIndex = computeNotificationClusteringIndex(notificationEvents)
 
         // Compute call summary
-        val callEvents = data.events.filter { it.eventType == "call" }
-        val callCount = callEvents.size
-        val callIgnored = callEvents.count { it.metrics["action"] == "ignored" }
+        val callEvents =
+                if (precomputed == null) data.events.ofType("call")
+                else emptyList()
+        val callCount = precomputed?.callCount ?: callEvents.size
+        val callIgnored =
+                precomputed?.callIgnored ?: callEvents.count { it.metrics["action"] == "ignored" }
 
         // Compute clipboard summary (counts only; correction_rate and clipboard_activity_rate come from Flux)
-        val clipboardEvents = data.events.filter { it.eventType == "clipboard" }
-        val clipboardCount = clipboardEvents.size
-        val clipboardCopyCount = clipboardEvents.count { it.metrics["action"] == "copy" }
-        val clipboardPasteCount = clipboardEvents.count { it.metrics["action"] == "paste" }
-        val clipboardCutCount = clipboardEvents.count { it.metrics["action"] == "cut" }
+        val clipboardEvents =
+                if (precomputed == null) data.events.ofType("clipboard")
+                else emptyList()
+        val clipboardCount = precomputed?.clipboardCount ?: clipboardEvents.size
+        val clipboardCopyCount =
+                precomputed?.clipboardCopyCount
+                        ?: clipboardEvents.count { it.metrics["action"] == "copy" }
+        val clipboardPasteCount =
+                precomputed?.clipboardPasteCount
+                        ?: clipboardEvents.count { it.metrics["action"] == "paste" }
+        val clipboardCutCount =
+                precomputed?.clipboardCutCount
+                        ?: clipboardEvents.count { it.metrics["action"] == "cut" }
 
         // Compute behavioral metrics from events
         // Use only Flux (Rust) calculations - native Kotlin calculations commented out
         val (calculationMetrics, fluxMetrics, performanceInfo) =
-                computeBehavioralMetricsWithFlux(data, duration, notificationCount, callCount)
+                if (precomputed != null) {
+                    performanceMonitor.recordSpeculation(
+                            precomputed.speculativeHit,
+                            precomputed.savedMs,
+                            precomputed.missReason
+                    )
+                    val info = mutableMapOf<String, Any>()
+                    if (precomputed.fluxMetrics != null) {
+                        info["flux_execution_time_ms"] = precomputed.fluxTimeMs
+                    }
+                    info["speculative_summary_hit"] = precomputed.speculativeHit
+                    info["speculative_saved_ms"] = precomputed.savedMs
+                    // Flux metrics are normalized by the duration up to this end time
+                    info["flux_scored_end_at"] =
+                            Instant.ofEpochMilli(precomputed.scoredEndTimeMs).toString()
+                    precomputed.missReason?.let { info["speculative_miss_reason"] = it }
+                    info["speculation"] = performanceMonitor.getSpeculationStats().toMap()
+                    Triple(mapOf<String, Any>(), precomputed.fluxMetrics, info)
+                } else {
+                    energyMeter.measure(EnergyMeter.Stage.FLUX) {
+                        computeBehavioralMetricsWithFlux(
+                                data,
+                                duration,
+                                notificationCount,
+                                callCount
+                        )
+                    }
+                }
 
         // Require Flux metrics - fail if not available
         if (fluxMetrics == null) {
@@ -387,8 +617,22 @@ class BehaviorSDK(private val context: Context, private val config: BehaviorConf
         // instead
         // val typingSessionSummary = computeTypingSessionSummary(data, duration)
 
-        // Collect motion data if enabled
-        val motionData = motionSignalCollector.stopSession()
+        var sessionPerformanceInfo: Map<String, Any> = performanceInfo
+        if (motionData.isNotEmpty()) {
+            sessionPerformanceInfo +=
+                    ("motion_pipeline" to motionSignalCollector.getPipelineStats())
+        }
+        checkpointer?.let { sessionPerformanceInfo += ("checkpoint" to it.getStats()) }
+        sessionPerformanceInfo += ("executor" to BehaviorExecutor.getStats())
+        sessionPerformanceInfo += ("event_latency" to latencyTracer.getStats())
+        sessionPerformanceInfo += ("energy" to getEnergyReport())
+        sessionPerformanceInfo +=
+                ("view_attachment" to
+                        mapOf(
+                                "input" to inputSignalCollector.getAttachStats(),
+                                "gesture" to gestureCollector.getAttachStats()
+                        ))
+        workloadRun?.let { sessionPerformanceInfo += ("synthetic_workload" to it.getStats()) }
 
         // Build comprehensive summary
         val summaryBase =
@@ -414,7 +658,7 @@ class BehaviorSDK(private val context: Context, private val config: BehaviorConf
                                 ),
                         "behavioral_metrics" to fluxMetrics!!, // Use Flux (Rust) results as primary
                         // "behavioral_metrics_flux" removed - Flux is now the primary source
-                        "performance_info" to performanceInfo,
+                        "performance_info" to sessionPerformanceInfo,
                         "notification_summary" to
                                 mapOf(
                                         "notification_count" to notificationCount,
@@ -482,16 +726,28 @@ class BehaviorSDK(private val context: Context, private val config: BehaviorConf
 
         // Add motion data if available
         if (motionData.isNotEmpty()) {
-            val motionDataJson =
-                    motionData.map { dataPoint ->
-                        mapOf("timestamp" to dataPoint.timestamp, "features" to dataPoint.features)
-                    }
+            val motionDataJson = motionData.map { dataPoint -> dataPoint.toMap() }
             summary = summary + mapOf("motion_data" to motionDataJson)
 
             // Store motion data for on-demand queries (will be cleared when next session starts)
             sessionMotionData[sessionId] = motionData
         }
 
+        rollupStore?.record(
+                endTimeMs = data.endTime,
+                durationMs = duration,
+                eventCount = data.eventCount,
+                appSwitchCount = data.appSwitchCount,
+                notificationCount = notificationCount,
+                callCount = callCount,
+                clipboardCount = clipboardCount,
+                behavioralMetrics = fluxMetrics
+        )
+
+        // The summary is built: nothing left to restore. A session whose summary failed keeps its
+        // checkpoint and is restored at the next initialize
+        checkpointer?.end(sessionId)
+
         // Don't remove sessionData here - it will be cleared when the next session starts
         // This allows calculateMetricsForTimeRange to access data for ended sessions
         return summary
@@ -569,7 +825,7 @@ class BehaviorSDK(private val context: Context, private val config: BehaviorConf
                     timezone = java.util.TimeZone.getDefault().id,
                     startTimeMs = data.startTime,
                     endTimeMs = data.endTime,
-                    events = data.events
+                    events = data.events.snapshot()
                 )
 
                 android.util.Log.d(
@@ -646,21 +902,37 @@ class BehaviorSDK(private val context: Context, private val config: BehaviorConf
         return statsCollector.getCurrentStats()
     }
 
-    fun calculateMetricsForTimeRange(
-            startTimestampMs: Long,
-            endTimestampMs: Long,
-            sessionId: String?
-    ): Map<String, Any?> {
-        // Determine which session to use
+    /** Per-hop event latency histograms and budget violations since initialize. */
+    fun getLatencyStats(): Map<String, Any> = latencyTracer.getStats()
+
+    /** Estimated battery cost per pipeline stage (see [EnergyMeter]). */
+    fun getEnergyReport(): Map<String, Any> =
+            energyMeter.getReport(motionSignalCollector.activeCollectionMs())
+
+    /**
+     * The session a query reads (the current session when [sessionId] is null), copied so the
+     * query can run off the main thread while sessions keep changing on it. Call on the main
+     * thread. Its event store is shared, as it is safe to read concurrently with ingestion.
+     */
+    fun querySession(sessionId: String?): QuerySession {
         val sessionIdToUse =
                 sessionId
                         ?: currentSessionId
                                 ?: throw IllegalStateException(
                                 "No active session and no sessionId provided"
                         )
+        return QuerySession(sessionIdToUse, sessionData[sessionIdToUse]?.copy())
+    }
+
+    fun calculateMetricsForTimeRange(
+            startTimestampMs: Long,
+            endTimestampMs: Long,
+            session: QuerySession
+    ): Map<String, Any?> {
+        val sessionIdToUse = session.sessionId
 
         // Get session data (may be null if session has ended)
-        val sessionDataEntry = sessionData[sessionIdToUse]
+        val sessionDataEntry = session.data
 
         // Validate time range is within session duration (with 1 second tolerance)
         if (sessionDataEntry != null) {
@@ -680,22 +952,16 @@ class BehaviorSDK(private val context: Context, private val config: BehaviorConf
             }
         }
 
-        // Filter events by time range
+        // Filter events by time range (binary search over the session's timestamp index;
+        // events with invalid timestamps are skipped)
         val filteredEvents =
                 if (sessionDataEntry != null) {
                     // Session is still active - get events from session data
-                    sessionDataEntry.events.filter { event ->
-                        try {
-                            val eventTime = Instant.parse(event.timestamp).toEpochMilli()
-                            eventTime >= startTimestampMs && eventTime <= endTimestampMs
-                        } catch (e: Exception) {
-                            false // Skip invalid timestamps
-                        }
-                    }
+                    sessionDataEntry.events.inRange(startTimestampMs, endTimestampMs)
                 } else {
                     // Session has ended - events should be retrieved from EventDatabase
                     // For now, return empty list (EventDatabase integration can be added later)
-                    emptyList()
+                    SessionEventLog()
                 }
 
         // Calculate duration
@@ -709,12 +975,12 @@ class BehaviorSDK(private val context: Context, private val config: BehaviorConf
                         startTime = startTimestampMs,
                         endTime = endTimestampMs,
                         eventCount = filteredEvents.size,
-                        appSwitchCount = filteredEvents.count { it.eventType == "app_switch" },
-                        events = filteredEvents.toMutableList()
+                        appSwitchCount = filteredEvents.countOfType("app_switch"),
+                        events = filteredEvents
                 )
 
         // Compute notification summary
-        val notificationEvents = filteredEvents.filter { it.eventType == "notification" }
+        val notificationEvents = filteredEvents.ofType("notification")
         val notificationCount = notificationEvents.size
         val notificationIgnored = notificationEvents.count { it.metrics["action"] == "ignored" }
         val notificationIgnoreRate =
@@ -724,12 +990,12 @@ class BehaviorSDK(private val context: Context, private val config: BehaviorConf
         val notificationClusteringIndex = computeNotificationClusteringIndex(notificationEvents)
 
         // Compute call summary
-        val callEvents = filteredEvents.filter { it.eventType == "call" }
+        val callEvents = filteredEvents.ofType("call")
         val callCount = callEvents.size
         val callIgnored = callEvents.count { it.metrics["action"] == "ignored" }
 
         // Compute clipboard summary (counts only; correction_rate and clipboard_activity_rate come from Flux)
-        val clipboardEvents = filteredEvents.filter { it.eventType == "clipboard" }
+        val clipboardEvents = filteredEvents.ofType("clipboard")
         val clipboardCount = clipboardEvents.size
         val clipboardCopyCount = clipboardEvents.count { it.metrics["action"] == "copy" }
         val clipboardPasteCount = clipboardEvents.count { it.metrics["action"] == "paste" }
@@ -737,7 +1003,14 @@ class BehaviorSDK(private val context: Context, private val config: BehaviorConf
 
         // Compute behavioral metrics using Flux (Rust) - same as endSession()
         val (_, fluxMetrics, _) =
-                computeBehavioralMetricsWithFlux(tempData, duration, notificationCount, callCount)
+                energyMeter.measure(EnergyMeter.Stage.FLUX) {
+                    computeBehavioralMetricsWithFlux(
+                            tempData,
+                            duration,
+                            notificationCount,
+                            callCount
+                    )
+                }
 
         // Require Flux metrics - fail if not available
         if (fluxMetrics == null) {
@@ -797,7 +1070,7 @@ class BehaviorSDK(private val context: Context, private val config: BehaviorConf
         // Convert motion data to map format
         val motionDataList: List<Map<String, Any>> =
                 allMotionData.map { dataPoint: MotionSignalCollector.MotionDataPoint ->
-                    mapOf("timestamp" to dataPoint.timestamp, "features" to dataPoint.features)
+                    dataPoint.toMap()
                 }
 
         // Get current device context and system state
@@ -851,6 +1124,34 @@ class BehaviorSDK(private val context: Context, private val config: BehaviorConf
         )
     }
 
+    /**
+     * Run an aggregate [EventQuery] over a session's event store (see [querySession]). Only
+     * sessions whose data is still held are queryable.
+     */
+    fun queryEvents(query: EventQuery, session: QuerySession): List<Map<String, Any?>> {
+        val sessionDataEntry =
+                session.data
+                        ?: throw IllegalArgumentException("Session not found: ${session.sessionId}")
+        return sessionDataEntry.events.aggregate(query)
+    }
+
+    /**
+     * Cross-session trend buckets from the rollup store, oldest first. Requires
+     * [BehaviorConfig.rollupRetentionDays] > 0.
+     */
+    fun getTrends(
+            granularity: RollupStore.Granularity,
+            startMs: Long,
+            endMs: Long
+    ): List<Map<String, Any>> {
+        val store =
+                rollupStore
+                        ?: throw IllegalStateException(
+                                "Rollups are disabled. Set rollupRetentionDays in BehaviorConfig."
+                        )
+        return store.trend(granularity, startMs, endMs)
+    }
+
     fun updateConfig(newConfig: BehaviorConfig) {
         inputSignalCollector.updateConfig(newConfig)
         attentionSignalCollector.updateConfig(newConfig)
@@ -874,14 +1175,211 @@ class BehaviorSDK(private val context: Context, private val config: BehaviorConf
         }
     }
 
+    /**
+     * Attach to an activity window: typing follows input focus in its view tree and a window-level
+     * touch hook reports interaction timing, plus gestures with
+     * [BehaviorConfig.nativeGestureEvents]. Neither walks the hierarchy, so the cost does not grow
+     * with the number of views, and views added later are covered. Replaces [attachToView].
+     */
+    fun attachToWindow(window: Window) {
+        if (!config.enableInputSignals) {
+            android.util.Log.d("BehaviorSDK", "Input signals disabled, not attaching collectors")
+            return
+        }
+        inputSignalCollector.attachToView(window.decorView)
+        gestureCollector.attachToWindow(window)
+    }
+
+    /** Detach from the window passed to [attachToWindow], e.g. when the activity goes away. */
+    fun detachFromWindow() {
+        inputSignalCollector.detach()
+        gestureCollector.detachFromWindow()
+    }
+
+    /**
+     * Drive the pipeline with generated input at [speed]× real time (1–1000) until [durationMs]
+     * of virtual time have been emitted. Events take the collector path on the main thread and
+     * are stamped when delivered; motion samples reach the motion collector while it collects.
+     * Replaces a workload that is already running.
+     */
+    @Synchronized
+    fun startSyntheticWorkload(
+            workload: WorkloadGenerator.Workload,
+            speed: Double,
+            durationMs: Long
+    ) {
+        startRun(workload, speed, durationMs, onTick = null)
+    }
+
+    /**
+     * Stop the synthetic workload and return what it generated, with the soak report when it was
+     * a soak test; empty when none ran.
+     */
+    @Synchronized
+    fun stopSyntheticWorkload(): Map<String, Any> {
+        val run = workloadRun ?: return emptyMap()
+        workloadRun = null
+        run.stop()
+        if (soakSessionId != null) handler.post { endSoakSession() }
+        val soak = soakMonitor ?: return run.getStats()
+        return run.getStats() + ("soak" to soak.getReport())
+    }
+
+    /**
+     * Soak test: run [workload] as [startSyntheticWorkload] does (e.g. 72 virtual hours at 1000×)
+     * while a [SoakMonitor] samples memory, retained structures, executor queue depths and
+     * per-hop latency every [sampleIntervalMs] of virtual time. With [sessionLengthMs] > 0 the
+     * events go to a session that is ended and replaced at that virtual interval, so retention
+     * across sessions is exercised; without it, the one session's events grow by design. Poll
+     * [getSoakReport] and stop with [stopSyntheticWorkload].
+     */
+    @Synchronized
+    fun startSoakTest(
+            workload: WorkloadGenerator.Workload,
+            speed: Double,
+            durationMs: Long,
+            sampleIntervalMs: Long,
+            sessionLengthMs: Long,
+            thresholds: SoakMonitor.Thresholds = SoakMonitor.Thresholds()
+    ) {
+        require(sampleIntervalMs > 0) { "Sample interval must be positive" }
+        val monitor =
+                SoakMonitor(
+                        soakGauges(),
+                        EventLatencyTracer.Hop.values().associate {
+                            it.key to latencyTracer.histogram(it)
+                        },
+                        thresholds
+                )
+        var nextSampleMs = 0L
+        var nextRotationMs = sessionLengthMs
+        startRun(workload, speed, durationMs) { virtualMs ->
+            if (sessionLengthMs > 0 && virtualMs >= nextRotationMs) {
+                while (nextRotationMs <= virtualMs) nextRotationMs += sessionLengthMs
+                handler.post { rotateSoakSession() }
+            }
+            // Always sample the end of the run
+            if (virtualMs >= nextSampleMs || virtualMs >= durationMs) {
+                monitor.sample(virtualMs)
+                while (nextSampleMs <= virtualMs) nextSampleMs += sampleIntervalMs
+            }
+        }
+        soakMonitor = monitor
+        soakSessionCount = 0
+        soakSessionErrors = 0
+        if (sessionLengthMs > 0) handler.post { rotateSoakSession() }
+    }
+
+    /** Verdict of the current or last soak test so far; empty when none ran. */
+    fun getSoakReport(): Map<String, Any> {
+        val monitor = soakMonitor ?: return emptyMap()
+        return monitor.getReport() +
+                mapOf(
+                        "sessions" to soakSessionCount,
+                        "session_errors" to soakSessionErrors,
+                        "workload" to (workloadRun?.getStats() ?: emptyMap<String, Any>())
+                )
+    }
+
+    private fun startRun(
+            workload: WorkloadGenerator.Workload,
+            speed: Double,
+            durationMs: Long,
+            onTick: ((Long) -> Unit)?
+    ) {
+        stopSyntheticWorkload()
+        soakMonitor = null
+        val run =
+                WorkloadGenerator.Run(
+                        WorkloadGenerator(workload),
+                        speed,
+                        durationMs,
+                        SyntheticSink(),
+                        onTick
+                )
+        workloadRun = run
+        run.start()
+    }
+
+    /** Gauges a soak test samples. They run on the workload's queue and only read. */
+    private fun soakGauges(): Map<String, () -> Long> {
+        val gauges = LinkedHashMap<String, () -> Long>()
+        gauges["rss_bytes"] = ::residentBytes
+        gauges["java_heap_bytes"] = {
+            Runtime.getRuntime().let { it.totalMemory() - it.freeMemory() }
+        }
+        gauges["native_heap_bytes"] = { Debug.getNativeHeapAllocatedSize() }
+        gauges["sessions_retained"] = { sessionData.size.toLong() }
+        gauges["session_events"] = { sessionData.values.sumOf { it.events.size.toLong() } }
+        gauges["session_motion_windows"] = {
+            sessionMotionData.values.sumOf { it.size.toLong() }
+        }
+        gauges["stats_events"] = { statsCollector.retainedEventCount().toLong() }
+        for (key in motionSignalCollector.getRetainedCounts().keys) {
+            gauges[key] = { motionSignalCollector.getRetainedCounts().getValue(key) }
+        }
+        for (key in notificationCollector.getTrackedCounts().keys) {
+            gauges[key] = { notificationCollector.getTrackedCounts().getValue(key) }
+        }
+        for (qos in BehaviorExecutor.QoS.values()) {
+            gauges["queue_${qos.key}"] = {
+                BehaviorExecutor.queueDepths().getValue(qos.key).toLong()
+            }
+        }
+        return gauges
+    }
+
+    /** Resident set size from /proc, 0 when unreadable. */
+    private fun residentBytes(): Long =
+            try {
+                val pages = File("/proc/self/statm").readText().trim().split(' ')[1].toLong()
+                pages * Os.sysconf(OsConstants._SC_PAGESIZE)
+            } catch (e: Exception) {
+                0L
+            }
+
+    /** End the soak session, if any, and start the next one. Main thread. */
+    private fun rotateSoakSession() {
+        if (workloadRun == null) return // Stopped since this was posted
+        endSoakSession()
+        val sessionId = "soak_${++soakSessionCount}"
+        startSession(sessionId)
+        soakSessionId = sessionId
+    }
+
+    private fun endSoakSession() {
+        val sessionId = soakSessionId ?: return
+        soakSessionId = null
+        try {
+            endSession(sessionId)
+        } catch (e: Exception) {
+            soakSessionErrors++
+            checkpointer?.end(sessionId) // Synthetic sessions are not worth restoring
+            android.util.Log.w("BehaviorSDK", "Soak session $sessionId failed to end: ${e.message}")
+        }
+    }
+
+    /** Human-readable performance report, including speculative summary hit rate. */
+    fun getPerformanceReport(): String {
+        performanceMonitor.recordSnapshot()
+        return performanceMonitor.printReport()
+    }
+
     fun dispose() {
         handler.removeCallbacks(idleCheckRunnable)
+        for (sessionId in liveSnapshotScorers.keys) {
+            stopLiveSnapshots(sessionId)
+        }
+        sessionPrecomputers.clear()
+        stopSyntheticWorkload()
+        endSoakSession()
         inputSignalCollector.dispose()
         attentionSignalCollector.dispose()
         gestureCollector.dispose()
         notificationCollector.dispose()
         callCollector.dispose()
         SynheartNotificationListenerService.setNotificationCollector(null)
+        checkpointer?.close()
         ProcessLifecycleOwner.get().lifecycle.removeObserver(this)
     }
 
@@ -891,14 +1389,15 @@ class BehaviorSDK(private val context: Context, private val config: BehaviorConf
         attentionSignalCollector.onAppForegrounded()
         lastAppUseTime = System.currentTimeMillis()
 
-        // Sync app switch count from AttentionSignalCollector to session data
-        currentSessionId?.let { sessionId ->
+        // Sync app switch count from AttentionSignalCollector to each active session
+        val appSwitchCount = attentionSignalCollector.getAppSwitchCount()
+        for (sessionId in activeSessionIds) {
             sessionData[sessionId]?.let { data ->
-                val currentAppSwitchCount = attentionSignalCollector.getAppSwitchCount()
+                val currentAppSwitchCount = appSwitchCount - data.appSwitchBaseline
                 // Only update if the count has increased (to avoid resetting on first launch)
                 if (currentAppSwitchCount > data.appSwitchCount) {
                     data.appSwitchCount = currentAppSwitchCount
-                    sessionData[sessionId] = data
+                    checkpointer?.updateCounters(data)
                 }
             }
         }
@@ -909,6 +1408,12 @@ class BehaviorSDK(private val context: Context, private val config: BehaviorConf
         appInForeground = false
         attentionSignalCollector.onAppBackgrounded()
         // App switches are tracked via attention signal collector
+
+        // Sessions usually end shortly after the app backgrounds
+        schedulePrecompute()
+
+        // Backgrounded processes are the ones Android kills: compact the checkpoints now
+        checkpointer?.compact()
     }
 
     fun onUserInteraction() {
@@ -921,28 +1426,114 @@ class BehaviorSDK(private val context: Context, private val config: BehaviorConf
 
         // Idle is now computed from gaps between events in the feature extractor
         // No need to emit separate idle events
+
+        // Precompute session summaries once per idle period
+        if (idleSeconds >= config.maxIdleGapSeconds &&
+                        idlePrecomputeInteractionTime != lastInteractionTime
+        ) {
+            idlePrecomputeInteractionTime = lastInteractionTime
+            schedulePrecompute()
+        }
     }
 
-    // Public method to receive events from Flutter (Dart side)
+    /** Run speculative summaries for the active sessions at background QoS. */
+    private fun schedulePrecompute() {
+        if (sessionPrecomputers.isEmpty()) return
+        precomputeQueue.execute {
+            val now = System.currentTimeMillis()
+            energyMeter.measure(EnergyMeter.Stage.FLUX) {
+                for (precomputer in sessionPrecomputers.values) {
+                    precomputer.precompute(now)
+                }
+            }
+        }
+    }
+
+    /**
+     * Receive an event from Flutter (Dart side). It takes the same traced path as native
+     * collector events; its capture time is Dart's, so the collector hop covers the channel.
+     */
     fun receiveEventFromFlutter(event: BehaviorEvent) {
+        ingest(event)
+    }
+
+    /** Hands each generator tick's events to the main thread in one post, as collectors run. */
+    private inner class SyntheticSink : WorkloadGenerator.Sink {
+        private var batch = ArrayList<BehaviorEvent>()
+        private var nextId = 0L
+
+        override fun onEvent(eventType: String, metrics: Map<String, Any>) {
+            batch.add(
+                    BehaviorEvent(
+                            eventId = "evt_syn_${nextId++}",
+                            sessionId = "current",
+                            timestamp = Instant.now().toString(),
+                            eventType = eventType,
+                            metrics = metrics
+                    )
+            )
+        }
+
+        override fun onMotionSample(sensorType: Int, values: FloatArray) {
+            motionSignalCollector.injectSample(sensorType, values)
+        }
+
+        override fun flush() {
+            if (batch.isEmpty()) return
+            val events = batch
+            batch = ArrayList()
+            handler.post { events.forEach(::ingest) }
+        }
+    }
+
+    /** Process one collected event, timing each hop against the event budget. */
+    private fun ingest(event: BehaviorEvent) {
+        latencyTracer.record(
+                EventLatencyTracer.Hop.COLLECTOR,
+                System.nanoTime() - event.captureNanos
+        )
         emitEvent(event)
+        val statsStart = System.nanoTime()
+        val statsCpu = energyMeter.threadCpuNanos()
+        statsCollector.recordEvent(event)
+        energyMeter.charge(EnergyMeter.Stage.EVENT_INGEST, statsCpu)
+        val end = System.nanoTime()
+        latencyTracer.record(EventLatencyTracer.Hop.STATS, end - statsStart)
+        latencyTracer.recordTotal(event.captureNanos, end)
     }
 
     private fun emitEvent(event: BehaviorEvent) {
-        // Replace "current" session ID with actual session ID
+        // Dart sees "current" resolved to the newest active session
+        val current = currentSessionId
         val eventWithSessionId =
-                if (event.sessionId == "current" && currentSessionId != null) {
-                    BehaviorEvent(
-                            eventId = event.eventId,
-                            sessionId = currentSessionId!!,
-                            timestamp = event.timestamp,
-                            eventType = event.eventType,
-                            metrics = event.metrics
-                    )
+                if (event.sessionId == "current" && current != null) {
+                    event.copy(sessionId = current)
                 } else {
                     event
                 }
 
+        // Store before posting, so a Dart listener that queries the session from onEvent
+        // already finds the event it was handed.
+        val storeStart = System.nanoTime()
+        var cpu = energyMeter.threadCpuNanos()
+
+        // Fan the event out to every active session shard, labelled with the shard's own
+        // session ID. Relabelled copies share the metrics map, so an overlapping session costs
+        // one small object and one list append, not a payload copy.
+        for (sessionId in activeSessionIds) {
+            val sessionDataEntry = sessionData[sessionId] ?: continue
+            val shardEvent =
+                    if (eventWithSessionId.sessionId == sessionId) eventWithSessionId
+                    else event.copy(sessionId = sessionId)
+            appendToSession(sessionDataEntry, shardEvent)
+            checkpointer?.append(sessionId, shardEvent)
+            liveSnapshotScorers[sessionId]?.append(shardEvent)
+            sessionPrecomputers[sessionId]?.append(shardEvent)
+        }
+        val channelStart = System.nanoTime()
+        latencyTracer.record(EventLatencyTracer.Hop.SESSION_STORE, channelStart - storeStart)
+        cpu = energyMeter.charge(EnergyMeter.Stage.EVENT_INGEST, cpu)
+
         if (eventHandler != null) {
             try {
                 eventHandler?.invoke(eventWithSessionId)
@@ -950,18 +1541,17 @@ class BehaviorSDK(private val context: Context, private val config: BehaviorConf
                 android.util.Log.e("BehaviorSDK", "ERROR calling eventHandler: ${e.message}", e)
             }
         }
+        latencyTracer.record(
+                EventLatencyTracer.Hop.CHANNEL,
+                System.nanoTime() - channelStart
+        )
+        energyMeter.charge(EnergyMeter.Stage.EVENT_DELIVERY, cpu)
+    }
 
-        if (currentSessionId == null) {
-            return // Early return if no session
-        }
-        val sessionId = currentSessionId!!
-        val sessionDataEntry = sessionData[sessionId]
-        if (sessionDataEntry == null) {
-            return // Early return if session data not found
-        }
+    private fun appendToSession(sessionDataEntry: SessionData, eventWithSessionId: BehaviorEvent) {
         // Store the event
         sessionDataEntry.eventCount++
-        sessionDataEntry.events.add(eventWithSessionId) // Store event for session metrics
+        sessionDataEntry.events.append(eventWithSessionId) // Store event for session metrics
 
         // Update session-specific metrics based on new event types
         when (eventWithSessionId.eventType) {
@@ -982,6 +1572,40 @@ class BehaviorSDK(private val context: Context, private val config: BehaviorConf
         }
     }
 
+    private fun startLiveSnapshots(sessionId: String, startTime: Long) {
+        if (config.liveSnapshotIntervalSeconds <= 0) return
+
+        val wasIdle = liveSnapshotScorers.isEmpty()
+        liveSnapshotScorers[sessionId] = LiveSnapshotScorer(sessionId, startTime)
+        if (wasIdle) {
+            liveSnapshotFuture =
+                    snapshotQueue.schedule(
+                            config.liveSnapshotIntervalSeconds * 1000L,
+                            liveSnapshotRunnable
+                    )
+        }
+    }
+
+    private fun stopLiveSnapshots(sessionId: String) {
+        liveSnapshotScorers.remove(sessionId)
+        if (liveSnapshotScorers.isEmpty()) {
+            liveSnapshotFuture?.cancel(false)
+        }
+    }
+
+    private fun emitLiveSnapshot() {
+        val now = System.currentTimeMillis()
+        for (scorer in liveSnapshotScorers.values) {
+            val snapshot =
+                    energyMeter.measure(EnergyMeter.Stage.FLUX) { scorer.snapshot(now) } ?: continue
+            try {
+                snapshotHandler?.invoke(snapshot)
+            } catch (e: Exception) {
+                android.util.Log.e("BehaviorSDK", "ERROR calling snapshotHandler: ${e.message}", e)
+            }
+        }
+    }
+
     private fun calculateStabilityIndex(data: SessionData): Double {
         // Stability = 1 - (switches / (duration_in_minutes * 10))
         val durationMinutes = (data.endTime - data.startTime) / 60000.0
@@ -1005,7 +1629,15 @@ data class BehaviorConfig(
         val enableMotionLite: Boolean = false,
         val sessionIdPrefix: String? = null,
         val eventBatchSize: Int = 10,
-        val maxIdleGapSeconds: Double = 10.0
+        val maxIdleGapSeconds: Double = 10.0,
+        val liveSnapshotIntervalSeconds: Int = 0, // 0 disables live snapshots
+        val useFusedMotionSensors: Boolean = false,
+        val motionCascadeThreshold: Double = 0.0, // 0 disables the stage 1 early exit
+        val rollupRetentionDays: Int = 0, // 0 disables cross-session rollups
+        val enableSessionCheckpoints: Boolean = false,
+        val encryptSessionCheckpoints: Boolean = false, // Needs a CheckpointKeyProvider key
+        val powerTable: PowerTable = PowerTable(), // For the per-stage energy estimates
+        val nativeGestureEvents: Boolean = false // Window hook emits taps/scrolls/swipes itself
 )
 
 data class BehaviorEvent(
@@ -1013,7 +1645,8 @@ data class BehaviorEvent(
         val sessionId: String,
         val timestamp: String, // ISO 8601 format
         val eventType: String, // scroll, tap, swipe, notification, call, typing
-        val metrics: Map<String, Any>
+        val metrics: Map<String, Any>,
+        val captureNanos: Long = System.nanoTime() // Monotonic time the collector created it
 ) {
     fun toMap(): Map<String, Any> =
             mapOf(
@@ -1058,9 +1691,13 @@ data class SessionData(
         val startInternetState: Boolean = false,
         val startDoNotDisturb: Boolean = false,
         val startCharging: Boolean = false,
-        val events: MutableList<BehaviorEvent> = mutableListOf() // Store events for session metrics
+        val appSwitchBaseline: Int = 0, // App switch counter value when the session started
+        val events: SessionEventLog = SessionEventLog() // Store events for session metrics
 )
 
+/** A session resolved for a query; [data] is null once the session's data is no longer held. */
+data class QuerySession(val sessionId: String, val data: SessionData?)
+
 data class SessionSummary(
         val sessionId: String,
         val startTimestamp: Long,
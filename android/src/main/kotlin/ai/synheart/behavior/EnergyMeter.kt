@@ -0,0 +1,200 @@
+package ai.synheart.behavior
+
+import android.os.Debug
+import android.os.Looper
+import java.util.concurrent.atomic.AtomicLong
+import java.util.concurrent.atomic.AtomicLongArray
+
+/**
+ * Active power per CPU core cluster, sensor power and battery voltage used to turn CPU time into
+ * charge. Defaults are typical for a mid-range big.LITTLE phone; calibrate per device from its
+ * `power_profile.xml` for real estimates.
+ */
+data class PowerTable(
+        val littleClusterMw: Double = 120.0,
+        val midClusterMw: Double = 400.0,
+        val bigClusterMw: Double = 1000.0,
+        val sensorMw: Double = 0.8, // Accelerometer plus gyroscope while motion is collected
+        val batteryVoltage: Double = 3.85
+) {
+    enum class Cluster(val key: String) {
+        LITTLE("little"),
+        MID("mid"),
+        BIG("big")
+    }
+
+    fun milliwatts(cluster: Cluster): Double =
+            when (cluster) {
+                Cluster.LITTLE -> littleClusterMw
+                Cluster.MID -> midClusterMw
+                Cluster.BIG -> bigClusterMw
+            }
+
+    /** Charge (mAh) drawn by [nanos] of work at [milliwatts]. */
+    fun milliampHours(nanos: Long, milliwatts: Double): Double =
+            nanos / 1e9 * milliwatts / batteryVoltage / 3600.0
+
+    companion object {
+        /** Parse the map sent by the Dart `PowerTable.toJson()`. Missing keys keep defaults. */
+        fun fromMap(map: Map<*, *>?): PowerTable {
+            val defaults = PowerTable()
+            if (map == null) return defaults
+            fun value(key: String, default: Double) = (map[key] as? Number)?.toDouble() ?: default
+            return PowerTable(
+                    littleClusterMw = value("littleClusterMw", defaults.littleClusterMw),
+                    midClusterMw = value("midClusterMw", defaults.midClusterMw),
+                    bigClusterMw = value("bigClusterMw", defaults.bigClusterMw),
+                    sensorMw = value("sensorMw", defaults.sensorMw),
+                    batteryVoltage = value("batteryVoltage", defaults.batteryVoltage)
+            )
+        }
+    }
+}
+
+/**
+ * Attributes the SDK's CPU time to pipeline stages and threads, and estimates the battery cost of
+ * each stage with a [PowerTable].
+ *
+ * Stages charge the calling thread's CPU time (`Debug.threadCpuTimeNanos`), not wall time, so
+ * waiting and preemption cost nothing. The thread decides the cluster: the main thread and
+ * interactive executor work are assumed to run on big cores, user-visible work on mid cores, and
+ * background work and other threads (sensor and binder callbacks) on little cores. Sensor
+ * hardware power is charged to [Stage.SENSOR_WAKEUPS] for the time motion is collected.
+ *
+ * Estimates are per hour of wall time since the meter was created.
+ */
+class EnergyMeter(private val powerTable: PowerTable) {
+
+    enum class Stage(val key: String) {
+        /** Sensor callbacks buffering motion samples, plus the sensors themselves. */
+        SENSOR_WAKEUPS("sensor_wakeups"),
+
+        /** Session store fan-out and rolling statistics for each event. */
+        EVENT_INGEST("event_ingest"),
+
+        /** Filtering, encoding and posting events to the method channel. */
+        EVENT_DELIVERY("event_delivery"),
+
+        /** Motion window feature extraction. */
+        MOTION_EXTRACTION("motion_extraction"),
+
+        /** Flux scoring: live snapshots, speculative and final session summaries. */
+        FLUX("flux"),
+
+        /** Session checkpoint writes. */
+        CHECKPOINT("checkpoint")
+    }
+
+    enum class ThreadClass(val key: String, val cluster: PowerTable.Cluster) {
+        MAIN("main", PowerTable.Cluster.BIG),
+        INTERACTIVE("interactive", PowerTable.Cluster.BIG),
+        USER_VISIBLE("user_visible", PowerTable.Cluster.MID),
+        BACKGROUND("background", PowerTable.Cluster.LITTLE),
+        OTHER("other", PowerTable.Cluster.LITTLE)
+    }
+
+    private val startedAtMs = System.currentTimeMillis()
+    private val cpuNanos = AtomicLongArray(STAGES * THREAD_CLASSES)
+    private val calls = AtomicLongArray(STAGES)
+    private val sensorActiveMs = AtomicLong()
+
+    /** CPU time of the calling thread, for [charge]. */
+    fun threadCpuNanos(): Long = Debug.threadCpuTimeNanos()
+
+    /**
+     * Charge the calling thread's CPU time since [startCpuNanos] to [stage]. Returns the current
+     * thread CPU time, so consecutive stages can be chained.
+     */
+    fun charge(stage: Stage, startCpuNanos: Long): Long {
+        val now = Debug.threadCpuTimeNanos()
+        if (startCpuNanos >= 0 && now >= startCpuNanos) {
+            val slot = stage.ordinal * THREAD_CLASSES + threadClass().ordinal
+            cpuNanos.addAndGet(slot, now - startCpuNanos)
+            calls.incrementAndGet(stage.ordinal)
+        }
+        return now
+    }
+
+    /** Run [block] and charge its CPU time to [stage]. */
+    inline fun <T> measure(stage: Stage, block: () -> T): T {
+        val start = threadCpuNanos()
+        try {
+            return block()
+        } finally {
+            charge(stage, start)
+        }
+    }
+
+    /** Add wall time during which the motion sensors were registered. */
+    fun addSensorActiveTime(ms: Long) {
+        sensorActiveMs.addAndGet(ms)
+    }
+
+    /**
+     * Per-stage CPU time and estimated mAh per hour, the dominant stage, and CPU time per thread
+     * class. [extraSensorActiveMs] covers a collection still running.
+     */
+    fun getReport(extraSensorActiveMs: Long = 0L): Map<String, Any> {
+        val hours = maxOf(System.currentTimeMillis() - startedAtMs, 1L) / 3_600_000.0
+        val sensorNanos = (sensorActiveMs.get() + extraSensorActiveMs) * 1_000_000L
+
+        val stageCharge = DoubleArray(STAGES)
+        val stageCpu = LongArray(STAGES)
+        val threadCpu = LongArray(THREAD_CLASSES)
+        for (stage in Stage.values()) {
+            for (thread in ThreadClass.values()) {
+                val nanos = cpuNanos.get(stage.ordinal * THREAD_CLASSES + thread.ordinal)
+                stageCpu[stage.ordinal] += nanos
+                threadCpu[thread.ordinal] += nanos
+                stageCharge[stage.ordinal] +=
+                        powerTable.milliampHours(nanos, powerTable.milliwatts(thread.cluster))
+            }
+        }
+        stageCharge[Stage.SENSOR_WAKEUPS.ordinal] +=
+                powerTable.milliampHours(sensorNanos, powerTable.sensorMw)
+        val total = stageCharge.sum()
+
+        val stages = LinkedHashMap<String, Any>()
+        for (stage in Stage.values()) {
+            val charge = stageCharge[stage.ordinal]
+            stages[stage.key] =
+                    mapOf(
+                            "cpu_ms" to stageCpu[stage.ordinal] / 1_000_000.0,
+                            "calls" to calls.get(stage.ordinal),
+                            "mah_per_hour" to charge / hours,
+                            "share" to if (total > 0) charge / total else 0.0
+                    )
+        }
+        val dominant = Stage.values().maxByOrNull { stageCharge[it.ordinal] }
+        return mapOf(
+                "observed_hours" to hours,
+                "sensor_active_ms" to sensorNanos / 1_000_000L,
+                "total_mah_per_hour" to total / hours,
+                "dominant_stage" to if (total > 0 && dominant != null) dominant.key else "none",
+                "stages" to stages,
+                "threads" to
+                        ThreadClass.values().associate {
+                            it.key to
+                                    mapOf(
+                                            "cpu_ms" to threadCpu[it.ordinal] / 1_000_000.0,
+                                            "cluster" to it.cluster.key
+                                    )
+                        }
+        )
+    }
+
+    private fun threadClass(): ThreadClass {
+        if (Looper.myLooper() == Looper.getMainLooper()) return ThreadClass.MAIN
+        return when (BehaviorExecutor.currentQoS()) {
+            BehaviorExecutor.QoS.INTERACTIVE -> ThreadClass.INTERACTIVE
+            BehaviorExecutor.QoS.USER_VISIBLE -> ThreadClass.USER_VISIBLE
+            BehaviorExecutor.QoS.BACKGROUND -> ThreadClass.BACKGROUND
+            null -> ThreadClass.OTHER
+        }
+    }
+
+    private companion object {
+        val STAGES = Stage.values().size
+        val THREAD_CLASSES = ThreadClass.values().size
+    }
+}
@@ -0,0 +1,73 @@
+package ai.synheart.behavior
+
+import java.util.concurrent.atomic.AtomicLong
+
+/**
+ * Per-hop latency of native event processing, checked against the per-event budget.
+ *
+ * Every [BehaviorEvent] carries the monotonic time its collector created it
+ * ([BehaviorEvent.captureNanos]); events sent from Dart carry Dart's capture time on the same
+ * clock. Each hop records its own duration, and [Hop] lists them in the order an event passes
+ * through them; [Hop.NATIVE_TOTAL] runs from capture until the event has been stored, handed to
+ * the channel and counted. An event whose native total exceeds [budgetMicros] counts as a budget
+ * violation. The Dart side adds the last hop (capture to the `onEvent` stream) from the same
+ * clock.
+ */
+class EventLatencyTracer(val budgetMicros: Long = DEFAULT_BUDGET_US) {
+
+    enum class Hop(val key: String) {
+        /** Capture until the SDK received the event from its collector or from Dart. */
+        COLLECTOR("collector"),
+
+        /** Appending to every active session (event store, checkpoint, scorers). */
+        SESSION_STORE("session_store"),
+
+        /** Filtering, encoding and posting the event to the method channel. */
+        CHANNEL("channel"),
+
+        /** Rolling statistics update. */
+        STATS("stats"),
+
+        /** Capture until every native hop finished. */
+        NATIVE_TOTAL("native_total")
+    }
+
+    private val hops = Array(Hop.values().size) { LatencyHistogram() }
+    private val budgetViolations = AtomicLong()
+
+    fun record(hop: Hop, nanos: Long) {
+        hops[hop.ordinal].record(nanos)
+    }
+
+    /** Live histogram of [hop], e.g. for interval quantiles via [LatencyHistogram.counts]. */
+    fun histogram(hop: Hop): LatencyHistogram = hops[hop.ordinal]
+
+    /** Record the native total of an event captured at [captureNanos]. */
+    fun recordTotal(captureNanos: Long, nowNanos: Long = System.nanoTime()) {
+        val nanos = nowNanos - captureNanos
+        hops[Hop.NATIVE_TOTAL.ordinal].record(nanos)
+        if (nanos > budgetMicros * 1000) budgetViolations.incrementAndGet()
+    }
+
+    fun getStats(): Map<String, Any> {
+        val events = hops[Hop.NATIVE_TOTAL.ordinal].size
+        return mapOf(
+                "budget_us" to budgetMicros,
+                "events" to events,
+                "budget_violations" to budgetViolations.get(),
+                "budget_violation_rate" to
+                        if (events > 0) budgetViolations.get().toDouble() / events else 0.0,
+                "hops" to Hop.values().associate { it.key to hops[it.ordinal].toMap() }
+        )
+    }
+
+    fun reset() {
+        hops.forEach { it.reset() }
+        budgetViolations.set(0)
+    }
+
+    companion object {
+        /** README: "Event processing: < 500 μs per event". */
+        const val DEFAULT_BUDGET_US = 500L
+    }
+}
@@ -0,0 +1,95 @@
+package ai.synheart.behavior
+
+/**
+ * Aggregate query over a session's [SessionEventLog].
+ *
+ * Filters by event type, time range and an optional metric predicate. It then groups by time
+ * bucket and/or one categorical metric and aggregates. Executed by [SessionEventLog.aggregate] as
+ * column scans, so no event objects are materialized.
+ *
+ * Example: taps per minute is `EventQuery(eventType = "tap", bucketMs = 60_000)`. Notifications by
+ * action per hour is `EventQuery(eventType = "notification", bucketMs = 3_600_000, groupBy =
+ * "action")`.
+ */
+data class EventQuery(
+        val eventType: String? = null, // null scans every event type
+        val startMs: Long? = null, // inclusive
+        val endMs: Long? = null, // inclusive
+        val where: Predicate? = null,
+        val bucketMs: Long = 0, // 0 puts the whole range in one bucket
+        val groupBy: String? = null, // categorical metric, e.g. "action"
+        val aggregation: Aggregation = Aggregation.COUNT,
+        val field: String? = null, // numeric metric for every aggregation except COUNT
+        val quantile: Double = 0.5
+) {
+    enum class Aggregation {
+        COUNT,
+        SUM,
+        AVG,
+        MIN,
+        MAX,
+        QUANTILE
+    }
+
+    /**
+     * Compares one metric against a constant. A string [value] is matched against the metric's
+     * categorical column and supports only == and !=. Numbers and booleans (as 1/0) are matched
+     * against its numeric column. Events without the metric never match.
+     */
+    data class Predicate(val field: String, val op: String, val value: Any) {
+        init {
+            require(op in NUMERIC_OPS) { "Unsupported predicate operator: $op" }
+            require(value !is String || op == "==" || op == "!=") {
+                "String predicates support only == and !="
+            }
+        }
+
+        companion object {
+            /** Parse a `where` map sent by the Dart `EventPredicate.toJson()`. */
+            fun fromMap(map: Map<String, Any?>): Predicate =
+                    Predicate(
+                            field = map["field"] as? String
+                                            ?: throw IllegalArgumentException(
+                                                    "Predicate requires a field"
+                                            ),
+                            op = map["op"] as? String ?: "==",
+                            value = map["value"]
+                                            ?: throw IllegalArgumentException(
+                                                    "Predicate requires a value"
+                                            )
+                    )
+        }
+    }
+
+    init {
+        require(bucketMs >= 0) { "bucketMs must be >= 0" }
+        require(aggregation == Aggregation.COUNT || field != null) {
+            "Aggregation $aggregation requires a field"
+        }
+        require(quantile in 0.0..1.0) { "quantile must be in [0, 1]" }
+    }
+
+    companion object {
+        val NUMERIC_OPS = setOf("==", "!=", "<", "<=", ">", ">=")
+
+        /** Parse the map sent over the method channel by the Dart `EventQuery.toJson()`. */
+        fun fromMap(map: Map<String, Any?>): EventQuery {
+            @Suppress("UNCHECKED_CAST") val where = map["where"] as? Map<String, Any?>
+            return EventQuery(
+                    eventType = map["eventType"] as? String,
+                    startMs = (map["startMs"] as? Number)?.toLong(),
+                    endMs = (map["endMs"] as? Number)?.toLong(),
+                    where = where?.let { Predicate.fromMap(it) },
+                    bucketMs = (map["bucketMs"] as? Number)?.toLong() ?: 0L,
+                    groupBy = map["groupBy"] as? String,
+                    aggregation =
+                            (map["aggregation"] as? String)?.let {
+                                Aggregation.valueOf(it.uppercase())
+                            }
+                                    ?: Aggregation.COUNT,
+                    field = map["field"] as? String,
+                    quantile = (map["quantile"] as? Number)?.toDouble() ?: 0.5
+            )
+        }
+    }
+}
@@ -0,0 +1,182 @@
+package ai.synheart.behavior
+
+import java.util.concurrent.atomic.AtomicInteger
+
+/**
+ * Decides which native events cross the method channel to Dart.
+ *
+ * An event is sent when the plain `onEvent` stream has a listener or when at least one
+ * subscription accepts it. A subscription's [Filter] is checked in order: event type, metric
+ * predicate, per-type sampling, then a per-type rate limit. Rejected events are only counted, so
+ * they are never converted to a map, sent or decoded in Dart.
+ *
+ * Subscriptions are replaced copy-on-write, so [route] reads them without a lock. Each
+ * subscription's sampling and rate limit state is guarded by the subscription itself.
+ */
+class EventSubscriptions {
+
+    /**
+     * Filter pushed down by one Dart subscriber.
+     *
+     * [sampleEvery] delivers the 1st, (N+1)th, ... matching event of each type. [maxPerSecond]
+     * caps delivery per event type with a token bucket holding up to one second of events; 0
+     * means unlimited.
+     */
+    class Filter(
+            val eventTypes: Set<String>? = null, // null matches every type
+            val where: EventQuery.Predicate? = null,
+            val sampleEvery: Int = 1,
+            val maxPerSecond: Double = 0.0
+    ) {
+        init {
+            require(sampleEvery >= 1) { "sampleEvery must be >= 1" }
+            require(maxPerSecond >= 0.0) { "maxPerSecond must be >= 0" }
+        }
+
+        companion object {
+            /** Parse the map sent over the method channel by the Dart `EventFilter.toJson()`. */
+            fun fromMap(map: Map<String, Any?>): Filter {
+                @Suppress("UNCHECKED_CAST") val where = map["where"] as? Map<String, Any?>
+                return Filter(
+                        eventTypes = (map["eventTypes"] as? List<*>)?.mapTo(HashSet()) { "$it" },
+                        where = where?.let { EventQuery.Predicate.fromMap(it) },
+                        sampleEvery = (map["sampleEvery"] as? Number)?.toInt() ?: 1,
+                        maxPerSecond = (map["maxPerSecond"] as? Number)?.toDouble() ?: 0.0
+                )
+            }
+        }
+    }
+
+    private class TypeState(var seen: Long, var tokens: Double, var refilledAtNanos: Long)
+
+    private class Subscription(val filter: Filter) {
+        var delivered = 0L
+        var filtered = 0L
+        private val types = HashMap<String, TypeState>()
+
+        @Synchronized
+        fun accept(event: BehaviorEvent, nowNanos: Long): Boolean {
+            val accepted = matches(event) && admit(event.eventType, nowNanos)
+            if (accepted) delivered++ else filtered++
+            return accepted
+        }
+
+        @Synchronized
+        fun stats(): Map<String, Long> = mapOf("delivered" to delivered, "filtered" to filtered)
+
+        private fun matches(event: BehaviorEvent): Boolean {
+            if (filter.eventTypes != null && event.eventType !in filter.eventTypes) return false
+            val predicate = filter.where ?: return true
+            return matchesPredicate(predicate, event.metrics[predicate.field])
+        }
+
+        private fun admit(eventType: String, nowNanos: Long): Boolean {
+            if (filter.sampleEvery == 1 && filter.maxPerSecond == 0.0) return true
+            val state =
+                    types.getOrPut(eventType) {
+                        TypeState(0L, burst(filter.maxPerSecond), nowNanos)
+                    }
+            if (state.seen++ % filter.sampleEvery != 0L) return false
+            if (filter.maxPerSecond == 0.0) return true
+
+            val elapsedSeconds = (nowNanos - state.refilledAtNanos) / 1_000_000_000.0
+            state.tokens =
+                    minOf(
+                            burst(filter.maxPerSecond),
+                            state.tokens + elapsedSeconds * filter.maxPerSecond
+                    )
+            state.refilledAtNanos = nowNanos
+            if (state.tokens < 1.0) return false
+            state.tokens -= 1.0
+            return true
+        }
+    }
+
+    @Volatile private var subscriptions: Map<Int, Subscription> = emptyMap()
+    @Volatile private var streamListening = false
+    private val nextId = AtomicInteger(1)
+
+    /** Register [filter] and return its subscription ID. */
+    @Synchronized
+    fun add(filter: Filter): Int {
+        val id = nextId.getAndIncrement()
+        subscriptions = subscriptions + (id to Subscription(filter))
+        return id
+    }
+
+    /** Remove a subscription. Returns false when [id] was not registered. */
+    @Synchronized
+    fun remove(id: Int): Boolean {
+        if (id !in subscriptions) return false
+        subscriptions = subscriptions - id
+        return true
+    }
+
+    @Synchronized
+    fun clear() {
+        subscriptions = emptyMap()
+        streamListening = false
+    }
+
+    /** Whether the unfiltered `onEvent` stream currently has a listener in Dart. */
+    fun setStreamListening(listening: Boolean) {
+        streamListening = listening
+    }
+
+    /**
+     * IDs of the subscriptions that accept [event], or null when nothing in Dart wants it (no
+     * stream listener and no accepting subscription).
+     */
+    fun route(event: BehaviorEvent): List<Int>? {
+        val current = subscriptions
+        if (current.isEmpty()) return if (streamListening) emptyList() else null
+
+        val nowNanos = System.nanoTime()
+        var accepted: MutableList<Int>? = null
+        for ((id, subscription) in current) {
+            if (subscription.accept(event, nowNanos)) {
+                (accepted ?: ArrayList<Int>(2).also { accepted = it }).add(id)
+            }
+        }
+        return accepted ?: if (streamListening) emptyList() else null
+    }
+
+    /** Delivered and filtered event counts per subscription ID. */
+    fun getStats(): Map<String, Map<String, Long>> =
+            subscriptions.entries.associate { (id, subscription) ->
+                id.toString() to subscription.stats()
+            }
+
+    private companion object {
+        fun burst(maxPerSecond: Double): Double = maxOf(1.0, maxPerSecond)
+
+        /** Same semantics as [EventQuery.Predicate] in [SessionEventLog.aggregate]. */
+        fun matchesPredicate(predicate: EventQuery.Predicate, actual: Any?): Boolean {
+            if (actual == null) return false
+            val expected = predicate.value
+            if (expected is String) {
+                // Categorical match on the metric's text, as in the category columns
+                val text = actual.toString()
+                return if (predicate.op == "==") text == expected else text != expected
+            }
+            val value = toNumber(actual) ?: return false
+            val target = toNumber(expected) ?: return false
+            if (value.isNaN()) return false
+            return when (predicate.op) {
+                "==" -> value == target
+                "!=" -> value != target
+                "<" -> value < target
+                "<=" -> value <= target
+                ">" -> value > target
+                else -> value >= target
+            }
+        }
+
+        fun toNumber(value: Any?): Double? =
+                when (value) {
+                    is Number -> value.toDouble()
+                    is Boolean -> if (value) 1.0 else 0.0
+                    else -> null
+                }
+    }
+}
@@ -0,0 +1,333 @@
+package ai.synheart.behavior
+
+import java.math.BigInteger
+
+/**
+ * Double formatting and parsing kernels for the JSON boundary.
+ *
+ * [append] writes the shortest decimal that parses back to the same double (Schubfach: the value
+ * and its rounding bounds are each scaled by one 128-bit power of ten, then the shortest decimal
+ * inside the bounds is picked). Java's `Double.toString` does not guarantee the shortest digits
+ * before JDK 19, and Android's does not at all.
+ *
+ * [parse] reads a decimal with at most 19 significant digits exactly: Clinger's fast path when
+ * the mantissa and the power of ten are both exact doubles, else Eisel-Lemire (one or two 64×128
+ * bit multiplies by a power of five, then rounding on the truncated product). Longer mantissas,
+ * subnormal results and the rare product too close to a halfway point to decide fall back to
+ * [java.lang.Double.parseDouble].
+ *
+ * Both tables are computed exactly with [BigInteger] on first use.
+ */
+object FastDouble {
+
+    /** Append the shortest round-trip decimal of [value] as a JSON number. */
+    fun append(value: Double, out: StringBuilder): StringBuilder {
+        require(!value.isNaN() && !value.isInfinite()) { "JSON has no NaN or infinity" }
+        val bits = java.lang.Double.doubleToRawLongBits(value)
+        if (bits < 0) out.append('-')
+        val t = bits and T_MASK
+        val bq = ((bits ushr 52) and 0x7ff).toInt()
+        if (bq != 0) {
+            val mq = -Q_MIN + 1 - bq
+            val c = C_MIN or t
+            // Integers below 2^53 need no scaling
+            if (mq in 1 until 53) {
+                val f = c shr mq
+                if (f shl mq == c) return appendDecimal(f, 0, out)
+            }
+            return toDecimal(-mq, c, 0, out)
+        }
+        if (t != 0L) {
+            return if (t < C_TINY) toDecimal(Q_MIN, 10 * t, -1, out)
+            else toDecimal(Q_MIN, t, 0, out)
+        }
+        return out.append('0')
+    }
+
+    fun toString(value: Double): String = append(value, StringBuilder(24)).toString()
+
+    /**
+     * Parse the JSON number in [text] between [start] and [end] to the nearest double. Throws
+     * [NumberFormatException] when it is not a JSON number.
+     */
+    fun parse(text: CharSequence, start: Int = 0, end: Int = text.length): Double {
+        var i = start
+        val negative = i < end && text[i] == '-'
+        if (negative) i++
+        var mantissa = 0L // Unsigned; up to 19 digits
+        var digits = 0
+        var exponent = 0
+
+        val integerStart = i
+        while (i < end && text[i] in '0'..'9') {
+            if (mantissa != 0L || text[i] != '0') digits++
+            if (digits <= MAX_DIGITS) mantissa = mantissa * 10 + (text[i] - '0')
+            i++
+        }
+        if (i == integerStart) throw notANumber(text, start, end)
+        if (text[integerStart] == '0' && i - integerStart > 1) throw notANumber(text, start, end)
+        if (i < end && text[i] == '.') {
+            i++
+            val fractionStart = i
+            while (i < end && text[i] in '0'..'9') {
+                if (mantissa != 0L || text[i] != '0') digits++
+                if (digits <= MAX_DIGITS) {
+                    mantissa = mantissa * 10 + (text[i] - '0')
+                    exponent--
+                }
+                i++
+            }
+            if (i == fractionStart) throw notANumber(text, start, end)
+        }
+        if (i < end && (text[i] == 'e' || text[i] == 'E')) {
+            i++
+            val exponentNegative = i < end && text[i] == '-'
+            if (i < end && (text[i] == '-' || text[i] == '+')) i++
+            val exponentStart = i
+            var value = 0
+            while (i < end && text[i] in '0'..'9') {
+                if (value < 100_000) value = value * 10 + (text[i] - '0')
+                i++
+            }
+            if (i == exponentStart) throw notANumber(text, start, end)
+            exponent += if (exponentNegative) -value else value
+        }
+        if (i != end) throw notANumber(text, start, end)
+
+        val magnitude =
+                when {
+                    digits > MAX_DIGITS -> return parseSlow(text, start, end)
+                    mantissa == 0L -> 0.0
+                    exponent in -22..22 && mantissa.toULong() <= (1uL shl 53) ->
+                            if (exponent >= 0) mantissa.toDouble() * POW10[exponent]
+                            else mantissa.toDouble() / POW10[-exponent]
+                    else -> {
+                        val bits = eiselLemire(mantissa, exponent)
+                        if (bits < 0) return parseSlow(text, start, end)
+                        java.lang.Double.longBitsToDouble(bits)
+                    }
+                }
+        return if (negative) -magnitude else magnitude
+    }
+
+    private fun parseSlow(text: CharSequence, start: Int, end: Int): Double =
+            java.lang.Double.parseDouble(text.subSequence(start, end).toString())
+
+    private fun notANumber(text: CharSequence, start: Int, end: Int) =
+            NumberFormatException("Not a JSON number: ${text.subSequence(start, end)}")
+
+    /** Schubfach for c·2^q; the result is f·10^(k + dk). */
+    private fun toDecimal(q: Int, c: Long, dk: Int, out: StringBuilder): StringBuilder {
+        val excluded = (c and 1L).toInt() // Odd significands do not own their bounds
+        val cb = c shl 2
+        val cbr = cb + 2
+        val cbl: Long
+        val k: Int
+        if (c != C_MIN || q == Q_MIN) {
+            cbl = cb - 2
+            k = flog10pow2(q)
+        } else {
+            // The gap below a power of two is half the gap above
+            cbl = cb - 1
+            k = flog10threeQuartersPow2(q)
+        }
+        val h = q + flog2pow10(-k) + 2
+        val index = k - K_MIN
+        val g1 = tables.g1[index]
+        val g0 = tables.g0[index]
+        val vb = roundToOdd(g1, g0, cb shl h)
+        val vbl = roundToOdd(g1, g0, cbl shl h)
+        val vbr = roundToOdd(g1, g0, cbr shl h)
+
+        val s = vb shr 2
+        if (s >= 100) {
+            // One digit fewer than s, when a multiple of ten is inside the bounds
+            val sp10 = s / 10 * 10
+            val tp10 = sp10 + 10
+            val upin = vbl + excluded <= sp10 shl 2
+            val wpin = (tp10 shl 2) + excluded <= vbr
+            if (upin != wpin) return appendDecimal(if (upin) sp10 else tp10, k, out)
+        }
+        val t = s + 1
+        val uin = vbl + excluded <= s shl 2
+        val win = (t shl 2) + excluded <= vbr
+        if (uin != win) return appendDecimal(if (uin) s else t, k + dk, out)
+        // Both in bounds: the closer one, ties to even
+        val cmp = vb - ((s + t) shl 1)
+        return appendDecimal(if (cmp < 0 || cmp == 0L && (s and 1L) == 0L) s else t, k + dk, out)
+    }
+
+    /** Round to odd of g·cp / 2^127, where g = g1·2^63 + g0. */
+    private fun roundToOdd(g1: Long, g0: Long, cp: Long): Long {
+        val x1 = multiplyHigh(g0, cp)
+        val y0 = g1 * cp
+        val y1 = multiplyHigh(g1, cp)
+        val z = (y0 ushr 1) + x1
+        val vbp = y1 + (z ushr 63)
+        return vbp or (((z and MASK_63) + MASK_63) ushr 63)
+    }
+
+    /** f·10^e as JSON: plain notation for 1e-7 ≤ |x| < 1e21, else scientific. */
+    private fun appendDecimal(
+            significand: Long,
+            exponent10: Int,
+            out: StringBuilder
+    ): StringBuilder {
+        var f = significand
+        var e = exponent10
+        while (f % 10 == 0L) {
+            f /= 10
+            e++
+        }
+        val digits = CharArray(MAX_DIGITS)
+        var n = 0
+        while (f != 0L) {
+            digits[MAX_DIGITS - 1 - n] = '0' + (f % 10).toInt()
+            f /= 10
+            n++
+        }
+        val first = MAX_DIGITS - n
+        val scientific = n - 1 + e
+        when {
+            scientific !in -7..20 -> {
+                out.append(digits[first])
+                if (n > 1) out.append('.').append(digits, first + 1, n - 1)
+                out.append('E').append(scientific)
+            }
+            e >= 0 -> {
+                out.append(digits, first, n)
+                repeat(e) { out.append('0') }
+            }
+            scientific >= 0 -> {
+                out.append(digits, first, n + e).append('.').append(digits, first + n + e, -e)
+            }
+            else -> {
+                out.append("0.")
+                repeat(-scientific - 1) { out.append('0') }
+                out.append(digits, first, n)
+            }
+        }
+        return out
+    }
+
+    /** Bits of w·10^q, or -1 when the product cannot decide the rounding. */
+    private fun eiselLemire(w: Long, q: Int): Long {
+        if (q < P5_MIN) return 0L
+        if (q > P5_MAX) return INFINITY_BITS
+        val lz = java.lang.Long.numberOfLeadingZeros(w)
+        val normalized = w shl lz
+        val index = q - P5_MIN
+        var high = multiplyHigh(normalized, tables.p5High[index])
+        var low = normalized * tables.p5High[index]
+        if (high and PRECISION_MASK == PRECISION_MASK) {
+            // The truncated power may matter: add the next 64 bits of it
+            val secondHigh = multiplyHigh(normalized, tables.p5Low[index])
+            low += secondHigh
+            if (secondHigh.toULong() > low.toULong()) high++
+            if (high and PRECISION_MASK == PRECISION_MASK && low == -1L) return -1L
+        }
+        val upper = (high ushr 63).toInt()
+        val shift = upper + 64 - 52 - 3
+        var mantissa = high ushr shift
+        var power2 = (((152170 + 65536) * q) shr 16) + 63 + upper - lz + 1023
+        if (power2 <= 0) return -1L // Subnormal
+        // Exactly halfway between two doubles (only possible for small q): round to even
+        if (low.toULong() <= 1uL &&
+                        q in -4..23 &&
+                        mantissa and 3L == 1L &&
+                        mantissa shl shift == high
+        ) {
+            mantissa = mantissa and 1L.inv()
+        }
+        mantissa += mantissa and 1L
+        mantissa = mantissa ushr 1
+        if (mantissa >= 2L shl 52) {
+            mantissa = 1L shl 52
+            power2++
+        }
+        mantissa = mantissa and (1L shl 52).inv()
+        if (power2 >= 0x7ff) return INFINITY_BITS
+        return mantissa or (power2.toLong() shl 52)
+    }
+
+    /** High 64 bits of the unsigned 128-bit product. */
+    private fun multiplyHigh(x: Long, y: Long): Long {
+        val x0 = x and MASK_32
+        val x1 = x ushr 32
+        val y0 = y and MASK_32
+        val y1 = y ushr 32
+        val t = x1 * y0 + ((x0 * y0) ushr 32)
+        val w1 = (t and MASK_32) + x0 * y1
+        return x1 * y1 + (t ushr 32) + (w1 ushr 32)
+    }
+
+    private fun flog10pow2(e: Int): Int = ((e * 661971961083L) shr 41).toInt()
+
+    private fun flog10threeQuartersPow2(e: Int): Int =
+            ((e * 661971961083L - 274743187321L) shr 41).toInt()
+
+    private fun flog2pow10(e: Int): Int = ((e * 913124641741L) shr 38).toInt()
+
+    private class Tables {
+        // g = floor(10^-k · 2^-r) + 1 with r = flog2pow10(-k) - 125, as 63-bit halves
+        val g1 = LongArray(K_MAX - K_MIN + 1)
+        val g0 = LongArray(K_MAX - K_MIN + 1)
+        // 5^q normalized to 128 bits (rounded up for q < 0), as 64-bit halves
+        val p5High = LongArray(P5_MAX - P5_MIN + 1)
+        val p5Low = LongArray(P5_MAX - P5_MIN + 1)
+
+        init {
+            for (k in K_MIN..K_MAX) {
+                val r = flog2pow10(-k) - 125
+                var numerator = if (k <= 0) BigInteger.TEN.pow(-k) else BigInteger.ONE
+                var denominator = if (k > 0) BigInteger.TEN.pow(k) else BigInteger.ONE
+                if (r <= 0) numerator = numerator.shiftLeft(-r)
+                else denominator = denominator.shiftLeft(r)
+                val g = numerator.divide(denominator).add(BigInteger.ONE)
+                g1[k - K_MIN] = g.shiftRight(63).toLong()
+                g0[k - K_MIN] = g.toLong() and MASK_63
+            }
+            val five = BigInteger.valueOf(5)
+            for (q in P5_MIN..P5_MAX) {
+                val power = five.pow(kotlin.math.abs(q))
+                var value =
+                        if (q >= 0) {
+                            power
+                        } else {
+                            val z = power.bitLength()
+                            val b = if (q >= -27) z + 127 else 2 * z + 128
+                            BigInteger.ONE.shiftLeft(b).divide(power).add(BigInteger.ONE)
+                        }
+                val bits = value.bitLength()
+                value =
+                        if (bits <= 128) value.shiftLeft(128 - bits)
+                        else value.shiftRight(bits - 128)
+                p5High[q - P5_MIN] = value.shiftRight(64).toLong()
+                p5Low[q - P5_MIN] = value.toLong()
+            }
+        }
+    }
+
+    private val tables by lazy { Tables() }
+
+    private const val Q_MIN = -1074 // Exponent of the smallest subnormal
+    private const val C_MIN = 1L shl 52
+    private const val C_TINY = 3L // Subnormals below this need an extra digit to round-trip
+    private const val T_MASK = (1L shl 52) - 1
+    private const val MASK_63 = (1L shl 63) - 1
+    private const val MASK_32 = 0xffffffffL
+    private const val K_MIN = -324
+    private const val K_MAX = 292
+    private const val P5_MIN = -342
+    private const val P5_MAX = 308
+    private const val MAX_DIGITS = 19
+    private const val PRECISION_MASK = -1L ushr 55 // Low bits that must not be all ones
+    private const val INFINITY_BITS = 0x7ffL shl 52
+    private val POW10 = DoubleArray(23).also { // 10^22 is the largest exact power of ten
+        var power = 1.0
+        for (i in it.indices) {
+            it[i] = power
+            power *= 10
+        }
+    }
+}
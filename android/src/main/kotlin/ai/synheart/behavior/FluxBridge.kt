@@ -1,6 +1,8 @@
 package ai.synheart.behavior
 
 import android.util.Log
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
 import java.time.Instant
 import org.json.JSONArray
 import org.json.JSONObject
@@ -13,11 +15,22 @@ import org.json.JSONObject
  *
  * Note: The synheart-flux library must be built with JNI support (android feature flag) for this
  * bridge to work. Without JNI wrappers, the native methods will not be available.
+ *
+ * The JNI bridge binds Flux once in JNI_OnLoad and registers its natives there; if binding
+ * fails no natives are registered and the bridge reports itself unavailable.
  */
 object FluxBridge {
     private const val TAG = "FluxBridge"
     private var libraryLoaded = false
     private var jniAvailable = false
+    private var capabilities = 0
+
+    /** Bits of the capability table reported by the JNI bridge (table version 1). */
+    object Capability {
+        const val VERSION = 1 shl 0 // flux_version
+        const val STREAMING = 1 shl 1 // flux_behavior_stream_*
+        const val BINARY = 1 shl 2 // flux_behavior_to_hsi_binary
+    }
 
     init {
         try {
@@ -34,7 +47,11 @@ object FluxBridge {
             // Test if JNI methods are actually available
             jniAvailable = testJniAvailability()
             if (jniAvailable) {
-                Log.d(TAG, "JNI methods available")
+                capabilities = nativeCapabilities()
+                Log.d(
+                        TAG,
+                        "JNI methods available (capability table v${getCapabilityTableVersion()}, flags 0x${Integer.toHexString(getCapabilities())})"
+                )
                 val version = nativeFluxVersion()
                 if (!version.isNullOrBlank()) {
                     Log.d(TAG, "synheart-flux version: $version")
@@ -71,6 +88,15 @@ object FluxBridge {
     /** Check if the Rust library is available and JNI is properly configured. */
     fun isAvailable(): Boolean = libraryLoaded && jniAvailable
 
+    /** Capability flags of the loaded library, a combination of [Capability] bits. */
+    fun getCapabilities(): Int = capabilities and 0x00FFFFFF
+
+    /** Layout version of the capability table, 0 when the bridge is unavailable. */
+    fun getCapabilityTableVersion(): Int = capabilities ushr 24
+
+    /** True if the loaded library exports the optional entry points for [flag]. */
+    fun hasCapability(flag: Int): Boolean = isAvailable() && (getCapabilities() and flag) == flag
+
     /**
      * Return the loaded synheart-flux library version (e.g. "0.2.0"), or null if unavailable.
      * Use this to verify you are running the expected Flux release.
@@ -113,6 +139,29 @@ object FluxBridge {
         }
     }
 
+    /**
+     * Convert many behavioral sessions to HSI JSON in one JNI call. Sessions are scored
+     * independently, one after another on the calling thread: Flux does not declare
+     * flux_behavior_to_hsi reentrant, so a batch must not be split across threads either.
+     *
+     * @param sessionJsons Session JSON payloads
+     * @return HSI JSON per input, in order; null entries failed
+     */
+    fun behaviorToHsiBatch(sessionJsons: List<String>): List<String?> {
+        if (sessionJsons.isEmpty()) return emptyList()
+        if (!isAvailable()) {
+            Log.w(TAG, "Rust library not initialized, cannot compute HSI")
+            return List(sessionJsons.size) { null }
+        }
+        return try {
+            val (data, offsets) = packPayloads(sessionJsons)
+            unpackResults(nativeBehaviorToHsiBatch(data, offsets), sessionJsons.size)
+        } catch (e: Exception) {
+            Log.e(TAG, "Exception calling behaviorToHsiBatch: ${e.message}", e)
+            List(sessionJsons.size) { null }
+        }
+    }
+
     /**
      * Create a stateful behavioral processor with the specified baseline window.
      *
@@ -156,6 +205,52 @@ object FluxBridge {
         }
     }
 
+    /**
+     * Process many sessions with the stateful processor in one JNI call, e.g. when re-scoring a
+     * backlog after a baseline reset. Sessions are processed in order so baselines evolve exactly
+     * as with repeated [processSession] calls.
+     *
+     * @return HSI JSON per input, in order; null entries failed
+     */
+    fun processSessionBatch(handle: Long, sessionJsons: List<String>): List<String?> {
+        if (sessionJsons.isEmpty()) return emptyList()
+        if (!isAvailable() || handle == 0L) return List(sessionJsons.size) { null }
+        return try {
+            val (data, offsets) = packPayloads(sessionJsons)
+            unpackResults(nativeProcessorProcessBatch(handle, data, offsets), sessionJsons.size)
+        } catch (e: Exception) {
+            Log.e(TAG, "Error processing session batch: ${e.message}")
+            List(sessionJsons.size) { null }
+        }
+    }
+
+    /** Concatenate payloads as UTF-8 with count + 1 offsets (payload i is data[o[i], o[i+1])). */
+    private fun packPayloads(payloads: List<String>): Pair<ByteArray, IntArray> {
+        val encoded = payloads.map { it.toByteArray(Charsets.UTF_8) }
+        val offsets = IntArray(encoded.size + 1)
+        for (i in encoded.indices) {
+            offsets[i + 1] = offsets[i] + encoded[i].size
+        }
+        val data = ByteArray(offsets[encoded.size])
+        for (i in encoded.indices) {
+            System.arraycopy(encoded[i], 0, data, offsets[i], encoded[i].size)
+        }
+        return Pair(data, offsets)
+    }
+
+    /** Inverse of the native packing: count + 1 little-endian offsets, then UTF-8 bytes. */
+    private fun unpackResults(packed: ByteArray?, count: Int): List<String?> {
+        if (packed == null) return List(count) { null }
+        val header = ByteBuffer.wrap(packed).order(ByteOrder.LITTLE_ENDIAN)
+        val dataStart = (count + 1) * 4
+        return List(count) { i ->
+            val start = header.getInt(i * 4)
+            val end = header.getInt((i + 1) * 4)
+            if (end > start) String(packed, dataStart + start, end - start, Charsets.UTF_8)
+            else null
+        }
+    }
+
     /** Save baselines from a processor to JSON for persistence. */
     fun saveBaselines(handle: Long): String? {
         if (!isAvailable() || handle == 0L) return null
@@ -191,6 +286,13 @@ object FluxBridge {
     private external fun nativeProcessorLoadBaselines(handle: Long, baselinesJson: String): Int
     private external fun nativeFluxVersion(): String?
     private external fun nativeLastError(): String?
+    private external fun nativeCapabilities(): Int
+    private external fun nativeBehaviorToHsiBatch(data: ByteArray, offsets: IntArray): ByteArray?
+    private external fun nativeProcessorProcessBatch(
+            handle: Long,
+            data: ByteArray,
+            offsets: IntArray
+    ): ByteArray?
 }
 
 /** Convert session events to synheart-flux JSON format. */
@@ -210,264 +312,302 @@ fun convertEventsToFluxJson(
     var scrollEventsWithoutReversal = 0
     var scrollEventsWithoutScrollData = 0
 
-    eventLoop@ for (event in events) {
-        val fluxEvent = JSONObject()
-        fluxEvent.put("timestamp", event.timestamp)
-        fluxEvent.put("event_type", event.eventType)
-
-        when (event.eventType) {
-            "scroll" -> {
-                scrollEventCount++
-                val hasReversal = event.metrics["direction_reversal"] as? Boolean ?: false
-                val hasScrollData = event.metrics.containsKey("direction_reversal")
-
-                if (hasScrollData) {
-                    if (hasReversal) {
-                        scrollEventsWithReversal++
-                    } else {
-                        scrollEventsWithoutReversal++
-                    }
+    for (event in events) {
+        if (event.eventType == "scroll") {
+            scrollEventCount++
+            val hasReversal = event.metrics["direction_reversal"] as? Boolean ?: false
+            val hasScrollData = event.metrics.containsKey("direction_reversal")
+
+            if (hasScrollData) {
+                if (hasReversal) {
+                    scrollEventsWithReversal++
                 } else {
-                    scrollEventsWithoutScrollData++
+                    scrollEventsWithoutReversal++
                 }
+            } else {
+                scrollEventsWithoutScrollData++
+            }
+        }
 
-                val scroll = JSONObject()
-                scroll.put("velocity", event.metrics["velocity"] ?: 0.0)
-                scroll.put("direction", event.metrics["direction"] ?: "down")
-                // Include direction_reversal if available (Flux accepts this field)
-                val directionReversal = event.metrics["direction_reversal"]
-                if (directionReversal != null) {
-                    scroll.put("direction_reversal", directionReversal as? Boolean ?: false)
-                }
-                fluxEvent.put("scroll", scroll)
+        val fluxEvent = convertEventToFluxJson(event) ?: continue
+        fluxEvents.put(fluxEvent)
+    }
+
+    // DEBUG: Log what we're sending to Flux
+    android.util.Log.d("FluxBridge", "=== CONVERTING TO FLUX JSON ===")
+    android.util.Log.d("FluxBridge", "Total scroll events being sent: $scrollEventCount")
+    android.util.Log.d("FluxBridge", "  - With reversal=true: $scrollEventsWithReversal")
+    android.util.Log.d("FluxBridge", "  - With reversal=false: $scrollEventsWithoutReversal")
+    android.util.Log.d(
+            "FluxBridge",
+            "  - Without direction_reversal field: $scrollEventsWithoutScrollData"
+    )
+    android.util.Log.d("FluxBridge", "=== END CONVERSION DEBUG ===")
+
+    val session = JSONObject()
+    session.put("session_id", sessionId)
+    session.put("device_id", deviceId)
+    session.put("timezone", timezone)
+    session.put("start_time", Instant.ofEpochMilli(startTimeMs).toString())
+    session.put("end_time", Instant.ofEpochMilli(endTimeMs).toString())
+    session.put("events", fluxEvents)
+
+    return JsonCodec.toJson(session)
+}
+
+/**
+ * Convert a single session event to a synheart-flux event object, or null for event types that
+ * are not sent to Flux (clipboard).
+ */
+fun convertEventToFluxJson(event: BehaviorEvent): JSONObject? {
+    val fluxEvent = JSONObject()
+    fluxEvent.put("timestamp", event.timestamp)
+    fluxEvent.put("event_type", event.eventType)
+
+    when (event.eventType) {
+        "scroll" -> {
+            val scroll = JSONObject()
+            scroll.put("velocity", event.metrics["velocity"] ?: 0.0)
+            scroll.put("direction", event.metrics["direction"] ?: "down")
+            // Include direction_reversal if available (Flux accepts this field)
+            val directionReversal = event.metrics["direction_reversal"]
+            if (directionReversal != null) {
+                scroll.put("direction_reversal", directionReversal as? Boolean ?: false)
             }
-            "tap" -> {
-                val tap = JSONObject()
-                tap.put("tap_duration_ms", event.metrics["tap_duration_ms"] ?: 0)
-                tap.put("long_press", event.metrics["long_press"] ?: false)
-                fluxEvent.put("tap", tap)
+            fluxEvent.put("scroll", scroll)
+        }
+        "tap" -> {
+            val tap = JSONObject()
+            tap.put("tap_duration_ms", event.metrics["tap_duration_ms"] ?: 0)
+            tap.put("long_press", event.metrics["long_press"] ?: false)
+            fluxEvent.put("tap", tap)
+        }
+        "swipe" -> {
+            val swipe = JSONObject()
+            swipe.put("velocity", event.metrics["velocity"] ?: 0.0)
+            swipe.put("direction", event.metrics["direction"] ?: "unknown")
+            fluxEvent.put("swipe", swipe)
+        }
+        "notification", "call" -> {
+            val interruption = JSONObject()
+            // Map action values to valid Rust enum values
+            // Rust only accepts: ignored, opened, answered, dismissed
+            val action =
+                    when (event.metrics["action"]?.toString()?.lowercase()) {
+                        "opened", "open" -> "opened"
+                        "answered", "answer" -> "answered"
+                        "dismissed", "dismiss" -> "dismissed"
+                        "received" ->
+                                "ignored" // Map "received" to "ignored" since it hasn't been
+                        // acted upon
+                        "ignored",
+                        "ignore" -> "ignored"
+                        else -> "ignored" // Default to "ignored" for unknown values
+                    }
+            interruption.put("action", action)
+            // Include source_app_id if available (Flux accepts this field)
+            val sourceAppId = event.metrics["source_app_id"]
+            if (sourceAppId != null) {
+                interruption.put("source_app_id", sourceAppId.toString())
             }
-            "swipe" -> {
-                val swipe = JSONObject()
-                swipe.put("velocity", event.metrics["velocity"] ?: 0.0)
-                swipe.put("direction", event.metrics["direction"] ?: "unknown")
-                fluxEvent.put("swipe", swipe)
+            fluxEvent.put("interruption", interruption)
+        }
+        "typing" -> {
+            val typing = JSONObject()
+            typing.put("typing_speed_cpm", event.metrics["typing_speed"] ?: 0.0)
+            typing.put("cadence_stability", event.metrics["typing_cadence_stability"] ?: 0.0)
+            // Include duration_sec if available (Flux accepts this field)
+            val duration = event.metrics["duration"]
+            if (duration != null) {
+                // Convert to seconds if it's in seconds, or keep as-is if already a number
+                val durationSec =
+                        when (duration) {
+                            is Number -> duration.toDouble()
+                            is String -> duration.toDoubleOrNull() ?: 0.0
+                            else -> 0.0
+                        }
+                typing.put("duration_sec", durationSec)
             }
-            "notification", "call" -> {
-                val interruption = JSONObject()
-                // Map action values to valid Rust enum values
-                // Rust only accepts: ignored, opened, answered, dismissed
-                val action =
-                        when (event.metrics["action"]?.toString()?.lowercase()) {
-                            "opened", "open" -> "opened"
-                            "answered", "answer" -> "answered"
-                            "dismissed", "dismiss" -> "dismissed"
-                            "received" ->
-                                    "ignored" // Map "received" to "ignored" since it hasn't been
-                            // acted upon
-                            "ignored",
-                            "ignore" -> "ignored"
-                            else -> "ignored" // Default to "ignored" for unknown values
+            // Include pause_count if available (Flux accepts this field)
+            // Map typing_gap_count to pause_count as they represent the same concept
+            val pauseCount = event.metrics["pause_count"] ?: event.metrics["typing_gap_count"]
+            if (pauseCount != null) {
+                val pauseCountValue =
+                        when (pauseCount) {
+                            is Number -> pauseCount.toInt()
+                            is String -> pauseCount.toIntOrNull() ?: 0
+                            else -> 0
                         }
-                interruption.put("action", action)
-                // Include source_app_id if available (Flux accepts this field)
-                val sourceAppId = event.metrics["source_app_id"]
-                if (sourceAppId != null) {
-                    interruption.put("source_app_id", sourceAppId.toString())
-                }
-                fluxEvent.put("interruption", interruption)
+                typing.put("pause_count", pauseCountValue)
             }
-            "typing" -> {
-                val typing = JSONObject()
-                typing.put("typing_speed_cpm", event.metrics["typing_speed"] ?: 0.0)
-                typing.put("cadence_stability", event.metrics["typing_cadence_stability"] ?: 0.0)
-                // Include duration_sec if available (Flux accepts this field)
-                val duration = event.metrics["duration"]
-                if (duration != null) {
-                    // Convert to seconds if it's in seconds, or keep as-is if already a number
-                    val durationSec =
-                            when (duration) {
-                                is Number -> duration.toDouble()
-                                is String -> duration.toDoubleOrNull() ?: 0.0
-                                else -> 0.0
-                            }
-                    typing.put("duration_sec", durationSec)
-                }
-                // Include pause_count if available (Flux accepts this field)
-                // Map typing_gap_count to pause_count as they represent the same concept
-                val pauseCount = event.metrics["pause_count"] ?: event.metrics["typing_gap_count"]
-                if (pauseCount != null) {
-                    val pauseCountValue =
-                            when (pauseCount) {
-                                is Number -> pauseCount.toInt()
-                                is String -> pauseCount.toIntOrNull() ?: 0
-                                else -> 0
-                            }
-                    typing.put("pause_count", pauseCountValue)
-                }
-                // Include detailed typing metrics that Flux uses for aggregation
-                // These are needed for Flux to calculate average_keystrokes_per_session,
-                // average_typing_gap, average_inter_tap_interval, and burstiness_of_typing
-                val typingTapCount = event.metrics["typing_tap_count"]
+            // Include detailed typing metrics that Flux uses for aggregation
+            // These are needed for Flux to calculate average_keystrokes_per_session,
+            // average_typing_gap, average_inter_tap_interval, and burstiness_of_typing
+            val typingTapCount = event.metrics["typing_tap_count"]
+            android.util.Log.d(
+                    "FluxBridge",
+                    "Typing event - typing_tap_count in metrics: ${event.metrics.containsKey("typing_tap_count")}, value: $typingTapCount"
+            )
+            if (typingTapCount != null) {
+                val tapCountValue =
+                        when (typingTapCount) {
+                            is Number -> typingTapCount.toInt()
+                            is String -> typingTapCount.toIntOrNull() ?: 0
+                            else -> 0
+                        }
+                typing.put("typing_tap_count", tapCountValue)
                 android.util.Log.d(
                         "FluxBridge",
-                        "Typing event - typing_tap_count in metrics: ${event.metrics.containsKey("typing_tap_count")}, value: $typingTapCount"
+                        "Added typing_tap_count to Flux JSON: $tapCountValue"
                 )
-                if (typingTapCount != null) {
-                    val tapCountValue =
-                            when (typingTapCount) {
-                                is Number -> typingTapCount.toInt()
-                                is String -> typingTapCount.toIntOrNull() ?: 0
-                                else -> 0
-                            }
-                    typing.put("typing_tap_count", tapCountValue)
-                    android.util.Log.d(
-                            "FluxBridge",
-                            "Added typing_tap_count to Flux JSON: $tapCountValue"
-                    )
-                } else {
-                    android.util.Log.d(
-                            "FluxBridge",
-                            "WARNING: typing_tap_count not found in typing event metrics. Available keys: ${event.metrics.keys}"
-                    )
-                }
-                val meanInterTapInterval = event.metrics["mean_inter_tap_interval_ms"]
+            } else {
                 android.util.Log.d(
                         "FluxBridge",
-                        "Typing event - mean_inter_tap_interval_ms in metrics: ${event.metrics.containsKey("mean_inter_tap_interval_ms")}, value: $meanInterTapInterval"
+                        "WARNING: typing_tap_count not found in typing event metrics. Available keys: ${event.metrics.keys}"
                 )
-                if (meanInterTapInterval != null) {
-                    val itiValue =
-                            when (meanInterTapInterval) {
-                                is Number -> meanInterTapInterval.toDouble()
-                                is String -> meanInterTapInterval.toDoubleOrNull() ?: 0.0
-                                else -> 0.0
-                            }
-                    typing.put("mean_inter_tap_interval_ms", itiValue)
-                    android.util.Log.d(
-                            "FluxBridge",
-                            "Added mean_inter_tap_interval_ms to Flux JSON: $itiValue"
-                    )
-                } else {
-                    android.util.Log.d(
-                            "FluxBridge",
-                            "WARNING: mean_inter_tap_interval_ms not found in typing event metrics. Available keys: ${event.metrics.keys}"
-                    )
-                }
-                val typingBurstiness = event.metrics["typing_burstiness"]
+            }
+            val meanInterTapInterval = event.metrics["mean_inter_tap_interval_ms"]
+            android.util.Log.d(
+                    "FluxBridge",
+                    "Typing event - mean_inter_tap_interval_ms in metrics: ${event.metrics.containsKey("mean_inter_tap_interval_ms")}, value: $meanInterTapInterval"
+            )
+            if (meanInterTapInterval != null) {
+                val itiValue =
+                        when (meanInterTapInterval) {
+                            is Number -> meanInterTapInterval.toDouble()
+                            is String -> meanInterTapInterval.toDoubleOrNull() ?: 0.0
+                            else -> 0.0
+                        }
+                typing.put("mean_inter_tap_interval_ms", itiValue)
                 android.util.Log.d(
                         "FluxBridge",
-                        "Typing event - typing_burstiness in metrics: ${event.metrics.containsKey("typing_burstiness")}, value: $typingBurstiness"
+                        "Added mean_inter_tap_interval_ms to Flux JSON: $itiValue"
                 )
-                if (typingBurstiness != null) {
-                    val burstValue =
-                            when (typingBurstiness) {
-                                is Number -> typingBurstiness.toDouble()
-                                is String -> typingBurstiness.toDoubleOrNull() ?: 0.0
-                                else -> 0.0
-                            }
-                    typing.put("typing_burstiness", burstValue)
-                    android.util.Log.d(
-                            "FluxBridge",
-                            "Added typing_burstiness to Flux JSON: $burstValue"
-                    )
-                } else {
-                    android.util.Log.d(
-                            "FluxBridge",
-                            "WARNING: typing_burstiness not found in typing event metrics. Available keys: ${event.metrics.keys}"
-                    )
-                }
-                // Include session boundaries if available
-                val startAt = event.metrics["start_at"]
-                if (startAt != null) {
-                    typing.put("start_at", startAt.toString())
-                }
-                val endAt = event.metrics["end_at"]
-                if (endAt != null) {
-                    typing.put("end_at", endAt.toString())
-                }
-                // Correction and clipboard counts for Flux (correction_rate, clipboard_activity_rate)
-                val backspaceCount = event.metrics["backspace_count"]
-                typing.put(
-                    "number_of_backspace",
-                    when (backspaceCount) {
-                        is Number -> backspaceCount.toInt()
-                        is String -> backspaceCount.toIntOrNull() ?: 0
-                        else -> 0
-                    }
-                )
-                typing.put("number_of_delete", 0)
-                val numberOfCopy = event.metrics["number_of_copy"]
-                typing.put(
-                    "number_of_copy",
-                    when (numberOfCopy) {
-                        is Number -> numberOfCopy.toInt()
-                        is String -> numberOfCopy.toIntOrNull() ?: 0
-                        else -> 0
-                    }
+            } else {
+                android.util.Log.d(
+                        "FluxBridge",
+                        "WARNING: mean_inter_tap_interval_ms not found in typing event metrics. Available keys: ${event.metrics.keys}"
                 )
-                val numberOfPaste = event.metrics["number_of_paste"]
-                typing.put(
-                    "number_of_paste",
-                    when (numberOfPaste) {
-                        is Number -> numberOfPaste.toInt()
-                        is String -> numberOfPaste.toIntOrNull() ?: 0
-                        else -> 0
-                    }
+            }
+            val typingBurstiness = event.metrics["typing_burstiness"]
+            android.util.Log.d(
+                    "FluxBridge",
+                    "Typing event - typing_burstiness in metrics: ${event.metrics.containsKey("typing_burstiness")}, value: $typingBurstiness"
+            )
+            if (typingBurstiness != null) {
+                val burstValue =
+                        when (typingBurstiness) {
+                            is Number -> typingBurstiness.toDouble()
+                            is String -> typingBurstiness.toDoubleOrNull() ?: 0.0
+                            else -> 0.0
+                        }
+                typing.put("typing_burstiness", burstValue)
+                android.util.Log.d(
+                        "FluxBridge",
+                        "Added typing_burstiness to Flux JSON: $burstValue"
                 )
-                val numberOfCut = event.metrics["number_of_cut"]
-                typing.put(
-                    "number_of_cut",
-                    when (numberOfCut) {
-                        is Number -> numberOfCut.toInt()
-                        is String -> numberOfCut.toIntOrNull() ?: 0
-                        else -> 0
-                    }
+            } else {
+                android.util.Log.d(
+                        "FluxBridge",
+                        "WARNING: typing_burstiness not found in typing event metrics. Available keys: ${event.metrics.keys}"
                 )
-                fluxEvent.put("typing", typing)
             }
-            "app_switch" -> {
-                val appSwitch = JSONObject()
-                appSwitch.put("from_app_id", event.metrics["from_app_id"] ?: "")
-                appSwitch.put("to_app_id", event.metrics["to_app_id"] ?: "")
-                fluxEvent.put("app_switch", appSwitch)
+            // Include session boundaries if available
+            val startAt = event.metrics["start_at"]
+            if (startAt != null) {
+                typing.put("start_at", startAt.toString())
             }
-            "clipboard" -> {
-                // Clipboard events are tracked separately, not sent to Flux
-                // Skip this event in Flux JSON conversion
-                continue@eventLoop
+            val endAt = event.metrics["end_at"]
+            if (endAt != null) {
+                typing.put("end_at", endAt.toString())
             }
+            // Correction and clipboard counts for Flux (correction_rate, clipboard_activity_rate)
+            val backspaceCount = event.metrics["backspace_count"]
+            typing.put(
+                "number_of_backspace",
+                when (backspaceCount) {
+                    is Number -> backspaceCount.toInt()
+                    is String -> backspaceCount.toIntOrNull() ?: 0
+                    else -> 0
+                }
+            )
+            typing.put("number_of_delete", 0)
+            val numberOfCopy = event.metrics["number_of_copy"]
+            typing.put(
+                "number_of_copy",
+                when (numberOfCopy) {
+                    is Number -> numberOfCopy.toInt()
+                    is String -> numberOfCopy.toIntOrNull() ?: 0
+                    else -> 0
+                }
+            )
+            val numberOfPaste = event.metrics["number_of_paste"]
+            typing.put(
+                "number_of_paste",
+                when (numberOfPaste) {
+                    is Number -> numberOfPaste.toInt()
+                    is String -> numberOfPaste.toIntOrNull() ?: 0
+                    else -> 0
+                }
+            )
+            val numberOfCut = event.metrics["number_of_cut"]
+            typing.put(
+                "number_of_cut",
+                when (numberOfCut) {
+                    is Number -> numberOfCut.toInt()
+                    is String -> numberOfCut.toIntOrNull() ?: 0
+                    else -> 0
+                }
+            )
+            fluxEvent.put("typing", typing)
+        }
+        "app_switch" -> {
+            val appSwitch = JSONObject()
+            appSwitch.put("from_app_id", event.metrics["from_app_id"] ?: "")
+            appSwitch.put("to_app_id", event.metrics["to_app_id"] ?: "")
+            fluxEvent.put("app_switch", appSwitch)
+        }
+        "clipboard" -> {
+            // Clipboard events are tracked separately, not sent to Flux
+            // Skip this event in Flux JSON conversion
+            return null
         }
-
-        fluxEvents.put(fluxEvent)
     }
 
-    // DEBUG: Log what we're sending to Flux
-    android.util.Log.d("FluxBridge", "=== CONVERTING TO FLUX JSON ===")
-    android.util.Log.d("FluxBridge", "Total scroll events being sent: $scrollEventCount")
-    android.util.Log.d("FluxBridge", "  - With reversal=true: $scrollEventsWithReversal")
-    android.util.Log.d("FluxBridge", "  - With reversal=false: $scrollEventsWithoutReversal")
-    android.util.Log.d(
-            "FluxBridge",
-            "  - Without direction_reversal field: $scrollEventsWithoutScrollData"
-    )
-    android.util.Log.d("FluxBridge", "=== END CONVERSION DEBUG ===")
+    return fluxEvent
+}
 
+/**
+ * Build a synheart-flux session JSON around an already serialized events array body (comma
+ * separated event objects, without brackets). Lets callers that keep events serialized
+ * incrementally avoid re-encoding the whole session.
+ */
+fun buildFluxSessionJson(
+    sessionId: String,
+    deviceId: String,
+    timezone: String,
+    startTimeMs: Long,
+    endTimeMs: Long,
+    serializedEvents: CharSequence
+): String {
     val session = JSONObject()
     session.put("session_id", sessionId)
     session.put("device_id", deviceId)
     session.put("timezone", timezone)
     session.put("start_time", Instant.ofEpochMilli(startTimeMs).toString())
     session.put("end_time", Instant.ofEpochMilli(endTimeMs).toString())
-    session.put("events", fluxEvents)
 
-    return session.toString()
+    val header = JsonCodec.toJson(session)
+    val json = StringBuilder(header.length + serializedEvents.length + 16)
+    json.append(header, 0, header.length - 1)
+    json.append(",\"events\":[").append(serializedEvents).append("]}")
+    return json.toString()
 }
 
 /** Extract behavioral metrics from HSI JSON in the format expected by the SDK. */
 fun extractBehavioralMetricsFromHsi(hsiJson: String): Map<String, Any>? {
     return try {
-        val hsi = JSONObject(hsiJson)
+        val hsi = JsonCodec.parseObject(hsiJson)
 
         // HSI 1.0 format: axes.behavior.readings array
         val axes = hsi.optJSONObject("axes") ?: return null
@@ -1,12 +1,17 @@
 package ai.synheart.behavior
 
+import android.os.Build
 import android.os.Handler
 import android.os.Looper
+import android.view.KeyboardShortcutGroup
+import android.view.Menu
 import android.view.MotionEvent
 import android.view.VelocityTracker
 import android.view.View
 import android.view.ViewTreeObserver
+import android.view.Window
 import android.widget.ScrollView
+import androidx.annotation.RequiresApi
 import androidx.core.widget.NestedScrollView
 import androidx.recyclerview.widget.RecyclerView
 import java.time.Instant
@@ -21,6 +26,7 @@ import kotlin.math.sqrt
 class GestureCollector(private var config: BehaviorConfig) {
 
     private var eventHandler: ((BehaviorEvent) -> Unit)? = null
+    private var touchHandler: (() -> Unit)? = null
 
     // Scroll tracking - wait until scroll stops before calculating
     private var scrollStartTime = 0L
@@ -64,10 +70,21 @@ class GestureCollector(private var config: BehaviorConfig) {
                 false // Don't consume the event
             }
 
+    // Window-level touch interception (see attachToWindow)
+    private var window: Window? = null
+    private var touchInterceptor: TouchInterceptor? = null
+    private val touchHookLatency = LatencyHistogram()
+    private var windowAttachNanos = 0L
+
     fun setEventHandler(handler: (BehaviorEvent) -> Unit) {
         this.eventHandler = handler
     }
 
+    /** Called on every touch down seen by the window hook, for interaction timing. */
+    fun setTouchHandler(handler: () -> Unit) {
+        this.touchHandler = handler
+    }
+
     fun attachToView(view: View) {
         if (!config.enableInputSignals) {
             android.util.Log.d("GestureCollector", "Input signals disabled, not attaching")
@@ -96,6 +113,50 @@ class GestureCollector(private var config: BehaviorConfig) {
         }
     }
 
+    /**
+     * Observe every touch in [window] by wrapping its [Window.Callback]. A touch listener on the
+     * root view only sees touches no child handled; the callback sees each event before dispatch,
+     * and attaching costs the same for any hierarchy size. Views added after attaching need no
+     * listener of their own, since their touches pass through the same callback. Events are never
+     * consumed.
+     *
+     * The hook reports touch timing only. Tap, scroll and swipe events come from the Dart
+     * `BehaviorGestureDetector`, so the hook emits them only with
+     * [BehaviorConfig.nativeGestureEvents]; otherwise every gesture would be counted twice.
+     */
+    fun attachToWindow(window: Window) {
+        if (!config.enableInputSignals) {
+            android.util.Log.d("GestureCollector", "Input signals disabled, not attaching")
+            return
+        }
+        val start = System.nanoTime()
+        detachFromWindow()
+        val callback = window.callback ?: return
+        val interceptor = TouchInterceptor(callback)
+        window.callback = interceptor
+        this.window = window
+        touchInterceptor = interceptor
+        windowAttachNanos = System.nanoTime() - start
+    }
+
+    /** Stop observing the window. Its callback is restored unless something wrapped ours since. */
+    fun detachFromWindow() {
+        val window = this.window ?: return
+        val interceptor = touchInterceptor ?: return
+        interceptor.enabled = false // Stays a pass-through if it cannot be unlinked
+        if (window.callback === interceptor) window.callback = interceptor.delegate
+        this.window = null
+        touchInterceptor = null
+    }
+
+    /** Window attach cost and the per-event cost of the touch hook, for performance_info. */
+    fun getAttachStats(): Map<String, Any> =
+            mapOf(
+                    "window_attached" to (window != null),
+                    "window_attach_us" to windowAttachNanos / 1000.0,
+                    "touch_hook" to touchHookLatency.toMap()
+            )
+
     fun updateConfig(newConfig: BehaviorConfig) {
         config = newConfig
     }
@@ -419,8 +480,40 @@ class GestureCollector(private var config: BehaviorConfig) {
     }
 
     fun dispose() {
+        detachFromWindow()
         tapTimestamps.clear()
         velocityTracker?.recycle()
         velocityTracker = null
     }
+
+    /** Forwards everything to [delegate], observing touch events on the way. */
+    private inner class TouchInterceptor(val delegate: Window.Callback) :
+            Window.Callback by delegate {
+        var enabled = true
+
+        override fun dispatchTouchEvent(event: MotionEvent): Boolean {
+            if (enabled) {
+                val start = System.nanoTime()
+                if (event.actionMasked == MotionEvent.ACTION_DOWN) touchHandler?.invoke()
+                if (config.nativeGestureEvents) handleTouchEvent(event)
+                touchHookLatency.record(System.nanoTime() - start)
+            }
+            return delegate.dispatchTouchEvent(event)
+        }
+
+        // Java default methods are not delegated by `by`
+        @RequiresApi(Build.VERSION_CODES.N)
+        override fun onProvideKeyboardShortcuts(
+                data: MutableList<KeyboardShortcutGroup>?,
+                menu: Menu?,
+                deviceId: Int
+        ) {
+            delegate.onProvideKeyboardShortcuts(data, menu, deviceId)
+        }
+
+        @RequiresApi(Build.VERSION_CODES.O)
+        override fun onPointerCaptureChanged(hasCapture: Boolean) {
+            delegate.onPointerCaptureChanged(hasCapture)
+        }
+    }
 }
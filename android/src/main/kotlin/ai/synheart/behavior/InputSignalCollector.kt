@@ -3,7 +3,7 @@ package ai.synheart.behavior
 import android.text.Editable
 import android.text.TextWatcher
 import android.view.View
-import android.view.ViewGroup
+import android.view.ViewTreeObserver
 import android.widget.EditText
 import java.time.Instant
 import java.util.LinkedList
@@ -38,42 +38,74 @@ class InputSignalCollector(private var config: BehaviorConfig) {
                 override fun afterTextChanged(s: Editable?) {}
             }
 
+    // Only the focused EditText carries the text watcher; focus changes move it
+    private var rootView: View? = null
+    private var watchedEditText: EditText? = null
+    private var focusAttaches = 0L
+    private var attachNanos = 0L
+    private val focusListener =
+            ViewTreeObserver.OnGlobalFocusChangeListener { _, newFocus ->
+                watch(newFocus as? EditText)
+            }
+    // Hierarchy changes move focus without a focus change event: a field can be added already
+    // focused, or the watched one removed. Re-read focus after each layout pass, O(depth).
+    private val layoutListener =
+            ViewTreeObserver.OnGlobalLayoutListener {
+                watch(rootView?.findFocus() as? EditText)
+            }
+
     fun setEventHandler(handler: (BehaviorEvent) -> Unit) {
         this.eventHandler = handler
     }
 
+    /**
+     * Track typing in [view]'s window. Text can only change in the focused EditText, so instead of
+     * walking the hierarchy the watcher follows input focus: it is added when an EditText gains
+     * focus and removed when focus leaves. Attaching costs O(depth) for any hierarchy size, and
+     * EditTexts added later (e.g. by a RecyclerView) are covered, including ones that arrive
+     * already focused.
+     */
     fun attachToView(view: View) {
         if (!config.enableInputSignals) {
             android.util.Log.d("InputSignalCollector", "Input signals disabled, not attaching")
             return
         }
 
-        android.util.Log.d(
-                "InputSignalCollector",
-                "Attaching to view: ${view.javaClass.simpleName}"
-        )
-        when (view) {
-            is EditText -> {
-                android.util.Log.d("InputSignalCollector", "Found EditText, attaching text watcher")
-                view.addTextChangedListener(textWatcher)
-            }
-            is ViewGroup -> {
-                android.util.Log.d(
-                        "InputSignalCollector",
-                        "Found ViewGroup with ${view.childCount} children, searching recursively"
-                )
-                // Recursively attach to all EditText children
-                for (i in 0 until view.childCount) {
-                    attachToView(view.getChildAt(i))
-                }
-            }
-            else -> {
-                android.util.Log.d(
-                        "InputSignalCollector",
-                        "View is neither EditText nor ViewGroup, skipping"
-                )
-            }
+        val start = System.nanoTime()
+        detach()
+        view.viewTreeObserver.addOnGlobalFocusChangeListener(focusListener)
+        view.viewTreeObserver.addOnGlobalLayoutListener(layoutListener)
+        rootView = view
+        watch(view.findFocus() as? EditText)
+        attachNanos = System.nanoTime() - start
+    }
+
+    /** Stop following focus and remove the text watcher. */
+    fun detach() {
+        val view = rootView ?: return
+        val observer = view.viewTreeObserver
+        if (observer.isAlive) {
+            observer.removeOnGlobalFocusChangeListener(focusListener)
+            observer.removeOnGlobalLayoutListener(layoutListener)
         }
+        rootView = null
+        watch(null)
+    }
+
+    /** Attach cost and focus-driven watcher moves, for performance_info. */
+    fun getAttachStats(): Map<String, Any> =
+            mapOf(
+                    "attached" to (rootView != null),
+                    "attach_us" to attachNanos / 1000.0,
+                    "focus_attaches" to focusAttaches
+            )
+
+    private fun watch(editText: EditText?) {
+        if (editText === watchedEditText) return
+        watchedEditText?.removeTextChangedListener(textWatcher)
+        editText?.addTextChangedListener(textWatcher)
+        watchedEditText = editText
+        if (editText != null) focusAttaches++
     }
 
     fun updateConfig(newConfig: BehaviorConfig) {
@@ -151,6 +183,7 @@ class InputSignalCollector(private var config: BehaviorConfig) {
     }
 
     fun dispose() {
+        detach()
         keystrokeTimestamps.clear()
     }
 }
@@ -0,0 +1,393 @@
+package ai.synheart.behavior
+
+import java.time.Instant
+import org.json.JSONArray
+import org.json.JSONException
+import org.json.JSONObject
+
+/**
+ * JSON text for the Flux boundary, with numbers through [FastDouble].
+ *
+ * [write] serializes org.json trees as `JSONObject.toString()` does (same key order and string
+ * escapes) but writes doubles as their shortest round-trip decimal into the caller's builder.
+ * [parseObject] builds the same org.json tree as `JSONObject(String)` from strict JSON: integers
+ * become Int or Long and other numbers Double, parsed with [FastDouble.parse].
+ */
+object JsonCodec {
+
+    fun toJson(value: Any?): String = StringBuilder(256).also { write(value, it) }.toString()
+
+    fun write(value: Any?, out: StringBuilder) {
+        when (value) {
+            null, JSONObject.NULL -> out.append("null")
+            is JSONObject -> {
+                out.append('{')
+                var first = true
+                for (key in value.keys()) {
+                    if (!first) out.append(',')
+                    first = false
+                    writeString(key, out)
+                    out.append(':')
+                    write(value.opt(key), out)
+                }
+                out.append('}')
+            }
+            is JSONArray -> {
+                out.append('[')
+                for (i in 0 until value.length()) {
+                    if (i > 0) out.append(',')
+                    write(value.opt(i), out)
+                }
+                out.append(']')
+            }
+            is String -> writeString(value, out)
+            is Boolean -> out.append(value)
+            is Double -> FastDouble.append(value, out)
+            is Int, is Long, is Short, is Byte -> out.append((value as Number).toLong())
+            is Number -> out.append(JSONObject.numberToString(value))
+            else -> writeString(value.toString(), out)
+        }
+    }
+
+    /** Parse a JSON object. Throws [JSONException] on anything but one well-formed object. */
+    fun parseObject(text: String): JSONObject =
+            parse(text) as? JSONObject ?: throw JSONException("Not a JSON object")
+
+    /** Parse one JSON value into org.json types. */
+    fun parse(text: String): Any {
+        val reader = Reader(text)
+        val value = reader.readValue()
+        reader.skipWhitespace()
+        if (reader.position != text.length) throw reader.error("Trailing characters")
+        return value
+    }
+
+    private fun writeString(value: String, out: StringBuilder) {
+        out.append('"')
+        var run = 0 // Start of the pending unescaped run
+        for (i in value.indices) {
+            val c = value[i]
+            val escape =
+                    when (c) {
+                        '"', '\\', '/' -> null
+                        '\t' -> "\\t"
+                        '\b' -> "\\b"
+                        '\n' -> "\\n"
+                        '\r' -> "\\r"
+                        '\u000c' -> "\\f"
+                        else -> if (c.code <= 0x1f) "" else continue
+                    }
+            out.append(value, run, i)
+            when {
+                escape == null -> out.append('\\').append(c)
+                escape.isEmpty() -> {
+                    out.append("\\u00").append(HEX[c.code shr 4]).append(HEX[c.code and 0xf])
+                }
+                else -> out.append(escape)
+            }
+            run = i + 1
+        }
+        out.append(value, run, value.length).append('"')
+    }
+
+    private class Reader(private val text: String) {
+        var position = 0
+
+        fun readValue(): Any {
+            skipWhitespace()
+            if (position >= text.length) throw error("Unexpected end of input")
+            return when (val c = text[position]) {
+                '{' -> readObject()
+                '[' -> readArray()
+                '"' -> readString()
+                't' -> readLiteral("true", true)
+                'f' -> readLiteral("false", false)
+                'n' -> readLiteral("null", JSONObject.NULL)
+                '-', in '0'..'9' -> readNumber()
+                else -> throw error("Unexpected $c")
+            }
+        }
+
+        private fun readObject(): JSONObject {
+            val result = JSONObject()
+            position++
+            skipWhitespace()
+            if (peek() == '}') {
+                position++
+                return result
+            }
+            while (true) {
+                skipWhitespace()
+                if (peek() != '"') throw error("Expected a key")
+                val key = readString()
+                skipWhitespace()
+                expect(':')
+                result.put(key, readValue())
+                skipWhitespace()
+                when (next()) {
+                    ',' -> continue
+                    '}' -> return result
+                    else -> throw error("Expected , or }")
+                }
+            }
+        }
+
+        private fun readArray(): JSONArray {
+            val result = JSONArray()
+            position++
+            skipWhitespace()
+            if (peek() == ']') {
+                position++
+                return result
+            }
+            while (true) {
+                result.put(readValue())
+                skipWhitespace()
+                when (next()) {
+                    ',' -> continue
+                    ']' -> return result
+                    else -> throw error("Expected , or ]")
+                }
+            }
+        }
+
+        private fun readString(): String {
+            position++ // Opening quote
+            val start = position
+            // Fast path: no escapes
+            while (position < text.length) {
+                val c = text[position]
+                if (c == '"') return text.substring(start, position++)
+                if (c == '\\') break
+                if (c < ' ') throw error("Control character in string")
+                position++
+            }
+            val builder = StringBuilder(position - start + 16).append(text, start, position)
+            while (position < text.length) {
+                val c = text[position++]
+                when (c) {
+                    '"' -> return builder.toString()
+                    '\\' -> {
+                        when (val escaped = next()) {
+                            'b' -> builder.append('\b')
+                            'f' -> builder.append('\u000c')
+                            'n' -> builder.append('\n')
+                            'r' -> builder.append('\r')
+                            't' -> builder.append('\t')
+                            'u' -> {
+                                if (position + 4 > text.length) throw error("Bad escape")
+                                // Exactly four ASCII hex digits, no sign
+                                var code = 0
+                                repeat(4) {
+                                    val digit =
+                                            when (val h = text[position++]) {
+                                                in '0'..'9' -> h - '0'
+                                                in 'a'..'f' -> h - 'a' + 10
+                                                in 'A'..'F' -> h - 'A' + 10
+                                                else -> throw error("Bad escape")
+                                            }
+                                    code = code * 16 + digit
+                                }
+                                builder.append(code.toChar())
+                            }
+                            '"', '\\', '/' -> builder.append(escaped)
+                            else -> throw error("Bad escape")
+                        }
+                    }
+                    else -> {
+                        if (c < ' ') throw error("Control character in string")
+                        builder.append(c)
+                    }
+                }
+            }
+            throw error("Unterminated string")
+        }
+
+        private fun readNumber(): Any {
+            val start = position
+            var integral = true
+            while (position < text.length) {
+                val c = text[position]
+                if (c == '.' || c == 'e' || c == 'E') {
+                    integral = false
+                } else if (c != '-' && c != '+' && c !in '0'..'9') {
+                    break
+                }
+                position++
+            }
+            // No leading zeros: "0" alone, or followed by a fraction or exponent
+            val digitsStart = if (text[start] == '-') start + 1 else start
+            if (digitsStart + 1 < position &&
+                            text[digitsStart] == '0' &&
+                            text[digitsStart + 1] in '0'..'9'
+            ) {
+                throw error("Bad number")
+            }
+            try {
+                // Same types as org.json: Int when it fits, then Long, else Double
+                if (integral && position - start <= 18) {
+                    val value = text.substring(start, position).toLong()
+                    return if (value in Int.MIN_VALUE..Int.MAX_VALUE) value.toInt() else value
+                }
+                if (integral) text.substring(start, position).toLongOrNull()?.let { return it }
+                return FastDouble.parse(text, start, position)
+            } catch (e: NumberFormatException) {
+                throw error("Bad number")
+            }
+        }
+
+        private fun readLiteral(literal: String, value: Any): Any {
+            if (!text.startsWith(literal, position)) throw error("Unexpected literal")
+            position += literal.length
+            return value
+        }
+
+        fun skipWhitespace() {
+            while (position < text.length) {
+                val c = text[position]
+                if (c != ' ' && c != '\n' && c != '\r' && c != '\t') return
+                position++
+            }
+        }
+
+        private fun peek(): Char = if (position < text.length) text[position] else '\u0000'
+
+        private fun next(): Char {
+            if (position >= text.length) throw error("Unexpected end of input")
+            return text[position++]
+        }
+
+        private fun expect(c: Char) {
+            if (next() != c) throw error("Expected $c")
+        }
+
+        fun error(message: String) = JSONException("$message at character $position")
+    }
+
+    /**
+     * Throughput of the Flux boundary on a representative session: [events] generated events
+     * serialized with `JSONObject.toString()` and with [write], the result parsed back with
+     * `JSONObject(String)` and [parseObject], plus the number kernels alone against
+     * `Double.toString` and `Double.parseDouble` on the session's doubles. The HSI Flux computes
+     * for the session is timed too when the library is available. Each path runs five times after
+     * a warm-up and the best run counts. Also counts doubles that do not round-trip.
+     */
+    fun benchmark(events: Int): Map<String, Any> {
+        val session = benchmarkSession(events)
+        val doubles = ArrayList<Double>()
+        collectDoubles(session, doubles)
+        val platformText = session.toString()
+        val fastText = toJson(session)
+        val hsiJson = if (FluxBridge.isAvailable()) FluxBridge.behaviorToHsi(fastText) else null
+
+        fun best(block: () -> Unit): Long {
+            block()
+            var best = Long.MAX_VALUE
+            repeat(BENCHMARK_RUNS) {
+                val start = System.nanoTime()
+                block()
+                best = minOf(best, System.nanoTime() - start)
+            }
+            return best
+        }
+        fun mbPerSecond(chars: Int, nanos: Long) = chars / 1e6 / (maxOf(nanos, 1L) / 1e9)
+        fun nsPerValue(nanos: Long) = nanos.toDouble() / maxOf(doubles.size, 1)
+        fun codec(text: String): Map<String, Any> {
+            val platformParse = best { JSONObject(text) }
+            val fastParse = best { parseObject(text) }
+            return mapOf(
+                    "chars" to text.length,
+                    "platform_parse_mb_s" to mbPerSecond(text.length, platformParse),
+                    "fast_parse_mb_s" to mbPerSecond(text.length, fastParse)
+            )
+        }
+
+        val platformWrite = best { session.toString() }
+        val fastWrite = best { toJson(session) }
+        val strings = doubles.map { FastDouble.toString(it) }
+        val platformFormat = best {
+            val builder = StringBuilder()
+            for (d in doubles) builder.append(d)
+        }
+        val fastFormat = best {
+            val builder = StringBuilder()
+            for (d in doubles) FastDouble.append(d, builder)
+        }
+        var sink = 0.0
+        val platformNumberParse = best { for (s in strings) sink += s.toDouble() }
+        val fastNumberParse = best { for (s in strings) sink += FastDouble.parse(s) }
+
+        val results = LinkedHashMap<String, Any>()
+        results["events"] = events
+        results["doubles"] = doubles.size
+        results["flux_session"] =
+                codec(fastText) +
+                        mapOf(
+                                "platform_chars" to platformText.length,
+                                "platform_write_mb_s" to
+                                        mbPerSecond(platformText.length, platformWrite),
+                                "fast_write_mb_s" to mbPerSecond(fastText.length, fastWrite)
+                        )
+        if (hsiJson != null) results["hsi"] = codec(hsiJson)
+        results["double_format_ns"] =
+                mapOf("platform" to nsPerValue(platformFormat), "fast" to nsPerValue(fastFormat))
+        results["double_parse_ns"] =
+                mapOf(
+                        "platform" to nsPerValue(platformNumberParse),
+                        "fast" to nsPerValue(fastNumberParse)
+                )
+        results["round_trip_mismatches"] =
+                doubles.indices.count { FastDouble.parse(strings[it]) != doubles[it] }
+        results["text_round_trip"] = toJson(parseObject(fastText)) == fastText
+        results["checksum"] = sink
+        return results
+    }
+
+    /** A Flux session of generated scroll, typing, notification and app switch events. */
+    private fun benchmarkSession(events: Int): JSONObject {
+        val generator = WorkloadGenerator(WorkloadGenerator.Workload(seed = 42L))
+        val fluxEvents = JSONArray()
+        var count = 0
+        val sink =
+                object : WorkloadGenerator.Sink {
+                    override fun onEvent(eventType: String, metrics: Map<String, Any>) {
+                        if (count >= events) return
+                        val timestamp = Instant.ofEpochMilli(generator.virtualMs).toString()
+                        val event =
+                                BehaviorEvent(
+                                        sessionId = "benchmark",
+                                        timestamp = timestamp,
+                                        eventType = eventType,
+                                        metrics = metrics
+                                )
+                        convertEventToFluxJson(event)?.let { fluxEvents.put(it) }
+                        count++
+                    }
+
+                    override fun onMotionSample(sensorType: Int, values: FloatArray) {}
+                }
+        var virtualMs = 0L
+        while (count < events) {
+            virtualMs += 60_000L
+            generator.advanceTo(virtualMs, sink)
+        }
+        return JSONObject()
+                .put("session_id", "benchmark")
+                .put("device_id", "android-device")
+                .put("timezone", "UTC")
+                .put("start_time", Instant.EPOCH.toString())
+                .put("end_time", Instant.ofEpochMilli(virtualMs).toString())
+                .put("events", fluxEvents)
+    }
+
+    private fun collectDoubles(value: Any?, into: MutableList<Double>) {
+        when (value) {
+            is JSONObject -> for (key in value.keys()) collectDoubles(value.opt(key), into)
+            is JSONArray -> for (i in 0 until value.length()) collectDoubles(value.opt(i), into)
+            is Double -> into.add(value)
+        }
+    }
+
+    private const val BENCHMARK_RUNS = 5
+    private val HEX = "0123456789abcdef".toCharArray()
+}
@@ -0,0 +1,98 @@
+package ai.synheart.behavior
+
+import java.util.concurrent.atomic.AtomicLong
+import java.util.concurrent.atomic.AtomicLongArray
+
+/**
+ * Lock-free histogram of durations, safe to record from any thread.
+ *
+ * Buckets are in microseconds: exact below 4 µs, then four per power of two. A quantile is
+ * reported as the upper bound of the bucket holding it, so it overstates by at most 25%.
+ */
+class LatencyHistogram {
+    private val count = AtomicLong()
+    private val totalNanos = AtomicLong()
+    private val maxNanos = AtomicLong()
+    private val buckets = AtomicLongArray(BUCKETS)
+
+    fun record(nanos: Long) {
+        count.incrementAndGet()
+        totalNanos.addAndGet(nanos)
+        var max = maxNanos.get()
+        while (nanos > max && !maxNanos.compareAndSet(max, nanos)) max = maxNanos.get()
+        buckets.incrementAndGet(bucketOf(nanos / 1000))
+    }
+
+    val size: Long
+        get() = count.get()
+
+    fun averageMicros(): Double {
+        val total = count.get()
+        return if (total > 0) totalNanos.get() / 1000.0 / total else 0.0
+    }
+
+    fun maxMicros(): Double = maxNanos.get() / 1000.0
+
+    /** Upper bound (µs) of the bucket holding quantile [q]. */
+    fun quantileMicros(q: Double): Long {
+        val total = count.get()
+        if (total == 0L) return 0L
+        val target = (total * q).toLong().coerceAtLeast(1L)
+        var seen = 0L
+        for (bucket in 0 until BUCKETS) {
+            seen += buckets.get(bucket)
+            if (seen >= target) return upperBoundMicros(bucket)
+        }
+        return upperBoundMicros(BUCKETS - 1)
+    }
+
+    /** Bucket counts. The difference of two calls gives the quantiles of the interval between. */
+    fun counts(): LongArray = LongArray(BUCKETS) { buckets.get(it) }
+
+    fun reset() {
+        count.set(0)
+        totalNanos.set(0)
+        maxNanos.set(0)
+        for (bucket in 0 until BUCKETS) buckets.set(bucket, 0)
+    }
+
+    fun toMap(): Map<String, Any> =
+            mapOf(
+                    "count" to count.get(),
+                    "avg_us" to averageMicros(),
+                    "p50_us" to quantileMicros(0.50),
+                    "p95_us" to quantileMicros(0.95),
+                    "p99_us" to quantileMicros(0.99),
+                    "max_us" to maxMicros()
+            )
+
+    companion object {
+        private const val BUCKETS = 128 // Covers durations up to ~70 minutes
+
+        /** Upper bound (µs) of the bucket holding quantile [q] of [counts]; 0 when empty. */
+        fun quantileMicros(counts: LongArray, q: Double): Long {
+            val total = counts.sum()
+            if (total == 0L) return 0L
+            val target = (total * q).toLong().coerceAtLeast(1L)
+            var seen = 0L
+            for (bucket in counts.indices) {
+                seen += counts[bucket]
+                if (seen >= target) return upperBoundMicros(bucket)
+            }
+            return upperBoundMicros(counts.size - 1)
+        }
+
+        private fun bucketOf(micros: Long): Int {
+            if (micros < 4) return maxOf(micros, 0L).toInt()
+            val msb = 63 - java.lang.Long.numberOfLeadingZeros(micros)
+            val sub = (micros shr (msb - 2)).toInt() and 3
+            return minOf((msb - 1) * 4 + sub, BUCKETS - 1)
+        }
+
+        private fun upperBoundMicros(bucket: Int): Long {
+            if (bucket < 4) return bucket + 1L
+            val msb = bucket / 4 + 1
+            return (5L + bucket % 4) shl (msb - 2)
+        }
+    }
+}
@@ -0,0 +1,160 @@
+package ai.synheart.behavior
+
+import java.time.Instant
+
+/**
+ * Rolling session state for live HSI snapshots.
+ *
+ * Each event is converted to its Flux JSON form once, when it arrives, and appended to a
+ * serialized events buffer; interruption and clipboard counters are updated in place, so the
+ * counters in a snapshot cost O(new events).
+ *
+ * Flux has no incremental entry point: scoring re-reads the whole session, O(session) per run.
+ * Snapshots therefore rescore only once the session has grown by a tenth since the last Flux run
+ * and reuse the previous metrics otherwise. Total Flux input stays within about 11× the final
+ * session, however short the snapshot interval; `metrics_event_count` says which events the
+ * metrics cover.
+ */
+class LiveSnapshotScorer(
+        private val sessionId: String,
+        private val startTimeMs: Long,
+        private val deviceId: String = "android-device",
+        private val timezone: String = java.util.TimeZone.getDefault().id
+) {
+    private val serializedEvents = StringBuilder()
+    private var fluxEventCount = 0
+
+    // Rolling counters (same definitions as the endSession summary)
+    private var eventCount = 0
+    private var notificationCount = 0
+    private var notificationIgnored = 0
+    private var notificationOpened = 0
+    private var callCount = 0
+    private var callIgnored = 0
+    private var clipboardCount = 0
+
+    // Snapshot bookkeeping
+    private var snapshotIndex = 0
+    private var eventCountAtLastSnapshot = 0
+
+    // Last Flux result, reused until the session has grown enough to rescore
+    private var fluxMetrics: Map<String, Any>? = null
+    private var fluxEventCountAtLastScore = 0
+    private var metricsEventCount = 0
+
+    /** Fold a new session event into the rolling state. O(1) per event. */
+    @Synchronized
+    fun append(event: BehaviorEvent) {
+        eventCount++
+        when (event.eventType) {
+            "notification" -> {
+                notificationCount++
+                when (event.metrics["action"]) {
+                    "ignored" -> notificationIgnored++
+                    "opened" -> notificationOpened++
+                }
+            }
+            "call" -> {
+                callCount++
+                if (event.metrics["action"] == "ignored") callIgnored++
+            }
+            "clipboard" -> clipboardCount++
+        }
+
+        val fluxEvent = convertEventToFluxJson(event) ?: return
+        if (fluxEventCount > 0) serializedEvents.append(',')
+        JsonCodec.write(fluxEvent, serializedEvents)
+        fluxEventCount++
+    }
+
+    /**
+     * Build a snapshot of the session up to [nowMs], or null if nothing arrived since the last
+     * snapshot (the previous snapshot is still current).
+     */
+    @Synchronized
+    fun snapshot(nowMs: Long): Map<String, Any>? {
+        val newEvents = eventCount - eventCountAtLastSnapshot
+        if (newEvents == 0 && snapshotIndex > 0) return null
+
+        val computeStart = System.nanoTime()
+        val growth = fluxEventCount - fluxEventCountAtLastScore
+        val rescore =
+                FluxBridge.isAvailable() &&
+                        (fluxMetrics == null ||
+                                growth >= maxOf(1, fluxEventCountAtLastScore / RESCORE_GROWTH))
+        if (rescore) {
+            val scored =
+                    try {
+                        val fluxJson =
+                                buildFluxSessionJson(
+                                        sessionId = sessionId,
+                                        deviceId = deviceId,
+                                        timezone = timezone,
+                                        startTimeMs = startTimeMs,
+                                        endTimeMs = nowMs,
+                                        serializedEvents = serializedEvents
+                                )
+                        FluxBridge.behaviorToHsi(fluxJson)?.let {
+                            extractBehavioralMetricsFromHsi(it)
+                        }
+                    } catch (e: Exception) {
+                        android.util.Log.w(
+                                "LiveSnapshotScorer",
+                                "Snapshot scoring failed: ${e.message}"
+                        )
+                        null
+                    }
+            if (scored != null) {
+                fluxMetrics = scored
+                fluxEventCountAtLastScore = fluxEventCount
+                metricsEventCount = eventCount
+            }
+        }
+        val computeTimeMs = (System.nanoTime() - computeStart) / 1_000_000
+
+        eventCountAtLastSnapshot = eventCount
+        snapshotIndex++
+
+        val notificationIgnoreRate =
+                if (notificationCount > 0) {
+                    notificationIgnored.toDouble() / notificationCount
+                } else {
+                    0.0
+                }
+
+        val snapshot =
+                mutableMapOf<String, Any>(
+                        "session_id" to sessionId,
+                        "snapshot_index" to snapshotIndex,
+                        "start_at" to Instant.ofEpochMilli(startTimeMs).toString(),
+                        "end_at" to Instant.ofEpochMilli(nowMs).toString(),
+                        "event_count" to eventCount,
+                        "new_event_count" to newEvents,
+                        "notification_summary" to
+                                mapOf(
+                                        "notification_count" to notificationCount,
+                                        "notification_ignored" to notificationIgnored,
+                                        "notification_opened" to notificationOpened,
+                                        "notification_ignore_rate" to notificationIgnoreRate,
+                                        "call_count" to callCount,
+                                        "call_ignored" to callIgnored
+                                ),
+                        "clipboard_count" to clipboardCount,
+                        "performance_info" to
+                                mapOf(
+                                        "snapshot_compute_time_ms" to computeTimeMs,
+                                        "flux_rescored" to rescore
+                                )
+                )
+        fluxMetrics?.let {
+            snapshot["behavioral_metrics"] = it
+            snapshot["metrics_event_count"] = metricsEventCount
+        }
+        return snapshot
+    }
+
+    private companion object {
+        // Rescore once the Flux events have grown by 1/RESCORE_GROWTH since the last score
+        const val RESCORE_GROWTH = 10
+    }
+}
@@ -0,0 +1,95 @@
+package ai.synheart.behavior
+
+import kotlin.math.abs
+import kotlin.math.exp
+import kotlin.math.sqrt
+
+/**
+ * Stage 1 of the motion state cascade.
+ *
+ * Classifies a window from two cheap time-domain features before any of the 561 UCI-HAR features
+ * are computed:
+ * - the standard deviation of the body-acceleration magnitude (m/s²), and
+ * - the flatness of the device, |mean gravity Z| / |mean gravity|.
+ *
+ * Each rule maps its feature through a logistic curve so the result reads as a probability. A
+ * window exits early only when that probability reaches [threshold]. Everything else falls through
+ * to full feature extraction and the SVC model. Only the trivially separable classes are decided
+ * here: MOVING (high body-acceleration variance) and LAYING (still, with the screen facing up or
+ * down). SITTING and STANDING always fall through.
+ */
+class MotionCascadeClassifier(private val threshold: Float) {
+
+    /** Early-exit label (model label set, uppercase) and its stage 1 confidence in [0, 1]. */
+    data class Decision(val label: String, val confidence: Float)
+
+    /**
+     * Decide the window from the body and gravity acceleration, or return null to fall through to
+     * the full model.
+     */
+    fun classify(
+            bodyAccX: FloatArray,
+            bodyAccY: FloatArray,
+            bodyAccZ: FloatArray,
+            gravityAccX: FloatArray,
+            gravityAccY: FloatArray,
+            gravityAccZ: FloatArray
+    ): Decision? {
+        val n = bodyAccX.size
+        if (n < MIN_SAMPLES || gravityAccX.size < MIN_SAMPLES) return null
+
+        // Body-acceleration magnitude std (one pass, double accumulators)
+        var sum = 0.0
+        var sumSq = 0.0
+        for (i in 0 until n) {
+            val x = bodyAccX[i].toDouble()
+            val y = bodyAccY[i].toDouble()
+            val z = bodyAccZ[i].toDouble()
+            val magnitude = sqrt(x * x + y * y + z * z)
+            sum += magnitude
+            sumSq += magnitude * magnitude
+        }
+        val mean = sum / n
+        val magnitudeStd = sqrt(maxOf(0.0, sumSq / n - mean * mean))
+
+        val moving = logistic((magnitudeStd - MOVING_STD) / MOVING_SCALE)
+        if (moving >= threshold) return Decision("MOVING", moving.toFloat())
+
+        // Device flatness from the mean gravity vector
+        var gx = 0.0
+        var gy = 0.0
+        var gz = 0.0
+        for (i in gravityAccX.indices) {
+            gx += gravityAccX[i]
+            gy += gravityAccY[i]
+            gz += gravityAccZ[i]
+        }
+        val gravityNorm = sqrt(gx * gx + gy * gy + gz * gz)
+        if (gravityNorm == 0.0) return null
+        val flatness = abs(gz) / gravityNorm
+
+        val still = 1.0 - logistic((magnitudeStd - STILL_STD) / STILL_SCALE)
+        val flat = logistic((flatness - FLAT_COS) / FLAT_SCALE)
+        val laying = still * flat
+        if (laying >= threshold) return Decision("LAYING", laying.toFloat())
+
+        return null
+    }
+
+    private fun logistic(x: Double): Double = 1.0 / (1.0 + exp(-x))
+
+    companion object {
+        // At least one second of samples at 50Hz before stage 1 will decide a window
+        private const val MIN_SAMPLES = 50
+
+        // Logistic midpoints and scales, set so that the curves pass through the midpoints at 0.5.
+        // Walking gives a magnitude std of ~2 m/s² or more; a phone resting on a surface stays
+        // under 0.1 m/s²
+        private const val MOVING_STD = 1.0
+        private const val MOVING_SCALE = 0.15
+        private const val STILL_STD = 0.3
+        private const val STILL_SCALE = 0.05
+        private const val FLAT_COS = 0.9 // cos(~26°) between gravity and the device Z axis
+        private const val FLAT_SCALE = 0.02
+    }
+}
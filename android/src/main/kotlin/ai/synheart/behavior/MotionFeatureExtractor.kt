@@ -3,16 +3,24 @@ package ai.synheart.behavior
 import kotlin.math.*
 
 // Type aliases for nested Triple structure
-typealias Triple3D = Triple<List<Double>, List<Double>, List<Double>>
+typealias Triple3D = Triple<FloatArray, FloatArray, FloatArray>
 
 typealias GravityResult = Pair<Triple3D, Triple3D>
 
 /**
  * Extracts 561 ML features from raw accelerometer and gyroscope data. Based on HAR (Human Activity
  * Recognition) feature set.
+ *
+ * The pipeline is float32 end to end, matching the sensor data and the Float32 input of the
+ * motion model; reductions accumulate in double where cancellation would otherwise dominate.
  */
 class MotionFeatureExtractor {
 
+    // Clipped band ranges keyed by spectrum length (see bandBounds)
+    private val bandBoundsCache = HashMap<Int, IntArray>()
+    // FFT twiddle factors keyed by transform size (see twiddles)
+    private val twiddleCache = HashMap<Int, FloatArray>()
+
     /**
      * Extract all 561 features from raw sensor data in a 5-second window.
      *
@@ -25,15 +33,13 @@ class MotionFeatureExtractor {
      * @return Map of feature names to values (561 features total)
      */
     fun extractFeatures(
-            accelX: List<Double>,
-            accelY: List<Double>,
-            accelZ: List<Double>,
-            gyroX: List<Double>,
-            gyroY: List<Double>,
-            gyroZ: List<Double>
-    ): Map<String, Double> {
-        val features = mutableMapOf<String, Double>()
-
+            accelX: FloatArray,
+            accelY: FloatArray,
+            accelZ: FloatArray,
+            gyroX: FloatArray,
+            gyroY: FloatArray,
+            gyroZ: FloatArray
+    ): Map<String, Float> {
         if (accelX.isEmpty() || gyroX.isEmpty()) {
             // Return zeros for all features if no data
             return generateEmptyFeatures()
@@ -43,12 +49,40 @@ class MotionFeatureExtractor {
         val gravityResult: GravityResult = separateGravity(accelX, accelY, accelZ)
         val bodyAcc: Triple3D = gravityResult.first
         val gravityAcc: Triple3D = gravityResult.second
-        val bodyAccX: List<Double> = bodyAcc.first
-        val bodyAccY: List<Double> = bodyAcc.second
-        val bodyAccZ: List<Double> = bodyAcc.third
-        val gravityAccX: List<Double> = gravityAcc.first
-        val gravityAccY: List<Double> = gravityAcc.second
-        val gravityAccZ: List<Double> = gravityAcc.third
+        return extractFeatures(
+                bodyAcc.first,
+                bodyAcc.second,
+                bodyAcc.third,
+                gravityAcc.first,
+                gravityAcc.second,
+                gravityAcc.third,
+                gyroX,
+                gyroY,
+                gyroZ
+        )
+    }
+
+    /**
+     * Extract all 561 features from body and gravity acceleration that were already separated,
+     * e.g. by the platform's fused TYPE_LINEAR_ACCELERATION / TYPE_GRAVITY sensors. Skips the
+     * software low-pass stage of the raw-accelerometer overload.
+     */
+    fun extractFeatures(
+            bodyAccX: FloatArray,
+            bodyAccY: FloatArray,
+            bodyAccZ: FloatArray,
+            gravityAccX: FloatArray,
+            gravityAccY: FloatArray,
+            gravityAccZ: FloatArray,
+            gyroX: FloatArray,
+            gyroY: FloatArray,
+            gyroZ: FloatArray
+    ): Map<String, Float> {
+        val features = LinkedHashMap<String, Float>(FEATURE_MAP_CAPACITY)
+
+        if (bodyAccX.isEmpty() || gyroX.isEmpty()) {
+            return generateEmptyFeatures()
+        }
 
         // Step 2: Calculate jerk (derivative) for acceleration and gyroscope
         val bodyAccJerkX = calculateJerk(bodyAccX)
@@ -163,10 +197,10 @@ class MotionFeatureExtractor {
      * Separate gravity from body acceleration using low-pass filter. Gravity is the low-frequency
      * component, body is the high-frequency component.
      */
-    private fun separateGravity(
-            accelX: List<Double>,
-            accelY: List<Double>,
-            accelZ: List<Double>
+    fun separateGravity(
+            accelX: FloatArray,
+            accelY: FloatArray,
+            accelZ: FloatArray
     ): GravityResult {
         // Simple low-pass filter: moving average with window size 10
         // Gravity = low-pass filtered signal
@@ -174,11 +208,9 @@ class MotionFeatureExtractor {
         val windowSize = minOf(10, accelX.size / 2)
         if (windowSize < 2) {
             // If too few samples, return original as body, zero as gravity
-            val zeroX: List<Double> = List(accelX.size) { 0.0 }
-            val zeroY: List<Double> = List(accelY.size) { 0.0 }
-            val zeroZ: List<Double> = List(accelZ.size) { 0.0 }
             val bodyTriple = Triple(accelX, accelY, accelZ)
-            val gravityTriple = Triple(zeroX, zeroY, zeroZ)
+            val gravityTriple =
+                    Triple(FloatArray(accelX.size), FloatArray(accelY.size), FloatArray(accelZ.size))
             return Pair(bodyTriple, gravityTriple)
         }
 
@@ -186,68 +218,70 @@ class MotionFeatureExtractor {
         val gravityY = movingAverage(accelY, windowSize)
         val gravityZ = movingAverage(accelZ, windowSize)
 
-        val bodyX = accelX.zip(gravityX).map { it.first - it.second }
-        val bodyY = accelY.zip(gravityY).map { it.first - it.second }
-        val bodyZ = accelZ.zip(gravityZ).map { it.first - it.second }
-
-        val bodyTriple = Triple(bodyX, bodyY, bodyZ)
+        val bodyTriple =
+                Triple(
+                        subtract(accelX, gravityX),
+                        subtract(accelY, gravityY),
+                        subtract(accelZ, gravityZ)
+                )
         val gravityTriple = Triple(gravityX, gravityY, gravityZ)
         return Pair(bodyTriple, gravityTriple)
     }
 
-    /** Calculate moving average (low-pass filter). */
-    private fun movingAverage(data: List<Double>, windowSize: Int): List<Double> {
-        if (data.isEmpty()) return emptyList()
+    /**
+     * Calculate moving average (low-pass filter). Window sums come from a double-precision prefix
+     * sum so the float32 output does not depend on the window length.
+     */
+    private fun movingAverage(data: FloatArray, windowSize: Int): FloatArray {
+        val n = data.size
+        val prefix = DoubleArray(n + 1)
+        for (i in 0 until n) {
+            prefix[i + 1] = prefix[i] + data[i]
+        }
 
-        val result = mutableListOf<Double>()
-        for (i in data.indices) {
-            val start = maxOf(0, i - windowSize / 2)
-            val end = minOf(data.size, i + windowSize / 2 + 1)
-            val window = data.subList(start, end)
-            result.add(window.average())
+        val half = windowSize / 2
+        return FloatArray(n) { i ->
+            val start = maxOf(0, i - half)
+            val end = minOf(n, i + half + 1)
+            ((prefix[end] - prefix[start]) / (end - start)).toFloat()
         }
-        return result
+    }
+
+    private fun subtract(a: FloatArray, b: FloatArray): FloatArray {
+        val size = minOf(a.size, b.size)
+        return FloatArray(size) { i -> a[i] - b[i] }
     }
 
     /** Calculate jerk (derivative) of signal. */
-    private fun calculateJerk(signal: List<Double>): List<Double> {
-        if (signal.size < 2) return emptyList()
-
-        val jerk = mutableListOf<Double>()
-        for (i in 1 until signal.size) {
-            // Jerk = difference between consecutive samples
-            // Assuming 50Hz sampling rate (0.02s intervals)
-            val dt = 0.02 // 20ms
-            jerk.add((signal[i] - signal[i - 1]) / dt)
-        }
-        return jerk
+    private fun calculateJerk(signal: FloatArray): FloatArray {
+        if (signal.size < 2) return FloatArray(0)
+
+        // Jerk = difference between consecutive samples
+        // Assuming 50Hz sampling rate (0.02s intervals)
+        return FloatArray(signal.size - 1) { i -> (signal[i + 1] - signal[i]) / JERK_DT }
     }
 
     /** Calculate magnitude: sqrt(x² + y² + z²) */
-    private fun calculateMagnitude(
-            x: List<Double>,
-            y: List<Double>,
-            z: List<Double>
-    ): List<Double> {
+    private fun calculateMagnitude(x: FloatArray, y: FloatArray, z: FloatArray): FloatArray {
         val minSize = minOf(x.size, y.size, z.size)
-        return (0 until minSize).map { i -> sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]) }
+        return FloatArray(minSize) { i -> sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]) }
     }
 
     /** Extract time domain features for 3-axis signals. */
     private fun extractTimeDomainFeatures(
             prefix: String,
-            x: List<Double>,
-            y: List<Double>,
-            z: List<Double>,
-            features: MutableMap<String, Double>,
+            x: FloatArray,
+            y: FloatArray,
+            z: FloatArray,
+            features: MutableMap<String, Float>,
             startIndex: Int // Kept for reference but not used in feature names
     ) {
         var index = startIndex
 
         // Mean (features 1-3, 41-43, etc.)
-        features["${prefix}-mean()-X"] = x.average()
-        features["${prefix}-mean()-Y"] = y.average()
-        features["${prefix}-mean()-Z"] = z.average()
+        features["${prefix}-mean()-X"] = mean(x)
+        features["${prefix}-mean()-Y"] = mean(y)
+        features["${prefix}-mean()-Z"] = mean(z)
 
         // Std (features 4-6)
         features["${prefix}-std()-X"] = stdDev(x)
@@ -260,18 +294,17 @@ class MotionFeatureExtractor {
         features["${prefix}-mad()-Z"] = mad(z)
 
         // Max (features 10-12)
-        features["${prefix}-max()-X"] = x.maxOrNull() ?: 0.0
-        features["${prefix}-max()-Y"] = y.maxOrNull() ?: 0.0
-        features["${prefix}-max()-Z"] = z.maxOrNull() ?: 0.0
+        features["${prefix}-max()-X"] = x.maxOrNull() ?: 0f
+        features["${prefix}-max()-Y"] = y.maxOrNull() ?: 0f
+        features["${prefix}-max()-Z"] = z.maxOrNull() ?: 0f
 
         // Min (features 13-15)
-        features["${prefix}-min()-X"] = x.minOrNull() ?: 0.0
-        features["${prefix}-min()-Y"] = y.minOrNull() ?: 0.0
-        features["${prefix}-min()-Z"] = z.minOrNull() ?: 0.0
+        features["${prefix}-min()-X"] = x.minOrNull() ?: 0f
+        features["${prefix}-min()-Y"] = y.minOrNull() ?: 0f
+        features["${prefix}-min()-Z"] = z.minOrNull() ?: 0f
 
         // SMA - Signal Magnitude Area (feature 16)
-        val sma = (x.map { abs(it) } + y.map { abs(it) } + z.map { abs(it) }).average()
-        features["${prefix}-sma()"] = sma
+        features["${prefix}-sma()"] = sma(x, y, z)
 
         // Energy (features 17-19)
         features["${prefix}-energy()-X"] = energy(x)
@@ -293,9 +326,9 @@ class MotionFeatureExtractor {
         val arCoeffsY = arCoefficients(y, 4)
         val arCoeffsZ = arCoefficients(z, 4)
         for (i in 0 until 4) {
-            features["${prefix}-arCoeff()-X,${i + 1}"] = arCoeffsX.getOrElse(i) { 0.0 }
-            features["${prefix}-arCoeff()-Y,${i + 1}"] = arCoeffsY.getOrElse(i) { 0.0 }
-            features["${prefix}-arCoeff()-Z,${i + 1}"] = arCoeffsZ.getOrElse(i) { 0.0 }
+            features["${prefix}-arCoeff()-X,${i + 1}"] = arCoeffsX[i]
+            features["${prefix}-arCoeff()-Y,${i + 1}"] = arCoeffsY[i]
+            features["${prefix}-arCoeff()-Z,${i + 1}"] = arCoeffsZ[i]
         }
 
         // Correlation (features 38-40)
@@ -307,16 +340,16 @@ class MotionFeatureExtractor {
     /** Extract time domain features for magnitude signals. */
     private fun extractTimeDomainFeaturesMagnitude(
             prefix: String,
-            mag: List<Double>,
-            features: MutableMap<String, Double>,
+            mag: FloatArray,
+            features: MutableMap<String, Float>,
             startIndex: Int
     ) {
-        features["${prefix}-mean()"] = mag.average()
+        features["${prefix}-mean()"] = mean(mag)
         features["${prefix}-std()"] = stdDev(mag)
         features["${prefix}-mad()"] = mad(mag)
-        features["${prefix}-max()"] = mag.maxOrNull() ?: 0.0
-        features["${prefix}-min()"] = mag.minOrNull() ?: 0.0
-        features["${prefix}-sma()"] = mag.map { abs(it) }.average()
+        features["${prefix}-max()"] = mag.maxOrNull() ?: 0f
+        features["${prefix}-min()"] = mag.minOrNull() ?: 0f
+        features["${prefix}-sma()"] = sma(mag)
         features["${prefix}-energy()"] = energy(mag)
         features["${prefix}-iqr()"] = iqr(mag)
         features["${prefix}-entropy()"] = entropy(mag)
@@ -324,32 +357,33 @@ class MotionFeatureExtractor {
         // AR Coefficients (4 coefficients)
         val arCoeffs = arCoefficients(mag, 4)
         for (i in 0 until 4) {
-            features["${prefix}-arCoeff()${i + 1}"] = arCoeffs.getOrElse(i) { 0.0 }
+            features["${prefix}-arCoeff()${i + 1}"] = arCoeffs[i]
         }
     }
 
     /** Extract frequency domain features using FFT. */
     private fun extractFrequencyDomainFeatures(
             prefix: String,
-            x: List<Double>,
-            y: List<Double>,
-            z: List<Double>,
-            features: MutableMap<String, Double>,
+            x: FloatArray,
+            y: FloatArray,
+            z: FloatArray,
+            features: MutableMap<String, Float>,
             startIndex: Int // Kept for reference but not used in feature names
     ) {
-        // Apply FFT
-        val fftX = fft(x)
-        val fftY = fft(y)
-        val fftZ = fft(z)
+        // Apply FFT and summarise each spectrum once; every spectral feature below reads
+        // from these summaries instead of re-mapping abs() over the spectrum.
+        val specX = analyzeSpectrum(fft(x))
+        val specY = analyzeSpectrum(fft(y))
+        val specZ = analyzeSpectrum(fft(z))
 
-        val absX = fftX.map { abs(it) }
-        val absY = fftY.map { abs(it) }
-        val absZ = fftZ.map { abs(it) }
+        val absX = specX.magnitudes
+        val absY = specY.magnitudes
+        val absZ = specZ.magnitudes
 
         // Mean
-        features["${prefix}-mean()-X"] = absX.average()
-        features["${prefix}-mean()-Y"] = absY.average()
-        features["${prefix}-mean()-Z"] = absZ.average()
+        features["${prefix}-mean()-X"] = mean(absX)
+        features["${prefix}-mean()-Y"] = mean(absY)
+        features["${prefix}-mean()-Z"] = mean(absZ)
 
         // Std
         features["${prefix}-std()-X"] = stdDev(absX)
@@ -362,18 +396,17 @@ class MotionFeatureExtractor {
         features["${prefix}-mad()-Z"] = mad(absZ)
 
         // Max
-        features["${prefix}-max()-X"] = absX.maxOrNull() ?: 0.0
-        features["${prefix}-max()-Y"] = absY.maxOrNull() ?: 0.0
-        features["${prefix}-max()-Z"] = absZ.maxOrNull() ?: 0.0
+        features["${prefix}-max()-X"] = absX.maxOrNull() ?: 0f
+        features["${prefix}-max()-Y"] = absY.maxOrNull() ?: 0f
+        features["${prefix}-max()-Z"] = absZ.maxOrNull() ?: 0f
 
         // Min
-        features["${prefix}-min()-X"] = absX.minOrNull() ?: 0.0
-        features["${prefix}-min()-Y"] = absY.minOrNull() ?: 0.0
-        features["${prefix}-min()-Z"] = absZ.minOrNull() ?: 0.0
+        features["${prefix}-min()-X"] = absX.minOrNull() ?: 0f
+        features["${prefix}-min()-Y"] = absY.minOrNull() ?: 0f
+        features["${prefix}-min()-Z"] = absZ.minOrNull() ?: 0f
 
         // SMA
-        val sma = (absX + absY + absZ).average()
-        features["${prefix}-sma()"] = sma
+        features["${prefix}-sma()"] = sma(absX, absY, absZ)
 
         // Energy
         features["${prefix}-energy()-X"] = energy(absX)
@@ -391,85 +424,82 @@ class MotionFeatureExtractor {
         features["${prefix}-entropy()-Z"] = entropy(absZ)
 
         // MaxInds - index of maximum frequency component
-        features["${prefix}-maxInds-X"] = absX.indexOf(absX.maxOrNull() ?: 0.0).toDouble()
-        features["${prefix}-maxInds-Y"] = absY.indexOf(absY.maxOrNull() ?: 0.0).toDouble()
-        features["${prefix}-maxInds-Z"] = absZ.indexOf(absZ.maxOrNull() ?: 0.0).toDouble()
+        features["${prefix}-maxInds-X"] = specX.maxIndex.toFloat()
+        features["${prefix}-maxInds-Y"] = specY.maxIndex.toFloat()
+        features["${prefix}-maxInds-Z"] = specZ.maxIndex.toFloat()
 
         // MeanFreq - weighted mean frequency
-        features["${prefix}-meanFreq()-X"] = meanFreq(fftX)
-        features["${prefix}-meanFreq()-Y"] = meanFreq(fftY)
-        features["${prefix}-meanFreq()-Z"] = meanFreq(fftZ)
+        features["${prefix}-meanFreq()-X"] = specX.meanFreq
+        features["${prefix}-meanFreq()-Y"] = specY.meanFreq
+        features["${prefix}-meanFreq()-Z"] = specZ.meanFreq
 
         // Skewness
-        features["${prefix}-skewness()-X"] = skewness(absX)
-        features["${prefix}-skewness()-Y"] = skewness(absY)
-        features["${prefix}-skewness()-Z"] = skewness(absZ)
+        features["${prefix}-skewness()-X"] = specX.skewness
+        features["${prefix}-skewness()-Y"] = specY.skewness
+        features["${prefix}-skewness()-Z"] = specZ.skewness
 
         // Kurtosis
-        features["${prefix}-kurtosis()-X"] = kurtosis(absX)
-        features["${prefix}-kurtosis()-Y"] = kurtosis(absY)
-        features["${prefix}-kurtosis()-Z"] = kurtosis(absZ)
+        features["${prefix}-kurtosis()-X"] = specX.kurtosis
+        features["${prefix}-kurtosis()-Y"] = specY.kurtosis
+        features["${prefix}-kurtosis()-Z"] = specZ.kurtosis
 
         // BandsEnergy - energy in frequency bands
-        extractBandsEnergy(prefix, fftX, fftY, fftZ, features)
+        extractBandsEnergy(prefix, specX, specY, specZ, features)
     }
 
     /** Extract frequency domain features for magnitude signals. */
     private fun extractFrequencyDomainFeaturesMagnitude(
             prefix: String,
-            mag: List<Double>,
-            features: MutableMap<String, Double>,
+            mag: FloatArray,
+            features: MutableMap<String, Float>,
             startIndex: Int // Kept for reference but not used in feature names
     ) {
-        val fftMag = fft(mag)
-        val absMag = fftMag.map { abs(it) }
+        val spec = analyzeSpectrum(fft(mag))
+        val absMag = spec.magnitudes
 
-        features["${prefix}-mean()"] = absMag.average()
+        features["${prefix}-mean()"] = mean(absMag)
         features["${prefix}-std()"] = stdDev(absMag)
         features["${prefix}-mad()"] = mad(absMag)
-        features["${prefix}-max()"] = absMag.maxOrNull() ?: 0.0
-        features["${prefix}-min()"] = absMag.minOrNull() ?: 0.0
-        features["${prefix}-sma()"] = absMag.average()
+        features["${prefix}-max()"] = absMag.maxOrNull() ?: 0f
+        features["${prefix}-min()"] = absMag.minOrNull() ?: 0f
+        features["${prefix}-sma()"] = mean(absMag)
         features["${prefix}-energy()"] = energy(absMag)
         features["${prefix}-iqr()"] = iqr(absMag)
         features["${prefix}-entropy()"] = entropy(absMag)
-        features["${prefix}-maxInds"] = absMag.indexOf(absMag.maxOrNull() ?: 0.0).toDouble()
-        features["${prefix}-meanFreq()"] = meanFreq(fftMag)
-        features["${prefix}-skewness()"] = skewness(absMag)
-        features["${prefix}-kurtosis()"] = kurtosis(absMag)
+        features["${prefix}-maxInds"] = spec.maxIndex.toFloat()
+        features["${prefix}-meanFreq()"] = spec.meanFreq
+        features["${prefix}-skewness()"] = spec.skewness
+        features["${prefix}-kurtosis()"] = spec.kurtosis
     }
 
     /** Extract angle features. */
     private fun extractAngleFeatures(
-            bodyAccX: List<Double>,
-            bodyAccY: List<Double>,
-            bodyAccZ: List<Double>,
-            bodyAccJerkX: List<Double>,
-            bodyAccJerkY: List<Double>,
-            bodyAccJerkZ: List<Double>,
-            bodyGyroX: List<Double>,
-            bodyGyroY: List<Double>,
-            bodyGyroZ: List<Double>,
-            bodyGyroJerkX: List<Double>,
-            bodyGyroJerkY: List<Double>,
-            bodyGyroJerkZ: List<Double>,
-            gravityAccX: List<Double>,
-            gravityAccY: List<Double>,
-            gravityAccZ: List<Double>,
-            features: MutableMap<String, Double>,
+            bodyAccX: FloatArray,
+            bodyAccY: FloatArray,
+            bodyAccZ: FloatArray,
+            bodyAccJerkX: FloatArray,
+            bodyAccJerkY: FloatArray,
+            bodyAccJerkZ: FloatArray,
+            bodyGyroX: FloatArray,
+            bodyGyroY: FloatArray,
+            bodyGyroZ: FloatArray,
+            bodyGyroJerkX: FloatArray,
+            bodyGyroJerkY: FloatArray,
+            bodyGyroJerkZ: FloatArray,
+            gravityAccX: FloatArray,
+            gravityAccY: FloatArray,
+            gravityAccZ: FloatArray,
+            features: MutableMap<String, Float>,
             startIndex: Int
     ) {
         var index = startIndex
 
         // Calculate mean vectors
-        val bodyAccMean = Triple(bodyAccX.average(), bodyAccY.average(), bodyAccZ.average())
-        val bodyAccJerkMean =
-                Triple(bodyAccJerkX.average(), bodyAccJerkY.average(), bodyAccJerkZ.average())
-        val bodyGyroMean = Triple(bodyGyroX.average(), bodyGyroY.average(), bodyGyroZ.average())
-        val bodyGyroJerkMean =
-                Triple(bodyGyroJerkX.average(), bodyGyroJerkY.average(), bodyGyroJerkZ.average())
-        val gravityMean =
-                Triple(gravityAccX.average(), gravityAccY.average(), gravityAccZ.average())
+        val bodyAccMean = meanVector(bodyAccX, bodyAccY, bodyAccZ)
+        val bodyAccJerkMean = meanVector(bodyAccJerkX, bodyAccJerkY, bodyAccJerkZ)
+        val bodyGyroMean = meanVector(bodyGyroX, bodyGyroY, bodyGyroZ)
+        val bodyGyroJerkMean = meanVector(bodyGyroJerkX, bodyGyroJerkY, bodyGyroJerkZ)
+        val gravityMean = meanVector(gravityAccX, gravityAccY, gravityAccZ)
 
         // Angle between vectors
         features["angle(tBodyAccMean,gravity)"] = angle(bodyAccMean, gravityMean)
@@ -486,34 +516,71 @@ class MotionFeatureExtractor {
         features["angle(Z,gravityMean)"] = angle(zAxis, gravityMean)
     }
 
-    // Helper functions for statistical calculations
+    // Helper functions for statistical calculations.
+    // Inputs and results are float32; sums run in double so that long windows and the
+    // cancellation in variance / autocorrelation do not lose precision.
 
-    private fun stdDev(data: List<Double>): Double {
-        if (data.isEmpty()) return 0.0
-        val mean = data.average()
-        val variance = data.map { (it - mean) * (it - mean) }.average()
-        return sqrt(variance)
+    private fun mean(data: FloatArray): Float {
+        if (data.isEmpty()) return Float.NaN
+        var sum = 0.0
+        for (v in data) sum += v
+        return (sum / data.size).toFloat()
     }
 
-    private fun mad(data: List<Double>): Double {
-        if (data.isEmpty()) return 0.0
-        val sorted = data.sorted()
+    private fun meanVector(
+            x: FloatArray,
+            y: FloatArray,
+            z: FloatArray
+    ): Triple<Double, Double, Double> =
+            Triple(mean(x).toDouble(), mean(y).toDouble(), mean(z).toDouble())
+
+    private fun stdDev(data: FloatArray): Float {
+        if (data.isEmpty()) return 0f
+        var sum = 0.0
+        for (v in data) sum += v
+        val mean = sum / data.size
+        var sumSq = 0.0
+        for (v in data) {
+            val d = v - mean
+            sumSq += d * d
+        }
+        return sqrt(sumSq / data.size).toFloat()
+    }
+
+    private fun mad(data: FloatArray): Float {
+        if (data.isEmpty()) return 0f
+        val sorted = data.sortedArray()
         val median =
                 if (sorted.size % 2 == 0) {
-                    (sorted[sorted.size / 2 - 1] + sorted[sorted.size / 2]) / 2.0
+                    (sorted[sorted.size / 2 - 1].toDouble() + sorted[sorted.size / 2]) / 2.0
                 } else {
-                    sorted[sorted.size / 2]
+                    sorted[sorted.size / 2].toDouble()
                 }
-        return sorted.map { abs(it - median) }.average()
+        var sum = 0.0
+        for (v in sorted) sum += abs(v - median)
+        return (sum / sorted.size).toFloat()
+    }
+
+    /** Mean absolute value over all samples of the given signals (NaN when all are empty). */
+    private fun sma(vararg signals: FloatArray): Float {
+        var sum = 0.0
+        var count = 0
+        for (signal in signals) {
+            for (v in signal) sum += abs(v)
+            count += signal.size
+        }
+        return (sum / count).toFloat()
     }
 
-    private fun energy(data: List<Double>): Double {
-        return data.map { it * it }.sum() / data.size
+    private fun energy(data: FloatArray): Float {
+        var sum = 0.0
+        for (v in data) sum += v.toDouble() * v
+        return (sum / data.size).toFloat()
     }
 
-    private fun iqr(data: List<Double>): Double {
-        if (data.size < 4) return 0.0
-        val sorted = data.sorted()
+    private fun iqr(data: FloatArray): Float {
+        if (data.size < 4) return 0f
+        val sorted = data.sortedArray()
         val q1Index = sorted.size / 4
         val q3Index = (3 * sorted.size) / 4
         val q1 = sorted[q1Index]
@@ -521,20 +588,20 @@ class MotionFeatureExtractor {
         return q3 - q1
     }
 
-    private fun entropy(data: List<Double>): Double {
-        if (data.isEmpty()) return 0.0
+    private fun entropy(data: FloatArray): Float {
+        if (data.isEmpty()) return 0f
         // Normalize data to [0, 1]
-        val min = data.minOrNull() ?: 0.0
-        val max = data.maxOrNull() ?: 1.0
+        val min = (data.minOrNull() ?: 0f).toDouble()
+        val max = (data.maxOrNull() ?: 1f).toDouble()
         val range = max - min
-        if (range == 0.0) return 0.0
+        if (range == 0.0) return 0f
 
-        val normalized = data.map { (it - min) / range }
         // Discretize into bins
         val bins = 10
         val histogram = IntArray(bins)
-        normalized.forEach { value ->
-            val bin = ((value * bins).toInt().coerceIn(0, bins - 1))
+        for (v in data) {
+            val normalized = (v - min) / range
+            val bin = ((normalized * bins).toInt().coerceIn(0, bins - 1))
             histogram[bin]++
         }
 
@@ -546,65 +613,76 @@ class MotionFeatureExtractor {
                 entropy -= p * ln(p)
             }
         }
-        return entropy
+        return entropy.toFloat()
     }
 
-    private fun arCoefficients(data: List<Double>, order: Int): List<Double> {
+    private fun arCoefficients(data: FloatArray, order: Int): FloatArray {
         // Simplified AR coefficient calculation using Yule-Walker equations
-        if (data.size < order + 1) return List(order) { 0.0 }
+        if (data.size < order + 1) return FloatArray(order)
 
-        // Calculate autocorrelation (need order + 1 values for lags 0 to order)
-        val autocorr = mutableListOf<Double>()
-        val mean = data.average()
-        val centered = data.map { it - mean }
+        // Calculate autocorrelation (need order + 1 values for lags 0 to order).
+        // Centering and lag products stay in double: this is where float32 cancels badly.
+        val autocorr = DoubleArray(order + 1)
+        var sum = 0.0
+        for (v in data) sum += v
+        val mean = sum / data.size
+        val centered = DoubleArray(data.size) { i -> data[i] - mean }
 
         for (lag in 0..order) {
-            var sum = 0.0
+            var lagSum = 0.0
             for (i in 0 until data.size - lag) {
-                sum += centered[i] * centered[i + lag]
+                lagSum += centered[i] * centered[i + lag]
             }
-            autocorr.add(sum / data.size)
+            autocorr[lag] = lagSum / data.size
         }
 
         // Solve Yule-Walker equations (simplified - using Levinson-Durbin recursion)
-        val coeffs = mutableListOf<Double>()
-        if (autocorr[0] == 0.0) return List(order) { 0.0 }
+        val coeffs = FloatArray(order)
+        if (autocorr[0] == 0.0) return coeffs
 
-        var prev = listOf(autocorr[1] / autocorr[0])
-        coeffs.addAll(prev)
+        var prev = doubleArrayOf(autocorr[1] / autocorr[0])
+        coeffs[0] = prev[0].toFloat()
 
         for (k in 1 until order) {
             var num = autocorr[k + 1]
             for (j in 0 until k) {
                 num -= prev[j] * autocorr[k - j]
             }
-            val denom = 1.0 - prev.mapIndexed { i, v -> v * autocorr[i + 1] }.sum()
+            var reflected = 0.0
+            for (i in prev.indices) {
+                reflected += prev[i] * autocorr[i + 1]
+            }
+            val denom = 1.0 - reflected
 
             if (denom == 0.0) {
-                coeffs.add(0.0)
+                coeffs[k] = 0f
                 continue
             }
 
             val ak = num / denom
-            val newCoeffs = mutableListOf<Double>()
+            val newCoeffs = DoubleArray(k + 1)
             for (i in 0 until k) {
-                newCoeffs.add(prev[i] - ak * prev[k - 1 - i])
+                newCoeffs[i] = prev[i] - ak * prev[k - 1 - i]
             }
-            newCoeffs.add(ak)
+            newCoeffs[k] = ak
             prev = newCoeffs
-            if (coeffs.size < order) {
-                coeffs.add(ak)
-            }
+            coeffs[k] = ak.toFloat()
         }
 
-        return coeffs.take(order)
+        return coeffs
     }
 
-    private fun correlation(x: List<Double>, y: List<Double>): Double {
-        if (x.size != y.size || x.isEmpty()) return 0.0
+    private fun correlation(x: FloatArray, y: FloatArray): Float {
+        if (x.size != y.size || x.isEmpty()) return 0f
 
-        val meanX = x.average()
-        val meanY = y.average()
+        var sumX = 0.0
+        var sumY = 0.0
+        for (i in x.indices) {
+            sumX += x[i]
+            sumY += y[i]
+        }
+        val meanX = sumX / x.size
+        val meanY = sumY / y.size
 
         var numerator = 0.0
         var sumSqX = 0.0
@@ -619,104 +697,196 @@ class MotionFeatureExtractor {
         }
 
         val denominator = sqrt(sumSqX * sumSqY)
-        return if (denominator == 0.0) 0.0 else numerator / denominator
+        return if (denominator == 0.0) 0f else (numerator / denominator).toFloat()
     }
 
-    private fun fft(data: List<Double>): List<Double> {
+    private fun fft(data: FloatArray): FloatArray {
         // Simple FFT implementation (Cooley-Tukey algorithm)
         // For production, consider using a library like Apache Commons Math
-        if (data.isEmpty()) return emptyList()
+        if (data.isEmpty()) return FloatArray(0)
 
         val n = data.size
         // Pad to next power of 2 for FFT
         val paddedSize = (1 shl (32 - n.countLeadingZeroBits())).coerceAtLeast(2)
-        val padded = data + List(paddedSize - n) { 0.0 }
+        val padded = data.copyOf(paddedSize)
 
-        return fftRecursive(padded).take(n)
+        return fftRecursive(padded).copyOf(n)
     }
 
-    private fun fftRecursive(data: List<Double>): List<Double> {
+    private fun fftRecursive(data: FloatArray): FloatArray {
         val n = data.size
         if (n <= 1) return data
 
-        val even = fftRecursive(data.filterIndexed { i, _ -> i % 2 == 0 })
-        val odd = fftRecursive(data.filterIndexed { i, _ -> i % 2 == 1 })
+        val even = fftRecursive(FloatArray(n / 2) { i -> data[2 * i] })
+        val odd = fftRecursive(FloatArray(n / 2) { i -> data[2 * i + 1] })
 
-        val result = mutableListOf<Double>()
+        val twiddles = twiddles(n)
+        val result = FloatArray(n)
         for (k in 0 until n / 2) {
-            val t = -2.0 * PI * k / n
-            val re = cos(t)
-            val im = sin(t)
-            val oddK = odd.getOrElse(k) { 0.0 }
-            val evenK = even.getOrElse(k) { 0.0 }
-            result.add(evenK + re * oddK)
-            result.add(evenK - re * oddK)
+            val re = twiddles[k]
+            val oddK = odd[k]
+            val evenK = even[k]
+            result[2 * k] = evenK + re * oddK
+            result[2 * k + 1] = evenK - re * oddK
         }
         return result
     }
 
-    private fun meanFreq(fftData: List<Double>): Double {
-        if (fftData.isEmpty()) return 0.0
-        val magnitudes = fftData.map { abs(it) }
-        val totalEnergy = magnitudes.sum()
-        if (totalEnergy == 0.0) return 0.0
+    /** cos(-2πk/n) for k in [0, n/2), cached per transform size. */
+    private fun twiddles(n: Int): FloatArray =
+            twiddleCache.getOrPut(n) {
+                FloatArray(n / 2) { k -> cos(-2.0 * PI * k / n).toFloat() }
+            }
 
-        var weightedSum = 0.0
-        magnitudes.forEachIndexed { index, mag -> weightedSum += index * mag }
-        return weightedSum / totalEnergy
+    /**
+     * Summary of one magnitude spectrum. [energyPrefix] holds running sums of squared
+     * magnitudes, so the energy of bins `[lo, hi)` is `energyPrefix[hi] - energyPrefix[lo]`.
+     */
+    private class Spectrum(
+            val magnitudes: FloatArray,
+            val energyPrefix: DoubleArray,
+            val maxIndex: Int,
+            val meanFreq: Float,
+            val skewness: Float,
+            val kurtosis: Float
+    ) {
+        fun bandEnergy(lo: Int, hi: Int): Float = (energyPrefix[hi] - energyPrefix[lo]).toFloat()
     }
 
-    private fun skewness(data: List<Double>): Double {
-        if (data.size < 3) return 0.0
-        val mean = data.average()
-        val std = stdDev(data)
-        if (std == 0.0) return 0.0
-
-        val n = data.size
-        val sum =
-                data
-                        .map {
-                            val normalized: Double = (it - mean) / std
-                            normalized.pow(3.0)
-                        }
-                        .sum()
-        return (n / ((n - 1.0) * (n - 2.0))) * sum
-    }
+    /**
+     * Compute magnitudes, band-energy prefix sums, maxInds and meanFreq in one pass, then the
+     * central moments for skewness/kurtosis in a second pass over the same primitive array.
+     * Magnitudes are float32; the prefix sums and moments accumulate in double.
+     */
+    private fun analyzeSpectrum(fftData: FloatArray): Spectrum {
+        val n = fftData.size
+        val magnitudes = FloatArray(n)
+        val energyPrefix = DoubleArray(n + 1)
+        var sum = 0.0
+        var weightedSum = 0.0
+        var maxValue = Float.NEGATIVE_INFINITY
+        var maxIndex = -1
+        var running = 0.0
+        for (i in 0 until n) {
+            val m = abs(fftData[i])
+            magnitudes[i] = m
+            running += m.toDouble() * m
+            energyPrefix[i + 1] = running
+            sum += m
+            weightedSum += i.toDouble() * m
+            if (m > maxValue) {
+                maxValue = m
+                maxIndex = i
+            }
+        }
 
-    private fun kurtosis(data: List<Double>): Double {
-        if (data.size < 4) return 0.0
-        val mean = data.average()
-        val std = stdDev(data)
-        if (std == 0.0) return 0.0
+        val meanFreq = if (n == 0 || sum == 0.0) 0.0 else weightedSum / sum
+
+        var skewness = 0.0
+        var kurtosis = 0.0
+        if (n >= 3) {
+            val mean = sum / n
+            var m2 = 0.0
+            var m3 = 0.0
+            var m4 = 0.0
+            for (i in 0 until n) {
+                val d = magnitudes[i] - mean
+                val d2 = d * d
+                m2 += d2
+                m3 += d2 * d
+                m4 += d2 * d2
+            }
+            val std = sqrt(m2 / n)
+            if (std != 0.0) {
+                val nd = n.toDouble()
+                val std2 = std * std
+                skewness = (nd / ((nd - 1.0) * (nd - 2.0))) * (m3 / (std2 * std))
+                if (n >= 4) {
+                    kurtosis =
+                            ((nd * (nd + 1.0)) / ((nd - 1.0) * (nd - 2.0) * (nd - 3.0))) *
+                                    (m4 / (std2 * std2)) -
+                                    3.0 * (nd - 1.0) * (nd - 1.0) / ((nd - 2.0) * (nd - 3.0))
+                }
+            }
+        }
 
-        val n = data.size
-        val sum =
-                data
-                        .map {
-                            val normalized: Double = (it - mean) / std
-                            normalized.pow(4.0)
-                        }
-                        .sum()
-        return ((n * (n + 1.0)) / ((n - 1.0) * (n - 2.0) * (n - 3.0))) * sum -
-                3.0 * (n - 1.0) * (n - 1.0) / ((n - 2.0) * (n - 3.0))
+        return Spectrum(
+                magnitudes,
+                energyPrefix,
+                maxIndex,
+                meanFreq.toFloat(),
+                skewness.toFloat(),
+                kurtosis.toFloat()
+        )
     }
 
+    /**
+     * Band bin ranges clipped to a spectrum of length n, as `[lo0, hi0, lo1, hi1, ...]`.
+     * Window lengths barely vary between flushes, so the clipped table is cached per length.
+     */
+    private fun bandBounds(n: Int): IntArray =
+            bandBoundsCache.getOrPut(n) {
+                IntArray(BANDS.size * 2) { i ->
+                    val band = BANDS[i / 2]
+                    if (i % 2 == 0) (band.first - 1).coerceAtMost(n)
+                    else band.second.coerceAtMost(n)
+                }
+            }
+
     private fun extractBandsEnergy(
             prefix: String,
-            fftX: List<Double>,
-            fftY: List<Double>,
-            fftZ: List<Double>,
-            features: MutableMap<String, Double>
+            specX: Spectrum,
+            specY: Spectrum,
+            specZ: Spectrum,
+            features: MutableMap<String, Float>
     ) {
-        val absX = fftX.map { abs(it) }
-        val absY = fftY.map { abs(it) }
-        val absZ = fftZ.map { abs(it) }
+        val boundsX = bandBounds(specX.magnitudes.size)
+        val boundsY = bandBounds(specY.magnitudes.size)
+        val boundsZ = bandBounds(specZ.magnitudes.size)
+
+        for (b in BANDS.indices) {
+            val (start, end) = BANDS[b]
+            val lo = 2 * b
+            val hi = lo + 1
+            features["${prefix}-bandsEnergy()-${start},${end}-X"] =
+                    specX.bandEnergy(boundsX[lo], boundsX[hi])
+            features["${prefix}-bandsEnergy()-${start},${end}-Y"] =
+                    specY.bandEnergy(boundsY[lo], boundsY[hi])
+            features["${prefix}-bandsEnergy()-${start},${end}-Z"] =
+                    specZ.bandEnergy(boundsZ[lo], boundsZ[hi])
+        }
+    }
+
+    private fun angle(
+            v1: Triple<Double, Double, Double>,
+            v2: Triple<Double, Double, Double>
+    ): Float {
+        val dot = v1.first * v2.first + v1.second * v2.second + v1.third * v2.third
+        val mag1 = sqrt(v1.first * v1.first + v1.second * v1.second + v1.third * v1.third)
+        val mag2 = sqrt(v2.first * v2.first + v2.second * v2.second + v2.third * v2.third)
+
+        if (mag1 == 0.0 || mag2 == 0.0) return 0f
+        val cosAngle = (dot / (mag1 * mag2)).coerceIn(-1.0, 1.0)
+        return acos(cosAngle).toFloat()
+    }
+
+    private fun generateEmptyFeatures(): Map<String, Float> {
+        // Return empty map - features will be calculated when data is available
+        return emptyMap()
+    }
+
+    companion object {
+        // 561 features at the default load factor
+        private const val FEATURE_MAP_CAPACITY = 768
+
+        // Assumed 50Hz sampling interval for jerk
+        private const val JERK_DT = 0.02f
 
         // Frequency bands: 1-8, 9-16, 17-24, 25-32, 33-40, 41-48, 49-56, 57-64
         // Then: 1-16, 17-32, 33-48, 49-64
         // Then: 1-24, 25-48
-        val bands =
-                listOf(
+        private val BANDS =
+                arrayOf(
                         Pair(1, 8),
                         Pair(9, 16),
                         Pair(17, 24),
@@ -732,40 +902,5 @@ class MotionFeatureExtractor {
                         Pair(1, 24),
                         Pair(25, 48)
                 )
-
-        for (band in bands) {
-            val (start, end) = band
-            val bandEnergyX =
-                    absX.subList((start - 1).coerceAtMost(absX.size), end.coerceAtMost(absX.size))
-                            .sumOf { it * it }
-            val bandEnergyY =
-                    absY.subList((start - 1).coerceAtMost(absY.size), end.coerceAtMost(absY.size))
-                            .sumOf { it * it }
-            val bandEnergyZ =
-                    absZ.subList((start - 1).coerceAtMost(absZ.size), end.coerceAtMost(absZ.size))
-                            .sumOf { it * it }
-
-            features["${prefix}-bandsEnergy()-${start},${end}-X"] = bandEnergyX
-            features["${prefix}-bandsEnergy()-${start},${end}-Y"] = bandEnergyY
-            features["${prefix}-bandsEnergy()-${start},${end}-Z"] = bandEnergyZ
-        }
-    }
-
-    private fun angle(
-            v1: Triple<Double, Double, Double>,
-            v2: Triple<Double, Double, Double>
-    ): Double {
-        val dot = v1.first * v2.first + v1.second * v2.second + v1.third * v2.third
-        val mag1 = sqrt(v1.first * v1.first + v1.second * v1.second + v1.third * v1.third)
-        val mag2 = sqrt(v2.first * v2.first + v2.second * v2.second + v2.third * v2.third)
-
-        if (mag1 == 0.0 || mag2 == 0.0) return 0.0
-        val cosAngle = (dot / (mag1 * mag2)).coerceIn(-1.0, 1.0)
-        return acos(cosAngle)
-    }
-
-    private fun generateEmptyFeatures(): Map<String, Double> {
-        // Return empty map - features will be calculated when data is available
-        return emptyMap()
     }
 }
@@ -8,6 +8,8 @@ import android.hardware.SensorManager
 import java.time.Instant
 import java.time.format.DateTimeFormatter
 import java.util.concurrent.ConcurrentLinkedQueue
+import java.util.concurrent.atomic.AtomicBoolean
+import kotlin.math.sqrt
 
 /**
  * Collects raw motion sensor data (accelerometer and gyroscope). Privacy: Only raw motion patterns,
@@ -15,15 +17,33 @@ import java.util.concurrent.ConcurrentLinkedQueue
  *
  * Collects raw samples and aggregates them into time windows (5 seconds). Calculates 561 ML
  * features per window for model input.
+ *
+ * With [BehaviorConfig.useFusedMotionSensors] the collector reads the platform's fused
+ * TYPE_GRAVITY and TYPE_LINEAR_ACCELERATION streams (usually computed on the sensor hub) instead
+ * of the raw accelerometer, and the software gravity filter is skipped. Devices without those
+ * virtual sensors fall back to the raw accelerometer and software separation.
+ *
+ * Sensor callbacks only buffer samples. Window features are computed on a background
+ * [BehaviorExecutor.SerialQueue], which also runs the session calls, so collector state is only
+ * touched from one thread at a time.
  */
-class MotionSignalCollector(private val context: Context, private var config: BehaviorConfig) :
-        SensorEventListener {
+class MotionSignalCollector(
+        private val context: Context,
+        private var config: BehaviorConfig,
+        private val energyMeter: EnergyMeter? = null
+) : SensorEventListener {
 
     private var sensorManager: SensorManager? = null
     private var accelerometerSensor: Sensor? = null
     private var gyroscopeSensor: Sensor? = null
+    private var gravitySensor: Sensor? = null
+    private var linearAccelerationSensor: Sensor? = null
+
+    private val lane = BehaviorExecutor.SerialQueue(BehaviorExecutor.QoS.BACKGROUND)
+    private val flushPending = AtomicBoolean(false)
 
-    private var isCollecting = false
+    @Volatile private var isCollecting = false
+    private var fusedGravity = false // Fused sensors registered for the current collection
     private var sessionStartTime: Long = 0
 
     // Raw sample buffers (thread-safe)
@@ -32,13 +52,40 @@ class MotionSignalCollector(private val context: Context, private var config: Be
             ConcurrentLinkedQueue<Pair<Long, FloatArray>>() // timestamp, [x, y, z]
     private val gyroscopeSamples =
             ConcurrentLinkedQueue<Pair<Long, FloatArray>>() // timestamp, [x, y, z]
+    private val gravitySamples =
+            ConcurrentLinkedQueue<Pair<Long, FloatArray>>() // timestamp, [x, y, z]
+    private val linearAccelerationSamples =
+            ConcurrentLinkedQueue<Pair<Long, FloatArray>>() // timestamp, [x, y, z]
+
+    // Pipeline cost per window, and periodic fused-vs-software gravity comparison
+    private var softwareWindowCount = 0
+    private var fusedWindowCount = 0
+    private var softwareSeparationNanos = 0L
+    private var softwareExtractionNanos = 0L
+    private var fusedExtractionNanos = 0L
+    private var gravityComparisonCount = 0
+    private var gravityDeviationSum = 0.0
+    private var comparisonSeparationNanos = 0L
+
+    // Motion state cascade (stage 1) and end-to-end native cost per collection hour
+    private var cascadeClassifier = createCascadeClassifier(config)
+    private var cascadeExitCount = 0
+    private var cascadeFallThroughCount = 0
+    private var cascadeNanos = 0L
+    private var motionCpuNanos = 0L
+    private var collectingSinceMs = 0L
+    private var collectedMs = 0L
 
     // Aggregated motion data (per time window) - now stores ML features instead of raw arrays
+    // One shared window timeline serves all overlapping sessions
     private val motionDataPoints = mutableListOf<MotionDataPoint>()
 
+    // Index into motionDataPoints of each active session's first window
+    private val sessionOffsets = LinkedHashMap<String, Int>()
+
     // Time window configuration (5 seconds = 5000ms)
     private val timeWindowMs: Long = 5000L
-    private var lastWindowEndTime: Long = 0
+    @Volatile private var lastWindowEndTime: Long = 0
 
     // ISO 8601 formatter for timestamps
     private val timestampFormatter = DateTimeFormatter.ISO_INSTANT
@@ -48,47 +95,84 @@ class MotionSignalCollector(private val context: Context, private var config: Be
 
     data class MotionDataPoint(
             val timestamp: String, // ISO 8601 format
-            val features: Map<String, Double> // 561 ML features
-    )
+            val features: Map<String, Float>, // 561 ML features (float32), empty on early exit
+            val cascadeState: String? = null, // Stage 1 label when the window exited early
+            val cascadeConfidence: Float = 0f // Stage 1 confidence in [0, 1]
+    ) {
+        fun toMap(): Map<String, Any> {
+            val map = mutableMapOf<String, Any>("timestamp" to timestamp, "features" to features)
+            if (cascadeState != null) {
+                map["cascade_state"] = cascadeState
+                map["cascade_confidence"] = cascadeConfidence
+            }
+            return map
+        }
+    }
 
     fun updateConfig(newConfig: BehaviorConfig) {
-        config = newConfig
-        if (!config.enableMotionLite && isCollecting) {
-            stopCollecting()
-        } else if (config.enableMotionLite && !isCollecting && sessionStartTime > 0) {
-            startCollecting()
+        // Nothing to return: queue it rather than have the caller wait on the lane
+        lane.execute {
+            config = newConfig
+            cascadeClassifier = createCascadeClassifier(newConfig)
+            if (!config.enableMotionLite && isCollecting) {
+                stopCollecting()
+            } else if (config.enableMotionLite && !isCollecting && sessionOffsets.isNotEmpty()) {
+                startCollecting()
+            }
         }
     }
 
-    fun startSession(sessionStartTime: Long) {
-        this.sessionStartTime = sessionStartTime
-        this.lastWindowEndTime = sessionStartTime
-
-        // Clear previous data
-        accelerometerSamples.clear()
-        gyroscopeSamples.clear()
-        motionDataPoints.clear()
+    fun startSession(sessionId: String, sessionStartTime: Long) {
+        lane.execute {
+            if (sessionOffsets.isEmpty()) {
+                this.sessionStartTime = sessionStartTime
+                this.lastWindowEndTime = sessionStartTime
+
+                // Clear previous data
+                accelerometerSamples.clear()
+                gyroscopeSamples.clear()
+                gravitySamples.clear()
+                linearAccelerationSamples.clear()
+                motionDataPoints.clear()
+
+                if (config.enableMotionLite) {
+                    startCollecting()
+                }
+            }
 
-        if (config.enableMotionLite) {
-            startCollecting()
+            // Overlapping sessions join the running timeline from its next window
+            sessionOffsets[sessionId] = motionDataPoints.size
         }
     }
 
-    fun stopSession(): List<MotionDataPoint> {
-        stopCollecting()
+    fun stopSession(sessionId: String): List<MotionDataPoint> = lane.call {
+        val offset = sessionOffsets.remove(sessionId) ?: return@call emptyList()
 
-        // Flush any remaining samples in the current window
-        flushCurrentWindow()
+        if (sessionOffsets.isEmpty()) {
+            stopCollecting()
+            flushDueWindows()
 
-        // Return collected motion data
-        return motionDataPoints.toList()
+            // Flush any remaining samples in the current window
+            flushCurrentWindow()
+
+            // Return collected motion data
+            return@call motionDataPoints.subList(offset, motionDataPoints.size).toList()
+        }
+
+        // Other sessions still share the timeline: include the partial window without
+        // consuming its samples, so the shared window cadence is unaffected
+        flushDueWindows()
+        val sessionPoints = motionDataPoints.subList(offset, motionDataPoints.size).toMutableList()
+        extractWindow(consumeSamples = false)?.let { sessionPoints.add(it) }
+        sessionPoints
     }
 
-    fun getCurrentMotionData(): List<MotionDataPoint> {
+    fun getCurrentMotionData(): List<MotionDataPoint> = lane.call {
+        flushDueWindows()
         // Flush current window to ensure we have the latest data
         flushCurrentWindow()
         // Return current motion data without stopping collection
-        return motionDataPoints.toList()
+        motionDataPoints.toList()
     }
 
     private fun startCollecting() {
@@ -100,10 +184,24 @@ class MotionSignalCollector(private val context: Context, private var config: Be
             return
         }
 
-        accelerometerSensor = sensorManager?.getDefaultSensor(Sensor.TYPE_ACCELEROMETER)
         gyroscopeSensor = sensorManager?.getDefaultSensor(Sensor.TYPE_GYROSCOPE)
+        if (config.useFusedMotionSensors) {
+            gravitySensor = sensorManager?.getDefaultSensor(Sensor.TYPE_GRAVITY)
+            linearAccelerationSensor =
+                    sensorManager?.getDefaultSensor(Sensor.TYPE_LINEAR_ACCELERATION)
+        }
+        fusedGravity = gravitySensor != null && linearAccelerationSensor != null
+        if (!fusedGravity) {
+            if (config.useFusedMotionSensors) {
+                android.util.Log.d(
+                        "MotionSignalCollector",
+                        "Fused gravity sensors not available, using software separation"
+                )
+            }
+            accelerometerSensor = sensorManager?.getDefaultSensor(Sensor.TYPE_ACCELEROMETER)
+        }
 
-        if (accelerometerSensor == null || gyroscopeSensor == null) {
+        if ((!fusedGravity && accelerometerSensor == null) || gyroscopeSensor == null) {
             android.util.Log.w(
                     "MotionSignalCollector",
                     "Motion sensors not available on this device"
@@ -115,10 +213,16 @@ class MotionSignalCollector(private val context: Context, private var config: Be
         // For higher rates, use SENSOR_DELAY_FASTEST, but it may drain battery faster
         val samplingRate = SensorManager.SENSOR_DELAY_NORMAL // ~50Hz (20ms intervals)
 
-        sensorManager?.registerListener(this, accelerometerSensor, samplingRate)
+        if (fusedGravity) {
+            sensorManager?.registerListener(this, gravitySensor, samplingRate)
+            sensorManager?.registerListener(this, linearAccelerationSensor, samplingRate)
+        } else {
+            sensorManager?.registerListener(this, accelerometerSensor, samplingRate)
+        }
         sensorManager?.registerListener(this, gyroscopeSensor, samplingRate)
 
         isCollecting = true
+        collectingSinceMs = System.currentTimeMillis()
         android.util.Log.d("MotionSignalCollector", "Started collecting motion data")
     }
 
@@ -129,37 +233,85 @@ class MotionSignalCollector(private val context: Context, private var config: Be
         sensorManager = null
         accelerometerSensor = null
         gyroscopeSensor = null
+        gravitySensor = null
+        linearAccelerationSensor = null
 
         isCollecting = false
+        val sessionMs = System.currentTimeMillis() - collectingSinceMs
+        collectedMs += sessionMs
+        energyMeter?.addSensorActiveTime(sessionMs)
         android.util.Log.d("MotionSignalCollector", "Stopped collecting motion data")
     }
 
     override fun onSensorChanged(event: SensorEvent?) {
         if (event == null || !isCollecting) return
+        offerSample(event.sensor.type, event.values)
+    }
+
+    /**
+     * Feed a sample as if it came from the sensor of [sensorType], stamped with the current time.
+     * Used by [WorkloadGenerator]; ignored while not collecting.
+     */
+    fun injectSample(sensorType: Int, values: FloatArray) {
+        if (!isCollecting) return
+        offerSample(sensorType, values)
+    }
+
+    private fun offerSample(sensorType: Int, sensorValues: FloatArray) {
+        val cpuStart = energyMeter?.threadCpuNanos() ?: 0L
 
         val timestamp = System.currentTimeMillis()
-        val sensorType = event.sensor.type
 
         when (sensorType) {
             Sensor.TYPE_ACCELEROMETER -> {
                 // Store raw accelerometer values (x, y, z in m/s²)
                 // Copy the values array to avoid reference issues
                 val values = FloatArray(3)
-                System.arraycopy(event.values, 0, values, 0, 3)
+                System.arraycopy(sensorValues, 0, values, 0, 3)
                 accelerometerSamples.offer(Pair(timestamp, values))
             }
             Sensor.TYPE_GYROSCOPE -> {
                 // Store raw gyroscope values (x, y, z in rad/s)
                 // Copy the values array to avoid reference issues
                 val values = FloatArray(3)
-                System.arraycopy(event.values, 0, values, 0, 3)
+                System.arraycopy(sensorValues, 0, values, 0, 3)
                 gyroscopeSamples.offer(Pair(timestamp, values))
             }
+            Sensor.TYPE_GRAVITY -> {
+                // Fused gravity estimate (m/s²)
+                val values = FloatArray(3)
+                System.arraycopy(sensorValues, 0, values, 0, 3)
+                gravitySamples.offer(Pair(timestamp, values))
+            }
+            Sensor.TYPE_LINEAR_ACCELERATION -> {
+                // Fused body acceleration, gravity removed (m/s²)
+                val values = FloatArray(3)
+                System.arraycopy(sensorValues, 0, values, 0, 3)
+                linearAccelerationSamples.offer(Pair(timestamp, values))
+            }
         }
 
-        // Check if we need to flush the current window and start a new one
+        // Feature extraction for a completed window runs on the lane, off the sensor thread
+        if (timestamp >= lastWindowEndTime + timeWindowMs &&
+                        flushPending.compareAndSet(false, true)
+        ) {
+            lane.execute {
+                flushPending.set(false)
+                flushDueWindows()
+            }
+        }
+        energyMeter?.charge(EnergyMeter.Stage.SENSOR_WAKEUPS, cpuStart)
+    }
+
+    /** Wall time of the collection in progress, 0 when the sensors are off. */
+    fun activeCollectionMs(): Long =
+            if (isCollecting) System.currentTimeMillis() - collectingSinceMs else 0L
+
+    /** Flush every window whose end has passed. Runs on the lane. */
+    private fun flushDueWindows() {
         // Use time boundaries, not event timestamps, to ensure consistent window creation
-        while (timestamp >= lastWindowEndTime + timeWindowMs) {
+        val now = System.currentTimeMillis()
+        while (now >= lastWindowEndTime + timeWindowMs) {
             flushCurrentWindow()
             lastWindowEndTime =
                     lastWindowEndTime + timeWindowMs // Use window boundary, not event timestamp
@@ -167,67 +319,280 @@ class MotionSignalCollector(private val context: Context, private var config: Be
     }
 
     private fun flushCurrentWindow() {
+        extractWindow(consumeSamples = true)?.let { motionDataPoints.add(it) }
+    }
+
+    private fun extractWindow(consumeSamples: Boolean): MotionDataPoint? {
+        val cpuStart = energyMeter?.threadCpuNanos() ?: 0L
+        val point = buildCurrentWindow(consumeSamples)
+        energyMeter?.charge(EnergyMeter.Stage.MOTION_EXTRACTION, cpuStart)
+        return point
+    }
+
+    /**
+     * Compute features for samples in the current window. With [consumeSamples] false the sample
+     * buffers are left untouched (used to close one session while others keep the window open).
+     */
+    private fun buildCurrentWindow(consumeSamples: Boolean): MotionDataPoint? {
         val windowStartTime = lastWindowEndTime
         val windowEndTime = System.currentTimeMillis()
 
-        // Collect all samples within this window
-        val accelSamples = mutableListOf<Pair<Long, FloatArray>>()
-        val gyroSamples = mutableListOf<Pair<Long, FloatArray>>()
+        // Collect all samples within this window, sorted by timestamp for consistent ordering
+        val gyroSamples =
+                takeWindow(gyroscopeSamples, windowStartTime, windowEndTime, consumeSamples)
+        val accelSamples =
+                takeWindow(
+                        if (fusedGravity) linearAccelerationSamples else accelerometerSamples,
+                        windowStartTime,
+                        windowEndTime,
+                        consumeSamples
+                )
+        val fusedGravitySamples =
+                if (fusedGravity) {
+                    takeWindow(gravitySamples, windowStartTime, windowEndTime, consumeSamples)
+                } else emptyList()
 
-        // Extract accelerometer samples in this window
-        val accelIterator = accelerometerSamples.iterator()
-        while (accelIterator.hasNext()) {
-            val sample = accelIterator.next()
-            if (sample.first >= windowStartTime && sample.first < windowEndTime) {
-                accelSamples.add(sample)
-                accelIterator.remove()
-            } else if (sample.first < windowStartTime) {
-                // Remove old samples
-                accelIterator.remove()
+        // Only create data point if we have samples
+        if (accelSamples.isEmpty() && gyroSamples.isEmpty()) return null
+        // The fused streams arrive separately; a window missing either one cannot be split
+        if (fusedGravity && (accelSamples.isEmpty() || fusedGravitySamples.isEmpty())) return null
+
+        val windowStart = System.nanoTime()
+        val body: Triple3D
+        val gravity: Triple3D
+        if (fusedGravity) {
+            body = Triple(axis(accelSamples, 0), axis(accelSamples, 1), axis(accelSamples, 2))
+            gravity = resampleAt(fusedGravitySamples, accelSamples)
+        } else {
+            // Software gravity separation, timed on its own so the two paths can be compared
+            val separated =
+                    featureExtractor.separateGravity(
+                            axis(accelSamples, 0),
+                            axis(accelSamples, 1),
+                            axis(accelSamples, 2)
+                    )
+            body = separated.first
+            gravity = separated.second
+            softwareSeparationNanos += System.nanoTime() - windowStart
+        }
+
+        // Stage 1: cheap classifier; confident windows skip the 561 features and the SVC
+        val cascadeStart = System.nanoTime()
+        val decision =
+                cascadeClassifier?.classify(
+                        body.first,
+                        body.second,
+                        body.third,
+                        gravity.first,
+                        gravity.second,
+                        gravity.third
+                )
+        val extractStart = System.nanoTime()
+        if (cascadeClassifier != null) cascadeNanos += extractStart - cascadeStart
+
+        val features: Map<String, Float>
+        if (decision != null) {
+            features = emptyMap()
+            cascadeExitCount++
+        } else {
+            if (cascadeClassifier != null) cascadeFallThroughCount++
+            // Extract 561 ML features from the separated sensor data
+            features =
+                    if (body.first.isEmpty() || gyroSamples.isEmpty()) {
+                        emptyMap()
+                    } else {
+                        featureExtractor.extractFeatures(
+                                body.first,
+                                body.second,
+                                body.third,
+                                gravity.first,
+                                gravity.second,
+                                gravity.third,
+                                axis(gyroSamples, 0),
+                                axis(gyroSamples, 1),
+                                axis(gyroSamples, 2)
+                        )
+                    }
+        }
+        val windowEnd = System.nanoTime()
+        motionCpuNanos += windowEnd - windowStart
+
+        if (fusedGravity) {
+            fusedExtractionNanos += windowEnd - extractStart
+            fusedWindowCount++
+            if (consumeSamples && fusedWindowCount % GRAVITY_COMPARISON_INTERVAL == 1) {
+                compareWithSoftwareGravity(
+                        body.first,
+                        body.second,
+                        body.third,
+                        gravity.first,
+                        gravity.second,
+                        gravity.third
+                )
             }
+        } else {
+            softwareExtractionNanos += windowEnd - extractStart
+            softwareWindowCount++
         }
 
-        // Extract gyroscope samples in this window
-        val gyroIterator = gyroscopeSamples.iterator()
-        while (gyroIterator.hasNext()) {
-            val sample = gyroIterator.next()
+        // Create timestamp for this window (use window start time)
+        val timestamp = Instant.ofEpochMilli(windowStartTime)
+        val timestampString = timestampFormatter.format(timestamp)
+
+        // Create motion data point with ML features (or the stage 1 decision)
+        return MotionDataPoint(
+                timestamp = timestampString,
+                features = features,
+                cascadeState = decision?.label,
+                cascadeConfidence = decision?.confidence ?: 0f
+        )
+    }
+
+    /**
+     * Samples of [queue] inside [windowStartTime, windowEndTime), sorted by timestamp. With
+     * [consumeSamples] the window's samples and anything older are removed from the queue.
+     */
+    private fun takeWindow(
+            queue: ConcurrentLinkedQueue<Pair<Long, FloatArray>>,
+            windowStartTime: Long,
+            windowEndTime: Long,
+            consumeSamples: Boolean
+    ): List<Pair<Long, FloatArray>> {
+        val samples = mutableListOf<Pair<Long, FloatArray>>()
+        val iterator = queue.iterator()
+        while (iterator.hasNext()) {
+            val sample = iterator.next()
             if (sample.first >= windowStartTime && sample.first < windowEndTime) {
-                gyroSamples.add(sample)
-                gyroIterator.remove()
-            } else if (sample.first < windowStartTime) {
+                samples.add(sample)
+                if (consumeSamples) iterator.remove()
+            } else if (sample.first < windowStartTime && consumeSamples) {
                 // Remove old samples
-                gyroIterator.remove()
+                iterator.remove()
             }
         }
+        samples.sortBy { it.first }
+        return samples
+    }
 
-        // Only create data point if we have samples
-        if (accelSamples.isNotEmpty() || gyroSamples.isNotEmpty()) {
-            // Convert to lists of doubles (raw values)
-            // Sort by timestamp to ensure consistent ordering
-            val sortedAccel = accelSamples.sortedBy { it.first }
-            val sortedGyro = gyroSamples.sortedBy { it.first }
-
-            val accelX = sortedAccel.map { it.second[0].toDouble() }
-            val accelY = sortedAccel.map { it.second[1].toDouble() }
-            val accelZ = sortedAccel.map { it.second[2].toDouble() }
-
-            val gyroX = sortedGyro.map { it.second[0].toDouble() }
-            val gyroY = sortedGyro.map { it.second[1].toDouble() }
-            val gyroZ = sortedGyro.map { it.second[2].toDouble() }
-
-            // Extract 561 ML features from raw sensor data
-            val features =
-                    featureExtractor.extractFeatures(accelX, accelY, accelZ, gyroX, gyroY, gyroZ)
+    /**
+     * [samples] linearly interpolated at each timestamp of [reference], held at the first and last
+     * sample outside their span, so a second sensor stream lines up index for index with the
+     * first. Both lists are sorted by timestamp, and [samples] is not empty.
+     */
+    private fun resampleAt(
+            samples: List<Pair<Long, FloatArray>>,
+            reference: List<Pair<Long, FloatArray>>
+    ): Triple3D {
+        val out = Array(3) { FloatArray(reference.size) }
+        var j = 0
+        for (i in reference.indices) {
+            val t = reference[i].first
+            while (j < samples.size - 1 && samples[j + 1].first <= t) j++
+            val a = samples[j]
+            val b = if (j < samples.size - 1) samples[j + 1] else a
+            val w =
+                    if (t > a.first && b.first > a.first) {
+                        (t - a.first).toFloat() / (b.first - a.first)
+                    } else 0f
+            for (k in 0 until 3) out[k][i] = a.second[k] + w * (b.second[k] - a.second[k])
+        }
+        return Triple(out[0], out[1], out[2])
+    }
 
-            // Create timestamp for this window (use window start time)
-            val timestamp = Instant.ofEpochMilli(windowStartTime)
-            val timestampString = timestampFormatter.format(timestamp)
+    /** Unpack one axis into a float array (raw values, same precision as the sensor). */
+    private fun axis(samples: List<Pair<Long, FloatArray>>, index: Int): FloatArray =
+            FloatArray(samples.size) { samples[it].second[index] }
+
+    /**
+     * Rebuild the raw acceleration from the fused streams (linear + gravity), run the software
+     * filter over it and record how far its gravity estimate is from the fused one.
+     */
+    private fun compareWithSoftwareGravity(
+            bodyX: FloatArray,
+            bodyY: FloatArray,
+            bodyZ: FloatArray,
+            gravityX: FloatArray,
+            gravityY: FloatArray,
+            gravityZ: FloatArray
+    ) {
+        val n = minOf(bodyX.size, gravityX.size)
+        if (n == 0) return
+        val rawX = FloatArray(n) { bodyX[it] + gravityX[it] }
+        val rawY = FloatArray(n) { bodyY[it] + gravityY[it] }
+        val rawZ = FloatArray(n) { bodyZ[it] + gravityZ[it] }
+
+        val separationStart = System.nanoTime()
+        val software = featureExtractor.separateGravity(rawX, rawY, rawZ).second
+        comparisonSeparationNanos += System.nanoTime() - separationStart
+
+        var deviation = 0.0
+        for (i in 0 until n) {
+            val dx = software.first[i] - gravityX[i]
+            val dy = software.second[i] - gravityY[i]
+            val dz = software.third[i] - gravityZ[i]
+            deviation += sqrt((dx * dx + dy * dy + dz * dz).toDouble())
+        }
+        gravityDeviationSum += deviation / n
+        gravityComparisonCount++
+    }
 
-            // Create motion data point with ML features
-            val dataPoint = MotionDataPoint(timestamp = timestampString, features = features)
+    /** Computed windows and raw samples still held, for leak checks. */
+    fun getRetainedCounts(): Map<String, Long> = lane.call {
+        mapOf(
+                "motion_windows" to motionDataPoints.size.toLong(),
+                "motion_samples_buffered" to
+                        (accelerometerSamples.size +
+                                        gyroscopeSamples.size +
+                                        gravitySamples.size +
+                                        linearAccelerationSamples.size)
+                                .toLong()
+        )
+    }
 
-            motionDataPoints.add(dataPoint)
-        }
+    /**
+     * Gravity separation mode and per-window cost of the motion pipeline. In fused mode the
+     * software filter is still run on every [GRAVITY_COMPARISON_INTERVAL]th window to report its
+     * cost and its mean deviation (m/s²) from the fused gravity vector. With the cascade enabled,
+     * also reports how many windows fell through stage 1 to the full model. The end-to-end figure
+     * is native motion CPU (separation, stage 1, feature extraction) per hour of collection.
+     */
+    fun getPipelineStats(): Map<String, Any> = lane.call {
+        fun avgMs(nanos: Long, count: Int): Double =
+                if (count > 0) nanos / 1_000_000.0 / count else 0.0
+
+        val activeMs = if (isCollecting) System.currentTimeMillis() - collectingSinceMs else 0L
+        val collectedHours = (collectedMs + activeMs) / 3_600_000.0
+
+        mapOf(
+                "gravity_source" to if (fusedGravity) "fused" else "software",
+                "software_windows" to softwareWindowCount,
+                "software_separation_ms_per_window" to
+                        avgMs(softwareSeparationNanos, softwareWindowCount),
+                "software_extraction_ms_per_window" to
+                        avgMs(softwareExtractionNanos, softwareWindowCount),
+                "fused_windows" to fusedWindowCount,
+                "fused_extraction_ms_per_window" to avgMs(fusedExtractionNanos, fusedWindowCount),
+                "gravity_comparisons" to gravityComparisonCount,
+                "gravity_comparison_separation_ms" to
+                        avgMs(comparisonSeparationNanos, gravityComparisonCount),
+                "gravity_mean_deviation" to
+                        if (gravityComparisonCount > 0) {
+                            gravityDeviationSum / gravityComparisonCount
+                        } else 0.0,
+                "cascade_enabled" to (cascadeClassifier != null),
+                "cascade_exits" to cascadeExitCount,
+                "cascade_fall_through" to cascadeFallThroughCount,
+                "cascade_fall_through_rate" to
+                        if (cascadeExitCount + cascadeFallThroughCount > 0) {
+                            cascadeFallThroughCount.toDouble() /
+                                    (cascadeExitCount + cascadeFallThroughCount)
+                        } else 0.0,
+                "cascade_ms_per_window" to
+                        avgMs(cascadeNanos, cascadeExitCount + cascadeFallThroughCount),
+                "motion_cpu_ms_per_hour" to
+                        if (collectedHours > 0.0) motionCpuNanos / 1_000_000.0 / collectedHours
+                        else 0.0
+        )
     }
 
     override fun onAccuracyChanged(sensor: Sensor?, accuracy: Int) {
@@ -235,9 +600,24 @@ class MotionSignalCollector(private val context: Context, private var config: Be
     }
 
     fun dispose() {
-        stopCollecting()
-        accelerometerSamples.clear()
-        gyroscopeSamples.clear()
-        motionDataPoints.clear()
+        lane.call {
+            stopCollecting()
+            accelerometerSamples.clear()
+            gyroscopeSamples.clear()
+            gravitySamples.clear()
+            linearAccelerationSamples.clear()
+            motionDataPoints.clear()
+            sessionOffsets.clear()
+        }
+    }
+
+    companion object {
+        // Fused mode: run the software filter for comparison on one window in this many
+        private const val GRAVITY_COMPARISON_INTERVAL = 12
+
+        private fun createCascadeClassifier(config: BehaviorConfig): MotionCascadeClassifier? =
+                if (config.motionCascadeThreshold > 0.0) {
+                    MotionCascadeClassifier(config.motionCascadeThreshold.toFloat())
+                } else null
     }
 }
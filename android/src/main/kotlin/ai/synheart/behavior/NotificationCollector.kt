@@ -24,6 +24,7 @@ class NotificationCollector(private var config: BehaviorConfig) {
     private val openedNotificationTimestamps = mutableListOf<Long>()
     private val handler = Handler(Looper.getMainLooper())
     private val notificationIgnoredThresholdMs = 30000L // 30 seconds
+    private val packageDedupeWindowMs = 1000L
     // Track pending delayed tasks so we can cancel them if notification is opened
     private val pendingIgnoredTasks = mutableMapOf<String, Runnable>() // notificationId -> Runnable
 
@@ -71,7 +72,7 @@ class NotificationCollector(private var config: BehaviorConfig) {
             val lastPackageNotificationTime = packageName?.let { recentNotificationPackages[it] }
             val isNewNotificationByPackage =
                     lastPackageNotificationTime == null ||
-                            (now - lastPackageNotificationTime) >= 1000
+                            (now - lastPackageNotificationTime) >= packageDedupeWindowMs
 
             // Only emit if both checks pass (either new ID or new package notification)
             val isNewNotification = isNewNotificationById && isNewNotificationByPackage
@@ -81,7 +82,11 @@ class NotificationCollector(private var config: BehaviorConfig) {
                     "Notification ID: $id, package: $packageName, lastSeenTime: $lastSeenTime, lastPackageTime: $lastPackageNotificationTime, isNew: $isNewNotification"
             )
 
-            // Update package tracking
+            // Update package tracking. Entries only matter within the dedupe window, so drop
+            // stale ones instead of keeping one per package that ever posted.
+            if (recentNotificationPackages.size > 32) {
+                recentNotificationPackages.values.removeAll { now - it >= packageDedupeWindowMs }
+            }
             packageName?.let { recentNotificationPackages[it] = now }
 
             android.util.Log.d("NotificationCollector", "Step 1: Getting timestamp")
@@ -224,6 +229,14 @@ class NotificationCollector(private var config: BehaviorConfig) {
         )
     }
 
+    /** Sizes of the tracking maps, for leak checks. */
+    fun getTrackedCounts(): Map<String, Long> =
+            mapOf(
+                    "notifications_pending" to receivedNotificationTimestamps.size.toLong(),
+                    "notification_packages" to recentNotificationPackages.size.toLong(),
+                    "notification_tasks" to pendingIgnoredTasks.size.toLong()
+            )
+
     fun dispose() {
         // Cancel all pending tasks
         pendingIgnoredTasks.values.forEach { task -> handler.removeCallbacks(task) }
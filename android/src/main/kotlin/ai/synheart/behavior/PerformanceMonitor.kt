@@ -5,6 +5,7 @@ import android.content.Context
 import android.os.Debug
 import android.os.Process
 import java.util.concurrent.ConcurrentHashMap
+import java.util.concurrent.atomic.AtomicLong
 
 /**
  * Monitors SDK performance metrics (CPU, memory usage).
@@ -17,6 +18,12 @@ class PerformanceMonitor(private val context: Context) {
     private var lastCpuCheckTime = 0L
     private var lastCpuTime = 0L
 
+    // Speculative session summaries (see SessionPrecomputer)
+    private val speculationHits = AtomicLong()
+    private val speculationMisses = AtomicLong()
+    private val speculationSavedMs = AtomicLong()
+    private val speculationMissReasons = ConcurrentHashMap<String, AtomicLong>()
+
     fun recordSnapshot(label: String = "default") {
         val now = System.currentTimeMillis()
         val memoryInfo = getMemoryUsage()
@@ -33,6 +40,27 @@ class PerformanceMonitor(private val context: Context) {
         metrics[label] = metric
     }
 
+    /**
+     * Record whether endSession reused a speculative summary, how much time it saved and, on a
+     * miss, why (see SessionPrecomputer.Result.missReason).
+     */
+    fun recordSpeculation(hit: Boolean, savedMs: Long, missReason: String? = null) {
+        if (hit) speculationHits.incrementAndGet() else speculationMisses.incrementAndGet()
+        speculationSavedMs.addAndGet(savedMs)
+        if (missReason != null) {
+            speculationMissReasons.getOrPut(missReason) { AtomicLong() }.incrementAndGet()
+        }
+    }
+
+    fun getSpeculationStats(): SpeculationStats {
+        return SpeculationStats(
+            hits = speculationHits.get(),
+            misses = speculationMisses.get(),
+            savedMs = speculationSavedMs.get(),
+            missReasons = speculationMissReasons.mapValues { it.value.get() }
+        )
+    }
+
     fun getMetrics(): Map<String, PerformanceMetrics> {
         return metrics.toMap()
     }
@@ -101,6 +129,7 @@ class PerformanceMonitor(private val context: Context) {
 
     fun printReport(): String {
         val summary = getSummary()
+        val speculation = getSpeculationStats()
 
         return buildString {
             appendLine("=== Synheart Behavior SDK Performance Report ===")
@@ -117,6 +146,14 @@ class PerformanceMonitor(private val context: Context) {
             appendLine("  Target: <2%")
             appendLine("  Status: ${if (summary.maxCpuPercent < 2.0) "✓ PASS" else "✗ FAIL"}")
             appendLine()
+            appendLine("Speculative Session Summaries:")
+            appendLine("  Hits: ${speculation.hits} / ${speculation.hits + speculation.misses}")
+            appendLine("  Hit Rate: ${(speculation.hitRate() * 100.0).format()}%")
+            appendLine("  Saved: ${speculation.savedMs} ms")
+            for ((reason, count) in speculation.missReasons) {
+                appendLine("  Misses ($reason): $count")
+            }
+            appendLine()
             appendLine("Overall Performance: ${if (summary.passesRequirements()) "✓ PASS" else "⚠ REVIEW NEEDED"}")
         }
     }
@@ -143,3 +180,24 @@ data class PerformanceSummary(
         return maxMemoryKB < 500 && maxCpuPercent < 2.0
     }
 }
+
+data class SpeculationStats(
+    val hits: Long,
+    val misses: Long,
+    val savedMs: Long,
+    val missReasons: Map<String, Long> = emptyMap()
+) {
+    fun hitRate(): Double {
+        val total = hits + misses
+        return if (total > 0) hits.toDouble() / total else 0.0
+    }
+
+    fun toMap(): Map<String, Any> =
+        mapOf(
+            "hits" to hits,
+            "misses" to misses,
+            "hit_rate" to hitRate(),
+            "saved_ms" to savedMs,
+            "miss_reasons" to missReasons
+        )
+}
@@ -0,0 +1,351 @@
+package ai.synheart.behavior
+
+import java.io.BufferedInputStream
+import java.io.BufferedOutputStream
+import java.io.DataInputStream
+import java.io.DataOutputStream
+import java.io.File
+import java.io.FileInputStream
+import java.io.FileOutputStream
+import java.io.IOException
+import java.util.TimeZone
+
+/**
+ * Cross-session rollups of session counts and core metrics, per hour and per local day.
+ *
+ * Each ended session is added to one hourly and one daily slot in O(1). Slots live in fixed-size
+ * rings: daily slots cover [retentionDays], and hourly slots cover the most recent
+ * [MAX_HOURLY_DAYS] of them. So memory is bounded (~125 KB at the maximum retention). A slot is
+ * reused (and reset) once its period falls out of the window. Only aggregates are kept, no events
+ * or session IDs.
+ *
+ * Sessions are attributed to the hour and local day in which they end. A trend query reads at most
+ * a few hundred slots, so multi-week queries stay in the microsecond range. Flux scores are
+ * averaged over the sessions that had them ([Field.SCORED_SESSION_COUNT]), so sessions ended
+ * without metrics do not pull the averages towards zero.
+ *
+ * With a [file], the rings survive restarts: [load] reads them back, and every [record] rewrites
+ * the file on a background serial queue (temp file, sync, rename, as for checkpoint snapshots).
+ * With a [cipher], the file is one [SegmentCipher] segment and must end in its final frame. A file
+ * that fails to open is deleted and the store starts empty.
+ */
+class RollupStore(
+        retentionDays: Int,
+        private val file: File? = null,
+        private val cipher: SegmentCipher? = null
+) {
+
+    /** Aggregated fields, in slot column order. */
+    enum class Field(val key: String) {
+        SESSION_COUNT("session_count"),
+        DURATION_MS("total_duration_ms"),
+        EVENT_COUNT("event_count"),
+        APP_SWITCH_COUNT("app_switch_count"),
+        NOTIFICATION_COUNT("notification_count"),
+        CALL_COUNT("call_count"),
+        CLIPBOARD_COUNT("clipboard_count"),
+        DEEP_FOCUS_BLOCKS("deep_focus_blocks"),
+        FOCUS_HINT_SUM("focus_hint"),
+        DISTRACTION_SUM("behavioral_distraction_score"),
+        INTERACTION_INTENSITY_SUM("interaction_intensity"),
+        SCORED_SESSION_COUNT("scored_session_count")
+    }
+
+    enum class Granularity(val key: String) {
+        HOUR("hour"),
+        DAY("day"),
+        WEEK("week")
+    }
+
+    private val retentionDays = retentionDays.coerceIn(1, MAX_RETENTION_DAYS)
+    private val hourly = Ring(minOf(this.retentionDays, MAX_HOURLY_DAYS) * 24)
+    private val daily = Ring(this.retentionDays)
+    private val writer = file?.let { BehaviorExecutor.SerialQueue(BehaviorExecutor.QoS.BACKGROUND) }
+
+    /** Add one ended session. Metric sums are averaged per scored session when queried. */
+    @Synchronized
+    fun record(
+            endTimeMs: Long,
+            durationMs: Long,
+            eventCount: Int,
+            appSwitchCount: Int,
+            notificationCount: Int,
+            callCount: Int,
+            clipboardCount: Int,
+            behavioralMetrics: Map<String, Any>
+    ) {
+        val values = DoubleArray(FIELD_COUNT)
+        values[Field.SESSION_COUNT.ordinal] = 1.0
+        values[Field.DURATION_MS.ordinal] = durationMs.toDouble()
+        values[Field.EVENT_COUNT.ordinal] = eventCount.toDouble()
+        values[Field.APP_SWITCH_COUNT.ordinal] = appSwitchCount.toDouble()
+        values[Field.NOTIFICATION_COUNT.ordinal] = notificationCount.toDouble()
+        values[Field.CALL_COUNT.ordinal] = callCount.toDouble()
+        values[Field.CLIPBOARD_COUNT.ordinal] = clipboardCount.toDouble()
+        values[Field.DEEP_FOCUS_BLOCKS.ordinal] =
+                (behavioralMetrics["deep_focus_blocks"] as? List<*>)?.size?.toDouble() ?: 0.0
+        // Flux reports its three scores together; a session without them is not scored
+        val focusHint = behavioralMetrics["focus_hint"] as? Number
+        val distraction = behavioralMetrics["behavioral_distraction_score"] as? Number
+        val intensity = behavioralMetrics["interaction_intensity"] as? Number
+        if (focusHint != null && distraction != null && intensity != null) {
+            values[Field.FOCUS_HINT_SUM.ordinal] = focusHint.toDouble()
+            values[Field.DISTRACTION_SUM.ordinal] = distraction.toDouble()
+            values[Field.INTERACTION_INTENSITY_SUM.ordinal] = intensity.toDouble()
+            values[Field.SCORED_SESSION_COUNT.ordinal] = 1.0
+        }
+
+        val localMs = localTime(TimeZone.getDefault(), endTimeMs)
+        hourly.add(Math.floorDiv(localMs, HOUR_MS), values)
+        daily.add(Math.floorDiv(localMs, DAY_MS), values)
+        persist()
+    }
+
+    /**
+     * Read the rings saved by a previous process. Call once, before the first [record]. Slots are
+     * re-added one by one, so a file written with another retention keeps what still fits.
+     */
+    @Synchronized
+    fun load() {
+        val source = file ?: return
+        if (!source.exists()) return
+        try {
+            openFile(source).use { input ->
+                if (input.readInt() != MAGIC ||
+                                input.readInt() != FORMAT_VERSION ||
+                                input.readInt() != FIELD_COUNT
+                ) {
+                    throw IOException("Unsupported rollup file")
+                }
+                hourly.read(input)
+                daily.read(input)
+            }
+        } catch (e: Exception) {
+            android.util.Log.w("BehaviorSDK", "Dropping unreadable rollups: ${e.message}")
+            hourly.clear()
+            daily.clear()
+            source.delete()
+        }
+    }
+
+    /**
+     * Buckets between [startMs] and [endMs] (inclusive, clamped to the retained slots) at the
+     * given granularity, oldest first. Empty periods are included with zero counts, so a chart
+     * gets a continuous series. Weeks are local ISO weeks (Monday start), built from daily slots.
+     * Bucket starts are in epoch milliseconds, each converted with the UTC offset in effect at that
+     * bucket, so a range across a daylight saving change stays aligned. A local hour skipped by
+     * the change has no bucket.
+     */
+    @Synchronized
+    fun trend(granularity: Granularity, startMs: Long, endMs: Long): List<Map<String, Any>> {
+        val zone = TimeZone.getDefault()
+        val ring = if (granularity == Granularity.HOUR) hourly else daily
+        val periodMs = if (granularity == Granularity.HOUR) HOUR_MS else DAY_MS
+
+        val last = Math.floorDiv(localTime(zone, endMs), periodMs)
+        val first =
+                maxOf(Math.floorDiv(localTime(zone, startMs), periodMs), last - ring.capacity + 1)
+        if (first > last) return emptyList()
+
+        val buckets = mutableListOf<Map<String, Any>>()
+        if (granularity == Granularity.WEEK) {
+            // Day 0 (1970-01-01) was a Thursday; shift by 3 so weeks start on Monday
+            var week = Math.floorDiv(first + 3, 7L)
+            while (week * 7 - 3 <= last) {
+                val sums = DoubleArray(FIELD_COUNT)
+                val weekStart = week * 7 - 3
+                for (day in maxOf(weekStart, first)..minOf(weekStart + 6, last)) {
+                    ring.addInto(day, sums)
+                }
+                buckets.add(bucket(dayStart(zone, weekStart), sums))
+                week++
+            }
+        } else {
+            for (period in first..last) {
+                val startMs =
+                        if (granularity == Granularity.HOUR) {
+                            utcTime(zone, period * HOUR_MS) ?: continue // Nothing recorded there
+                        } else dayStart(zone, period)
+                val sums = DoubleArray(FIELD_COUNT)
+                ring.addInto(period, sums)
+                buckets.add(bucket(startMs, sums))
+            }
+        }
+        return buckets
+    }
+
+    @Synchronized
+    fun clear() {
+        hourly.clear()
+        daily.clear()
+        persist()
+    }
+
+    /** Block until every queued write of [file] has finished. */
+    fun flush() {
+        writer?.call {}
+    }
+
+    /** Queue a rewrite of [file] with a copy of the rings taken under the store's lock. */
+    private fun persist() {
+        val target = file ?: return
+        val hourlyCopy = hourly.copy()
+        val dailyCopy = daily.copy()
+        writer?.execute {
+            try {
+                write(target, hourlyCopy, dailyCopy)
+            } catch (e: IOException) {
+                android.util.Log.w("BehaviorSDK", "Rollup write failed: ${e.message}")
+            }
+        }
+    }
+
+    private fun write(target: File, hourlyCopy: Ring, dailyCopy: Ring) {
+        target.parentFile?.mkdirs()
+        val temp = File(target.path + TEMP_SUFFIX)
+        FileOutputStream(temp).use { stream ->
+            val sealed = cipher?.sealing(stream, associatedData(target))
+            val out = DataOutputStream(sealed ?: BufferedOutputStream(stream))
+            out.writeInt(MAGIC)
+            out.writeInt(FORMAT_VERSION)
+            out.writeInt(FIELD_COUNT)
+            hourlyCopy.write(out)
+            dailyCopy.write(out)
+            if (sealed != null) sealed.finish() else out.flush()
+            stream.fd.sync()
+        }
+        if (!temp.renameTo(target)) throw IOException("Could not replace ${target.name}")
+    }
+
+    private fun openFile(source: File): DataInputStream {
+        val input = FileInputStream(source)
+        return try {
+            DataInputStream(
+                    cipher?.opening(input, associatedData(source), requireFinal = true)
+                            ?: BufferedInputStream(input)
+            )
+        } catch (e: IOException) {
+            input.close()
+            throw e
+        }
+    }
+
+    /** Local wall time of [utcMs] in [zone], as milliseconds since the local epoch. */
+    private fun localTime(zone: TimeZone, utcMs: Long): Long = utcMs + zone.getOffset(utcMs)
+
+    /**
+     * Epoch milliseconds of local wall time [localMs] in [zone]: the earlier one when a clock
+     * change repeats it, null when a clock change skips it.
+     */
+    private fun utcTime(zone: TimeZone, localMs: Long): Long? {
+        var result: Long? = null
+        // The offset at that time is the one in effect shortly before or after it
+        val candidates =
+                intArrayOf(zone.getOffset(localMs - DAY_MS), zone.getOffset(localMs + DAY_MS))
+        for (offset in candidates) {
+            val utcMs = localMs - offset
+            if (zone.getOffset(utcMs) == offset && (result == null || utcMs < result)) {
+                result = utcMs
+            }
+        }
+        return result
+    }
+
+    /** First instant of local day [day] in [zone], also when its midnight is skipped. */
+    private fun dayStart(zone: TimeZone, day: Long): Long =
+            utcTime(zone, day * DAY_MS) ?: (day * DAY_MS - zone.getOffset(day * DAY_MS - DAY_MS))
+
+    private fun bucket(startMs: Long, sums: DoubleArray): Map<String, Any> {
+        val scored = sums[Field.SCORED_SESSION_COUNT.ordinal]
+        val result = LinkedHashMap<String, Any>()
+        result["bucket_start_ms"] = startMs
+        for (field in Field.values()) {
+            val value = sums[field.ordinal]
+            result[field.key] =
+                    when (field) {
+                        // Averages of the Flux scores over the sessions that had them
+                        Field.FOCUS_HINT_SUM,
+                        Field.DISTRACTION_SUM,
+                        Field.INTERACTION_INTENSITY_SUM ->
+                                if (scored > 0) value / scored else 0.0
+                        Field.DURATION_MS -> value.toLong()
+                        else -> value.toInt()
+                    }
+        }
+        return result
+    }
+
+    /** Fixed-capacity ring of slots keyed by period index (epoch hour or epoch day). */
+    private class Ring(val capacity: Int) {
+        private val periods = LongArray(capacity) { Long.MIN_VALUE }
+        private val values = DoubleArray(capacity * FIELD_COUNT)
+
+        fun add(period: Long, delta: DoubleArray) {
+            val slot = Math.floorMod(period, capacity.toLong()).toInt()
+            val base = slot * FIELD_COUNT
+            if (periods[slot] > period) return // Older than the retained window
+            if (periods[slot] != period) {
+                // Slot held an older period that has left the retention window
+                periods[slot] = period
+                values.fill(0.0, base, base + FIELD_COUNT)
+            }
+            for (i in 0 until FIELD_COUNT) values[base + i] += delta[i]
+        }
+
+        fun addInto(period: Long, sums: DoubleArray) {
+            val slot = Math.floorMod(period, capacity.toLong()).toInt()
+            if (periods[slot] != period) return
+            val base = slot * FIELD_COUNT
+            for (i in 0 until FIELD_COUNT) sums[i] += values[base + i]
+        }
+
+        fun clear() {
+            periods.fill(Long.MIN_VALUE)
+            values.fill(0.0)
+        }
+
+        fun copy(): Ring =
+                Ring(capacity).also {
+                    periods.copyInto(it.periods)
+                    values.copyInto(it.values)
+                }
+
+        /** Occupied slots as (period, values); empty slots are not written. */
+        fun write(out: DataOutputStream) {
+            out.writeInt(periods.count { it != Long.MIN_VALUE })
+            for (slot in 0 until capacity) {
+                if (periods[slot] == Long.MIN_VALUE) continue
+                out.writeLong(periods[slot])
+                val base = slot * FIELD_COUNT
+                for (i in 0 until FIELD_COUNT) out.writeDouble(values[base + i])
+            }
+        }
+
+        fun read(input: DataInputStream) {
+            val delta = DoubleArray(FIELD_COUNT)
+            repeat(input.readInt()) {
+                val period = input.readLong()
+                for (i in 0 until FIELD_COUNT) delta[i] = input.readDouble()
+                add(period, delta)
+            }
+        }
+    }
+
+    companion object {
+        const val MAX_RETENTION_DAYS = 366
+
+        // Hourly detail is kept for at most five weeks; older trends use daily slots
+        const val MAX_HOURLY_DAYS = 35
+
+        private val FIELD_COUNT = Field.values().size
+
+        private const val MAGIC = 0x5342524c // "SBRL"
+        private const val FORMAT_VERSION = 1
+        private const val TEMP_SUFFIX = ".tmp"
+        private const val HOUR_MS = 3_600_000L
+        private const val DAY_MS = 86_400_000L
+
+        /** Binds an encrypted rollup file to its name, as checkpoints bind theirs. */
+        private fun associatedData(file: File): ByteArray = file.name.toByteArray(Charsets.UTF_8)
+    }
+}
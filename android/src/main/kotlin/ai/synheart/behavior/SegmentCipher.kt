@@ -0,0 +1,324 @@
+package ai.synheart.behavior
+
+import java.io.BufferedInputStream
+import java.io.BufferedOutputStream
+import java.io.DataInputStream
+import java.io.EOFException
+import java.io.File
+import java.io.FileInputStream
+import java.io.FileOutputStream
+import java.io.IOException
+import java.io.InputStream
+import java.io.OutputStream
+import java.security.GeneralSecurityException
+import java.security.SecureRandom
+import javax.crypto.Cipher
+import javax.crypto.KeyGenerator
+import javax.crypto.SecretKey
+import javax.crypto.spec.GCMParameterSpec
+
+/**
+ * Supplies the key for encrypted session checkpoints. Register one with
+ * [SynheartBehaviorPlugin.checkpointKeyProvider] before `initialize`.
+ */
+fun interface CheckpointKeyProvider {
+    /**
+     * A 128- or 256-bit AES key, or null when none is available (checkpoints are then not written).
+     *
+     * The key must accept caller-chosen GCM nonces. Android Keystore keys reject them by default
+     * and run every operation in secure hardware, so keep a data key wrapped by a Keystore key
+     * and return the unwrapped data key here.
+     */
+    fun checkpointKey(): SecretKey?
+}
+
+/**
+ * Streaming AEAD for checkpoint segments: AES-GCM over frames of up to [FRAME_BYTES] plaintext.
+ *
+ * A file starts with a plaintext preamble (magic, version, random 8-byte nonce prefix). Each frame
+ * is `[length][flags][ciphertext + tag]`, and its nonce is the prefix plus the frame counter, so
+ * frames cannot be reordered, dropped or moved to another file. The caller's associated data
+ * (file kind and session key) and the frame flags are authenticated with every frame. The last
+ * frame of a finished file carries [FLAG_FINAL]; readers that require it detect truncation.
+ *
+ * [SealingOutputStream.flush] seals what is buffered as a frame, so an append-only log loses at
+ * most the frame torn by a kill, as with the plaintext CRC-framed log.
+ *
+ * AES-GCM goes through the platform JCA provider (Conscrypt on Android, backed by BoringSSL),
+ * which uses ARMv8 Crypto Extensions or AES-NI with carry-less multiply when the CPU has them
+ * and constant-time software otherwise.
+ */
+class SegmentCipher(private val key: SecretKey) {
+
+    /** Encrypting stream over [out]. The preamble is written immediately. */
+    fun sealing(out: OutputStream, associatedData: ByteArray): SealingOutputStream =
+            SealingOutputStream(out, associatedData)
+
+    /**
+     * Decrypting stream over [input]. Throws [IOException] when the preamble does not match, a
+     * frame fails authentication, or [requireFinal] is set and the file ends before its final
+     * frame. A frame torn by a kill ends the stream with [EOFException].
+     */
+    fun opening(
+            input: InputStream,
+            associatedData: ByteArray,
+            requireFinal: Boolean
+    ): InputStream = OpeningInputStream(input, associatedData, requireFinal)
+
+    inner class SealingOutputStream internal constructor(
+            private val out: OutputStream,
+            private val associatedData: ByteArray
+    ) : OutputStream() {
+        private val cipher = Cipher.getInstance(TRANSFORMATION)
+        private val noncePrefix = ByteArray(PREFIX_BYTES).also { random.nextBytes(it) }
+        private val nonce = ByteArray(NONCE_BYTES)
+        private val plain = ByteArray(FRAME_BYTES)
+        private val frame = ByteArray(HEADER_BYTES + FRAME_BYTES + TAG_BYTES)
+        private var buffered = 0
+        private var counter = 0L
+        private var finished = false
+
+        init {
+            val preamble = ByteArray(PREAMBLE_BYTES)
+            putInt(preamble, 0, MAGIC)
+            putInt(preamble, 4, VERSION)
+            noncePrefix.copyInto(preamble, 8)
+            out.write(preamble)
+        }
+
+        override fun write(b: Int) {
+            if (buffered == FRAME_BYTES) seal(final = false)
+            plain[buffered++] = b.toByte()
+        }
+
+        override fun write(b: ByteArray, off: Int, len: Int) {
+            var offset = off
+            var remaining = len
+            while (remaining > 0) {
+                if (buffered == FRAME_BYTES) seal(final = false)
+                val n = minOf(remaining, FRAME_BYTES - buffered)
+                System.arraycopy(b, offset, plain, buffered, n)
+                buffered += n
+                offset += n
+                remaining -= n
+            }
+        }
+
+        /** Seal the buffered bytes as a frame and flush it to the underlying stream. */
+        override fun flush() {
+            if (buffered > 0) seal(final = false)
+            out.flush()
+        }
+
+        /** Seal the final frame. The underlying stream stays open (e.g. to sync it). */
+        fun finish() {
+            if (finished) return
+            seal(final = true)
+            out.flush()
+            finished = true
+        }
+
+        override fun close() {
+            try {
+                finish()
+            } finally {
+                out.close()
+            }
+        }
+
+        private fun seal(final: Boolean) {
+            if (finished) throw IOException("Segment already finished")
+            if (counter > MAX_FRAMES) throw IOException("Segment too long")
+            val flags = if (final) FLAG_FINAL else 0
+            try {
+                cipher.init(Cipher.ENCRYPT_MODE, key, GCMParameterSpec(TAG_BITS, nonceFor(counter)))
+                cipher.updateAAD(associatedData)
+                cipher.updateAAD(byteArrayOf(flags.toByte()))
+                val length = cipher.doFinal(plain, 0, buffered, frame, HEADER_BYTES)
+                putInt(frame, 0, length)
+                frame[4] = flags.toByte()
+                out.write(frame, 0, HEADER_BYTES + length)
+            } catch (e: GeneralSecurityException) {
+                throw IOException("Segment encryption failed", e)
+            }
+            buffered = 0
+            counter++
+        }
+
+        private fun nonceFor(frameIndex: Long): ByteArray {
+            noncePrefix.copyInto(nonce)
+            putInt(nonce, PREFIX_BYTES, frameIndex.toInt())
+            return nonce
+        }
+    }
+
+    private inner class OpeningInputStream(
+            input: InputStream,
+            private val associatedData: ByteArray,
+            private val requireFinal: Boolean
+    ) : InputStream() {
+        private val input = DataInputStream(BufferedInputStream(input))
+        private val cipher = Cipher.getInstance(TRANSFORMATION)
+        private val nonce = ByteArray(NONCE_BYTES)
+        private val frame = ByteArray(FRAME_BYTES + TAG_BYTES)
+        private val plain = ByteArray(FRAME_BYTES)
+        private var position = 0
+        private var available = 0
+        private var counter = 0L
+        private var sawFinal = false
+
+        init {
+            if (this.input.readInt() != MAGIC || this.input.readInt() != VERSION) {
+                throw IOException("Not an encrypted segment")
+            }
+            this.input.readFully(nonce, 0, PREFIX_BYTES)
+        }
+
+        override fun read(): Int {
+            if (position == available && !nextFrame()) return -1
+            return plain[position++].toInt() and 0xff
+        }
+
+        override fun read(b: ByteArray, off: Int, len: Int): Int {
+            if (len == 0) return 0
+            if (position == available && !nextFrame()) return -1
+            val n = minOf(len, available - position)
+            System.arraycopy(plain, position, b, off, n)
+            position += n
+            return n
+        }
+
+        override fun close() {
+            input.close()
+        }
+
+        /** Decrypt the next frame into [plain]; false at the end of the segment. */
+        private fun nextFrame(): Boolean {
+            while (true) {
+                val length =
+                        try {
+                            input.readInt()
+                        } catch (e: EOFException) {
+                            if (requireFinal && !sawFinal) throw IOException("Segment truncated")
+                            return false
+                        }
+                if (sawFinal) throw IOException("Data after the final frame")
+                if (length < TAG_BYTES || length > FRAME_BYTES + TAG_BYTES) {
+                    throw IOException("Invalid frame length")
+                }
+                val flags = input.readByte()
+                input.readFully(frame, 0, length)
+                try {
+                    putInt(nonce, PREFIX_BYTES, counter.toInt())
+                    cipher.init(Cipher.DECRYPT_MODE, key, GCMParameterSpec(TAG_BITS, nonce))
+                    cipher.updateAAD(associatedData)
+                    cipher.updateAAD(byteArrayOf(flags))
+                    available = cipher.doFinal(frame, 0, length, plain, 0)
+                } catch (e: GeneralSecurityException) {
+                    throw IOException("Segment authentication failed", e)
+                }
+                position = 0
+                counter++
+                sawFinal = flags.toInt() and FLAG_FINAL != 0
+                if (available > 0) return true
+            }
+        }
+    }
+
+    companion object {
+        /** Plaintext bytes per frame. */
+        const val FRAME_BYTES = 64 * 1024
+
+        private const val TRANSFORMATION = "AES/GCM/NoPadding"
+        private const val MAGIC = 0x53424345 // "SBCE"
+        private const val VERSION = 1
+        private const val PREFIX_BYTES = 8
+        private const val NONCE_BYTES = 12
+        private const val PREAMBLE_BYTES = 8 + PREFIX_BYTES
+        private const val HEADER_BYTES = 5 // Frame length and flags
+        private const val TAG_BITS = 128
+        private const val TAG_BYTES = TAG_BITS / 8
+        private const val FLAG_FINAL = 1
+        private const val MAX_FRAMES = 0xffffffffL
+        private const val CHUNK_BYTES = 8 * 1024
+        private const val BENCHMARK_RUNS = 3
+
+        private val random = SecureRandom()
+
+        /** A fresh random 256-bit AES key. */
+        fun generateKey(): SecretKey =
+                KeyGenerator.getInstance("AES").apply { init(256) }.generateKey()
+
+        /**
+         * Throughput of writing and reading [bytes] through the page cache in [directory], plain
+         * and encrypted with [key], in MB/s. Each path runs three times and the best run counts.
+         */
+        fun benchmark(directory: File, key: SecretKey, bytes: Int): Map<String, Any> {
+            directory.mkdirs()
+            val file = File(directory, "segment_benchmark.tmp")
+            val cipher = SegmentCipher(key)
+            val data = ByteArray(CHUNK_BYTES).also { java.util.Random(42).nextBytes(it) }
+            val associatedData = "benchmark".toByteArray(Charsets.UTF_8)
+
+            fun timed(block: () -> Unit): Long {
+                val start = System.nanoTime()
+                block()
+                return System.nanoTime() - start
+            }
+            fun write(encrypted: Boolean) = timed {
+                val stream = FileOutputStream(file)
+                val out =
+                        if (encrypted) cipher.sealing(stream, associatedData)
+                        else BufferedOutputStream(stream, FRAME_BYTES)
+                out.use {
+                    var written = 0
+                    while (written < bytes) {
+                        val n = minOf(CHUNK_BYTES, bytes - written)
+                        it.write(data, 0, n)
+                        written += n
+                    }
+                }
+            }
+            fun read(encrypted: Boolean) = timed {
+                val stream = FileInputStream(file)
+                val input =
+                        if (encrypted) cipher.opening(stream, associatedData, requireFinal = true)
+                        else BufferedInputStream(stream, FRAME_BYTES)
+                input.use {
+                    val buffer = ByteArray(CHUNK_BYTES)
+                    while (it.read(buffer) >= 0) {}
+                }
+            }
+            fun throughput(nanos: Long) = bytes / 1e6 / (maxOf(nanos, 1L) / 1e9)
+
+            try {
+                val results = LinkedHashMap<String, Any>()
+                for (encrypted in listOf(false, true)) {
+                    var bestWrite = Long.MAX_VALUE
+                    var bestRead = Long.MAX_VALUE
+                    repeat(BENCHMARK_RUNS) {
+                        bestWrite = minOf(bestWrite, write(encrypted))
+                        bestRead = minOf(bestRead, read(encrypted))
+                    }
+                    results[if (encrypted) "encrypted" else "plaintext"] =
+                            mapOf(
+                                    "write_mb_s" to throughput(bestWrite),
+                                    "read_mb_s" to throughput(bestRead)
+                            )
+                }
+                results["bytes"] = bytes
+                results["cipher_provider"] = Cipher.getInstance(TRANSFORMATION).provider.name
+                return results
+            } finally {
+                file.delete()
+            }
+        }
+
+        private fun putInt(buffer: ByteArray, offset: Int, value: Int) {
+            buffer[offset] = (value ushr 24).toByte()
+            buffer[offset + 1] = (value ushr 16).toByte()
+            buffer[offset + 2] = (value ushr 8).toByte()
+            buffer[offset + 3] = value.toByte()
+        }
+    }
+}
@@ -0,0 +1,611 @@
+package ai.synheart.behavior
+
+import java.io.BufferedInputStream
+import java.io.BufferedOutputStream
+import java.io.ByteArrayOutputStream
+import java.io.DataInputStream
+import java.io.DataOutputStream
+import java.io.EOFException
+import java.io.File
+import java.io.FileInputStream
+import java.io.FileOutputStream
+import java.io.IOException
+import java.security.MessageDigest
+import java.util.concurrent.ScheduledFuture
+import java.util.concurrent.atomic.AtomicLong
+import java.util.zip.CRC32
+
+/**
+ * Crash-safe checkpoints of the active sessions, so a session survives the process being killed in
+ * the background (opt-in via [BehaviorConfig.enableSessionCheckpoints]).
+ *
+ * Each session has two files in [directory]:
+ * - `<key>.snap`: a compact snapshot of the session header, counters and events, tagged with a
+ *   generation.
+ * - `<key>.log`: an append-only delta log of the events and counter changes since that snapshot.
+ *   It starts with the same generation.
+ *
+ * The caller only queues a delta. Encoding and file writes run on a background serial queue of
+ * [BehaviorExecutor], batched every [FLUSH_DELAY_MS]. Log records are length-prefixed and
+ * CRC-checked. On restore, a record torn by a kill mid-write is dropped, along with anything after
+ * it.
+ *
+ * Once the log reaches [COMPACT_AFTER_RECORDS] records, or the app is backgrounded, the snapshot is
+ * rewritten with the next generation and the log is restarted. The new snapshot goes to a temp
+ * file, is synced, and then renamed over the old one; only then is the log truncated, so a
+ * snapshot that fails to write leaves the previous snapshot and its log in use. A log whose
+ * generation does not match the snapshot is left over from before a compaction and is ignored.
+ * The page cache outlives a process kill, so log batches are not synced.
+ *
+ * Deltas are written in the order the SDK appends events, so the first N rows of a session's
+ * [SessionEventLog] are always the N events already checkpointed.
+ *
+ * With a [cipher], both files are encrypted at rest as [SegmentCipher] segments bound to their
+ * kind and session key; each log batch is sealed as one frame. Checkpoints written with the other
+ * setting (or another key) fail to open on restore and are deleted.
+ */
+class SessionCheckpointer(
+        private val directory: File,
+        private val energyMeter: EnergyMeter? = null,
+        private val cipher: SegmentCipher? = null
+) {
+
+    /** A checkpointed session: header and counters in [data] (no events), plus its events. */
+    class RestoredSession(val data: SessionData, val events: List<BehaviorEvent>)
+
+    private sealed class Op {
+        class Begin(val data: SessionData, val eventCount: Int) : Op()
+        class Append(val sessionId: String, val event: BehaviorEvent) : Op()
+        class Counters(
+                val sessionId: String,
+                val appSwitchCount: Int,
+                val orientationChanges: Int
+        ) : Op()
+        class Compact(val sessionId: String?) : Op() // null compacts every session
+        class End(val sessionId: String) : Op()
+    }
+
+    /** Per-session file state; only touched on the checkpoint queue. */
+    private class Checkpoint(val data: SessionData, val key: String) {
+        var generation = 0L
+        var eventCount = 0 // Events in the snapshot plus the log
+        var logRecords = 0
+        var log: DataOutputStream? = null
+        var appSwitchCount = 0
+        var orientationChanges = 0
+    }
+
+    private val queue = BehaviorExecutor.SerialQueue(BehaviorExecutor.QoS.BACKGROUND)
+    private val pending = ArrayList<Op>()
+    private var flushScheduled = false
+    private var delayedFlush: ScheduledFuture<*>? = null // Guarded by pending
+    private val flushRunnable = Runnable {
+        val cpuStart = energyMeter?.threadCpuNanos() ?: 0L
+        flush()
+        energyMeter?.charge(EnergyMeter.Stage.CHECKPOINT, cpuStart)
+    }
+    private val checkpoints = HashMap<String, Checkpoint>()
+    private val record = ByteArrayOutputStream()
+    private val recordOut = DataOutputStream(record)
+    private val crc = CRC32()
+
+    // Cost accounting, read from any thread
+    private val eventsLogged = AtomicLong()
+    private val enqueueNanos = AtomicLong()
+    private val writeNanos = AtomicLong()
+    private val bytesWritten = AtomicLong()
+    private val snapshotsWritten = AtomicLong()
+    @Volatile private var restoreMs = 0.0
+    @Volatile private var restoredEvents = 0
+
+    /**
+     * Start checkpointing [data]. Events already in its event log (a restored session's replayed
+     * events) go into the first snapshot. Replaces any checkpoint with the same ID.
+     */
+    fun begin(data: SessionData) {
+        enqueue(Op.Begin(data, data.events.size), urgent = false)
+    }
+
+    /** Log an event appended to the session's event log. */
+    fun append(sessionId: String, event: BehaviorEvent) {
+        val start = System.nanoTime()
+        enqueue(Op.Append(sessionId, event), urgent = false)
+        enqueueNanos.addAndGet(System.nanoTime() - start)
+    }
+
+    /** Log the counters that change outside events (app switches, orientation changes). */
+    fun updateCounters(data: SessionData) {
+        enqueue(
+                Op.Counters(data.sessionId, data.appSwitchCount, data.orientationChangeCount),
+                urgent = false
+        )
+    }
+
+    /** Write fresh snapshots now, e.g. when the app is backgrounded and may be killed. */
+    fun compact() {
+        enqueue(Op.Compact(null), urgent = true)
+    }
+
+    /** The session ended normally: drop its checkpoint. */
+    fun end(sessionId: String) {
+        enqueue(Op.End(sessionId), urgent = true)
+    }
+
+    /** Flush pending deltas and close the logs. Checkpoints stay on disk. */
+    fun close() {
+        synchronized(pending) { delayedFlush?.cancel(false) }
+        queue.execute {
+            flush()
+            for (checkpoint in checkpoints.values) closeLog(checkpoint)
+            checkpoints.clear()
+        }
+    }
+
+    /**
+     * Read every checkpoint left by a previous process, oldest session first. Call once, before any
+     * session starts. Checkpoints not written to for [maxAgeMs] are deleted instead.
+     */
+    fun restore(maxAgeMs: Long = MAX_CHECKPOINT_AGE_MS): List<RestoredSession> {
+        val start = System.nanoTime()
+        val now = System.currentTimeMillis()
+        val files = directory.listFiles() ?: emptyArray()
+        val restored = mutableListOf<RestoredSession>()
+
+        for (file in files) {
+            if (!file.name.endsWith(SNAPSHOT_SUFFIX)) continue
+            val key = file.name.removeSuffix(SNAPSHOT_SUFFIX)
+            val logFile = File(directory, key + LOG_SUFFIX)
+            val lastWrite = maxOf(file.lastModified(), logFile.lastModified())
+            val session = if (now - lastWrite <= maxAgeMs) readCheckpoint(file, logFile) else null
+            if (session == null) {
+                file.delete()
+                logFile.delete()
+            } else {
+                restored.add(session)
+            }
+        }
+        // Logs and temp files without a snapshot are leftovers of ended or torn checkpoints
+        for (file in files) {
+            val name = file.name
+            val snapshotOfLog = File(directory, name.removeSuffix(LOG_SUFFIX) + SNAPSHOT_SUFFIX)
+            val orphanLog = name.endsWith(LOG_SUFFIX) && !snapshotOfLog.exists()
+            if (name.endsWith(TEMP_SUFFIX) || orphanLog) {
+                file.delete()
+            }
+        }
+
+        restoredEvents = restored.sumOf { it.events.size }
+        restoreMs = (System.nanoTime() - start) / 1_000_000.0
+        return restored.sortedBy { it.data.startTime }
+    }
+
+    /** Checkpoint cost so far, for performance_info. */
+    fun getStats(): Map<String, Any> {
+        val events = eventsLogged.get()
+        return mapOf(
+                "events_logged" to events,
+                "enqueue_ns_per_event" to if (events > 0) enqueueNanos.get() / events else 0L,
+                "write_ns_per_event" to if (events > 0) writeNanos.get() / events else 0L,
+                "bytes_per_event" to if (events > 0) bytesWritten.get() / events else 0L,
+                "snapshots_written" to snapshotsWritten.get(),
+                "restore_ms" to restoreMs,
+                "restored_events" to restoredEvents
+        )
+    }
+
+    private fun enqueue(op: Op, urgent: Boolean) {
+        synchronized(pending) {
+            pending.add(op)
+            if (flushScheduled && !urgent) return
+            flushScheduled = true
+            if (urgent) {
+                delayedFlush?.cancel(false)
+                delayedFlush = null
+                queue.execute(flushRunnable)
+            } else {
+                delayedFlush = queue.schedule(FLUSH_DELAY_MS, flushRunnable)
+            }
+        }
+    }
+
+    private fun flush() {
+        val ops: List<Op>
+        synchronized(pending) {
+            ops = ArrayList(pending)
+            pending.clear()
+            flushScheduled = false
+            delayedFlush = null
+        }
+        if (ops.isEmpty()) return
+
+        val start = System.nanoTime()
+        var appended = 0
+        for (op in ops) {
+            try {
+                when (op) {
+                    is Op.Begin -> {
+                        checkpoints.remove(op.data.sessionId)?.let { closeLog(it) }
+                        val checkpoint = Checkpoint(op.data, keyOf(op.data.sessionId))
+                        checkpoint.eventCount = op.eventCount
+                        checkpoint.appSwitchCount = op.data.appSwitchCount
+                        checkpoint.orientationChanges = op.data.orientationChangeCount
+                        checkpoints[op.data.sessionId] = checkpoint
+                        writeSnapshot(checkpoint)
+                    }
+                    is Op.Append -> {
+                        val checkpoint = checkpoints[op.sessionId] ?: continue
+                        recordOut.writeByte(RECORD_EVENT.toInt())
+                        writeEvent(recordOut, op.event)
+                        writeRecord(checkpoint)
+                        checkpoint.eventCount++
+                        appended++
+                        if (checkpoint.logRecords >= COMPACT_AFTER_RECORDS) {
+                            writeSnapshot(checkpoint)
+                        }
+                    }
+                    is Op.Counters -> {
+                        val checkpoint = checkpoints[op.sessionId] ?: continue
+                        checkpoint.appSwitchCount = op.appSwitchCount
+                        checkpoint.orientationChanges = op.orientationChanges
+                        recordOut.writeByte(RECORD_COUNTERS.toInt())
+                        recordOut.writeInt(op.appSwitchCount)
+                        recordOut.writeInt(op.orientationChanges)
+                        writeRecord(checkpoint)
+                    }
+                    is Op.Compact -> {
+                        for (checkpoint in checkpoints.values) {
+                            if (op.sessionId == null || op.sessionId == checkpoint.data.sessionId) {
+                                if (checkpoint.logRecords > 0) writeSnapshot(checkpoint)
+                            }
+                        }
+                    }
+                    is Op.End -> {
+                        val checkpoint = checkpoints.remove(op.sessionId) ?: continue
+                        closeLog(checkpoint)
+                        File(directory, checkpoint.key + SNAPSHOT_SUFFIX).delete()
+                        File(directory, checkpoint.key + LOG_SUFFIX).delete()
+                    }
+                }
+            } catch (e: IOException) {
+                record.reset()
+                android.util.Log.w("BehaviorSDK", "Checkpoint write failed: ${e.message}")
+            }
+        }
+        for (checkpoint in checkpoints.values) {
+            try {
+                checkpoint.log?.flush()
+            } catch (e: IOException) {
+                android.util.Log.w("BehaviorSDK", "Checkpoint flush failed: ${e.message}")
+            }
+        }
+
+        eventsLogged.addAndGet(appended.toLong())
+        writeNanos.addAndGet(System.nanoTime() - start)
+    }
+
+    /** Frame the buffered record as [length][crc32][payload] and append it to the log. */
+    private fun writeRecord(checkpoint: Checkpoint) {
+        // No log yet means no snapshot was written for this checkpoint: write one first, so the
+        // log is only ever (re)started behind a snapshot of its generation
+        if (checkpoint.log == null) writeSnapshot(checkpoint)
+        val log = checkpoint.log ?: throw IOException("No checkpoint log")
+        val bytes = record.toByteArray()
+        record.reset()
+        crc.reset()
+        crc.update(bytes)
+        log.writeInt(bytes.size)
+        log.writeInt(crc.value.toInt())
+        log.write(bytes)
+        checkpoint.logRecords++
+        bytesWritten.addAndGet(bytes.size + 8L)
+    }
+
+    /** Truncate the log and start it at the checkpoint's generation. */
+    private fun openLog(checkpoint: Checkpoint): DataOutputStream {
+        val file = FileOutputStream(File(directory, checkpoint.key + LOG_SUFFIX))
+        val log =
+                DataOutputStream(
+                        cipher?.sealing(file, associatedData(checkpoint.key, LOG_SUFFIX))
+                                ?: BufferedOutputStream(file)
+                )
+        log.writeInt(LOG_MAGIC)
+        log.writeInt(FORMAT_VERSION)
+        log.writeLong(checkpoint.generation)
+        checkpoint.log = log
+        checkpoint.logRecords = 0
+        return log
+    }
+
+    private fun closeLog(checkpoint: Checkpoint) {
+        try {
+            checkpoint.log?.close()
+        } catch (e: IOException) {
+            // Nothing left to save
+        }
+        checkpoint.log = null
+    }
+
+    /**
+     * Rewrite the snapshot with the next generation and restart the log. The current log stays
+     * open, and on disk, until the new snapshot has replaced the old one.
+     */
+    private fun writeSnapshot(checkpoint: Checkpoint) {
+        directory.mkdirs()
+        val data = checkpoint.data
+        val events = data.events.snapshot()
+        val generation = checkpoint.generation + 1
+        val temp = File(directory, checkpoint.key + TEMP_SUFFIX)
+
+        FileOutputStream(temp).use { file ->
+            val sealed = cipher?.sealing(file, associatedData(checkpoint.key, SNAPSHOT_SUFFIX))
+            val out = DataOutputStream(sealed ?: BufferedOutputStream(file))
+            out.writeInt(SNAPSHOT_MAGIC)
+            out.writeInt(FORMAT_VERSION)
+            out.writeLong(generation)
+            writeString(out, data.sessionId)
+            out.writeLong(data.startTime)
+            out.writeLong(data.sessionSpacing)
+            out.writeFloat(data.startScreenBrightness)
+            out.writeInt(data.startOrientation)
+            out.writeBoolean(data.startInternetState)
+            out.writeBoolean(data.startDoNotDisturb)
+            out.writeBoolean(data.startCharging)
+            out.writeInt(checkpoint.appSwitchCount)
+            out.writeInt(checkpoint.orientationChanges)
+            out.writeInt(checkpoint.eventCount)
+            for (i in 0 until checkpoint.eventCount) writeEvent(out, events[i])
+            if (sealed != null) sealed.finish() else out.flush()
+            file.fd.sync()
+        }
+        if (!temp.renameTo(File(directory, checkpoint.key + SNAPSHOT_SUFFIX))) {
+            throw IOException("Could not replace snapshot for ${data.sessionId}")
+        }
+        closeLog(checkpoint)
+        checkpoint.generation = generation
+        openLog(checkpoint)
+        snapshotsWritten.incrementAndGet()
+    }
+
+    /** Snapshot plus the valid prefix of its log, or null when the snapshot is unreadable. */
+    private fun readCheckpoint(snapshotFile: File, logFile: File): RestoredSession? {
+        val key = snapshotFile.name.removeSuffix(SNAPSHOT_SUFFIX)
+        val events = ArrayList<BehaviorEvent>()
+        val (generation, data) =
+                try {
+                    openSegment(snapshotFile, key, SNAPSHOT_SUFFIX).use { readSnapshot(it, events) }
+                } catch (e: Exception) {
+                    android.util.Log.w(
+                            "BehaviorSDK",
+                            "Dropping unreadable checkpoint: ${e.message}"
+                    )
+                    null
+                }
+                        ?: return null
+
+        if (logFile.exists()) {
+            try {
+                openSegment(logFile, key, LOG_SUFFIX).use { input ->
+                    if (input.readInt() == LOG_MAGIC &&
+                                    input.readInt() == FORMAT_VERSION &&
+                                    input.readLong() == generation
+                    ) {
+                        readLog(input, data, events)
+                    }
+                }
+            } catch (e: EOFException) {
+                // Log header itself was torn; the snapshot alone is consistent
+            } catch (e: IOException) {
+                android.util.Log.w(
+                        "BehaviorSDK",
+                        "Ignoring unreadable checkpoint log: ${e.message}"
+                )
+            }
+        }
+        return RestoredSession(data, events)
+    }
+
+    /** Reader over a checkpoint file; a snapshot must have its final frame when encrypted. */
+    private fun openSegment(file: File, key: String, suffix: String): DataInputStream {
+        val input = FileInputStream(file)
+        return try {
+            DataInputStream(
+                    cipher?.opening(
+                            input,
+                            associatedData(key, suffix),
+                            requireFinal = suffix == SNAPSHOT_SUFFIX
+                    )
+                            ?: BufferedInputStream(input)
+            )
+        } catch (e: IOException) {
+            input.close()
+            throw e
+        }
+    }
+
+    /** Snapshot generation and session header; its events are added to [events]. */
+    private fun readSnapshot(
+            input: DataInputStream,
+            events: MutableList<BehaviorEvent>
+    ): Pair<Long, SessionData>? {
+        if (input.readInt() != SNAPSHOT_MAGIC || input.readInt() != FORMAT_VERSION) return null
+        val generation = input.readLong()
+        val data =
+                SessionData(
+                        sessionId = readString(input),
+                        startTime = input.readLong(),
+                        sessionSpacing = input.readLong(),
+                        startScreenBrightness = input.readFloat(),
+                        startOrientation = input.readInt(),
+                        startInternetState = input.readBoolean(),
+                        startDoNotDisturb = input.readBoolean(),
+                        startCharging = input.readBoolean(),
+                        appSwitchCount = input.readInt(),
+                        orientationChangeCount = input.readInt()
+                )
+        repeat(input.readInt()) { events.add(readEvent(input)) }
+        return generation to data
+    }
+
+    /** Apply log records until the end of the file or the first torn/corrupt record. */
+    private fun readLog(
+            input: DataInputStream,
+            data: SessionData,
+            events: MutableList<BehaviorEvent>
+    ) {
+        val check = CRC32()
+        while (true) {
+            val length =
+                    try {
+                        input.readInt()
+                    } catch (e: EOFException) {
+                        return
+                    }
+            if (length <= 0 || length > MAX_RECORD_BYTES) return
+            val expectedCrc = input.readInt()
+            val bytes = ByteArray(length)
+            input.readFully(bytes)
+            check.reset()
+            check.update(bytes)
+            if (check.value.toInt() != expectedCrc) return
+
+            val payload = DataInputStream(bytes.inputStream())
+            when (payload.readByte()) {
+                RECORD_EVENT -> events.add(readEvent(payload))
+                RECORD_COUNTERS -> {
+                    data.appSwitchCount = payload.readInt()
+                    data.orientationChangeCount = payload.readInt()
+                }
+                else -> return
+            }
+        }
+    }
+
+    companion object {
+        // Checkpoints untouched for a day belong to sessions the app never came back to
+        const val MAX_CHECKPOINT_AGE_MS = 24 * 60 * 60 * 1000L
+
+        private const val FLUSH_DELAY_MS = 500L
+        private const val COMPACT_AFTER_RECORDS = 2000
+        private const val MAX_RECORD_BYTES = 1 shl 20
+
+        private const val SNAPSHOT_MAGIC = 0x53424350 // "SBCP"
+        private const val LOG_MAGIC = 0x5342434c // "SBCL"
+        private const val FORMAT_VERSION = 1
+        private const val SNAPSHOT_SUFFIX = ".snap"
+        private const val LOG_SUFFIX = ".log"
+        private const val TEMP_SUFFIX = ".snap.tmp"
+
+        private const val RECORD_EVENT: Byte = 1
+        private const val RECORD_COUNTERS: Byte = 2
+
+        // Metric value tags
+        private const val T_NULL = 0
+        private const val T_BOOL = 1
+        private const val T_INT = 2
+        private const val T_LONG = 3
+        private const val T_DOUBLE = 4
+        private const val T_STRING = 5
+        private const val T_LIST = 6
+        private const val T_MAP = 7
+
+        /** Binds an encrypted file to its kind and session, so files cannot be swapped. */
+        private fun associatedData(key: String, suffix: String): ByteArray =
+                (key + suffix).toByteArray(Charsets.UTF_8)
+
+        /** File name stem for a session: SHA-1 of its ID, so any ID is a safe file name. */
+        private fun keyOf(sessionId: String): String =
+                MessageDigest.getInstance("SHA-1")
+                        .digest(sessionId.toByteArray(Charsets.UTF_8))
+                        .joinToString("") { "%02x".format(it) }
+
+        private fun writeEvent(out: DataOutputStream, event: BehaviorEvent) {
+            writeString(out, event.eventId)
+            writeString(out, event.sessionId)
+            writeString(out, event.timestamp)
+            writeString(out, event.eventType)
+            writeValue(out, event.metrics)
+        }
+
+        private fun readEvent(input: DataInputStream): BehaviorEvent {
+            val eventId = readString(input)
+            val sessionId = readString(input)
+            val timestamp = readString(input)
+            val eventType = readString(input)
+            @Suppress("UNCHECKED_CAST")
+            val metrics = readValue(input) as? Map<String, Any> ?: emptyMap()
+            return BehaviorEvent(eventId, sessionId, timestamp, eventType, metrics)
+        }
+
+        private fun writeValue(out: DataOutputStream, value: Any?) {
+            when (value) {
+                null -> out.writeByte(T_NULL)
+                is Boolean -> {
+                    out.writeByte(T_BOOL)
+                    out.writeBoolean(value)
+                }
+                is Int, is Short, is Byte -> {
+                    out.writeByte(T_INT)
+                    out.writeInt((value as Number).toInt())
+                }
+                is Long -> {
+                    out.writeByte(T_LONG)
+                    out.writeLong(value)
+                }
+                is Number -> {
+                    out.writeByte(T_DOUBLE)
+                    out.writeDouble(value.toDouble())
+                }
+                is List<*> -> {
+                    out.writeByte(T_LIST)
+                    out.writeInt(value.size)
+                    for (item in value) writeValue(out, item)
+                }
+                is Map<*, *> -> {
+                    out.writeByte(T_MAP)
+                    out.writeInt(value.size)
+                    for ((key, item) in value) {
+                        writeString(out, key.toString())
+                        writeValue(out, item)
+                    }
+                }
+                else -> {
+                    out.writeByte(T_STRING)
+                    writeString(out, value.toString())
+                }
+            }
+        }
+
+        private fun readValue(input: DataInputStream): Any? =
+                when (input.readByte().toInt()) {
+                    T_NULL -> null
+                    T_BOOL -> input.readBoolean()
+                    T_INT -> input.readInt()
+                    T_LONG -> input.readLong()
+                    T_DOUBLE -> input.readDouble()
+                    T_STRING -> readString(input)
+                    T_LIST -> List(input.readInt()) { readValue(input) }
+                    T_MAP -> {
+                        val size = input.readInt()
+                        val map = LinkedHashMap<String, Any?>(size)
+                        repeat(size) { map[readString(input)] = readValue(input) }
+                        map
+                    }
+                    else -> throw IOException("Unknown value tag")
+                }
+
+        // Length-prefixed UTF-8 (DataOutput.writeUTF is limited to 64 KB)
+        private fun writeString(out: DataOutputStream, value: String) {
+            val bytes = value.toByteArray(Charsets.UTF_8)
+            out.writeInt(bytes.size)
+            out.write(bytes)
+        }
+
+        private fun readString(input: DataInputStream): String {
+            val length = input.readInt()
+            if (length < 0 || length > MAX_RECORD_BYTES) throw IOException("Invalid string length")
+            val bytes = ByteArray(length)
+            input.readFully(bytes)
+            return String(bytes, Charsets.UTF_8)
+        }
+    }
+}
@@ -0,0 +1,488 @@
+package ai.synheart.behavior
+
+import java.time.Instant
+
+/**
+ * Append-only event log for one session, with a posting list per event type.
+ *
+ * The main log keeps events in arrival order and is what [List] iteration returns, so existing
+ * consumers (Flux JSON conversion, snapshots) see exactly what the old `MutableList` gave them.
+ * Next to it, each event type keeps a posting list of (timestamp, row) pairs. Type-filtered
+ * queries such as "notifications" or "app switches between t0 and t1" binary-search the posting
+ * list and touch only matching rows, instead of scanning every event.
+ *
+ * Timestamps are parsed once on append. Events that arrive out of timestamp order are allowed: the
+ * affected posting list is re-sorted lazily on its next range query. Results are always returned
+ * in arrival order, like a `filter` over the main log.
+ *
+ * Each posting list can also hold metric columns: a numeric `DoubleArray`, or dictionary codes for a
+ * categorical metric. They are built on first use and extended incrementally, and
+ * [aggregate] runs [EventQuery]s as scans over them.
+ *
+ * Reads are snapshot-isolated and never block the writer. Appends are serialized on a writer lock
+ * and become visible by bumping a volatile row count (the log's epoch) last. A read fixes the epoch
+ * once and only looks at rows below it. Since posting lists hold rows in increasing order, the
+ * snapshot's share of each list is found by binary search. Arrays only ever grow by copying, and
+ * published slots are never overwritten. A reader holding an old array therefore sees a consistent
+ * prefix, and the garbage collector reclaims that array once no snapshot refers to it. The sorted
+ * permutation and metric columns are reader-side caches with their own per-list lock, which the
+ * writer never takes.
+ */
+class SessionEventLog : AbstractList<BehaviorEvent>() {
+
+    private val writeLock = Any()
+
+    @Volatile private var rows = arrayOfNulls<BehaviorEvent>(INITIAL_CAPACITY)
+    @Volatile private var published = 0 // Rows visible to readers; written last on append
+    private val all = Postings()
+    @Volatile private var byType: Map<String, Postings> = emptyMap() // Copy-on-write
+
+    override val size: Int
+        get() = published
+
+    override fun get(index: Int): BehaviorEvent {
+        val epoch = published
+        if (index < 0 || index >= epoch) {
+            throw IndexOutOfBoundsException("Index $index, size $epoch")
+        }
+        return rows[index]!!
+    }
+
+    /**
+     * The events published so far, as a fixed-size list. Later appends are not visible through it,
+     * so a long scan (Flux conversion, export) sees one consistent state without holding any lock.
+     */
+    fun snapshot(): List<BehaviorEvent> = Snapshot(published)
+
+    /** Append an event to the log and to its type's posting list. */
+    fun append(event: BehaviorEvent) {
+        val timestampMs = parseTimestamp(event.timestamp)
+        synchronized(writeLock) { append(event, timestampMs) }
+    }
+
+    private fun append(event: BehaviorEvent, timestampMs: Long) {
+        val row = published
+        var rowArray = rows
+        if (row == rowArray.size) {
+            rowArray = rowArray.copyOf(row * 2)
+            rows = rowArray
+        }
+        rowArray[row] = event
+        all.add(timestampMs, row)
+        val postings =
+                byType[event.eventType]
+                        ?: Postings().also { byType = byType + (event.eventType to it) }
+        postings.add(timestampMs, row)
+        published = row + 1
+    }
+
+    /** All events of [eventType], in arrival order. */
+    fun ofType(eventType: String): List<BehaviorEvent> {
+        val snapshot = Snapshot(published)
+        val view = byType[eventType]?.view(snapshot.epoch) ?: return emptyList()
+        return List(view.count) { snapshot[view.rowAt(it)] }
+    }
+
+    /** Number of events of [eventType]. */
+    fun countOfType(eventType: String): Int = byType[eventType]?.view(published)?.count ?: 0
+
+    /** Events of [eventType] with a timestamp in [startMs, endMs], in arrival order. */
+    fun ofType(eventType: String, startMs: Long, endMs: Long): List<BehaviorEvent> {
+        val snapshot = Snapshot(published)
+        val view = byType[eventType]?.view(snapshot.epoch) ?: return emptyList()
+        return view.rowsInRange(startMs, endMs).map { snapshot[it] }
+    }
+
+    /** Number of events of [eventType] with a timestamp in [startMs, endMs]. */
+    fun countOfType(eventType: String, startMs: Long, endMs: Long): Int =
+            byType[eventType]?.view(published)?.countInRange(startMs, endMs) ?: 0
+
+    /** A new log holding the events with a timestamp in [startMs, endMs], in arrival order. */
+    fun inRange(startMs: Long, endMs: Long): SessionEventLog {
+        val snapshot = Snapshot(published)
+        val view = all.view(snapshot.epoch)
+        val result = SessionEventLog()
+        // Row r of the main log is position r of `all`
+        for (row in view.rowsInRange(startMs, endMs)) {
+            result.append(snapshot[row], view.timestampAt(row))
+        }
+        return result
+    }
+
+    /**
+     * Run an aggregate query as a scan over the timestamp and metric columns of the query's posting
+     * list. Returns one row per (time bucket, group), ordered by bucket and then by group:
+     * `bucket_start_ms` (null without buckets), `group` (null without groupBy, or for events
+     * missing the field), `count` (matching events) and `value` (the aggregate, null when no
+     * matching event has the field).
+     */
+    fun aggregate(query: EventQuery): List<Map<String, Any?>> {
+        val snapshot = Snapshot(published)
+        val postings =
+                if (query.eventType == null) all
+                else byType[query.eventType] ?: return emptyList()
+
+        // Column caches are shared between readers; the writer never takes this lock
+        synchronized(postings) {
+            val view = postings.view(snapshot.epoch)
+            val order = view.order
+            val from = view.lowerBound(maxOf(query.startMs ?: Long.MIN_VALUE, VALID_MIN))
+            val to = view.upperBound(query.endMs ?: Long.MAX_VALUE)
+            if (from >= to) return emptyList()
+
+            val timestamps = view.timestamps
+            val values = query.field?.let { postings.numericColumn(it, view, snapshot) }
+            val groups = query.groupBy?.let { postings.categoryColumn(it, view, snapshot) }
+            val groupCodes = groups?.codes
+            val matches = query.where?.let { compilePredicate(it, postings, view, snapshot) }
+
+            val accumulators = HashMap<Long, Accumulator>()
+            val keepValues = query.aggregation == EventQuery.Aggregation.QUANTILE
+            for (k in from until to) {
+                val position = if (order == null) k else order[k]
+                if (matches != null && !matches(position)) continue
+
+                val bucket =
+                        if (query.bucketMs > 0) Math.floorDiv(timestamps[position], query.bucketMs)
+                        else 0L
+                // Group code + 1 so that "missing" (-1) maps to 0
+                val group = if (groupCodes != null) groupCodes[position] + 1 else 0
+                val key = bucket * GROUP_KEY_SPACE + group
+                val accumulator = accumulators.getOrPut(key) { Accumulator(keepValues) }
+                accumulator.count++
+                if (values != null) accumulator.add(values.values[position])
+            }
+
+            return accumulators.keys.sorted().map { key ->
+                val bucket = Math.floorDiv(key, GROUP_KEY_SPACE)
+                val group = Math.floorMod(key, GROUP_KEY_SPACE).toInt() - 1
+                val accumulator = accumulators.getValue(key)
+                mapOf(
+                        "bucket_start_ms" to
+                                if (query.bucketMs > 0) bucket * query.bucketMs else null,
+                        "group" to if (groups != null && group >= 0) groups.names[group] else null,
+                        "count" to accumulator.count,
+                        "value" to accumulator.result(query.aggregation, query.quantile)
+                )
+            }
+        }
+    }
+
+    private fun compilePredicate(
+            predicate: EventQuery.Predicate,
+            postings: Postings,
+            view: Postings.View,
+            snapshot: Snapshot
+    ): (Int) -> Boolean {
+        val value = predicate.value
+        if (value is String) {
+            val column = postings.categoryColumn(predicate.field, view, snapshot)
+            val code = column.codeOf(value)
+            val codes = column.codes
+            return if (predicate.op == "==") {
+                fun(position: Int) = code >= 0 && codes[position] == code
+            } else {
+                fun(position: Int) = codes[position] >= 0 && codes[position] != code
+            }
+        }
+
+        val target = toNumber(value) ?: throw IllegalArgumentException("Unsupported predicate value")
+        val column = postings.numericColumn(predicate.field, view, snapshot).values
+        // NaN (missing metric) fails every comparison, including !=
+        return when (predicate.op) {
+            "==" -> fun(position: Int) = column[position] == target
+            "!=" -> fun(position: Int) = !column[position].isNaN() && column[position] != target
+            "<" -> fun(position: Int) = column[position] < target
+            "<=" -> fun(position: Int) = column[position] <= target
+            ">" -> fun(position: Int) = column[position] > target
+            else -> fun(position: Int) = column[position] >= target
+        }
+    }
+
+    /** The first [epoch] rows, read through the row array current when the snapshot was taken. */
+    private inner class Snapshot(val epoch: Int) : AbstractList<BehaviorEvent>() {
+        // Read after [epoch], so the array holds every row below it
+        private val rowArray = rows
+
+        override val size: Int
+            get() = epoch
+
+        override fun get(index: Int): BehaviorEvent {
+            if (index < 0 || index >= epoch) {
+                throw IndexOutOfBoundsException("Index $index, size $epoch")
+            }
+            return rowArray[index]!!
+        }
+    }
+
+    /** Per-group running aggregate. Values are only kept when a quantile is requested. */
+    private class Accumulator(keepValues: Boolean) {
+        var count = 0
+        private var valueCount = 0
+        private var sum = 0.0
+        private var min = Double.POSITIVE_INFINITY
+        private var max = Double.NEGATIVE_INFINITY
+        private var kept: DoubleArray? = if (keepValues) DoubleArray(INITIAL_CAPACITY) else null
+
+        fun add(value: Double) {
+            if (value.isNaN()) return
+            sum += value
+            if (value < min) min = value
+            if (value > max) max = value
+            kept?.let {
+                if (valueCount == it.size) kept = it.copyOf(valueCount * 2)
+                kept!![valueCount] = value
+            }
+            valueCount++
+        }
+
+        fun result(aggregation: EventQuery.Aggregation, quantile: Double): Double? {
+            if (aggregation == EventQuery.Aggregation.COUNT) return count.toDouble()
+            if (valueCount == 0) return null
+            return when (aggregation) {
+                EventQuery.Aggregation.SUM -> sum
+                EventQuery.Aggregation.AVG -> sum / valueCount
+                EventQuery.Aggregation.MIN -> min
+                EventQuery.Aggregation.MAX -> max
+                else -> {
+                    // Linear interpolation between closest ranks
+                    val sorted = kept!!.copyOf(valueCount).also { it.sort() }
+                    val rank = quantile * (valueCount - 1)
+                    val lower = rank.toInt()
+                    val upper = minOf(lower + 1, valueCount - 1)
+                    sorted[lower] + (sorted[upper] - sorted[lower]) * (rank - lower)
+                }
+            }
+        }
+    }
+
+    /** Numeric metric column aligned with a posting list; NaN where the metric is missing. */
+    private class NumericColumn {
+        var values = DoubleArray(INITIAL_CAPACITY)
+        var filled = 0
+    }
+
+    /** Dictionary-encoded categorical metric column; -1 where the metric is missing. */
+    private class CategoryColumn {
+        var codes = IntArray(INITIAL_CAPACITY)
+        var filled = 0
+        val names = ArrayList<String>()
+        private val dictionary = HashMap<String, Int>()
+
+        fun codeOf(name: String): Int = dictionary[name] ?: -1
+
+        fun encode(name: String): Int =
+                dictionary.getOrPut(name) {
+                    require(names.size < GROUP_KEY_SPACE - 1) {
+                        "Too many distinct values to group by"
+                    }
+                    names.add(name)
+                    names.size - 1
+                }
+    }
+
+    /**
+     * Parallel (timestamp, row) arrays in arrival order, plus a permutation sorted by timestamp
+     * that is only built once an event arrives out of order.
+     *
+     * The array fields and [size] are written only by the appender. Readers go through a [View],
+     * which pins the arrays and the entries visible at one epoch. The sorted permutation and the
+     * metric columns are reader-side caches guarded by this object's monitor.
+     */
+    private class Postings {
+        @Volatile private var timestamps = LongArray(INITIAL_CAPACITY)
+        @Volatile private var rowIndices = IntArray(INITIAL_CAPACITY)
+        @Volatile private var inOrder = true
+        @Volatile private var size = 0
+
+        private var sortedOrder: IntArray? = null // Covers the first sortedOrder.size entries
+        private val numericColumns = HashMap<String, NumericColumn>()
+        private val categoryColumns = HashMap<String, CategoryColumn>()
+
+        /** Called under the log's writer lock. */
+        fun add(timestampMs: Long, row: Int) {
+            val n = size
+            var t = timestamps
+            var r = rowIndices
+            if (n == t.size) {
+                t = t.copyOf(n * 2)
+                r = r.copyOf(n * 2)
+            }
+            if (n > 0 && timestampMs < t[n - 1]) inOrder = false
+            t[n] = timestampMs
+            r[n] = row
+            timestamps = t
+            rowIndices = r
+            size = n + 1 // Publish
+        }
+
+        /** The entries whose row is below [epoch]. */
+        fun view(epoch: Int): View {
+            val n = size
+            val sorted = inOrder // Read after size, so it covers every entry below n
+            val t = timestamps
+            val r = rowIndices
+            // Rows are appended in increasing order: count the entries below the epoch
+            var lo = 0
+            var hi = n
+            while (lo < hi) {
+                val mid = (lo + hi) ushr 1
+                if (r[mid] < epoch) lo = mid + 1 else hi = mid
+            }
+            return View(t, r, lo, sorted)
+        }
+
+        /**
+         * Timestamp-sorted permutation of the first [count] positions. Extends the cached one by
+         * sorting only the positions appended since and merging, so a reader polling a live
+         * session does not re-sort the whole list each time.
+         */
+        @Synchronized
+        private fun sortedPositions(timestamps: LongArray, count: Int): IntArray {
+            val cached = sortedOrder ?: IntArray(0)
+            if (cached.size == count) return cached
+            if (cached.size > count) {
+                // Older snapshot than the cache: drop the positions appended after it
+                val result = IntArray(count)
+                var k = 0
+                for (position in cached) if (position < count) result[k++] = position
+                return result
+            }
+
+            val fresh =
+                    (cached.size until count)
+                            .sortedWith(compareBy({ timestamps[it] }, { it }))
+                            .toIntArray()
+            // Cached positions are all lower, so taking them first on ties keeps the order stable
+            val merged = IntArray(count)
+            var i = 0
+            var j = 0
+            for (k in 0 until count) {
+                merged[k] =
+                        if (j >= fresh.size ||
+                                        (i < cached.size &&
+                                                timestamps[cached[i]] <= timestamps[fresh[j]])
+                        ) {
+                            cached[i++]
+                        } else {
+                            fresh[j++]
+                        }
+            }
+            sortedOrder = merged
+            return merged
+        }
+
+        /** Column of metric [field], extended to cover the entries of [view]. */
+        @Synchronized
+        fun numericColumn(field: String, view: View, rows: List<BehaviorEvent>): NumericColumn {
+            val column = numericColumns.getOrPut(field) { NumericColumn() }
+            if (column.values.size < view.count) {
+                column.values = column.values.copyOf(view.timestamps.size)
+            }
+            while (column.filled < view.count) {
+                val metric = rows[view.rowAt(column.filled)].metrics[field]
+                column.values[column.filled] = toNumber(metric) ?: Double.NaN
+                column.filled++
+            }
+            return column
+        }
+
+        @Synchronized
+        fun categoryColumn(field: String, view: View, rows: List<BehaviorEvent>): CategoryColumn {
+            val column = categoryColumns.getOrPut(field) { CategoryColumn() }
+            if (column.codes.size < view.count) {
+                column.codes = column.codes.copyOf(view.timestamps.size)
+            }
+            while (column.filled < view.count) {
+                val metric = rows[view.rowAt(column.filled)].metrics[field]
+                column.codes[column.filled] = metric?.let { column.encode(it.toString()) } ?: -1
+                column.filled++
+            }
+            return column
+        }
+
+        /**
+         * Read view over the first [count] entries of the arrays. Its sorted [order] is null when
+         * arrival order is already timestamp order, and is only resolved by range lookups.
+         */
+        inner class View(
+                val timestamps: LongArray,
+                private val rowIndices: IntArray,
+                val count: Int,
+                private val sorted: Boolean
+        ) {
+            val order: IntArray? by
+                    lazy(LazyThreadSafetyMode.NONE) {
+                        if (sorted) null else sortedPositions(timestamps, count)
+                    }
+
+            fun rowAt(position: Int): Int = rowIndices[position]
+
+            fun timestampAt(position: Int): Long = timestamps[position]
+
+            fun countInRange(startMs: Long, endMs: Long): Int {
+                if (startMs > endMs) return 0
+                return upperBound(endMs) - lowerBound(startMs)
+            }
+
+            fun rowsInRange(startMs: Long, endMs: Long): IntArray {
+                if (startMs > endMs) return IntArray(0)
+                val from = lowerBound(startMs)
+                val to = upperBound(endMs)
+                val result = IntArray(to - from) { rowIndices[position(from + it)] }
+                // Rows were gathered in timestamp order; give them back in arrival order
+                if (order != null) result.sort()
+                return result
+            }
+
+            private fun position(k: Int): Int = order?.get(k) ?: k
+
+            // First k with timestamp >= value
+            fun lowerBound(value: Long): Int {
+                var lo = 0
+                var hi = count
+                while (lo < hi) {
+                    val mid = (lo + hi) ushr 1
+                    if (timestamps[position(mid)] < value) lo = mid + 1 else hi = mid
+                }
+                return lo
+            }
+
+            // First k with timestamp > value
+            fun upperBound(value: Long): Int {
+                var lo = 0
+                var hi = count
+                while (lo < hi) {
+                    val mid = (lo + hi) ushr 1
+                    if (timestamps[position(mid)] <= value) lo = mid + 1 else hi = mid
+                }
+                return lo
+            }
+        }
+    }
+
+    companion object {
+        private const val INITIAL_CAPACITY = 16
+
+        // Unparseable timestamps sort first and never fall inside a range query
+        private const val INVALID_TIMESTAMP = Long.MIN_VALUE
+        private const val VALID_MIN = Long.MIN_VALUE + 1
+
+        // Aggregation key = time bucket * GROUP_KEY_SPACE + (group code + 1)
+        private const val GROUP_KEY_SPACE = 1L shl 16
+
+        private fun toNumber(value: Any?): Double? =
+                when (value) {
+                    is Number -> value.toDouble()
+                    is Boolean -> if (value) 1.0 else 0.0
+                    else -> null
+                }
+
+        private fun parseTimestamp(timestamp: String): Long =
+                try {
+                    Instant.parse(timestamp).toEpochMilli()
+                } catch (e: Exception) {
+                    INVALID_TIMESTAMP
+                }
+    }
+}
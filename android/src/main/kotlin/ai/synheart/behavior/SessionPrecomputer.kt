@@ -0,0 +1,222 @@
+package ai.synheart.behavior
+
+/**
+ * Speculative end-of-session work for one session.
+ *
+ * [append] only updates the interruption/clipboard counters, in O(1) on the event path. The Flux
+ * JSON is built from the session's [events] log when the app backgrounds or goes idle and the SDK
+ * calls [precompute] on a worker thread: events logged since the previous pass are serialized and
+ * appended to the cached array body, then synheart-flux runs over the session so far and the
+ * result is kept keyed by the number of events it covers. [finish] reuses that result when no
+ * event arrived since. Otherwise it serializes just the events logged after the last pass and
+ * reruns Flux over the whole session; Flux scores whole sessions only, so its readings cannot be
+ * topped up incrementally.
+ *
+ * Only the Flux readings depend on the end time (through the session duration); the counters and
+ * serialized events never do. The reuse bound grows with the session, so that a later end moves
+ * the duration, and the rates normalized by it, by at most [DURATION_TOLERANCE]; the end time a
+ * reused result was scored at is reported in [Result.scoredEndTimeMs].
+ */
+class SessionPrecomputer(
+        private val sessionId: String,
+        private val startTimeMs: Long,
+        private val events: SessionEventLog,
+        private val deviceId: String = "android-device",
+        private val timezone: String = java.util.TimeZone.getDefault().id
+) {
+    // Flux state: the serialized prefix of [events] and the speculative result. Guarded by
+    // [fluxLock]; the counters below are guarded by this.
+    private val fluxLock = Any()
+    private val serializedEvents = StringBuilder()
+    private var serializedCount = 0 // Events of the log serialized so far
+    private var fluxEventCount = 0
+
+    // Rolling counters (same definitions as the endSession summary)
+    private val notificationEvents = mutableListOf<BehaviorEvent>()
+    private var notificationIgnored = 0
+    private var callCount = 0
+    private var callIgnored = 0
+    private var clipboardCount = 0
+    private var clipboardCopyCount = 0
+    private var clipboardPasteCount = 0
+    private var clipboardCutCount = 0
+
+    // Speculative Flux result and the number of logged events it was computed for
+    private var speculativeMetrics: Map<String, Any>? = null
+    private var speculativeVersion = -1
+    private var speculativeEndTimeMs = 0L
+    private var speculativeTimeMs = 0L
+
+    /** Result of [finish], consumed by endSession. */
+    data class Result(
+            val notificationEvents: List<BehaviorEvent>,
+            val notificationIgnored: Int,
+            val callCount: Int,
+            val callIgnored: Int,
+            val clipboardCount: Int,
+            val clipboardCopyCount: Int,
+            val clipboardPasteCount: Int,
+            val clipboardCutCount: Int,
+            val fluxMetrics: Map<String, Any>?,
+            val fluxTimeMs: Long,
+            val scoredEndTimeMs: Long, // End time Flux scored; earlier than the end on a hit
+            val speculativeHit: Boolean,
+            val savedMs: Long,
+            val missReason: String? // cold, new_events or stale; null on a hit
+    )
+
+    /** Fold a new session event into the rolling counters. O(1) per event. */
+    @Synchronized
+    fun append(event: BehaviorEvent) {
+        when (event.eventType) {
+            "notification" -> {
+                notificationEvents.add(event)
+                if (event.metrics["action"] == "ignored") notificationIgnored++
+            }
+            "call" -> {
+                callCount++
+                if (event.metrics["action"] == "ignored") callIgnored++
+            }
+            "clipboard" -> {
+                clipboardCount++
+                when (event.metrics["action"]) {
+                    "copy" -> clipboardCopyCount++
+                    "paste" -> clipboardPasteCount++
+                    "cut" -> clipboardCutCount++
+                }
+            }
+        }
+    }
+
+    /**
+     * Run Flux over the session up to [nowMs] unless the cached result already covers every event.
+     * Called off the main thread. Event appends never wait for it, and [fluxLock] is released
+     * during the Flux call.
+     */
+    fun precompute(nowMs: Long) {
+        val version: Int
+        val fluxJson: String
+        synchronized(fluxLock) {
+            if (speculativeVersion == events.size) return
+            version = serializeNewEvents()
+            fluxJson = sessionJson(nowMs)
+        }
+
+        val computeStart = System.nanoTime()
+        val metrics = runFlux(fluxJson) ?: return
+        val computeTimeMs = (System.nanoTime() - computeStart) / 1_000_000
+
+        synchronized(fluxLock) {
+            // A newer precompute may have finished first
+            if (version < speculativeVersion) return
+            speculativeMetrics = metrics
+            speculativeVersion = version
+            speculativeEndTimeMs = nowMs
+            speculativeTimeMs = computeTimeMs
+        }
+    }
+
+    /**
+     * Final counters and Flux metrics for a session ending at [endTimeMs]. The speculative result
+     * is used when it covers every event and its end time is within [MAX_SPECULATION_AGE_MS] or
+     * [DURATION_TOLERANCE] of the duration it was scored for, whichever is longer; otherwise the
+     * events logged since the last pass are serialized and Flux reruns over the whole session.
+     */
+    fun finish(endTimeMs: Long): Result {
+        var fluxMetrics: Map<String, Any>? = null
+        var fluxJson: String? = null
+        val missReason: String?
+        val scoredEndTimeMs: Long
+        val savedMs: Long
+        synchronized(fluxLock) {
+            val scoredDurationMs = speculativeEndTimeMs - startTimeMs
+            val maxAgeMs =
+                    maxOf(MAX_SPECULATION_AGE_MS, (scoredDurationMs * DURATION_TOLERANCE).toLong())
+            missReason =
+                    when {
+                        speculativeMetrics == null -> "cold"
+                        speculativeVersion != events.size -> "new_events"
+                        endTimeMs - speculativeEndTimeMs > maxAgeMs -> "stale"
+                        else -> null
+                    }
+            if (missReason == null) {
+                fluxMetrics = speculativeMetrics
+                scoredEndTimeMs = speculativeEndTimeMs
+                savedMs = speculativeTimeMs
+            } else {
+                serializeNewEvents()
+                fluxJson = sessionJson(endTimeMs)
+                scoredEndTimeMs = endTimeMs
+                savedMs = 0L
+            }
+        }
+        val hit = missReason == null
+
+        var fluxTimeMs = 0L
+        fluxJson?.let {
+            val computeStart = System.nanoTime()
+            fluxMetrics = runFlux(it)
+            fluxTimeMs = (System.nanoTime() - computeStart) / 1_000_000
+        }
+
+        return synchronized(this) {
+            Result(
+                    notificationEvents = notificationEvents.toList(),
+                    notificationIgnored = notificationIgnored,
+                    callCount = callCount,
+                    callIgnored = callIgnored,
+                    clipboardCount = clipboardCount,
+                    clipboardCopyCount = clipboardCopyCount,
+                    clipboardPasteCount = clipboardPasteCount,
+                    clipboardCutCount = clipboardCutCount,
+                    fluxMetrics = fluxMetrics,
+                    fluxTimeMs = fluxTimeMs,
+                    scoredEndTimeMs = scoredEndTimeMs,
+                    speculativeHit = hit,
+                    savedMs = savedMs,
+                    missReason = missReason
+            )
+        }
+    }
+
+    /** Serialize the events logged since the last call; returns how many are now covered. */
+    private fun serializeNewEvents(): Int {
+        val logged = events.snapshot()
+        for (i in serializedCount until logged.size) {
+            val fluxEvent = convertEventToFluxJson(logged[i]) ?: continue
+            if (fluxEventCount > 0) serializedEvents.append(',')
+            JsonCodec.write(fluxEvent, serializedEvents)
+            fluxEventCount++
+        }
+        serializedCount = logged.size
+        return serializedCount
+    }
+
+    private fun sessionJson(endTimeMs: Long): String =
+            buildFluxSessionJson(
+                    sessionId = sessionId,
+                    deviceId = deviceId,
+                    timezone = timezone,
+                    startTimeMs = startTimeMs,
+                    endTimeMs = endTimeMs,
+                    serializedEvents = serializedEvents
+            )
+
+    private fun runFlux(fluxJson: String): Map<String, Any>? {
+        if (!FluxBridge.isAvailable()) return null
+        return try {
+            FluxBridge.behaviorToHsi(fluxJson)?.let { extractBehavioralMetricsFromHsi(it) }
+        } catch (e: Exception) {
+            android.util.Log.w("SessionPrecomputer", "Flux computation failed: ${e.message}")
+            null
+        }
+    }
+
+    companion object {
+        // Speculative results up to this old are always reused when no new event arrived
+        const val MAX_SPECULATION_AGE_MS = 5_000L
+
+        // Beyond that, reuse while the end moves the scored duration by at most this fraction
+        const val DURATION_TOLERANCE = 0.01
+    }
+}
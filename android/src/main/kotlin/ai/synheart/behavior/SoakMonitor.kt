@@ -0,0 +1,135 @@
+package ai.synheart.behavior
+
+/**
+ * Long-run health check for the pipeline, usually under an accelerated [WorkloadGenerator] load.
+ *
+ * Each [sample] reads every gauge (memory, retained structures, queue depths) and the p95 of
+ * every latency stage over the interval since the previous sample. [getReport] then judges the
+ * samples after the warm-up:
+ * - A gauge grows without bound when the least-squares line through it rises by more than
+ *   [Thresholds.maxGrowthFraction] of its starting value and by more than an absolute floor
+ *   ([Thresholds.minGrowthBytes] for gauges ending in `_bytes`, else [Thresholds.minGrowthCount]).
+ *   Bounded structures level off and fit a flat line; sawtooth patterns from periodic cleanup
+ *   average out.
+ * - A stage drifts when the median interval p95 of the last third exceeds that of the first third
+ *   by more than [Thresholds.maxLatencyDrift] times and [Thresholds.minLatencyDriftUs].
+ */
+class SoakMonitor(
+        private val gauges: Map<String, () -> Long>,
+        private val stages: Map<String, LatencyHistogram>,
+        private val thresholds: Thresholds = Thresholds()
+) {
+
+    data class Thresholds(
+            val warmupFraction: Double = 0.25, // Leading share of samples that is not judged
+            val maxGrowthFraction: Double = 0.2,
+            val minGrowthBytes: Long = 8L * 1024 * 1024,
+            val minGrowthCount: Long = 1000,
+            val maxLatencyDrift: Double = 2.0,
+            val minLatencyDriftUs: Long = 200
+    )
+
+    private class Sample(val virtualMs: Long, val gauges: LongArray, val p95Us: LongArray)
+
+    private val gaugeNames = gauges.keys.toList()
+    private val stageNames = stages.keys.toList()
+    private val samples = ArrayList<Sample>()
+    private val previousCounts = stageNames.map { stages.getValue(it).counts() }.toMutableList()
+
+    /** Record the gauges and the latency of the interval since the last call. */
+    @Synchronized
+    fun sample(virtualMs: Long) {
+        val values = LongArray(gaugeNames.size) { gauges.getValue(gaugeNames[it])() }
+        val p95 =
+                LongArray(stageNames.size) { i ->
+                    val counts = stages.getValue(stageNames[i]).counts()
+                    val interval = LongArray(counts.size) { counts[it] - previousCounts[i][it] }
+                    previousCounts[i] = counts
+                    LatencyHistogram.quantileMicros(interval, 0.95)
+                }
+        samples.add(Sample(virtualMs, values, p95))
+    }
+
+    /** Verdict so far: `passed`, the `failures`, and per-gauge and per-stage detail. */
+    @Synchronized
+    fun getReport(): Map<String, Any> {
+        val judged = samples.drop((samples.size * thresholds.warmupFraction).toInt())
+        val failures = ArrayList<String>()
+        val gaugeReport = LinkedHashMap<String, Any>()
+        val stageReport = LinkedHashMap<String, Any>()
+
+        if (judged.size >= MIN_SAMPLES) {
+            val times = DoubleArray(judged.size) { judged[it].virtualMs.toDouble() }
+            for ((g, name) in gaugeNames.withIndex()) {
+                val values = DoubleArray(judged.size) { judged[it].gauges[g].toDouble() }
+                val (start, end) = fittedEnds(times, values)
+                val growth = end - start
+                val floor =
+                        if (name.endsWith("_bytes")) thresholds.minGrowthBytes
+                        else thresholds.minGrowthCount
+                val unbounded =
+                        growth > thresholds.maxGrowthFraction * maxOf(start, 1.0) && growth > floor
+                if (unbounded) failures.add("$name grows without bound")
+                gaugeReport[name] =
+                        mapOf(
+                                "first" to judged.first().gauges[g],
+                                "last" to judged.last().gauges[g],
+                                "max" to judged.maxOf { it.gauges[g] },
+                                "fitted_growth" to growth,
+                                "unbounded" to unbounded
+                        )
+            }
+            val third = judged.size / 3
+            for ((s, name) in stageNames.withIndex()) {
+                val early = medianP95(judged.subList(0, third), s)
+                val late = medianP95(judged.subList(judged.size - third, judged.size), s)
+                val drifted =
+                        early != null &&
+                                late != null &&
+                                late > early * thresholds.maxLatencyDrift &&
+                                late - early > thresholds.minLatencyDriftUs
+                if (drifted) failures.add("$name latency drifts")
+                stageReport[name] =
+                        mapOf(
+                                "early_p95_us" to (early ?: 0L),
+                                "late_p95_us" to (late ?: 0L),
+                                "drifted" to drifted
+                        )
+            }
+        }
+
+        return mapOf(
+                "samples" to samples.size,
+                "virtual_ms" to (samples.lastOrNull()?.virtualMs ?: 0L),
+                "judged" to (judged.size >= MIN_SAMPLES),
+                "passed" to failures.isEmpty(),
+                "failures" to failures,
+                "gauges" to gaugeReport,
+                "stages" to stageReport
+        )
+    }
+
+    /** Values of the least-squares line at the first and last time. */
+    private fun fittedEnds(times: DoubleArray, values: DoubleArray): Pair<Double, Double> {
+        val meanT = times.average()
+        val meanV = values.average()
+        var covariance = 0.0
+        var variance = 0.0
+        for (i in times.indices) {
+            covariance += (times[i] - meanT) * (values[i] - meanV)
+            variance += (times[i] - meanT) * (times[i] - meanT)
+        }
+        val slope = if (variance > 0) covariance / variance else 0.0
+        return meanV + slope * (times.first() - meanT) to meanV + slope * (times.last() - meanT)
+    }
+
+    /** Median p95 of the intervals in [range] that saw events; null when none did. */
+    private fun medianP95(range: List<Sample>, stage: Int): Long? {
+        val values = range.map { it.p95Us[stage] }.filter { it > 0 }.sorted()
+        return if (values.isEmpty()) null else values[values.size / 2]
+    }
+
+    private companion object {
+        const val MIN_SAMPLES = 6
+    }
+}
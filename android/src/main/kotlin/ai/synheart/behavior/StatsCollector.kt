@@ -85,6 +85,9 @@ class StatsCollector {
         )
     }
 
+    /** Events held for the rolling statistics (at most 100). */
+    @Synchronized fun retainedEventCount(): Int = recentEvents.size
+
     @Synchronized
     fun clear() {
         recentEvents.clear()
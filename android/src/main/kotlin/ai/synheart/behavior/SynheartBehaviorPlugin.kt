@@ -5,6 +5,8 @@ import android.content.Context
 import android.content.Intent
 import android.content.pm.PackageManager
 import android.os.Build
+import android.os.Handler
+import android.os.Looper
 import android.provider.Settings
 import android.view.View
 import androidx.core.app.ActivityCompat
@@ -23,6 +25,9 @@ class SynheartBehaviorPlugin : FlutterPlugin, MethodCallHandler, ActivityAware {
     private var rootView: View? = null
     private var context: Context? = null
     private var behaviorSDK: BehaviorSDK? = null
+    private val mainHandler = Handler(Looper.getMainLooper())
+    private val subscriptions = EventSubscriptions()
+    private var dartInstance: Long? = null // Dart isolate that registered the subscriptions
 
     override fun onAttachedToEngine(binding: FlutterPlugin.FlutterPluginBinding) {
         channel = MethodChannel(binding.binaryMessenger, "ai.synheart.behavior")
@@ -35,8 +40,8 @@ class SynheartBehaviorPlugin : FlutterPlugin, MethodCallHandler, ActivityAware {
             "initialize" -> {
                 @Suppress("UNCHECKED_CAST")
                 val config = (call.arguments as? Map<String, Any>) ?: emptyMap()
-                initialize(config)
-                result.success(null)
+                val restoredSessions = initialize(config)
+                result.success(mapOf("restoredSessions" to restoredSessions))
             }
             "startSession" -> {
                 @Suppress("UNCHECKED_CAST")
@@ -94,16 +99,186 @@ class SynheartBehaviorPlugin : FlutterPlugin, MethodCallHandler, ActivityAware {
                 val startTimestampMs = args["startTimestampMs"] as? Long ?: 0L
                 val endTimestampMs = args["endTimestampMs"] as? Long ?: 0L
                 val sessionId = args["sessionId"] as? String
-                try {
-                    val metrics =
-                            calculateMetricsForTimeRange(
-                                    startTimestampMs = startTimestampMs,
-                                    endTimestampMs = endTimestampMs,
-                                    sessionId = sessionId
+                runSessionQuery(result, "CALCULATION_ERROR", sessionId) { behaviorSDK, session ->
+                    behaviorSDK.calculateMetricsForTimeRange(
+                            startTimestampMs = startTimestampMs,
+                            endTimestampMs = endTimestampMs,
+                            session = session
+                    )
+                }
+            }
+            "queryEvents" -> {
+                @Suppress("UNCHECKED_CAST")
+                val args = (call.arguments as? Map<String, Any?>) ?: emptyMap()
+                @Suppress("UNCHECKED_CAST")
+                val queryMap = (args["query"] as? Map<String, Any?>) ?: emptyMap()
+                val sessionId = args["sessionId"] as? String
+                runSessionQuery(result, "QUERY_ERROR", sessionId) { behaviorSDK, session ->
+                    behaviorSDK.queryEvents(EventQuery.fromMap(queryMap), session)
+                }
+            }
+            "getTrends" -> {
+                @Suppress("UNCHECKED_CAST")
+                val args = (call.arguments as? Map<String, Any>) ?: emptyMap()
+                runQuery(result, "TRENDS_ERROR") {
+                    val behaviorSDK = this.behaviorSDK ?: throw Exception("SDK not initialized")
+                    val granularity =
+                            RollupStore.Granularity.valueOf(
+                                    (args["granularity"] as? String ?: "day").uppercase()
                             )
-                    result.success(metrics)
+                    val endMs =
+                            (args["endMs"] as? Number)?.toLong() ?: System.currentTimeMillis()
+                    val startMs = (args["startMs"] as? Number)?.toLong() ?: endMs
+                    behaviorSDK.getTrends(granularity, startMs, endMs)
+                }
+            }
+            "setEventStreamListening" -> {
+                @Suppress("UNCHECKED_CAST")
+                val args = (call.arguments as? Map<String, Any>) ?: emptyMap()
+                subscriptions.setStreamListening(args["listening"] as? Boolean ?: false)
+                result.success(null)
+            }
+            "subscribeEvents" -> {
+                @Suppress("UNCHECKED_CAST")
+                val filter = (call.arguments as? Map<String, Any?>) ?: emptyMap()
+                try {
+                    result.success(subscriptions.add(EventSubscriptions.Filter.fromMap(filter)))
                 } catch (e: Exception) {
-                    result.error("CALCULATION_ERROR", e.message, null)
+                    result.error("SUBSCRIPTION_ERROR", e.message, null)
+                }
+            }
+            "unsubscribeEvents" -> {
+                @Suppress("UNCHECKED_CAST")
+                val args = (call.arguments as? Map<String, Any>) ?: emptyMap()
+                val subscriptionId = (args["subscriptionId"] as? Number)?.toInt() ?: -1
+                result.success(subscriptions.remove(subscriptionId))
+            }
+            "getSubscriptionStats" -> {
+                result.success(subscriptions.getStats())
+            }
+            "benchmarkCheckpointStorage" -> {
+                @Suppress("UNCHECKED_CAST")
+                val args = (call.arguments as? Map<String, Any>) ?: emptyMap()
+                val megabytes = (args["megabytes"] as? Number)?.toInt() ?: 16
+                runQuery(result, "BENCHMARK_ERROR", BehaviorExecutor.QoS.BACKGROUND) {
+                    // Without a host key the cipher cost is measured with a throwaway key
+                    val hostKey = resolveCheckpointKey()
+                    SegmentCipher.benchmark(
+                            context!!.cacheDir,
+                            hostKey ?: SegmentCipher.generateKey(),
+                            megabytes.coerceIn(1, 256) * 1024 * 1024
+                    ) + ("key_source" to if (hostKey != null) "host" else "generated")
+                }
+            }
+            "benchmarkJsonCodec" -> {
+                @Suppress("UNCHECKED_CAST")
+                val args = (call.arguments as? Map<String, Any>) ?: emptyMap()
+                val events = (args["events"] as? Number)?.toInt() ?: 2000
+                runQuery(result, "BENCHMARK_ERROR", BehaviorExecutor.QoS.BACKGROUND) {
+                    JsonCodec.benchmark(events.coerceIn(1, 100_000))
+                }
+            }
+            "startSyntheticWorkload" -> {
+                val behaviorSDK = this.behaviorSDK
+                @Suppress("UNCHECKED_CAST")
+                val args = (call.arguments as? Map<String, Any>) ?: emptyMap()
+                if (behaviorSDK == null) {
+                    result.error("WORKLOAD_ERROR", "SDK not initialized", null)
+                } else {
+                    try {
+                        behaviorSDK.startSyntheticWorkload(
+                                WorkloadGenerator.Workload.fromMap(
+                                        args["workload"] as? Map<*, *> ?: emptyMap<String, Any>()
+                                ),
+                                (args["speed"] as? Number)?.toDouble() ?: 1.0,
+                                ((args["durationSeconds"] as? Number)?.toDouble() ?: 60.0)
+                                        .times(1000)
+                                        .toLong()
+                        )
+                        result.success(null)
+                    } catch (e: Exception) {
+                        result.error("WORKLOAD_ERROR", e.message, null)
+                    }
+                }
+            }
+            "stopSyntheticWorkload" -> {
+                val behaviorSDK = this.behaviorSDK
+                if (behaviorSDK == null) {
+                    result.error("WORKLOAD_ERROR", "SDK not initialized", null)
+                } else {
+                    runQuery(result, "WORKLOAD_ERROR") { behaviorSDK.stopSyntheticWorkload() }
+                }
+            }
+            "startSoakTest" -> {
+                val behaviorSDK = this.behaviorSDK
+                @Suppress("UNCHECKED_CAST")
+                val args = (call.arguments as? Map<String, Any>) ?: emptyMap()
+                if (behaviorSDK == null) {
+                    result.error("SOAK_ERROR", "SDK not initialized", null)
+                } else {
+                    fun millis(key: String, default: Double) =
+                            ((args[key] as? Number)?.toDouble() ?: default).times(1000).toLong()
+                    val limits = args["thresholds"] as? Map<*, *> ?: emptyMap<String, Any>()
+                    fun limit(key: String) = limits[key] as? Number
+                    val defaults = SoakMonitor.Thresholds()
+                    try {
+                        behaviorSDK.startSoakTest(
+                                WorkloadGenerator.Workload.fromMap(
+                                        args["workload"] as? Map<*, *> ?: emptyMap<String, Any>()
+                                ),
+                                (args["speed"] as? Number)?.toDouble() ?: 1000.0,
+                                millis("durationSeconds", 72 * 3600.0),
+                                millis("sampleIntervalSeconds", 600.0),
+                                millis("sessionLengthSeconds", 3600.0),
+                                SoakMonitor.Thresholds(
+                                        warmupFraction =
+                                                limit("warmupFraction")?.toDouble()
+                                                        ?: defaults.warmupFraction,
+                                        maxGrowthFraction =
+                                                limit("maxGrowthFraction")?.toDouble()
+                                                        ?: defaults.maxGrowthFraction,
+                                        minGrowthBytes =
+                                                limit("minGrowthBytes")?.toLong()
+                                                        ?: defaults.minGrowthBytes,
+                                        minGrowthCount =
+                                                limit("minGrowthCount")?.toLong()
+                                                        ?: defaults.minGrowthCount,
+                                        maxLatencyDrift =
+                                                limit("maxLatencyDrift")?.toDouble()
+                                                        ?: defaults.maxLatencyDrift,
+                                        minLatencyDriftUs =
+                                                limit("minLatencyDriftUs")?.toLong()
+                                                        ?: defaults.minLatencyDriftUs
+                                )
+                        )
+                        result.success(null)
+                    } catch (e: Exception) {
+                        result.error("SOAK_ERROR", e.message, null)
+                    }
+                }
+            }
+            "getSoakReport" -> {
+                val behaviorSDK = this.behaviorSDK
+                if (behaviorSDK == null) {
+                    result.error("SOAK_ERROR", "SDK not initialized", null)
+                } else {
+                    runQuery(result, "SOAK_ERROR") { behaviorSDK.getSoakReport() }
+                }
+            }
+            "getEnergyReport" -> {
+                val behaviorSDK = this.behaviorSDK
+                if (behaviorSDK == null) {
+                    result.error("ENERGY_ERROR", "SDK not initialized", null)
+                } else {
+                    result.success(behaviorSDK.getEnergyReport())
+                }
+            }
+            "getLatencyStats" -> {
+                val behaviorSDK = this.behaviorSDK
+                if (behaviorSDK == null) {
+                    result.error("LATENCY_ERROR", "SDK not initialized", null)
+                } else {
+                    result.success(behaviorSDK.getLatencyStats())
                 }
             }
             else -> {
@@ -112,7 +287,52 @@ class SynheartBehaviorPlugin : FlutterPlugin, MethodCallHandler, ActivityAware {
         }
     }
 
-    private fun initialize(config: Map<String, Any>) {
+    /**
+     * Run a read-only query at interactive QoS and reply on the main thread. The stores it reads
+     * are safe to read concurrently with event ingestion.
+     */
+    private fun runQuery(
+            result: Result,
+            errorCode: String,
+            qos: BehaviorExecutor.QoS = BehaviorExecutor.QoS.INTERACTIVE,
+            query: () -> Any?
+    ) {
+        BehaviorExecutor.execute(qos) {
+            try {
+                val value = query()
+                mainHandler.post { result.success(value) }
+            } catch (e: Exception) {
+                mainHandler.post { result.error(errorCode, e.message, null) }
+            }
+        }
+    }
+
+    /**
+     * [runQuery] over one session. The session is resolved and copied here, on the main thread
+     * that starts, ends and updates sessions, so the query never reads them while they change.
+     */
+    private fun runSessionQuery(
+            result: Result,
+            errorCode: String,
+            sessionId: String?,
+            query: (BehaviorSDK, QuerySession) -> Any?
+    ) {
+        val behaviorSDK = this.behaviorSDK
+        val session =
+                try {
+                    behaviorSDK?.querySession(sessionId)
+                } catch (e: Exception) {
+                    result.error(errorCode, e.message, null)
+                    return
+                }
+        if (behaviorSDK == null || session == null) {
+            result.error(errorCode, "SDK not initialized", null)
+            return
+        }
+        runQuery(result, errorCode) { query(behaviorSDK, session) }
+    }
+
+    private fun initialize(config: Map<String, Any>): List<Map<String, Any>> {
         val behaviorConfig =
                 BehaviorConfig(
                         enableInputSignals = config["enableInputSignals"] as? Boolean ?: true,
@@ -121,14 +341,64 @@ class SynheartBehaviorPlugin : FlutterPlugin, MethodCallHandler, ActivityAware {
                         enableMotionLite = config["enableMotionLite"] as? Boolean ?: false,
                         sessionIdPrefix = config["sessionIdPrefix"] as? String,
                         eventBatchSize = config["eventBatchSize"] as? Int ?: 10,
-                        maxIdleGapSeconds = config["maxIdleGapSeconds"] as? Double ?: 10.0
+                        maxIdleGapSeconds = config["maxIdleGapSeconds"] as? Double ?: 10.0,
+                        liveSnapshotIntervalSeconds =
+                                config["liveSnapshotIntervalSeconds"] as? Int ?: 0,
+                        useFusedMotionSensors =
+                                config["useFusedMotionSensors"] as? Boolean ?: false,
+                        motionCascadeThreshold =
+                                (config["motionCascadeThreshold"] as? Number)?.toDouble() ?: 0.0,
+                        rollupRetentionDays = config["rollupRetentionDays"] as? Int ?: 0,
+                        enableSessionCheckpoints =
+                                config["enableSessionCheckpoints"] as? Boolean ?: false,
+                        encryptSessionCheckpoints =
+                                config["encryptSessionCheckpoints"] as? Boolean ?: false,
+                        powerTable = PowerTable.fromMap(config["powerTable"] as? Map<*, *>),
+                        nativeGestureEvents = config["nativeGestureEvents"] as? Boolean ?: false
                 )
 
-        behaviorSDK = BehaviorSDK(context!!, behaviorConfig)
-        behaviorSDK?.initialize()
-        behaviorSDK?.setEventHandler { event -> emitEvent(event.toMap()) }
+        // A new Dart instance (after a hot restart) registers its own subscriptions; another
+        // initialize from the same one keeps them
+        val instance = (config["dartInstance"] as? Number)?.toLong()
+        if (instance != dartInstance) {
+            subscriptions.clear()
+            dartInstance = instance
+        }
+        val checkpointKey =
+                if (behaviorConfig.encryptSessionCheckpoints) resolveCheckpointKey() else null
+        behaviorSDK = BehaviorSDK(context!!, behaviorConfig, checkpointKey)
+        val restoredSessions = behaviorSDK?.initialize() ?: emptyList()
+        // The activity usually attaches before Dart initializes the SDK
+        activity?.window?.let { window -> behaviorSDK?.attachToWindow(window) }
+        behaviorSDK?.setEventHandler { event ->
+            // Events nobody in Dart wants are dropped before they are converted or sent
+            val targets = subscriptions.route(event) ?: return@setEventHandler
+            // Capture time on the monotonic clock Dart's Timeline.now also reads, for the last hop
+            val captureMicros = "capture_us" to event.captureNanos / 1000
+            emitEvent(
+                    if (targets.isEmpty()) event.toMap() + captureMicros
+                    else event.toMap() + captureMicros + ("subscriptions" to targets)
+            )
+        }
+        behaviorSDK?.setSnapshotHandler { snapshot ->
+            // Snapshots are computed off the main thread; the channel must be used on it
+            mainHandler.post { emitSnapshot(snapshot) }
+        }
+        return restoredSessions
     }
 
+    /** The host app's checkpoint key, or null when it has none or its provider failed. */
+    private fun resolveCheckpointKey(): javax.crypto.SecretKey? =
+            try {
+                checkpointKeyProvider?.checkpointKey()
+            } catch (e: Exception) {
+                android.util.Log.w(
+                        "SynheartBehaviorPlugin",
+                        "Checkpoint key unavailable: ${e.message}"
+                )
+                null
+            }
+
     private fun startSession(sessionId: String) {
         behaviorSDK?.startSession(sessionId)
     }
@@ -205,7 +475,20 @@ class SynheartBehaviorPlugin : FlutterPlugin, MethodCallHandler, ActivityAware {
                         enableMotionLite = config["enableMotionLite"] as? Boolean ?: false,
                         sessionIdPrefix = config["sessionIdPrefix"] as? String,
                         eventBatchSize = config["eventBatchSize"] as? Int ?: 10,
-                        maxIdleGapSeconds = config["maxIdleGapSeconds"] as? Double ?: 10.0
+                        maxIdleGapSeconds = config["maxIdleGapSeconds"] as? Double ?: 10.0,
+                        liveSnapshotIntervalSeconds =
+                                config["liveSnapshotIntervalSeconds"] as? Int ?: 0,
+                        useFusedMotionSensors =
+                                config["useFusedMotionSensors"] as? Boolean ?: false,
+                        motionCascadeThreshold =
+                                (config["motionCascadeThreshold"] as? Number)?.toDouble() ?: 0.0,
+                        rollupRetentionDays = config["rollupRetentionDays"] as? Int ?: 0,
+                        enableSessionCheckpoints =
+                                config["enableSessionCheckpoints"] as? Boolean ?: false,
+                        encryptSessionCheckpoints =
+                                config["encryptSessionCheckpoints"] as? Boolean ?: false,
+                        powerTable = PowerTable.fromMap(config["powerTable"] as? Map<*, *>),
+                        nativeGestureEvents = config["nativeGestureEvents"] as? Boolean ?: false
                 )
         behaviorSDK?.updateConfig(behaviorConfig)
     }
@@ -213,6 +496,7 @@ class SynheartBehaviorPlugin : FlutterPlugin, MethodCallHandler, ActivityAware {
     private fun dispose() {
         behaviorSDK?.dispose()
         behaviorSDK = null
+        subscriptions.clear()
     }
 
     private fun emitEvent(event: Map<String, Any>) {
@@ -232,6 +516,18 @@ class SynheartBehaviorPlugin : FlutterPlugin, MethodCallHandler, ActivityAware {
         }
     }
 
+    private fun emitSnapshot(snapshot: Map<String, Any>) {
+        try {
+            channel.invokeMethod("onSnapshot", snapshot)
+        } catch (e: Exception) {
+            android.util.Log.e(
+                    "SynheartBehaviorPlugin",
+                    "ERROR sending snapshot to Flutter: ${e.message}",
+                    e
+            )
+        }
+    }
+
     private fun generateSessionId(): String {
         return "SESS-${System.currentTimeMillis()}"
     }
@@ -292,6 +588,10 @@ class SynheartBehaviorPlugin : FlutterPlugin, MethodCallHandler, ActivityAware {
             val eventType = eventMap["event_type"] as? String ?: "tap"
             @Suppress("UNCHECKED_CAST")
             val metrics = eventMap["metrics"] as? Map<String, Any> ?: emptyMap()
+            // Dart's Timeline.now, on the same monotonic clock as System.nanoTime
+            val captureNanos =
+                    (eventData["capture_us"] as? Number)?.toLong()?.times(1000)
+                            ?: System.nanoTime()
 
             val event =
                     BehaviorEvent(
@@ -299,7 +599,8 @@ class SynheartBehaviorPlugin : FlutterPlugin, MethodCallHandler, ActivityAware {
                             sessionId = sessionId,
                             timestamp = timestamp,
                             eventType = eventType,
-                            metrics = metrics
+                            metrics = metrics,
+                            captureNanos = captureNanos
                     )
 
             // Use reflection or make emitEvent public - for now, let's create a public method
@@ -315,21 +616,10 @@ class SynheartBehaviorPlugin : FlutterPlugin, MethodCallHandler, ActivityAware {
         }
     }
 
-    private fun calculateMetricsForTimeRange(
-            startTimestampMs: Long,
-            endTimestampMs: Long,
-            sessionId: String?
-    ): Map<String, Any?> {
-        val behaviorSDK = this.behaviorSDK ?: throw Exception("SDK not initialized")
-        return behaviorSDK.calculateMetricsForTimeRange(
-                startTimestampMs = startTimestampMs,
-                endTimestampMs = endTimestampMs,
-                sessionId = sessionId
-        )
-    }
-
     override fun onDetachedFromEngine(binding: FlutterPlugin.FlutterPluginBinding) {
         channel.setMethodCallHandler(null)
+        subscriptions.clear()
+        dartInstance = null
         context = null
     }
 
@@ -337,8 +627,8 @@ class SynheartBehaviorPlugin : FlutterPlugin, MethodCallHandler, ActivityAware {
         activity = binding.activity
         rootView = activity?.window?.decorView?.rootView
 
-        // Attach SDK to root view for signal collection
-        rootView?.let { view -> behaviorSDK?.attachToView(view) }
+        // Attach SDK to the activity window for signal collection
+        activity?.window?.let { window -> behaviorSDK?.attachToWindow(window) }
 
         // Register for configuration changes to track orientation
         // We'll check orientation changes periodically since ActivityPluginBinding
@@ -347,6 +637,7 @@ class SynheartBehaviorPlugin : FlutterPlugin, MethodCallHandler, ActivityAware {
     }
 
     override fun onDetachedFromActivityForConfigChanges() {
+        behaviorSDK?.detachFromWindow()
         activity = null
         rootView = null
     }
@@ -354,10 +645,20 @@ class SynheartBehaviorPlugin : FlutterPlugin, MethodCallHandler, ActivityAware {
     override fun onReattachedToActivityForConfigChanges(binding: ActivityPluginBinding) {
         activity = binding.activity
         rootView = activity?.window?.decorView?.rootView
+        activity?.window?.let { window -> behaviorSDK?.attachToWindow(window) }
     }
 
     override fun onDetachedFromActivity() {
+        behaviorSDK?.detachFromWindow()
         activity = null
         rootView = null
     }
+
+    companion object {
+        /**
+         * Key source for `BehaviorConfig.encryptSessionCheckpoints`, typically backed by the
+         * Android Keystore. Set it before `initialize`, e.g. in `configureFlutterEngine`.
+         */
+        @JvmStatic var checkpointKeyProvider: CheckpointKeyProvider? = null
+    }
 }
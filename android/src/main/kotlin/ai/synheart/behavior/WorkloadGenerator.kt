@@ -0,0 +1,495 @@
+package ai.synheart.behavior
+
+import android.hardware.Sensor
+import java.util.PriorityQueue
+import java.util.Random
+import java.util.concurrent.ScheduledFuture
+import kotlin.math.PI
+import kotlin.math.cos
+import kotlin.math.exp
+import kotlin.math.ln
+import kotlin.math.max
+import kotlin.math.roundToLong
+import kotlin.math.sin
+
+/**
+ * Seedable synthetic input for driving the pipeline at controlled load, for stress and scaling
+ * tests without a person at the device.
+ *
+ * Each enabled signal is a parametric model on a shared virtual clock:
+ * - Scroll: Poisson bursts of scroll gestures with log-normal velocities and direction reversals.
+ * - Typing: Poisson bursts of keystrokes with log-normal inter-key times.
+ * - Notifications: Poisson arrivals whose rate jumps during Poisson-started storms; each is later
+ *   opened (log-normal delay) or ignored.
+ * - App switches: Poisson, with log-normal time in background.
+ * - Motion: accelerometer and gyroscope at 50 Hz from activity profiles (gravity orientation,
+ *   gait frequency and amplitude, sensor noise) played in a repeating schedule.
+ *
+ * The same workload and seed always produce the same sequence. [advanceTo] emits everything due
+ * in virtual time, in time order; [Run] advances it at 1×–1000× real time.
+ */
+class WorkloadGenerator(private val workload: Workload) {
+
+    /** Receives generated input. Called on the generator's thread. */
+    interface Sink {
+        fun onEvent(eventType: String, metrics: Map<String, Any>)
+
+        fun onMotionSample(sensorType: Int, values: FloatArray)
+
+        /** End of one [advanceTo] call, e.g. to hand a batch to another thread. */
+        fun flush() {}
+    }
+
+    data class ScrollModel(
+            val burstsPerMinute: Double = 4.0,
+            val scrollsPerBurst: Double = 5.0, // Mean, geometric
+            val gapMs: Double = 700.0, // Mean gap between scrolls of a burst, exponential
+            val velocityMedian: Double = 1200.0, // px/s
+            val velocitySigma: Double = 0.6, // Log-space standard deviation
+            val reversalProbability: Double = 0.15
+    )
+
+    data class TypingModel(
+            val burstsPerMinute: Double = 2.0,
+            val keysPerBurst: Double = 12.0, // Mean, geometric
+            val interKeyMedianMs: Double = 180.0,
+            val interKeySigma: Double = 0.5 // Log-space; larger is burstier
+    )
+
+    data class NotificationModel(
+            val perHour: Double = 12.0,
+            val stormsPerHour: Double = 0.5,
+            val stormPerMinute: Double = 10.0, // Arrival rate during a storm
+            val stormDurationMs: Double = 60_000.0, // Mean, exponential
+            val openProbability: Double = 0.3,
+            val openDelayMedianMs: Double = 20_000.0,
+            val ignoredAfterMs: Long = 30_000L
+    )
+
+    data class AppSwitchModel(
+            val perHour: Double = 20.0,
+            val backgroundMedianMs: Double = 15_000.0,
+            val backgroundSigma: Double = 1.0
+    )
+
+    /** How the phone is held and moved, for synthetic motion. */
+    enum class Activity(
+            val gravity: FloatArray, // Gravity in device coordinates (m/s²)
+            val gaitHz: Double,
+            val accelAmplitude: Double, // m/s²
+            val gyroAmplitude: Double, // rad/s
+            val noise: Double // Standard deviation of sensor noise
+    ) {
+        LAYING(floatArrayOf(0f, 0f, 9.81f), 0.0, 0.0, 0.0, 0.02),
+        SITTING(floatArrayOf(0f, 6.94f, 6.94f), 0.0, 0.0, 0.05, 0.08),
+        WALKING(floatArrayOf(0f, 9.81f, 0f), 1.9, 2.5, 0.8, 0.3),
+        RUNNING(floatArrayOf(0f, 9.81f, 0f), 2.8, 7.0, 2.0, 0.6)
+    }
+
+    data class MotionModel(
+            val schedule: List<Pair<Activity, Long>> = listOf(Activity.SITTING to 60_000L),
+            val sampleRateHz: Int = 50
+    ) {
+        init {
+            require(schedule.isNotEmpty() && schedule.all { it.second > 0 }) {
+                "Motion schedule needs at least one phase with a positive duration"
+            }
+            require(sampleRateHz in 1..1000) { "Invalid sample rate" }
+        }
+    }
+
+    /** Enabled signal models; null disables a signal. */
+    data class Workload(
+            val seed: Long = 1L,
+            val scroll: ScrollModel? = ScrollModel(),
+            val typing: TypingModel? = TypingModel(),
+            val notifications: NotificationModel? = NotificationModel(),
+            val appSwitches: AppSwitchModel? = AppSwitchModel(),
+            val motion: MotionModel? = null
+    ) {
+        companion object {
+            /** Parse the map sent by the Dart `SyntheticWorkload.toJson()`. */
+            fun fromMap(map: Map<*, *>): Workload {
+                fun model(key: String) = map[key] as? Map<*, *>
+                return Workload(
+                        seed = (map["seed"] as? Number)?.toLong() ?: 1L,
+                        scroll = model("scroll")?.let(::scrollModel),
+                        typing = model("typing")?.let(::typingModel),
+                        notifications = model("notifications")?.let(::notificationModel),
+                        appSwitches = model("appSwitches")?.let(::appSwitchModel),
+                        motion = model("motion")?.let(::motionModel)
+                )
+            }
+
+            private fun scrollModel(map: Map<*, *>): ScrollModel {
+                val d = ScrollModel()
+                return ScrollModel(
+                        map.double("burstsPerMinute", d.burstsPerMinute),
+                        map.double("scrollsPerBurst", d.scrollsPerBurst),
+                        map.double("gapMs", d.gapMs),
+                        map.double("velocityMedian", d.velocityMedian),
+                        map.double("velocitySigma", d.velocitySigma),
+                        map.double("reversalProbability", d.reversalProbability)
+                )
+            }
+
+            private fun typingModel(map: Map<*, *>): TypingModel {
+                val d = TypingModel()
+                return TypingModel(
+                        map.double("burstsPerMinute", d.burstsPerMinute),
+                        map.double("keysPerBurst", d.keysPerBurst),
+                        map.double("interKeyMedianMs", d.interKeyMedianMs),
+                        map.double("interKeySigma", d.interKeySigma)
+                )
+            }
+
+            private fun notificationModel(map: Map<*, *>): NotificationModel {
+                val d = NotificationModel()
+                return NotificationModel(
+                        map.double("perHour", d.perHour),
+                        map.double("stormsPerHour", d.stormsPerHour),
+                        map.double("stormPerMinute", d.stormPerMinute),
+                        map.double("stormDurationMs", d.stormDurationMs),
+                        map.double("openProbability", d.openProbability),
+                        map.double("openDelayMedianMs", d.openDelayMedianMs),
+                        (map["ignoredAfterMs"] as? Number)?.toLong() ?: d.ignoredAfterMs
+                )
+            }
+
+            private fun appSwitchModel(map: Map<*, *>): AppSwitchModel {
+                val d = AppSwitchModel()
+                return AppSwitchModel(
+                        map.double("perHour", d.perHour),
+                        map.double("backgroundMedianMs", d.backgroundMedianMs),
+                        map.double("backgroundSigma", d.backgroundSigma)
+                )
+            }
+
+            private fun motionModel(map: Map<*, *>): MotionModel {
+                val schedule =
+                        (map["schedule"] as? List<*>)?.filterIsInstance<Map<*, *>>()?.map {
+                            Activity.valueOf("${it["activity"]}".uppercase()) to
+                                    ((it["durationMs"] as? Number)?.toLong() ?: 60_000L)
+                        }
+                return MotionModel(
+                        schedule = schedule ?: MotionModel().schedule,
+                        sampleRateHz = (map["sampleRateHz"] as? Number)?.toInt() ?: 50
+                )
+            }
+
+            private fun Map<*, *>.double(key: String, default: Double) =
+                    (this[key] as? Number)?.toDouble() ?: default
+        }
+    }
+
+    private val random = Random(workload.seed)
+    private val sources = PriorityQueue<Source>(compareBy { it.nextAt })
+    private val counts = LinkedHashMap<String, Long>()
+
+    /** Virtual time reached, in ms since the workload started. */
+    var virtualMs = 0L
+        private set
+
+    init {
+        workload.scroll?.let { sources.add(ScrollSource(it)) }
+        workload.typing?.let { sources.add(TypingSource(it)) }
+        workload.notifications?.let { sources.add(NotificationSource(it)) }
+        workload.appSwitches?.let { sources.add(AppSwitchSource(it)) }
+        workload.motion?.let { sources.add(MotionSource(it)) }
+    }
+
+    /** Emit everything due up to [targetMs] of virtual time, in time order. */
+    fun advanceTo(targetMs: Long, sink: Sink) {
+        while (true) {
+            val source = sources.peek() ?: break
+            if (source.nextAt > targetMs) break
+            sources.poll()
+            virtualMs = source.nextAt
+            source.emit(sink)
+            sources.add(source)
+        }
+        virtualMs = max(virtualMs, targetMs)
+        sink.flush()
+    }
+
+    /** Generated counts per event type, plus motion samples. */
+    fun getStats(): Map<String, Any> =
+            mapOf("virtual_ms" to virtualMs, "generated" to counts.toMap())
+
+    private fun count(key: String) {
+        counts[key] = (counts[key] ?: 0L) + 1
+    }
+
+    private fun event(sink: Sink, eventType: String, metrics: Map<String, Any>) {
+        count(eventType)
+        sink.onEvent(eventType, metrics)
+    }
+
+    private abstract inner class Source {
+        var nextAt = 0L
+
+        /** Emit the input due at [nextAt] and move [nextAt] forward. */
+        abstract fun emit(sink: Sink)
+    }
+
+    private inner class ScrollSource(private val model: ScrollModel) : Source() {
+        private var remaining = 0
+        private var direction = "down"
+
+        init {
+            nextAt = after(0L, 60_000.0 / model.burstsPerMinute)
+        }
+
+        override fun emit(sink: Sink) {
+            if (remaining == 0) remaining = geometric(model.scrollsPerBurst)
+            val reversal = random.nextDouble() < model.reversalProbability
+            if (reversal) direction = if (direction == "down") "up" else "down"
+            val velocity = logNormal(model.velocityMedian, model.velocitySigma)
+            val gestureSeconds = logNormal(250.0, 0.4) / 1000.0
+            event(
+                    sink,
+                    "scroll",
+                    mapOf(
+                            "velocity" to velocity,
+                            "acceleration" to velocity / gestureSeconds,
+                            "direction" to direction,
+                            "direction_reversal" to reversal
+                    )
+            )
+            remaining--
+            nextAt =
+                    if (remaining > 0) after(nextAt, model.gapMs)
+                    else after(nextAt, 60_000.0 / model.burstsPerMinute)
+        }
+    }
+
+    private inner class TypingSource(private val model: TypingModel) : Source() {
+        private var remaining = 0
+        private var lastKeyAt = -1L
+
+        init {
+            nextAt = after(0L, 60_000.0 / model.burstsPerMinute)
+        }
+
+        override fun emit(sink: Sink) {
+            if (remaining == 0) {
+                remaining = geometric(model.keysPerBurst)
+                lastKeyAt = -1L
+            }
+            // Same tap shape as InputSignalCollector: duration estimated from inter-key latency
+            val latency = if (lastKeyAt < 0) 0L else nextAt - lastKeyAt
+            event(
+                    sink,
+                    "tap",
+                    mapOf(
+                            "tap_duration_ms" to latency.coerceIn(50, 150).toInt(),
+                            "long_press" to false
+                    )
+            )
+            lastKeyAt = nextAt
+            remaining--
+            nextAt =
+                    if (remaining > 0) {
+                        nextAt + max(1L, logNormal(model.interKeyMedianMs, model.interKeySigma)
+                                .roundToLong())
+                    } else {
+                        after(nextAt, 60_000.0 / model.burstsPerMinute)
+                    }
+        }
+    }
+
+    private inner class NotificationSource(private val model: NotificationModel) : Source() {
+        private var storm = false
+        private var nextArrival = after(0L, 3_600_000.0 / model.perHour)
+        private var nextStormToggle = after(0L, 3_600_000.0 / model.stormsPerHour)
+        private val responses = PriorityQueue<Pair<Long, String>>(compareBy { it.first })
+
+        init {
+            updateNextAt()
+        }
+
+        override fun emit(sink: Sink) {
+            val now = nextAt
+            val response = responses.peek()
+            when {
+                response != null && response.first == now -> {
+                    responses.poll()
+                    event(sink, "notification", mapOf("action" to response.second))
+                }
+                nextStormToggle == now -> {
+                    storm = !storm
+                    nextStormToggle =
+                            if (storm) after(now, model.stormDurationMs)
+                            else after(now, 3_600_000.0 / model.stormsPerHour)
+                    // Arrivals are memoryless, so the new rate applies from now
+                    nextArrival = after(now, meanArrivalGapMs())
+                }
+                else -> {
+                    event(sink, "notification", mapOf("action" to "received"))
+                    responses.add(
+                            if (random.nextDouble() < model.openProbability) {
+                                val delay = logNormal(model.openDelayMedianMs, 0.8).roundToLong()
+                                now + delay.coerceIn(1L, model.ignoredAfterMs - 1) to "opened"
+                            } else {
+                                now + model.ignoredAfterMs to "ignored"
+                            }
+                    )
+                    nextArrival = after(now, meanArrivalGapMs())
+                }
+            }
+            updateNextAt()
+        }
+
+        private fun meanArrivalGapMs() =
+                if (storm) 60_000.0 / model.stormPerMinute else 3_600_000.0 / model.perHour
+
+        private fun updateNextAt() {
+            nextAt = minOf(nextArrival, nextStormToggle, responses.peek()?.first ?: Long.MAX_VALUE)
+        }
+    }
+
+    private inner class AppSwitchSource(private val model: AppSwitchModel) : Source() {
+        init {
+            nextAt = after(0L, 3_600_000.0 / model.perHour)
+        }
+
+        override fun emit(sink: Sink) {
+            val background = logNormal(model.backgroundMedianMs, model.backgroundSigma)
+            event(sink, "app_switch", mapOf("background_duration_ms" to background.toInt()))
+            nextAt = after(nextAt, 3_600_000.0 / model.perHour)
+        }
+    }
+
+    private inner class MotionSource(private val model: MotionModel) : Source() {
+        private val periodNanos = 1_000_000_000L / model.sampleRateHz
+        private val cycleMs = model.schedule.sumOf { it.second }
+        private var sample = 0L
+
+        override fun emit(sink: Sink) {
+            val seconds = sample * periodNanos / 1e9
+            val activity = activityAt(nextAt % cycleMs)
+            val phase = 2 * PI * activity.gaitHz * seconds
+            val amplitude = activity.accelAmplitude
+            val gyro = activity.gyroAmplitude
+
+            val accel = activity.gravity.copyOf()
+            accel[0] += (0.3 * amplitude * sin(phase / 2) + noise(activity)).toFloat() // Sway
+            accel[1] += (amplitude * sin(phase) + 0.3 * amplitude * sin(2 * phase + 0.5) +
+                            noise(activity))
+                    .toFloat() // Vertical bounce, with its first harmonic
+            accel[2] += (0.2 * amplitude * sin(phase + 1.0) + noise(activity)).toFloat()
+            sink.onMotionSample(Sensor.TYPE_ACCELEROMETER, accel)
+
+            val rotation =
+                    floatArrayOf(
+                            (gyro * sin(phase) + noise(activity)).toFloat(),
+                            (0.5 * gyro * sin(phase / 2) + noise(activity)).toFloat(),
+                            (0.3 * gyro * cos(phase) + noise(activity)).toFloat()
+                    )
+            sink.onMotionSample(Sensor.TYPE_GYROSCOPE, rotation)
+            count("motion_samples")
+
+            sample++
+            nextAt = sample * periodNanos / 1_000_000L
+        }
+
+        private fun activityAt(cycleOffsetMs: Long): Activity {
+            var end = 0L
+            for ((activity, durationMs) in model.schedule) {
+                end += durationMs
+                if (cycleOffsetMs < end) return activity
+            }
+            return model.schedule.last().first
+        }
+
+        private fun noise(activity: Activity) = random.nextGaussian() * activity.noise
+    }
+
+    /** [from] plus an exponential gap with [meanMs]; never for a zero rate. */
+    private fun after(from: Long, meanMs: Double): Long {
+        if (!meanMs.isFinite() || meanMs <= 0) return Long.MAX_VALUE
+        val gap = -meanMs * ln(1.0 - random.nextDouble())
+        return from + max(1L, gap.roundToLong())
+    }
+
+    private fun logNormal(median: Double, sigma: Double) =
+            median * exp(sigma * random.nextGaussian())
+
+    /** At least 1, with the given mean. */
+    private fun geometric(mean: Double): Int {
+        if (mean <= 1.0) return 1
+        val u = 1.0 - random.nextDouble()
+        return 1 + (ln(u) / ln(1.0 - 1.0 / mean)).toInt()
+    }
+
+    /**
+     * Drives a generator at [speed]× real time on a background queue until [durationMs] of
+     * virtual time have been emitted or [stop] is called. Each tick emits everything due since the
+     * previous one, then calls [onTick] with the virtual time reached.
+     */
+    class Run(
+            private val generator: WorkloadGenerator,
+            private val speed: Double,
+            private val durationMs: Long,
+            private val sink: Sink,
+            private val onTick: ((virtualMs: Long) -> Unit)? = null
+    ) {
+        private val queue = BehaviorExecutor.SerialQueue(BehaviorExecutor.QoS.BACKGROUND)
+        private var startedNanos = 0L
+        private var wallMs = 0L
+        private var future: ScheduledFuture<*>? = null
+        @Volatile private var running = false
+
+        private val tick =
+                object : Runnable {
+                    override fun run() {
+                        if (!running) return
+                        wallMs = (System.nanoTime() - startedNanos) / 1_000_000L
+                        val target = minOf((wallMs * speed).toLong(), durationMs)
+                        generator.advanceTo(target, sink)
+                        onTick?.invoke(target)
+                        if (target >= durationMs) {
+                            running = false
+                        } else {
+                            future = queue.schedule(TICK_MS, this)
+                        }
+                    }
+                }
+
+        init {
+            require(speed in 1.0..1000.0) { "Speed must be between 1 and 1000" }
+            require(durationMs > 0) { "Duration must be positive" }
+        }
+
+        fun start() {
+            queue.execute {
+                startedNanos = System.nanoTime()
+                running = true
+                tick.run()
+            }
+        }
+
+        /** Stop emitting. Nothing is emitted after this returns. */
+        fun stop() {
+            queue.call {
+                running = false
+                future?.cancel(false)
+            }
+        }
+
+        fun getStats(): Map<String, Any> =
+                queue.call {
+                    generator.getStats() +
+                            mapOf(
+                                    "running" to running,
+                                    "speed" to speed,
+                                    "duration_ms" to durationMs,
+                                    "wall_ms" to wallMs
+                            )
+                }
+
+        private companion object {
+            const val TICK_MS = 10L
+        }
+    }
+}
@@ -0,0 +1,267 @@
+package ai.synheart.behavior
+
+import java.math.BigDecimal
+import java.math.BigInteger
+import java.math.MathContext
+import java.math.RoundingMode
+import java.util.Random
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertNotEquals
+import org.junit.Assert.assertTrue
+import org.junit.Assert.fail
+import org.junit.Test
+
+/**
+ * [FastDouble] against the platform: `Double.parseDouble` is the reference for every parse, and
+ * formatting must round-trip through it, be as short as possible and, on JDK 19+ where
+ * `Double.toString` is shortest too, pick the same decimal. Doubles are compared bit for bit, so
+ * -0.0 and 0.0 differ.
+ */
+class FastDoubleTest {
+
+    @Test
+    fun formatsExtremesAndNotationBoundaries() {
+        val expected =
+                linkedMapOf(
+                        0.0 to "0",
+                        -0.0 to "-0",
+                        1.0 to "1",
+                        0.1 to "0.1",
+                        0.3 to "0.3",
+                        Double.MIN_VALUE to "4.9E-324",
+                        -Double.MIN_VALUE to "-4.9E-324",
+                        3 * Double.MIN_VALUE to "1.5E-323",
+                        1e-323 to "9.9E-324", // Two digits, as Double.toString
+                        1e-322 to "9.9E-323",
+                        Math.nextDown(java.lang.Double.MIN_NORMAL) to "2.225073858507201E-308",
+                        java.lang.Double.MIN_NORMAL to "2.2250738585072014E-308",
+                        Math.nextDown(Double.MAX_VALUE) to "1.7976931348623155E308",
+                        Double.MAX_VALUE to "1.7976931348623157E308",
+                        -Double.MAX_VALUE to "-1.7976931348623157E308",
+                        9007199254740992.0 to "9007199254740992",
+                        9.223372036854776E18 to "9223372036854776000",
+                        1e-7 to "0.0000001",
+                        1e-8 to "1E-8",
+                        1e20 to "100000000000000000000",
+                        1e21 to "1E21",
+                        2e23 to "2E23"
+                )
+        for ((value, text) in expected) {
+            assertEquals("format of $value", text, FastDouble.toString(value))
+            assertRoundTrip(value)
+        }
+    }
+
+    @Test
+    fun powersOfTen() {
+        for (e in -330..310) {
+            for (text in listOf("1e$e", "1E$e", "1.0e$e", "10e${e - 1}", "0.1e${e + 1}")) {
+                assertParse(text)
+            }
+            val value = "1e$e".toDouble()
+            if (value == 0.0 || value.isInfinite()) continue
+            assertRoundTrip(value)
+            assertRoundTrip(-value)
+            val text =
+                    when {
+                        e in 0..20 -> "1" + "0".repeat(e)
+                        e > 20 -> "1E$e"
+                        e >= -7 -> "0." + "0".repeat(-e - 1) + "1"
+                        e >= -321 -> "1E$e"
+                        else -> continue // 1e-322 and 1e-323 keep two digits, checked above
+                    }
+            assertEquals("format of 1e$e", text, FastDouble.toString(value))
+        }
+    }
+
+    @Test
+    fun subnormals() {
+        for (t in 1L..2_000L) assertRoundTrip(java.lang.Double.longBitsToDouble(t))
+        assertRoundTrip(java.lang.Double.longBitsToDouble((1L shl 52) - 1)) // Largest subnormal
+        val random = Random(SEED)
+        repeat(20_000) {
+            val t = (random.nextLong() and ((1L shl 52) - 1)).coerceAtLeast(1L)
+            assertRoundTrip(java.lang.Double.longBitsToDouble(t))
+        }
+        // Around half of MIN_VALUE (rounds to 0 at exactly half) and the normal boundary
+        for (text in
+                listOf(
+                        "2.4703282292062327e-324",
+                        "2.4703282292062328e-324",
+                        "1e-324",
+                        "5e-324",
+                        "7.4e-324",
+                        "2.225073858507201e-308",
+                        "2.2250738585072011e-308",
+                        "2.2250738585072012e-308",
+                        "1e-400",
+                        "-1e-400"
+                )) {
+            assertParse(text)
+        }
+    }
+
+    @Test
+    fun overflowAndLimits() {
+        for (text in
+                listOf(
+                        "1.7976931348623157e308",
+                        "1.7976931348623158e308", // Still rounds down to MAX_VALUE
+                        "1.7976931348623159e308",
+                        "1e309",
+                        "-1e309",
+                        "1e400",
+                        "9223372036854775807",
+                        "9223372036854775808",
+                        "18446744073709551615",
+                        "0e400",
+                        "-0"
+                )) {
+            assertParse(text)
+        }
+        assertBits(Double.MAX_VALUE, FastDouble.parse("1.7976931348623158e308"), "near MAX")
+        assertBits(Double.POSITIVE_INFINITY, FastDouble.parse("1e400"), "1e400")
+    }
+
+    /**
+     * Decimals exactly halfway between two doubles, and one unit in the last place either side.
+     * With at most 19 digits these take the Eisel-Lemire path, which must round ties to even;
+     * the long midpoints of arbitrary doubles take the fallback.
+     */
+    @Test
+    fun halfwayCases() {
+        for (shift in 0 until 12) {
+            for (i in 0 until 200) {
+                val odd = BigInteger.ONE.shiftLeft(53).add(BigInteger.valueOf(2L * i + 1))
+                val midpoint = odd.shiftLeft(shift)
+                val digits = midpoint.toString()
+                if (digits.length > 19) continue
+                val tenfold = midpoint.multiply(BigInteger.TEN)
+                for (text in
+                        listOf(
+                                digits,
+                                "${digits}0e-1",
+                                "${tenfold.add(BigInteger.ONE)}e-1",
+                                "${tenfold.subtract(BigInteger.ONE)}e-1",
+                                midpoint.add(BigInteger.ONE).toString(),
+                                midpoint.subtract(BigInteger.ONE).toString()
+                        )) {
+                    assertParse(text)
+                }
+            }
+        }
+        // 2^53 + 1 lies between 2^53 and 2^53 + 2: the even significand wins
+        assertBits(9007199254740992.0, FastDouble.parse("9007199254740993"), "2^53 + 1")
+        assertBits(9007199254740996.0, FastDouble.parse("9007199254740995"), "2^53 + 3")
+
+        val random = Random(SEED)
+        repeat(20_000) {
+            val value = java.lang.Double.longBitsToDouble(random.nextLong() ushr 1)
+            if (value.isNaN() || value.isInfinite() || value == Double.MAX_VALUE) return@repeat
+            val sum = BigDecimal(value).add(BigDecimal(Math.nextUp(value)))
+            assertParse(sum.divide(BigDecimal(2)).toString())
+        }
+    }
+
+    @Test
+    fun randomRoundTrips() {
+        val random = Random(SEED)
+        repeat(RANDOM_VALUES) {
+            // Uniform bit patterns cover every exponent; scaled fractions cover typical metrics
+            val value = java.lang.Double.longBitsToDouble(random.nextLong())
+            if (!value.isNaN() && !value.isInfinite()) assertRoundTrip(value)
+            assertRoundTrip(random.nextDouble() * Math.pow(10.0, random.nextInt(15) - 5.0))
+        }
+    }
+
+    @Test
+    fun randomDecimals() {
+        val random = Random(SEED)
+        repeat(RANDOM_VALUES) {
+            val digits = 1 + random.nextInt(19)
+            val mantissa = StringBuilder().append('1' + random.nextInt(9))
+            repeat(digits - 1) { mantissa.append('0' + random.nextInt(10)) }
+            val exponent = random.nextInt(656) - 345
+            assertParse("${mantissa}e$exponent")
+            assertParse("-${mantissa[0]}.${mantissa.substring(1).ifEmpty { "0" }}e$exponent")
+        }
+    }
+
+    @Test
+    fun parsesSubrangesAndRejectsNonNumbers() {
+        assertBits(125.0, FastDouble.parse("[12.5e1,", 1, 7), "subrange")
+        val invalid =
+                listOf(
+                        "",
+                        "-",
+                        "1.",
+                        ".5",
+                        "1e",
+                        "1e+",
+                        "+1",
+                        "1x",
+                        "abc",
+                        "0x10",
+                        "1.5e3.2",
+                        "01", // JSON allows no leading zeros
+                        "-01",
+                        "00",
+                        "00.5",
+                        "01e2"
+                )
+        for (text in invalid) {
+            try {
+                FastDouble.parse(text)
+                fail("Parsed \"$text\"")
+            } catch (e: NumberFormatException) {
+                // Expected
+            }
+        }
+    }
+
+    /** Parse [text] exactly as `Double.parseDouble` does. */
+    private fun assertParse(text: String) {
+        assertBits(java.lang.Double.parseDouble(text), FastDouble.parse(text), "parse of $text")
+    }
+
+    /** Format [value], check the text is shortest, and parse it and Double.toString back. */
+    private fun assertRoundTrip(value: Double) {
+        val text = FastDouble.toString(value)
+        val platform = java.lang.Double.toString(value)
+        assertBits(value, java.lang.Double.parseDouble(text), "parseDouble of $text")
+        assertBits(value, FastDouble.parse(text), "parse of $text")
+        assertBits(value, FastDouble.parse(platform), "parse of $platform")
+
+        // Double.toString keeps at least two significant digits, so one-digit forms are not
+        // required; from three digits on, neither neighbour one digit shorter may round-trip
+        val decimal = BigDecimal(text)
+        val digits = decimal.stripTrailingZeros().precision()
+        if (digits >= 3) {
+            for (mode in listOf(RoundingMode.FLOOR, RoundingMode.CEILING)) {
+                val shorter = decimal.round(MathContext(digits - 1, mode))
+                assertNotEquals("$text is not shortest", value, shorter.toDouble(), 0.0)
+            }
+        }
+        if (JAVA_VERSION >= 19) {
+            assertEquals("$text vs $platform", 0, decimal.compareTo(BigDecimal(platform)))
+        }
+    }
+
+    private fun assertBits(expected: Double, actual: Double, message: String) {
+        assertTrue(
+                "$message: expected $expected, got $actual",
+                java.lang.Double.doubleToRawLongBits(expected) ==
+                        java.lang.Double.doubleToRawLongBits(actual)
+        )
+    }
+
+    companion object {
+        private const val SEED = 20_240_611L
+        private const val RANDOM_VALUES = 100_000
+
+        private val JAVA_VERSION =
+                System.getProperty("java.specification.version").orEmpty().removePrefix("1.")
+                        .toIntOrNull()
+                        ?: 8
+    }
+}
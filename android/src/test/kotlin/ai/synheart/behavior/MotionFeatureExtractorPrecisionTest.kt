@@ -0,0 +1,326 @@
+package ai.synheart.behavior
+
+import java.io.File
+import java.util.Random
+import kotlin.math.PI
+import kotlin.math.abs
+import kotlin.math.sin
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertTrue
+import org.junit.Assume.assumeTrue
+import org.junit.Test
+
+/**
+ * Float32 [MotionFeatureExtractor] against the float64 [Float64FeatureReference] on fixed,
+ * seeded 5 s windows at 50 Hz. Both extractors get bit-identical inputs (the float32 samples
+ * widened to double), so every difference comes from the float32 pipeline.
+ */
+class MotionFeatureExtractorPrecisionTest {
+
+    private class Fixture(val name: String, val signals: Array<FloatArray>)
+
+    @Test
+    fun featuresMatchFloat64ReferenceWithinTolerance() {
+        for (fixture in fixtures()) {
+            val float32 = extract32(fixture)
+            val reference64 = Float64FeatureReference()
+            val float64 = extract64(fixture, reference64)
+            assertEquals("${fixture.name}: feature count", 561, float64.size)
+            assertEquals("${fixture.name}: feature names", float64.keys, float32.keys)
+
+            for ((name, reference) in float64) {
+                val actual = float32.getValue(name).toDouble()
+                assertTrue("${fixture.name}: $name is not finite", actual.isFinite())
+                if (name.contains("-maxInds")) {
+                    val spectrum = reference64.maxIndsSpectra.getValue(name)
+                    assertPeak(fixture.name, name, actual.toInt(), spectrum, float64)
+                    continue
+                }
+                val error = abs(actual - reference)
+                val tolerance = tolerance(name, reference, float64)
+                assertTrue(
+                        "${fixture.name}: $name = $actual, reference $reference, " +
+                                "error $error > $tolerance",
+                        error <= tolerance
+                )
+            }
+        }
+    }
+
+    @Test
+    fun classifierLabelsMatchFloat64Reference() {
+        val model = File(MODEL_PATH)
+        assumeTrue("$MODEL_PATH not found", model.exists())
+        val classifier = LinearClassifier.load(model.readBytes())
+
+        for (fixture in fixtures()) {
+            val float32 = extract32(fixture)
+            val float64 = extract64(fixture)
+            // Same ordering as MotionStateInference: features.txt carries no indices, so the
+            // Dart side falls back to the sorted feature names
+            val names = float64.keys.sorted()
+            val vector32 = DoubleArray(names.size) { float32.getValue(names[it]).toDouble() }
+            val vector64 = DoubleArray(names.size) { float64.getValue(names[it]) }
+            val scores32 = classifier.scores(vector32)
+            val scores64 = classifier.scores(vector64)
+
+            assertEquals(
+                    "${fixture.name}: label (float32 scores ${scores32.toList()}, " +
+                            "float64 scores ${scores64.toList()})",
+                    classifier.labels[argmax(scores64)],
+                    classifier.labels[argmax(scores32)]
+            )
+        }
+    }
+
+    private fun extract32(fixture: Fixture): Map<String, Float> {
+        val s = fixture.signals
+        return MotionFeatureExtractor().extractFeatures(s[0], s[1], s[2], s[3], s[4], s[5])
+    }
+
+    private fun extract64(
+            fixture: Fixture,
+            reference: Float64FeatureReference = Float64FeatureReference()
+    ): Map<String, Double> {
+        val s = fixture.signals.map { signal -> signal.map { it.toDouble() } }
+        return reference.extractFeatures(s[0], s[1], s[2], s[3], s[4], s[5])
+    }
+
+    /**
+     * maxInds is an index, and two bins of near-equal magnitude can swap under float32 round-off.
+     * The float32 pick must be a bin of the float64 [spectrum] within tolerance of its peak.
+     */
+    private fun assertPeak(
+            fixture: String,
+            name: String,
+            index: Int,
+            spectrum: DoubleArray,
+            features: Map<String, Double>
+    ) {
+        assertTrue("$fixture: $name = $index is out of range", index in spectrum.indices)
+        val peak = spectrum.maxOrNull() ?: 0.0
+        val scale = signalScale(name.substringBefore('-'), features)
+        val tolerance = REL_TOL * peak + ABS_TOL * maxOf(scale, 1e-6)
+        assertTrue(
+                "$fixture: $name = $index has magnitude ${spectrum[index]}, peak $peak",
+                peak - spectrum[index] <= tolerance
+        )
+    }
+
+    /**
+     * Allowed |float32 - float64| for one feature. Continuous features get [REL_TOL] of their
+     * value plus [ABS_TOL] of the signal's scale, so features that sit near zero (spectral
+     * minima, body-acceleration means) are judged against the signal they come from. AR
+     * coefficients come out of Levinson steps whose denominator can approach zero, which
+     * amplifies round-off, so they get [AR_REL_TOL]. Entropy counts samples per histogram bin and
+     * may move one sample across a bin edge. maxInds is checked by [assertPeak].
+     */
+    private fun tolerance(name: String, reference: Double, features: Map<String, Double>): Double {
+        if (name.contains("-entropy()")) return ENTROPY_TOL
+        if (name.contains("-arCoeff()")) return AR_REL_TOL * abs(reference) + ABS_TOL
+        val dimensionless = name.startsWith("angle(") || DIMENSIONLESS.any { name.contains(it) }
+        var scale = if (dimensionless) 1.0 else signalScale(name.substringBefore('-'), features)
+        if (name.contains("-energy()") || name.contains("-bandsEnergy()")) scale *= scale
+        return REL_TOL * abs(reference) + ABS_TOL * maxOf(scale, 1e-6)
+    }
+
+    /** Largest |max()| or |min()| of a signal, i.e. its amplitude in its own units. */
+    private fun signalScale(signal: String, features: Map<String, Double>): Double {
+        var scale = 0.0
+        for ((name, value) in features) {
+            if (name.startsWith("$signal-max()") || name.startsWith("$signal-min()")) {
+                scale = maxOf(scale, abs(value))
+            }
+        }
+        return scale
+    }
+
+    private fun argmax(values: DoubleArray): Int {
+        var best = 0
+        for (i in values.indices) if (values[i] > values[best]) best = i
+        return best
+    }
+
+    /** Laying, sitting, walking and running windows: gravity, gait harmonics and noise. */
+    private fun fixtures(): List<Fixture> =
+            listOf(
+                    fixture("laying", 11L, doubleArrayOf(0.3, 0.2, 9.78), 0.0, 0.0, 0.02, 0.005),
+                    fixture("sitting", 12L, doubleArrayOf(1.5, 8.9, 3.6), 0.3, 0.05, 0.03, 0.01),
+                    fixture("walking", 13L, doubleArrayOf(0.5, 9.6, 1.2), 1.9, 2.0, 0.15, 0.05),
+                    fixture("running", 14L, doubleArrayOf(0.8, 9.4, 1.6), 2.8, 6.0, 0.4, 0.2)
+            )
+
+    private fun fixture(
+            name: String,
+            seed: Long,
+            gravity: DoubleArray,
+            stepHz: Double,
+            amplitude: Double,
+            accelNoise: Double,
+            gyroNoise: Double
+    ): Fixture {
+        val random = Random(seed)
+        val signals = Array(6) { FloatArray(SAMPLES) }
+        for (i in 0 until SAMPLES) {
+            val phase = 2.0 * PI * stepHz * i / SAMPLE_RATE_HZ
+            val gait =
+                    doubleArrayOf(
+                            0.4 * amplitude * sin(2.0 * phase),
+                            amplitude * sin(phase),
+                            0.6 * amplitude * sin(phase + 0.7)
+                    )
+            for (axis in 0 until 3) {
+                signals[axis][i] =
+                        (gravity[axis] + gait[axis] + accelNoise * random.nextGaussian())
+                                .toFloat()
+                signals[axis + 3][i] =
+                        (0.4 * gait[(axis + 1) % 3] + gyroNoise * random.nextGaussian())
+                                .toFloat()
+            }
+        }
+        return Fixture(name, signals)
+    }
+
+    /**
+     * The ONNX `LinearClassifier` node of the bundled model: `scores = coefficients · x +
+     * intercepts`, label = argmax (post_transform NONE). Reads just enough protobuf to find it.
+     */
+    private class LinearClassifier(
+            val coefficients: DoubleArray,
+            val intercepts: DoubleArray,
+            val labels: List<String>
+    ) {
+        fun scores(features: DoubleArray): DoubleArray {
+            assertEquals(coefficients.size, intercepts.size * features.size)
+            return DoubleArray(intercepts.size) { c ->
+                var sum = intercepts[c]
+                for (i in features.indices) sum += coefficients[c * features.size + i] * features[i]
+                sum
+            }
+        }
+
+        companion object {
+            fun load(model: ByteArray): LinearClassifier {
+                val graph = Proto(model).messages(MODEL_GRAPH).single()
+                val node =
+                        Proto(graph).messages(GRAPH_NODE).single {
+                            Proto(it).strings(NODE_OP_TYPE).singleOrNull() == "LinearClassifier"
+                        }
+                val attributes =
+                        Proto(node).messages(NODE_ATTRIBUTE).associateBy {
+                            Proto(it).strings(ATTR_NAME).single()
+                        }
+                fun attribute(name: String) = Proto(attributes.getValue(name))
+                return LinearClassifier(
+                        attribute("coefficients").floats(ATTR_FLOATS),
+                        attribute("intercepts").floats(ATTR_FLOATS),
+                        attribute("classlabels_strings").strings(ATTR_STRINGS)
+                )
+            }
+
+            private const val MODEL_GRAPH = 7
+            private const val GRAPH_NODE = 1
+            private const val NODE_OP_TYPE = 4
+            private const val NODE_ATTRIBUTE = 5
+            private const val ATTR_NAME = 1
+            private const val ATTR_FLOATS = 7
+            private const val ATTR_STRINGS = 9
+        }
+    }
+
+    /** Field access over one serialized protobuf message. */
+    private class Proto(private val bytes: ByteArray) {
+
+        fun messages(field: Int): List<ByteArray> = fields(field).map { it as ByteArray }
+
+        fun strings(field: Int): List<String> = messages(field).map { String(it, Charsets.UTF_8) }
+
+        /** Repeated float, packed (wire type 2) or one fixed32 per element (wire type 5). */
+        fun floats(field: Int): DoubleArray {
+            val values = ArrayList<Double>()
+            for (value in fields(field)) {
+                if (value is ByteArray) {
+                    for (i in 0 until value.size / 4) values.add(float32(fixed32(value, i * 4)))
+                } else {
+                    values.add(float32(value as Long))
+                }
+            }
+            return values.toDoubleArray()
+        }
+
+        private fun fields(field: Int): List<Any> {
+            val values = ArrayList<Any>()
+            var position = 0
+            while (position < bytes.size) {
+                val (key, afterKey) = varint(position)
+                position = afterKey
+                val number = (key ushr 3).toInt()
+                val value: Any
+                when ((key and 7L).toInt()) {
+                    0 -> {
+                        val (v, next) = varint(position)
+                        value = v
+                        position = next
+                    }
+                    1 -> {
+                        value = 0L
+                        position += 8
+                    }
+                    2 -> {
+                        val (length, start) = varint(position)
+                        position = start + length.toInt()
+                        value = bytes.copyOfRange(start, position)
+                    }
+                    5 -> {
+                        value = fixed32(bytes, position)
+                        position += 4
+                    }
+                    else -> throw IllegalStateException("Unsupported wire type in field $number")
+                }
+                if (number == field) values.add(value)
+            }
+            return values
+        }
+
+        private fun varint(start: Int): Pair<Long, Int> {
+            var result = 0L
+            var shift = 0
+            var position = start
+            while (true) {
+                val b = bytes[position++].toInt() and 0xff
+                result = result or ((b and 0x7f).toLong() shl shift)
+                if (b and 0x80 == 0) return Pair(result, position)
+                shift += 7
+            }
+        }
+
+        private fun fixed32(data: ByteArray, position: Int): Long =
+                (data[position].toLong() and 0xff) or
+                        ((data[position + 1].toLong() and 0xff) shl 8) or
+                        ((data[position + 2].toLong() and 0xff) shl 16) or
+                        ((data[position + 3].toLong() and 0xff) shl 24)
+
+        private fun float32(bits: Long): Double =
+                java.lang.Float.intBitsToFloat(bits.toInt()).toDouble()
+    }
+
+    companion object {
+        private const val SAMPLE_RATE_HZ = 50.0
+        private const val SAMPLES = 250
+
+        // Gradle runs unit tests from the android/ module directory
+        private const val MODEL_PATH = "../assets/models/linear_svc_model.onnx"
+
+        // Float32 keeps ~7 significant digits; the pipeline's cancellation-prone sums run in
+        // double, so 1e-3 leaves headroom for FFT round-off without hiding real regressions
+        private const val REL_TOL = 1e-3
+        private const val ABS_TOL = 1e-3
+        private const val AR_REL_TOL = 1e-2
+
+        // One sample crossing one of 10 histogram bin edges moves entropy by < ln(n) / n
+        private const val ENTROPY_TOL = 0.05
+
+        private val DIMENSIONLESS =
+                listOf("-correlation()", "-meanFreq()", "-skewness()", "-kurtosis()")
+    }
+}
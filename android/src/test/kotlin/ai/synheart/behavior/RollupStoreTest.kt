@@ -0,0 +1,157 @@
+package ai.synheart.behavior
+
+import java.io.File
+import java.nio.file.Files
+import java.util.TimeZone
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertTrue
+import org.junit.Before
+import org.junit.Test
+
+class RollupStoreTest {
+
+    private lateinit var directory: File
+
+    @Before
+    fun setUp() {
+        directory = Files.createTempDirectory("rollups").toFile()
+    }
+
+    @After
+    fun tearDown() {
+        directory.deleteRecursively()
+    }
+
+    @Test
+    fun scoresAreAveragedOverScoredSessionsOnly() {
+        val store = RollupStore(7)
+        record(store, END_MS, scores(0.8))
+        record(store, END_MS, emptyMap()) // Ended without Flux metrics
+
+        val day = store.trend(RollupStore.Granularity.DAY, END_MS, END_MS).single()
+        assertEquals(2, day["session_count"])
+        assertEquals(1, day["scored_session_count"])
+        assertEquals(0.8, day["focus_hint"] as Double, 1e-12)
+        assertEquals(0.2, day["behavioral_distraction_score"] as Double, 1e-12)
+        assertEquals(0.4, day["interaction_intensity"] as Double, 1e-12)
+    }
+
+    @Test
+    fun hourBucketsFollowClockChanges() {
+        val saved = TimeZone.getDefault()
+        TimeZone.setDefault(TimeZone.getTimeZone("Europe/Berlin"))
+        try {
+            // Clocks went from 02:00 CET to 03:00 CEST at 01:00 UTC on 2023-03-26
+            val store = RollupStore(7)
+            for (hour in -3..2) record(store, CLOCK_CHANGE_MS + hour * HOUR_MS + 1_000, emptyMap())
+
+            val hours =
+                    store.trend(
+                            RollupStore.Granularity.HOUR,
+                            CLOCK_CHANGE_MS - 3 * HOUR_MS,
+                            CLOCK_CHANGE_MS + 3 * HOUR_MS
+                    )
+            // One bucket per UTC hour; the skipped local hour 02:00 has none
+            assertEquals(
+                    (-3..3).map { CLOCK_CHANGE_MS + it * HOUR_MS },
+                    hours.map { it["bucket_start_ms"] }
+            )
+            assertEquals(listOf(1, 1, 1, 1, 1, 1, 0), hours.map { it["session_count"] })
+        } finally {
+            TimeZone.setDefault(saved)
+        }
+    }
+
+    @Test
+    fun ringsSurviveRestart() {
+        val file = File(directory, "rollups")
+        val store = RollupStore(30, file)
+        for (day in 0 until 10) record(store, END_MS - day * DAY_MS, scores(day / 10.0))
+        store.flush()
+
+        val restored = RollupStore(30, file).also { it.load() }
+        for (granularity in RollupStore.Granularity.values()) {
+            assertEquals(
+                    store.trend(granularity, END_MS - 9 * DAY_MS, END_MS),
+                    restored.trend(granularity, END_MS - 9 * DAY_MS, END_MS)
+            )
+        }
+    }
+
+    @Test
+    fun shorterRetentionKeepsWhatFits() {
+        val file = File(directory, "rollups")
+        val store = RollupStore(30, file)
+        for (day in 0 until 20) record(store, END_MS - day * DAY_MS, scores(0.5))
+        store.flush()
+
+        val restored = RollupStore(7, file).also { it.load() }
+        val days = restored.trend(RollupStore.Granularity.DAY, END_MS - 19 * DAY_MS, END_MS)
+        assertEquals(7, days.size)
+        assertEquals(store.trend(RollupStore.Granularity.DAY, END_MS - 6 * DAY_MS, END_MS), days)
+    }
+
+    @Test
+    fun encryptedRingsNeedTheirKey() {
+        val file = File(directory, "rollups")
+        val key = SegmentCipher.generateKey()
+        val store = RollupStore(7, file, SegmentCipher(key))
+        record(store, END_MS, scores(0.4))
+        store.flush()
+
+        val restored = RollupStore(7, file, SegmentCipher(key)).also { it.load() }
+        assertEquals(
+                store.trend(RollupStore.Granularity.DAY, END_MS, END_MS),
+                restored.trend(RollupStore.Granularity.DAY, END_MS, END_MS)
+        )
+
+        // Another key cannot open the file: it is dropped and the store starts empty
+        val other = RollupStore(7, file, SegmentCipher(SegmentCipher.generateKey()))
+        other.load()
+        assertFalse(file.exists())
+        val day = other.trend(RollupStore.Granularity.DAY, END_MS, END_MS).single()
+        assertEquals(0, day["session_count"])
+    }
+
+    @Test
+    fun corruptFileIsDropped() {
+        val file = File(directory, "rollups")
+        file.writeBytes(byteArrayOf(1, 2, 3))
+
+        val store = RollupStore(7, file)
+        store.load()
+        assertFalse(file.exists())
+        record(store, END_MS, scores(0.1))
+        store.flush()
+        assertTrue(file.exists())
+    }
+
+    private fun scores(value: Double): Map<String, Any> =
+            mapOf(
+                    "focus_hint" to value,
+                    "behavioral_distraction_score" to 1 - value,
+                    "interaction_intensity" to value / 2
+            )
+
+    private fun record(store: RollupStore, endMs: Long, metrics: Map<String, Any>) {
+        store.record(
+                endTimeMs = endMs,
+                durationMs = 60_000,
+                eventCount = 12,
+                appSwitchCount = 1,
+                notificationCount = 2,
+                callCount = 0,
+                clipboardCount = 1,
+                behavioralMetrics = metrics
+        )
+    }
+
+    companion object {
+        private const val END_MS = 1_700_000_000_000L
+        private const val DAY_MS = 86_400_000L
+        private const val HOUR_MS = 3_600_000L
+        private const val CLOCK_CHANGE_MS = 1_679_792_400_000L
+    }
+}
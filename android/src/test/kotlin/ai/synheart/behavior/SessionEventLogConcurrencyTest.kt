@@ -0,0 +1,172 @@
+package ai.synheart.behavior
+
+import java.time.Instant
+import java.util.concurrent.ConcurrentLinkedQueue
+import java.util.concurrent.CountDownLatch
+import java.util.concurrent.TimeUnit
+import java.util.concurrent.atomic.AtomicBoolean
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertTrue
+import org.junit.Test
+
+/**
+ * One writer appends to a [SessionEventLog] while readers run every query kind against it.
+ * Event `seq` is its arrival index and fixes its type and timestamp, so each reader can compute
+ * what a consistent prefix of the log must return and compare the whole result against it.
+ */
+class SessionEventLogConcurrencyTest {
+
+    @Test
+    fun queriesSeeConsistentPrefixesWhileAppending() {
+        val log = SessionEventLog()
+        val failures = ConcurrentLinkedQueue<Throwable>()
+        val start = CountDownLatch(1)
+        val writing = AtomicBoolean(true)
+
+        val readers =
+                List(READERS) { reader ->
+                    Thread {
+                        try {
+                            start.await()
+                            val type = TYPES[reader % TYPES.size]
+                            var lastSize = 0
+                            var lastCount = 0
+                            var round = 0
+                            while (writing.get() || round == 0) {
+                                lastSize = checkSnapshot(log, lastSize)
+                                lastCount = checkOfType(log, type, lastCount)
+                                checkRange(log, type, round)
+                                checkInRange(log, round)
+                                checkAggregate(log, type)
+                                round++
+                            }
+                        } catch (t: Throwable) {
+                            failures.add(t)
+                        }
+                    }
+                }
+        readers.forEach { it.start() }
+
+        val writer = Thread {
+            try {
+                start.await()
+                for (seq in 0 until EVENTS) {
+                    log.append(event(seq))
+                    // Let readers interleave with the growth of every array in the log
+                    if (seq % 64 == 0) Thread.yield()
+                }
+            } catch (t: Throwable) {
+                failures.add(t)
+            } finally {
+                writing.set(false)
+            }
+        }
+        writer.start()
+        start.countDown()
+
+        writer.join(TimeUnit.MINUTES.toMillis(1))
+        readers.forEach { it.join(TimeUnit.MINUTES.toMillis(1)) }
+        assertTrue("Threads still running", readers.none { it.isAlive } && !writer.isAlive)
+        failures.firstOrNull()?.let { throw AssertionError("Concurrent access failed", it) }
+
+        assertEquals(EVENTS, log.size)
+        for (type in TYPES) {
+            assertEquals(expectedSeqs(EVENTS - 1) { typeOf(it) == type }, seqs(log.ofType(type)))
+        }
+    }
+
+    /** snapshot() and plain iteration are both prefixes in arrival order. */
+    private fun checkSnapshot(log: SessionEventLog, lastSize: Int): Int {
+        val snapshot = log.snapshot()
+        assertTrue("Size went backwards", snapshot.size >= lastSize)
+        snapshot.forEachIndexed { index, event -> assertEquals(index, seqOf(event)) }
+        var index = 0
+        for (event in log) assertEquals(index++, seqOf(event))
+        return snapshot.size
+    }
+
+    /** ofType() returns every event of the type up to its last one, and counts only grow. */
+    private fun checkOfType(log: SessionEventLog, type: String, lastCount: Int): Int {
+        val events = log.ofType(type)
+        assertPrefix(events) { typeOf(it) == type }
+        val count = log.countOfType(type)
+        assertTrue("Count went backwards", count >= events.size && events.size >= lastCount)
+        return count
+    }
+
+    /** Range queries on a type, over a window that slides with the round. */
+    private fun checkRange(log: SessionEventLog, type: String, round: Int) {
+        val startMs = timestampOf((round * 37) % EVENTS)
+        val endMs = startMs + 2_000
+        val events = log.ofType(type, startMs, endMs)
+        events.forEach { assertEquals(type, it.eventType) }
+        assertPrefix(events) { typeOf(it) == type && timestampOf(it) in startMs..endMs }
+        assertTrue(log.countOfType(type, startMs, endMs) >= events.size)
+    }
+
+    /** inRange() copies a consistent prefix of the window across all types. */
+    private fun checkInRange(log: SessionEventLog, round: Int) {
+        val startMs = timestampOf((round * 53) % EVENTS)
+        val endMs = startMs + 1_000
+        assertPrefix(log.inRange(startMs, endMs)) { timestampOf(it) in startMs..endMs }
+    }
+
+    /** Aggregate counts never go backwards and SUM covers exactly the counted prefix. */
+    private fun checkAggregate(log: SessionEventLog, type: String) {
+        val count =
+                log.aggregate(EventQuery(eventType = type)).singleOrNull()?.get("count") as Int?
+                        ?: 0
+        val sum =
+                log.aggregate(
+                                EventQuery(
+                                        eventType = type,
+                                        aggregation = EventQuery.Aggregation.SUM,
+                                        field = "seq"
+                                )
+                        )
+                        .singleOrNull()
+        if (sum == null) return
+        // A later snapshot: at least as many events, summing to that prefix of the type's seqs
+        val sumCount = sum["count"] as Int
+        assertTrue("Aggregate count went backwards", sumCount >= count)
+        val first = TYPES.indexOf(type).toLong()
+        val expected = sumCount * first + TYPES.size.toLong() * sumCount * (sumCount - 1) / 2
+        assertEquals(expected.toDouble(), sum["value"] as Double, 0.0)
+    }
+
+    /** [events] are exactly the events matching [matches] up to the last one returned. */
+    private fun assertPrefix(events: List<BehaviorEvent>, matches: (Int) -> Boolean) {
+        if (events.isEmpty()) return
+        val actual = seqs(events)
+        assertEquals(expectedSeqs(actual.last(), matches), actual)
+    }
+
+    private fun expectedSeqs(lastSeq: Int, matches: (Int) -> Boolean): List<Int> =
+            (0..lastSeq).filter(matches)
+
+    private fun seqs(events: List<BehaviorEvent>): List<Int> = events.map { seqOf(it) }
+
+    private fun seqOf(event: BehaviorEvent): Int = event.metrics["seq"] as Int
+
+    private fun event(seq: Int) =
+            BehaviorEvent(
+                    eventId = "evt_$seq",
+                    sessionId = "stress",
+                    timestamp = Instant.ofEpochMilli(timestampOf(seq)).toString(),
+                    eventType = typeOf(seq),
+                    metrics = mapOf("seq" to seq)
+            )
+
+    private fun typeOf(seq: Int): String = TYPES[seq % TYPES.size]
+
+    // Every seventh event arrives out of timestamp order, also within its type (same-type events
+    // are 40 ms apart), so range queries on every posting list take the sorted path
+    private fun timestampOf(seq: Int): Long = BASE_MS + seq * 10L - if (seq % 7 == 3) 45L else 0L
+
+    companion object {
+        private const val EVENTS = 20_000
+        private const val READERS = 4
+        private const val BASE_MS = 1_700_000_000_000L
+        private val TYPES = listOf("scroll", "tap", "typing", "notification")
+    }
+}
@@ -894,6 +894,7 @@ public struct BehaviorConfig {
     public let sessionIdPrefix: String?
     public let eventBatchSize: Int
     public let maxIdleGapSeconds: Double
+    public let useFusedMotionSensors: Bool
 
     public init(
         enableInputSignals: Bool = true,
@@ -901,7 +902,8 @@ public struct BehaviorConfig {
         enableMotionLite: Bool = false,
         sessionIdPrefix: String? = nil,
         eventBatchSize: Int = 10,
-        maxIdleGapSeconds: Double = 10.0
+        maxIdleGapSeconds: Double = 10.0,
+        useFusedMotionSensors: Bool = false
     ) {
         self.enableInputSignals = enableInputSignals
         self.enableAttentionSignals = enableAttentionSignals
@@ -909,6 +911,7 @@ public struct BehaviorConfig {
         self.sessionIdPrefix = sessionIdPrefix
         self.eventBatchSize = eventBatchSize
         self.maxIdleGapSeconds = maxIdleGapSeconds
+        self.useFusedMotionSensors = useFusedMotionSensors
     }
 }
 
@@ -27,6 +27,27 @@ class MotionFeatureExtractor {
         // Step 1: Separate gravity from body acceleration (low-pass filter)
         let (bodyAcc, gravityAcc) = separateGravity(accelX: accelX, accelY: accelY, accelZ: accelZ)
         
+        return extractFeatures(bodyAcc: bodyAcc, gravityAcc: gravityAcc, gyroX: gyroX, gyroY: gyroY, gyroZ: gyroZ)
+    }
+    
+    /**
+     * Extract all 561 features from acceleration that is already split into body and gravity
+     * components, e.g. CMDeviceMotion's userAcceleration and gravity. Skips the software
+     * low-pass filter.
+     */
+    func extractFeatures(
+        bodyAcc: (x: [Double], y: [Double], z: [Double]),
+        gravityAcc: (x: [Double], y: [Double], z: [Double]),
+        gyroX: [Double],
+        gyroY: [Double],
+        gyroZ: [Double]
+    ) -> [String: Double] {
+        var features: [String: Double] = [:]
+        
+        if bodyAcc.x.isEmpty || gyroX.isEmpty {
+            return features
+        }
+        
         // Step 2: Calculate jerk (derivative) for acceleration and gyroscope
         let bodyAccJerkX = calculateJerk(bodyAcc.x)
         let bodyAccJerkY = calculateJerk(bodyAcc.y)
@@ -255,13 +276,15 @@ class MotionFeatureExtractor {
         z: [Double],
         features: inout [String: Double]
     ) {
-        let fftX = fft(x)
-        let fftY = fft(y)
-        let fftZ = fft(z)
+        // Summarise each spectrum once; the spectral features below read from these
+        // summaries instead of re-mapping abs() over the spectrum per feature.
+        let specX = analyzeSpectrum(fft(x))
+        let specY = analyzeSpectrum(fft(y))
+        let specZ = analyzeSpectrum(fft(z))
         
-        let absX = fftX.map { abs($0) }
-        let absY = fftY.map { abs($0) }
-        let absZ = fftZ.map { abs($0) }
+        let absX = specX.magnitudes
+        let absY = specY.magnitudes
+        let absZ = specZ.magnitudes
         
         // Mean
         features["\(prefix)-mean()-X"] = absX.average()
@@ -308,39 +331,27 @@ class MotionFeatureExtractor {
         features["\(prefix)-entropy()-Z"] = entropy(absZ)
         
         // MaxInds
-        if let maxX = absX.max(), let idxX = absX.firstIndex(of: maxX) {
-            features["\(prefix)-maxInds-X"] = Double(idxX)
-        } else {
-            features["\(prefix)-maxInds-X"] = 0.0
-        }
-        if let maxY = absY.max(), let idxY = absY.firstIndex(of: maxY) {
-            features["\(prefix)-maxInds-Y"] = Double(idxY)
-        } else {
-            features["\(prefix)-maxInds-Y"] = 0.0
-        }
-        if let maxZ = absZ.max(), let idxZ = absZ.firstIndex(of: maxZ) {
-            features["\(prefix)-maxInds-Z"] = Double(idxZ)
-        } else {
-            features["\(prefix)-maxInds-Z"] = 0.0
-        }
+        features["\(prefix)-maxInds-X"] = Double(specX.maxIndex)
+        features["\(prefix)-maxInds-Y"] = Double(specY.maxIndex)
+        features["\(prefix)-maxInds-Z"] = Double(specZ.maxIndex)
         
         // MeanFreq
-        features["\(prefix)-meanFreq()-X"] = meanFreq(fftX)
-        features["\(prefix)-meanFreq()-Y"] = meanFreq(fftY)
-        features["\(prefix)-meanFreq()-Z"] = meanFreq(fftZ)
+        features["\(prefix)-meanFreq()-X"] = specX.meanFreq
+        features["\(prefix)-meanFreq()-Y"] = specY.meanFreq
+        features["\(prefix)-meanFreq()-Z"] = specZ.meanFreq
         
         // Skewness
-        features["\(prefix)-skewness()-X"] = skewness(absX)
-        features["\(prefix)-skewness()-Y"] = skewness(absY)
-        features["\(prefix)-skewness()-Z"] = skewness(absZ)
+        features["\(prefix)-skewness()-X"] = specX.skewness
+        features["\(prefix)-skewness()-Y"] = specY.skewness
+        features["\(prefix)-skewness()-Z"] = specZ.skewness
         
         // Kurtosis
-        features["\(prefix)-kurtosis()-X"] = kurtosis(absX)
-        features["\(prefix)-kurtosis()-Y"] = kurtosis(absY)
-        features["\(prefix)-kurtosis()-Z"] = kurtosis(absZ)
+        features["\(prefix)-kurtosis()-X"] = specX.kurtosis
+        features["\(prefix)-kurtosis()-Y"] = specY.kurtosis
+        features["\(prefix)-kurtosis()-Z"] = specZ.kurtosis
         
         // BandsEnergy
-        extractBandsEnergy(prefix: prefix, fftX: fftX, fftY: fftY, fftZ: fftZ, features: &features)
+        extractBandsEnergy(prefix: prefix, specX: specX, specY: specY, specZ: specZ, features: &features)
     }
     
     /**
@@ -351,8 +362,8 @@ class MotionFeatureExtractor {
         mag: [Double],
         features: inout [String: Double]
     ) {
-        let fftMag = fft(mag)
-        let absMag = fftMag.map { abs($0) }
+        let spec = analyzeSpectrum(fft(mag))
+        let absMag = spec.magnitudes
         
         features["\(prefix)-mean()"] = absMag.average()
         features["\(prefix)-std()"] = stdDev(absMag)
@@ -363,14 +374,10 @@ class MotionFeatureExtractor {
         features["\(prefix)-energy()"] = energy(absMag)
         features["\(prefix)-iqr()"] = iqr(absMag)
         features["\(prefix)-entropy()"] = entropy(absMag)
-        if let max = absMag.max(), let idx = absMag.firstIndex(of: max) {
-            features["\(prefix)-maxInds"] = Double(idx)
-        } else {
-            features["\(prefix)-maxInds"] = 0.0
-        }
-        features["\(prefix)-meanFreq()"] = meanFreq(fftMag)
-        features["\(prefix)-skewness()"] = skewness(absMag)
-        features["\(prefix)-kurtosis()"] = kurtosis(absMag)
+        features["\(prefix)-maxInds"] = Double(spec.maxIndex)
+        features["\(prefix)-meanFreq()"] = spec.meanFreq
+        features["\(prefix)-skewness()"] = spec.skewness
+        features["\(prefix)-kurtosis()"] = spec.kurtosis
     }
     
     /**
@@ -587,74 +594,142 @@ class MotionFeatureExtractor {
         return result.map { abs($0) }
     }
     
-    private func meanFreq(_ fftData: [Double]) -> Double {
-        if fftData.isEmpty { return 0.0 }
-        let magnitudes = fftData.map { abs($0) }
-        let totalEnergy = magnitudes.reduce(0, +)
-        if totalEnergy == 0.0 { return 0.0 }
+    /**
+     * Summary of one magnitude spectrum. `energyPrefix` holds running sums of squared
+     * magnitudes, so the energy of bins `lo..<hi` is `energyPrefix[hi] - energyPrefix[lo]`.
+     */
+    private struct Spectrum {
+        let magnitudes: [Double]
+        let energyPrefix: [Double]
+        let maxIndex: Int
+        let meanFreq: Double
+        let skewness: Double
+        let kurtosis: Double
+        
+        func bandEnergy(_ lo: Int, _ hi: Int) -> Double {
+            return energyPrefix[hi] - energyPrefix[lo]
+        }
+    }
+    
+    // Frequency bands: 1-8 ... 57-64, then 1-16 ... 49-64, then 1-24, 25-48
+    private static let bands = [
+        (1, 8), (9, 16), (17, 24), (25, 32),
+        (33, 40), (41, 48), (49, 56), (57, 64),
+        (1, 16), (17, 32), (33, 48), (49, 64),
+        (1, 24), (25, 48)
+    ]
+    
+    // Clipped band ranges keyed by spectrum length (see bandBounds)
+    private var bandBoundsCache: [Int: [(Int, Int)]] = [:]
+    // Bin index ramp 0, 1, 2, ... keyed by spectrum length, used for meanFreq
+    private var rampCache: [Int: [Double]] = [:]
+    
+    /**
+     * Compute magnitudes, band-energy prefix sums, maxInds, meanFreq and the central
+     * moments for skewness/kurtosis with vDSP kernels over the spectrum.
+     */
+    private func analyzeSpectrum(_ fftData: [Double]) -> Spectrum {
+        let n = fftData.count
+        if n == 0 {
+            return Spectrum(magnitudes: [], energyPrefix: [0.0], maxIndex: 0,
+                            meanFreq: 0.0, skewness: 0.0, kurtosis: 0.0)
+        }
+        let len = vDSP_Length(n)
+        
+        var magnitudes = [Double](repeating: 0.0, count: n)
+        vDSP_vabsD(fftData, 1, &magnitudes, 1, len)
+        
+        var squares = [Double](repeating: 0.0, count: n)
+        vDSP_vsqD(magnitudes, 1, &squares, 1, len)
+        var energyPrefix = [Double](repeating: 0.0, count: n + 1)
+        var running = 0.0
+        for i in 0..<n {
+            running += squares[i]
+            energyPrefix[i + 1] = running
+        }
+        
+        var maxValue = 0.0
+        var maxIdx: vDSP_Length = 0
+        vDSP_maxviD(magnitudes, 1, &maxValue, &maxIdx, len)
+        
+        var sum = 0.0
+        vDSP_sveD(magnitudes, 1, &sum, len)
         
         var weightedSum = 0.0
-        for (index, mag) in magnitudes.enumerated() {
-            weightedSum += Double(index) * mag
+        vDSP_dotprD(ramp(n), 1, magnitudes, 1, &weightedSum, len)
+        let meanFreq = sum == 0.0 ? 0.0 : weightedSum / sum
+        
+        var skewness = 0.0
+        var kurtosis = 0.0
+        if n >= 3 {
+            var negMean = -sum / Double(n)
+            var d = [Double](repeating: 0.0, count: n)
+            vDSP_vsaddD(magnitudes, 1, &negMean, &d, 1, len)
+            var d2 = [Double](repeating: 0.0, count: n)
+            vDSP_vsqD(d, 1, &d2, 1, len)
+            
+            var m2 = 0.0
+            var m3 = 0.0
+            var m4 = 0.0
+            vDSP_sveD(d2, 1, &m2, len)
+            vDSP_dotprD(d2, 1, d, 1, &m3, len)
+            vDSP_svesqD(d2, 1, &m4, len)
+            
+            let std = sqrt(m2 / Double(n))
+            if std != 0.0 {
+                let nd = Double(n)
+                let std2 = std * std
+                skewness = (nd / ((nd - 1.0) * (nd - 2.0))) * (m3 / (std2 * std))
+                if n >= 4 {
+                    kurtosis = ((nd * (nd + 1.0)) / ((nd - 1.0) * (nd - 2.0) * (nd - 3.0))) * (m4 / (std2 * std2)) -
+                        3.0 * (nd - 1.0) * (nd - 1.0) / ((nd - 2.0) * (nd - 3.0))
+                }
+            }
         }
-        return weightedSum / totalEnergy
+        
+        return Spectrum(magnitudes: magnitudes, energyPrefix: energyPrefix, maxIndex: Int(maxIdx),
+                        meanFreq: meanFreq, skewness: skewness, kurtosis: kurtosis)
     }
     
-    private func skewness(_ data: [Double]) -> Double {
-        if data.count < 3 { return 0.0 }
-        let mean = data.average()
-        let std = stdDev(data)
-        if std == 0.0 { return 0.0 }
-        
-        let n = Double(data.count)
-        let sum = data.map { pow(($0 - mean) / std, 3.0) }.reduce(0, +)
-        return (n / ((n - 1.0) * (n - 2.0))) * sum
+    private func ramp(_ n: Int) -> [Double] {
+        if let cached = rampCache[n] { return cached }
+        var values = [Double](repeating: 0.0, count: n)
+        var start = 0.0
+        var step = 1.0
+        vDSP_vrampD(&start, &step, &values, 1, vDSP_Length(n))
+        rampCache[n] = values
+        return values
     }
     
-    private func kurtosis(_ data: [Double]) -> Double {
-        if data.count < 4 { return 0.0 }
-        let mean = data.average()
-        let std = stdDev(data)
-        if std == 0.0 { return 0.0 }
-        
-        let n = Double(data.count)
-        let sum = data.map { pow(($0 - mean) / std, 4.0) }.reduce(0, +)
-        return ((n * (n + 1.0)) / ((n - 1.0) * (n - 2.0) * (n - 3.0))) * sum -
-            3.0 * (n - 1.0) * (n - 1.0) / ((n - 2.0) * (n - 3.0))
+    /**
+     * Band bin ranges clipped to a spectrum of length n. Window lengths barely vary
+     * between flushes, so the clipped table is cached per length.
+     */
+    private func bandBounds(_ n: Int) -> [(Int, Int)] {
+        if let cached = bandBoundsCache[n] { return cached }
+        let bounds = MotionFeatureExtractor.bands.map { (min($0.0 - 1, n), min($0.1, n)) }
+        bandBoundsCache[n] = bounds
+        return bounds
     }
     
     private func extractBandsEnergy(
         prefix: String,
-        fftX: [Double],
-        fftY: [Double],
-        fftZ: [Double],
+        specX: Spectrum,
+        specY: Spectrum,
+        specZ: Spectrum,
         features: inout [String: Double]
     ) {
-        let absX = fftX.map { abs($0) }
-        let absY = fftY.map { abs($0) }
-        let absZ = fftZ.map { abs($0) }
-        
-        let bands = [
-            (1, 8), (9, 16), (17, 24), (25, 32),
-            (33, 40), (41, 48), (49, 56), (57, 64),
-            (1, 16), (17, 32), (33, 48), (49, 64),
-            (1, 24), (25, 48)
-        ]
-        
-        for (start, end) in bands {
-            let startIdx = min(start - 1, absX.count)
-            let endIdx = min(end, absX.count)
-            
-            let bandEnergyX = absX[startIdx..<endIdx].map { $0 * $0 }.reduce(0, +)
-            let bandEnergyY = absY[startIdx..<endIdx].map { $0 * $0 }.reduce(0, +)
-            let bandEnergyZ = absZ[startIdx..<endIdx].map { $0 * $0 }.reduce(0, +)
-            
-            features["\(prefix)-bandsEnergy()-\(start),\(end)-X"] = bandEnergyX
-            features["\(prefix)-bandsEnergy()-\(start),\(end)-Y"] = bandEnergyY
-            features["\(prefix)-bandsEnergy()-\(start),\(end)-Z"] = bandEnergyZ
+        let boundsX = bandBounds(specX.magnitudes.count)
+        let boundsY = bandBounds(specY.magnitudes.count)
+        let boundsZ = bandBounds(specZ.magnitudes.count)
+        
+        for (i, (start, end)) in MotionFeatureExtractor.bands.enumerated() {
+            features["\(prefix)-bandsEnergy()-\(start),\(end)-X"] = specX.bandEnergy(boundsX[i].0, boundsX[i].1)
+            features["\(prefix)-bandsEnergy()-\(start),\(end)-Y"] = specY.bandEnergy(boundsY[i].0, boundsY[i].1)
+            features["\(prefix)-bandsEnergy()-\(start),\(end)-Z"] = specZ.bandEnergy(boundsZ[i].0, boundsZ[i].1)
         }
     }
-    
+
     private func angle(_ v1: (Double, Double, Double), _ v2: (Double, Double, Double)) -> Double {
         let dot = v1.0 * v2.0 + v1.1 * v2.1 + v1.2 * v2.2
         let mag1 = sqrt(v1.0 * v1.0 + v1.1 * v1.1 + v1.2 * v1.2)
@@ -6,18 +6,25 @@ import CoreMotion
 ///
 /// Collects raw samples and aggregates them into time windows (5 seconds).
 /// Calculates 561 ML features per window for model input.
+///
+/// With `useFusedMotionSensors` the collector reads CMDeviceMotion, whose
+/// userAcceleration and gravity are already separated by Core Motion's sensor
+/// fusion, and skips the software gravity filter. Falls back to the raw
+/// accelerometer when device motion is unavailable.
 class MotionSignalCollector {
     
     private var config: BehaviorConfig
     private var motionManager: CMMotionManager?
     
     private var isCollecting = false
+    private var fusedGravity = false // Device motion (fused gravity) used for the current collection
     private var sessionStartTime: Double = 0
     
     // Raw sample buffers (thread-safe using DispatchQueue)
     private let sampleQueue = DispatchQueue(label: "com.synheart.motion.samples", attributes: .concurrent)
     private var accelerometerSamples: [(timestamp: Double, x: Double, y: Double, z: Double)] = []
     private var gyroscopeSamples: [(timestamp: Double, x: Double, y: Double, z: Double)] = []
+    private var gravitySamples: [(timestamp: Double, x: Double, y: Double, z: Double)] = []
     
     // Aggregated motion data (per time window)
     private var motionDataPoints: [MotionDataPoint] = []
@@ -62,6 +69,7 @@ class MotionSignalCollector {
         sampleQueue.async(flags: .barrier) {
             self.accelerometerSamples.removeAll()
             self.gyroscopeSamples.removeAll()
+            self.gravitySamples.removeAll()
             self.motionDataPoints.removeAll()
         }
         
@@ -100,6 +108,12 @@ class MotionSignalCollector {
             return
         }
         
+        if config.useFusedMotionSensors && motionManager.isDeviceMotionAvailable {
+            startDeviceMotionUpdates(motionManager)
+            return
+        }
+        fusedGravity = false
+        
         // Check if sensors are available
         if !motionManager.isAccelerometerAvailable || !motionManager.isGyroAvailable {
             print("MotionSignalCollector: Motion sensors not available on this device")
@@ -151,11 +165,54 @@ class MotionSignalCollector {
         print("MotionSignalCollector: Started collecting motion data")
     }
     
+    /// Collect fused device motion: userAcceleration (body) and gravity in g,
+    /// plus the bias-corrected rotation rate, from a single 50Hz stream.
+    private func startDeviceMotionUpdates(_ motionManager: CMMotionManager) {
+        motionManager.deviceMotionUpdateInterval = 0.02 // 50Hz
+        
+        motionManager.startDeviceMotionUpdates(to: OperationQueue()) { [weak self] (motion, error) in
+            guard let self = self, let motion = motion, error == nil else { return }
+            
+            let timestamp = Date().timeIntervalSince1970 * 1000 // milliseconds
+            self.sampleQueue.async(flags: .barrier) {
+                self.accelerometerSamples.append((
+                    timestamp: timestamp,
+                    x: motion.userAcceleration.x,
+                    y: motion.userAcceleration.y,
+                    z: motion.userAcceleration.z
+                ))
+                self.gravitySamples.append((
+                    timestamp: timestamp,
+                    x: motion.gravity.x,
+                    y: motion.gravity.y,
+                    z: motion.gravity.z
+                ))
+                self.gyroscopeSamples.append((
+                    timestamp: timestamp,
+                    x: motion.rotationRate.x,
+                    y: motion.rotationRate.y,
+                    z: motion.rotationRate.z
+                ))
+            }
+            
+            // Check if we need to flush the current window
+            while timestamp >= self.lastWindowEndTime + self.timeWindowMs {
+                self.flushCurrentWindow()
+                self.lastWindowEndTime = self.lastWindowEndTime + self.timeWindowMs
+            }
+        }
+        
+        fusedGravity = true
+        isCollecting = true
+        print("MotionSignalCollector: Started collecting fused device motion data")
+    }
+    
     private func stopCollecting() {
         if !isCollecting { return }
         
         motionManager?.stopAccelerometerUpdates()
         motionManager?.stopGyroUpdates()
+        motionManager?.stopDeviceMotionUpdates()
         motionManager = nil
         
         isCollecting = false
@@ -165,6 +222,7 @@ class MotionSignalCollector {
     private func flushCurrentWindow() {
         let windowStartTime = lastWindowEndTime
         let windowEndTime = Date().timeIntervalSince1970 * 1000
+        let fused = fusedGravity
         
         sampleQueue.async(flags: .barrier) {
             // Collect all samples within this window
@@ -176,9 +234,14 @@ class MotionSignalCollector {
                 sample.timestamp >= windowStartTime && sample.timestamp < windowEndTime
             }
             
+            let gravity = self.gravitySamples.filter { sample in
+                sample.timestamp >= windowStartTime && sample.timestamp < windowEndTime
+            }
+            
             // Remove processed samples
             self.accelerometerSamples.removeAll { $0.timestamp < windowEndTime }
             self.gyroscopeSamples.removeAll { $0.timestamp < windowEndTime }
+            self.gravitySamples.removeAll { $0.timestamp < windowEndTime }
             
             // Only create data point if we have samples
             if !accelSamples.isEmpty || !gyroSamples.isEmpty {
@@ -195,11 +258,22 @@ class MotionSignalCollector {
                 let gyroY = sortedGyro.map { $0.y }
                 let gyroZ = sortedGyro.map { $0.z }
                 
-                // Extract 561 ML features from raw sensor data
-                let features = self.featureExtractor.extractFeatures(
-                    accelX: accelX, accelY: accelY, accelZ: accelZ,
-                    gyroX: gyroX, gyroY: gyroY, gyroZ: gyroZ
-                )
+                // Extract 561 ML features; in fused mode the accelerometer buffer
+                // already holds body acceleration and gravity comes from Core Motion
+                let features: [String: Double]
+                if fused {
+                    let sortedGravity = gravity.sorted { $0.timestamp < $1.timestamp }
+                    features = self.featureExtractor.extractFeatures(
+                        bodyAcc: (accelX, accelY, accelZ),
+                        gravityAcc: (sortedGravity.map { $0.x }, sortedGravity.map { $0.y }, sortedGravity.map { $0.z }),
+                        gyroX: gyroX, gyroY: gyroY, gyroZ: gyroZ
+                    )
+                } else {
+                    features = self.featureExtractor.extractFeatures(
+                        accelX: accelX, accelY: accelY, accelZ: accelZ,
+                        gyroX: gyroX, gyroY: gyroY, gyroZ: gyroZ
+                    )
+                }
                 
                 // Create timestamp for this window (use window start time)
                 let timestampDate = Date(timeIntervalSince1970: windowStartTime / 1000)
@@ -221,6 +295,7 @@ class MotionSignalCollector {
         sampleQueue.async(flags: .barrier) {
             self.accelerometerSamples.removeAll()
             self.gyroscopeSamples.removeAll()
+            self.gravitySamples.removeAll()
             self.motionDataPoints.removeAll()
         }
     }
@@ -110,7 +110,8 @@ public class SynheartBehaviorPlugin: NSObject, FlutterPlugin {
             enableMotionLite: config["enableMotionLite"] as? Bool ?? false,
             sessionIdPrefix: config["sessionIdPrefix"] as? String,
             eventBatchSize: config["eventBatchSize"] as? Int ?? 10,
-            maxIdleGapSeconds: config["maxIdleGapSeconds"] as? Double ?? 10.0
+            maxIdleGapSeconds: config["maxIdleGapSeconds"] as? Double ?? 10.0,
+            useFusedMotionSensors: config["useFusedMotionSensors"] as? Bool ?? false
         )
 
         behaviorSDK = BehaviorSDK(config: behaviorConfig)
@@ -183,7 +184,8 @@ public class SynheartBehaviorPlugin: NSObject, FlutterPlugin {
             enableMotionLite: config["enableMotionLite"] as? Bool ?? false,
             sessionIdPrefix: config["sessionIdPrefix"] as? String,
             eventBatchSize: config["eventBatchSize"] as? Int ?? 10,
-            maxIdleGapSeconds: config["maxIdleGapSeconds"] as? Double ?? 10.0
+            maxIdleGapSeconds: config["maxIdleGapSeconds"] as? Double ?? 10.0,
+            useFusedMotionSensors: config["useFusedMotionSensors"] as? Bool ?? false
         )
         behaviorSDK?.updateConfig(behaviorConfig)
     }
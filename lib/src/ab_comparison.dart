@@ -0,0 +1,246 @@
+import 'dart:math';
+
+/// One measured run of a benchmark workload, as metric name to value (for
+/// example `ns_per_op`, `allocs_per_op`, `ipc`).
+typedef BenchmarkRun = Future<Map<String, double>> Function();
+
+/// Outcome of an A/B comparison, from the candidate's point of view.
+enum AbVerdict { faster, slower, inconclusive }
+
+/// Baseline vs candidate for one metric.
+class MetricComparison {
+  final String metric;
+  final double baselineMedian;
+  final double candidateMedian;
+
+  /// Candidate median over baseline median.
+  final double ratio;
+
+  /// Bootstrap confidence interval of [ratio].
+  final double ciLow;
+  final double ciHigh;
+
+  final AbVerdict verdict;
+
+  const MetricComparison({
+    required this.metric,
+    required this.baselineMedian,
+    required this.candidateMedian,
+    required this.ratio,
+    required this.ciLow,
+    required this.ciHigh,
+    required this.verdict,
+  });
+
+  Map<String, dynamic> toJson() => {
+        'metric': metric,
+        'baseline_median': baselineMedian,
+        'candidate_median': candidateMedian,
+        'ratio': ratio,
+        'ci_low': ciLow,
+        'ci_high': ciHigh,
+        'verdict': verdict.name,
+      };
+}
+
+/// A/B result for one benchmark.
+class BenchmarkComparison {
+  final String name;
+
+  /// Runs per side.
+  final int repetitions;
+
+  final Map<String, MetricComparison> metrics;
+
+  /// Verdict of the primary metric.
+  final AbVerdict verdict;
+
+  const BenchmarkComparison({
+    required this.name,
+    required this.repetitions,
+    required this.metrics,
+    required this.verdict,
+  });
+
+  Map<String, dynamic> toJson() => {
+        'name': name,
+        'repetitions': repetitions,
+        'verdict': verdict.name,
+        'metrics': metrics.map((key, value) => MapEntry(key, value.toJson())),
+      };
+}
+
+/// Statistical A/B comparison of two builds or configurations over the same
+/// workload.
+///
+/// [run] interleaves the two sides (A B, B A, A B, ...) so drift on a shared
+/// machine (thermal state, background load) hits both equally. Each metric
+/// gets a percentile bootstrap confidence interval on the ratio of medians.
+/// A change counts only when the whole interval lies beyond
+/// [noiseThreshold]; otherwise the verdict is inconclusive.
+///
+/// Metrics are lower-is-better except those in `higherIsBetter` (IPC by
+/// default).
+class AbComparator {
+  /// Runs per side.
+  final int repetitions;
+
+  /// Warm-up runs per side, discarded.
+  final int warmup;
+
+  /// Bootstrap resamples.
+  final int resamples;
+
+  /// Confidence level of the interval.
+  final double confidence;
+
+  /// Relative change below which a difference is treated as noise.
+  final double noiseThreshold;
+
+  /// Seed for the bootstrap, so a verdict is reproducible from the samples.
+  final int seed;
+
+  const AbComparator({
+    this.repetitions = 15,
+    this.warmup = 2,
+    this.resamples = 2000,
+    this.confidence = 0.95,
+    this.noiseThreshold = 0.02,
+    this.seed = 42,
+  });
+
+  /// Run [baseline] and [candidate] interleaved and compare their metrics.
+  Future<BenchmarkComparison> run(
+    String name,
+    BenchmarkRun baseline,
+    BenchmarkRun candidate, {
+    String primaryMetric = 'ns_per_op',
+    Set<String> higherIsBetter = const {'ipc'},
+  }) async {
+    for (var i = 0; i < warmup; i++) {
+      await baseline();
+      await candidate();
+    }
+
+    final baselineRuns = <Map<String, double>>[];
+    final candidateRuns = <Map<String, double>>[];
+    for (var i = 0; i < repetitions; i++) {
+      if (i.isEven) {
+        baselineRuns.add(await baseline());
+        candidateRuns.add(await candidate());
+      } else {
+        candidateRuns.add(await candidate());
+        baselineRuns.add(await baseline());
+      }
+    }
+
+    return compare(
+      name,
+      baselineRuns,
+      candidateRuns,
+      primaryMetric: primaryMetric,
+      higherIsBetter: higherIsBetter,
+    );
+  }
+
+  /// Compare runs that were already measured. Metrics missing from either
+  /// side are skipped.
+  BenchmarkComparison compare(
+    String name,
+    List<Map<String, double>> baselineRuns,
+    List<Map<String, double>> candidateRuns, {
+    String primaryMetric = 'ns_per_op',
+    Set<String> higherIsBetter = const {'ipc'},
+  }) {
+    final random = Random(seed);
+    final metricNames = <String>{
+      for (final run in baselineRuns) ...run.keys,
+    };
+
+    final metrics = <String, MetricComparison>{};
+    for (final metric in metricNames) {
+      final a = _values(baselineRuns, metric);
+      final b = _values(candidateRuns, metric);
+      if (a.isEmpty || b.isEmpty) continue;
+      metrics[metric] = _compareMetric(
+        metric,
+        a,
+        b,
+        random,
+        higherIsBetter.contains(metric),
+      );
+    }
+
+    return BenchmarkComparison(
+      name: name,
+      repetitions: min(baselineRuns.length, candidateRuns.length),
+      metrics: metrics,
+      verdict: metrics[primaryMetric]?.verdict ?? AbVerdict.inconclusive,
+    );
+  }
+
+  MetricComparison _compareMetric(
+    String metric,
+    List<double> a,
+    List<double> b,
+    Random random,
+    bool higherIsBetter,
+  ) {
+    final baselineMedian = _median(a);
+    final candidateMedian = _median(b);
+    final ratio = _ratio(candidateMedian, baselineMedian);
+
+    final ratios = List<double>.generate(resamples, (_) {
+      final resampledA = _resample(a, random);
+      final resampledB = _resample(b, random);
+      return _ratio(_median(resampledB), _median(resampledA));
+    })
+      ..sort();
+    final tail = (1 - confidence) / 2;
+    final ciLow = ratios[(tail * (resamples - 1)).round()];
+    final ciHigh = ratios[((1 - tail) * (resamples - 1)).round()];
+
+    var verdict = AbVerdict.inconclusive;
+    if (ciHigh < 1 - noiseThreshold) {
+      verdict = higherIsBetter ? AbVerdict.slower : AbVerdict.faster;
+    } else if (ciLow > 1 + noiseThreshold) {
+      verdict = higherIsBetter ? AbVerdict.faster : AbVerdict.slower;
+    }
+
+    return MetricComparison(
+      metric: metric,
+      baselineMedian: baselineMedian,
+      candidateMedian: candidateMedian,
+      ratio: ratio,
+      ciLow: ciLow,
+      ciHigh: ciHigh,
+      verdict: verdict,
+    );
+  }
+
+  static List<double> _values(List<Map<String, double>> runs, String metric) =>
+      [
+        for (final run in runs)
+          if (run[metric] != null) run[metric]!,
+      ];
+
+  static List<double> _resample(List<double> values, Random random) =>
+      List<double>.generate(
+        values.length,
+        (_) => values[random.nextInt(values.length)],
+      );
+
+  static double _median(List<double> values) {
+    final sorted = List<double>.from(values)..sort();
+    final middle = sorted.length ~/ 2;
+    return sorted.length.isOdd
+        ? sorted[middle]
+        : (sorted[middle - 1] + sorted[middle]) / 2;
+  }
+
+  // Two zero medians (e.g. no allocations on either side) are equal
+  static double _ratio(double candidate, double baseline) {
+    if (baseline == 0) return candidate == 0 ? 1.0 : double.infinity;
+    return candidate / baseline;
+  }
+}
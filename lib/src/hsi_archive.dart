@@ -0,0 +1,583 @@
+import 'dart:convert';
+import 'dart:io' show GZipCodec;
+import 'dart:math' show pow;
+import 'dart:typed_data';
+
+/// One axis score read by [HsiArchive.scanAxis].
+class HsiAxisSample {
+  /// Index of the document in the archive.
+  final int document;
+
+  final double score;
+
+  const HsiAxisSample(this.document, this.score);
+}
+
+/// Compact binary archive of HSI documents, as returned by Flux
+/// (`behaviorToHsi`, `processSession`), for apps that keep results as
+/// history.
+///
+/// The encoding is lossless: [decode] returns the same JSON values, with
+/// ints and doubles, key order and timestamp strings preserved.
+/// - Object keys and strings share one dictionary for the whole archive.
+/// - ISO 8601 UTC timestamps are stored as varint deltas in microseconds,
+///   with their exact formatting.
+/// - Axis reading scores (`{"axis": ..., "score": <double>}`) are stored in
+///   one float column per axis, outside the documents.
+///
+/// Because scores live in per-axis columns, [scanAxis] reads a single metric
+/// across every document without decoding any of them.
+class HsiArchive {
+  static const List<int> _magic = [0x48, 0x53, 0x49, 0x41]; // "HSIA"
+  static const int _version = 1;
+
+  // Value tags
+  static const int _tNull = 0;
+  static const int _tFalse = 1;
+  static const int _tTrue = 2;
+  static const int _tInt = 3;
+  static const int _tDouble = 4;
+  static const int _tString = 5;
+  static const int _tTimestamp = 6;
+  static const int _tList = 7;
+  static const int _tObject = 8;
+  static const int _tScore = 9; // Next value of an axis column
+
+  // Column value encodings
+  static const int _float64 = 0;
+  static const int _scaled = 1; // Zigzag varint of value * 10^scale
+
+  static const int _maxScale = 9;
+  static final RegExp _timestampPattern = RegExp(
+    r'^(\d{4})-(\d{2})-(\d{2})T(\d{2}):(\d{2}):(\d{2})(?:\.(\d{1,9}))?'
+    r'(Z|\+00:00)$',
+  );
+
+  HsiArchive._();
+
+  /// Encode parsed HSI documents.
+  static Uint8List encode(List<Map<String, dynamic>> documents) {
+    final encoder = _Encoder();
+    for (var i = 0; i < documents.length; i++) {
+      encoder.document = i;
+      encoder.value(documents[i]);
+    }
+    return encoder.finish(documents.length);
+  }
+
+  /// Encode HSI JSON strings.
+  static Uint8List encodeJson(Iterable<String> hsiJson) => encode([
+        for (final json in hsiJson) jsonDecode(json) as Map<String, dynamic>,
+      ]);
+
+  /// Decode every document of an archive.
+  static List<Map<String, dynamic>> decode(Uint8List archive) {
+    final header = _Header.read(archive);
+    final columns = <int, _ColumnCursor>{};
+    var offset = header.columnsOffset;
+    for (final entry in header.columns) {
+      columns[entry.axisId] =
+          _ColumnCursor(_readColumn(archive, offset).map((s) => s.score));
+      offset += entry.byteLength;
+    }
+
+    final reader = _Reader(archive, offset);
+    final treeEnd = reader.varint() + reader.offset;
+    final decoder = _Decoder(reader, header.strings, columns);
+    final documents = <Map<String, dynamic>>[
+      for (var i = 0; i < header.documents; i++)
+        decoder.value() as Map<String, dynamic>,
+    ];
+    if (reader.offset != treeEnd) {
+      throw const FormatException('Trailing bytes in HSI archive');
+    }
+    return documents;
+  }
+
+  /// Names of the axes with a score column.
+  static List<String> axes(Uint8List archive) {
+    final header = _Header.read(archive);
+    return [for (final entry in header.columns) header.strings[entry.axisId]];
+  }
+
+  /// Every score of [axis], in document order. Only the archive header and
+  /// that axis column are read.
+  static List<HsiAxisSample> scanAxis(Uint8List archive, String axis) {
+    final header = _Header.read(archive);
+    var offset = header.columnsOffset;
+    for (final entry in header.columns) {
+      if (header.strings[entry.axisId] == axis) {
+        return _readColumn(archive, offset);
+      }
+      offset += entry.byteLength;
+    }
+    return const [];
+  }
+
+  /// Archive size and single-axis scan time against gzip'd JSON, which has
+  /// to be inflated and parsed to read one axis. Times are the best of
+  /// [iterations] runs, in microseconds.
+  static Map<String, dynamic> benchmark(
+    List<String> hsiJson, {
+    String axis = 'focus',
+    int iterations = 20,
+  }) {
+    final json = utf8.encode('[${hsiJson.join(',')}]');
+    final gzipped = GZipCodec().encode(json);
+    final archive = encodeJson(hsiJson);
+
+    int best(void Function() run) {
+      var bestUs = 1 << 62;
+      final stopwatch = Stopwatch();
+      for (var i = 0; i < iterations; i++) {
+        stopwatch
+          ..reset()
+          ..start();
+        run();
+        stopwatch.stop();
+        if (stopwatch.elapsedMicroseconds < bestUs) {
+          bestUs = stopwatch.elapsedMicroseconds;
+        }
+      }
+      return bestUs;
+    }
+
+    return {
+      'documents': hsiJson.length,
+      'json_bytes': json.length,
+      'gzip_bytes': gzipped.length,
+      'archive_bytes': archive.length,
+      'gzip_scan_us': best(() => _scanJson(gzipped, axis)),
+      'archive_scan_us': best(() => scanAxis(archive, axis)),
+    };
+  }
+
+  static List<HsiAxisSample> _scanJson(List<int> gzipped, String axis) {
+    final documents = jsonDecode(utf8.decode(GZipCodec().decode(gzipped)));
+    final samples = <HsiAxisSample>[];
+    for (var i = 0; i < (documents as List).length; i++) {
+      final axes = (documents[i] as Map)['axes'];
+      if (axes is! Map) continue;
+      for (final domain in axes.values) {
+        final readings = domain is Map ? domain['readings'] : null;
+        if (readings is! List) continue;
+        for (final reading in readings) {
+          if (reading is Map && reading['axis'] == axis) {
+            final score = reading['score'];
+            if (score is double) samples.add(HsiAxisSample(i, score));
+          }
+        }
+      }
+    }
+    return samples;
+  }
+
+  static List<HsiAxisSample> _readColumn(Uint8List archive, int offset) {
+    final reader = _Reader(archive, offset);
+    final count = reader.varint();
+    final documents = List<int>.filled(count, 0);
+    var document = 0;
+    for (var i = 0; i < count; i++) {
+      document += reader.varint();
+      documents[i] = document;
+    }
+    final mode = reader.byte();
+    if (mode == _float64) {
+      return [
+        for (var i = 0; i < count; i++)
+          HsiAxisSample(documents[i], reader.float64()),
+      ];
+    }
+    if (mode != _scaled) {
+      throw const FormatException('Unknown HSI archive column encoding');
+    }
+    final divisor = _powersOf10[reader.varint()];
+    return [
+      for (var i = 0; i < count; i++)
+        HsiAxisSample(documents[i], reader.zigzag() / divisor),
+    ];
+  }
+
+  static final List<double> _powersOf10 = List<double>.generate(
+    _maxScale + 1,
+    (scale) => pow(10, scale).toDouble(),
+  );
+
+  /// Microseconds since the epoch and format byte (fraction digits, plus 16
+  /// for a `+00:00` suffix) of a timestamp that re-formats to exactly [text],
+  /// or null.
+  static (int, int)? _parseTimestamp(String text) {
+    if (text.length < 20 || text.length > 35) return null;
+    final match = _timestampPattern.firstMatch(text);
+    if (match == null) return null;
+    final fraction = match.group(7) ?? '';
+    final micros = DateTime.utc(
+          int.parse(match.group(1)!),
+          int.parse(match.group(2)!),
+          int.parse(match.group(3)!),
+          int.parse(match.group(4)!),
+          int.parse(match.group(5)!),
+          int.parse(match.group(6)!),
+        ).microsecondsSinceEpoch +
+        (fraction.isEmpty
+            ? 0
+            : int.parse(fraction.padRight(9, '0').substring(0, 6)));
+    final format = fraction.length | (match.group(8) == 'Z' ? 0 : 16);
+    return _formatTimestamp(micros, format) == text ? (micros, format) : null;
+  }
+
+  static String _formatTimestamp(int micros, int format) {
+    final time = DateTime.fromMicrosecondsSinceEpoch(micros, isUtc: true);
+    String two(int n) => n.toString().padLeft(2, '0');
+    final digits = format & 15;
+    final buffer = StringBuffer()
+      ..write(time.year.toString().padLeft(4, '0'))
+      ..write('-${two(time.month)}-${two(time.day)}')
+      ..write('T${two(time.hour)}:${two(time.minute)}:${two(time.second)}');
+    if (digits > 0) {
+      final fraction = (micros % 1000000).toString().padLeft(6, '0');
+      buffer
+        ..write('.')
+        ..write(digits <= 6
+            ? fraction.substring(0, digits)
+            : fraction.padRight(digits, '0'));
+    }
+    buffer.write(format & 16 != 0 ? '+00:00' : 'Z');
+    return buffer.toString();
+  }
+}
+
+class _ColumnEntry {
+  final int axisId;
+  final int byteLength;
+
+  const _ColumnEntry(this.axisId, this.byteLength);
+}
+
+/// String dictionary and column directory at the start of an archive.
+class _Header {
+  final List<String> strings;
+  final int documents;
+  final List<_ColumnEntry> columns;
+  final int columnsOffset;
+
+  _Header(this.strings, this.documents, this.columns, this.columnsOffset);
+
+  factory _Header.read(Uint8List archive) {
+    final reader = _Reader(archive, 0);
+    for (final byte in HsiArchive._magic) {
+      if (reader.byte() != byte) {
+        throw const FormatException('Not an HSI archive');
+      }
+    }
+    if (reader.varint() != HsiArchive._version) {
+      throw const FormatException('Unsupported HSI archive version');
+    }
+    final strings = [
+      for (var i = reader.varint(); i > 0; i--) reader.string(),
+    ];
+    final documents = reader.varint();
+    final columns = [
+      for (var i = reader.varint(); i > 0; i--)
+        _ColumnEntry(reader.varint(), reader.varint()),
+    ];
+    return _Header(strings, documents, columns, reader.offset);
+  }
+}
+
+class _ColumnCursor {
+  final List<double> values;
+  int next = 0;
+
+  _ColumnCursor(Iterable<double> values) : values = values.toList();
+}
+
+class _Column {
+  final List<int> documents = [];
+  final List<double> values = [];
+
+  void encode(_Writer out) {
+    out.varint(documents.length);
+    var previous = 0;
+    for (final document in documents) {
+      out.varint(document - previous);
+      previous = document;
+    }
+    final scale = _decimalScale();
+    if (scale == null) {
+      out.byte(HsiArchive._float64);
+      for (final value in values) {
+        out.float64(value);
+      }
+    } else {
+      out
+        ..byte(HsiArchive._scaled)
+        ..varint(scale);
+      final multiplier = HsiArchive._powersOf10[scale];
+      for (final value in values) {
+        out.zigzag((value * multiplier).round());
+      }
+    }
+  }
+
+  /// Smallest decimal scale at which every value round-trips exactly, or
+  /// null. Scores rounded to a few decimals then take a byte or two each.
+  int? _decimalScale() {
+    for (var scale = 0; scale <= HsiArchive._maxScale; scale++) {
+      final multiplier = HsiArchive._powersOf10[scale];
+      var exact = true;
+      for (final value in values) {
+        final scaled = value * multiplier;
+        if (value == 0 && value.isNegative || // -0.0 would come back as 0.0
+            !scaled.isFinite ||
+            scaled.abs() > 1e15 ||
+            scaled.round() / multiplier != value) {
+          exact = false;
+          break;
+        }
+      }
+      if (exact) return scale;
+    }
+    return null;
+  }
+}
+
+class _Encoder {
+  final _Writer tree = _Writer();
+  final Map<String, int> strings = {};
+  final Map<int, _Column> columns = {};
+  int document = 0;
+  int lastMicros = 0;
+
+  int intern(String value) =>
+      strings.putIfAbsent(value, () => strings.length);
+
+  void value(Object? value) {
+    if (value == null) {
+      tree.byte(HsiArchive._tNull);
+    } else if (value is bool) {
+      tree.byte(value ? HsiArchive._tTrue : HsiArchive._tFalse);
+    } else if (value is int) {
+      tree
+        ..byte(HsiArchive._tInt)
+        ..zigzag(value);
+    } else if (value is double) {
+      tree
+        ..byte(HsiArchive._tDouble)
+        ..float64(value);
+    } else if (value is String) {
+      final timestamp = HsiArchive._parseTimestamp(value);
+      if (timestamp == null) {
+        tree
+          ..byte(HsiArchive._tString)
+          ..varint(intern(value));
+      } else {
+        final (micros, format) = timestamp;
+        tree
+          ..byte(HsiArchive._tTimestamp)
+          ..zigzag(micros - lastMicros)
+          ..byte(format);
+        lastMicros = micros;
+      }
+    } else if (value is List) {
+      tree
+        ..byte(HsiArchive._tList)
+        ..varint(value.length);
+      for (final item in value) {
+        this.value(item);
+      }
+    } else if (value is Map) {
+      final axis = value['axis'];
+      final score = value['score'];
+      final axisId = axis is String && score is double ? intern(axis) : null;
+      tree
+        ..byte(HsiArchive._tObject)
+        ..varint(value.length);
+      for (final entry in value.entries) {
+        tree.varint(intern(entry.key as String));
+        if (axisId != null && entry.key == 'score') {
+          tree
+            ..byte(HsiArchive._tScore)
+            ..varint(axisId);
+          final column = columns.putIfAbsent(axisId, _Column.new);
+          column.documents.add(document);
+          column.values.add(score as double);
+        } else {
+          this.value(entry.value);
+        }
+      }
+    } else {
+      throw ArgumentError.value(value, 'value', 'Not a JSON value');
+    }
+  }
+
+  static Uint8List _encodeColumn(_Column column) {
+    final writer = _Writer();
+    column.encode(writer);
+    return writer.bytes();
+  }
+
+  Uint8List finish(int documents) {
+    final out = _Writer();
+    for (final byte in HsiArchive._magic) {
+      out.byte(byte);
+    }
+    out
+      ..varint(HsiArchive._version)
+      ..varint(strings.length);
+    for (final string in strings.keys) {
+      out.string(string);
+    }
+    out.varint(documents);
+
+    final encodedColumns = <int, Uint8List>{
+      for (final entry in columns.entries)
+        entry.key: _encodeColumn(entry.value),
+    };
+    out.varint(encodedColumns.length);
+    for (final entry in encodedColumns.entries) {
+      out
+        ..varint(entry.key)
+        ..varint(entry.value.length);
+    }
+    for (final column in encodedColumns.values) {
+      out.bytesOf(column);
+    }
+
+    final treeBytes = tree.bytes();
+    out
+      ..varint(treeBytes.length)
+      ..bytesOf(treeBytes);
+    return out.bytes();
+  }
+}
+
+class _Decoder {
+  final _Reader reader;
+  final List<String> strings;
+  final Map<int, _ColumnCursor> columns;
+  int lastMicros = 0;
+
+  _Decoder(this.reader, this.strings, this.columns);
+
+  Object? value() {
+    switch (reader.byte()) {
+      case HsiArchive._tNull:
+        return null;
+      case HsiArchive._tFalse:
+        return false;
+      case HsiArchive._tTrue:
+        return true;
+      case HsiArchive._tInt:
+        return reader.zigzag();
+      case HsiArchive._tDouble:
+        return reader.float64();
+      case HsiArchive._tString:
+        return strings[reader.varint()];
+      case HsiArchive._tTimestamp:
+        lastMicros += reader.zigzag();
+        return HsiArchive._formatTimestamp(lastMicros, reader.byte());
+      case HsiArchive._tList:
+        return [for (var i = reader.varint(); i > 0; i--) value()];
+      case HsiArchive._tObject:
+        final map = <String, dynamic>{};
+        for (var i = reader.varint(); i > 0; i--) {
+          final key = strings[reader.varint()];
+          map[key] = value();
+        }
+        return map;
+      case HsiArchive._tScore:
+        final column = columns[reader.varint()];
+        if (column == null || column.next >= column.values.length) {
+          throw const FormatException('HSI archive column overrun');
+        }
+        return column.values[column.next++];
+      default:
+        throw const FormatException('Unknown HSI archive value tag');
+    }
+  }
+}
+
+class _Writer {
+  final BytesBuilder _builder = BytesBuilder(copy: false);
+  final ByteData _scratch = ByteData(8);
+
+  void byte(int value) => _builder.addByte(value);
+
+  void bytesOf(List<int> bytes) => _builder.add(bytes);
+
+  /// Unsigned LEB128 of the 64-bit pattern of [value].
+  void varint(int value) {
+    var v = value;
+    while (v & ~0x7f != 0) {
+      _builder.addByte((v & 0x7f) | 0x80);
+      v = v >>> 7;
+    }
+    _builder.addByte(v);
+  }
+
+  void zigzag(int value) => varint((value << 1) ^ (value >> 63));
+
+  void float64(double value) {
+    _scratch.setFloat64(0, value, Endian.little);
+    _builder.add(_scratch.buffer.asUint8List(0, 8).toList());
+  }
+
+  void string(String value) {
+    final bytes = utf8.encode(value);
+    varint(bytes.length);
+    _builder.add(bytes);
+  }
+
+  Uint8List bytes() => _builder.toBytes();
+}
+
+class _Reader {
+  final Uint8List _bytes;
+  final ByteData _data;
+  int offset;
+
+  _Reader(this._bytes, this.offset)
+      : _data = ByteData.sublistView(_bytes);
+
+  int byte() {
+    if (offset >= _bytes.length) {
+      throw const FormatException('Truncated HSI archive');
+    }
+    return _bytes[offset++];
+  }
+
+  int varint() {
+    var result = 0;
+    for (var shift = 0; shift < 64; shift += 7) {
+      final b = byte();
+      result |= (b & 0x7f) << shift;
+      if (b & 0x80 == 0) return result;
+    }
+    throw const FormatException('Invalid varint in HSI archive');
+  }
+
+  int zigzag() {
+    final v = varint();
+    return (v >>> 1) ^ -(v & 1);
+  }
+
+  double float64() {
+    if (offset + 8 > _bytes.length) {
+      throw const FormatException('Truncated HSI archive');
+    }
+    final value = _data.getFloat64(offset, Endian.little);
+    offset += 8;
+    return value;
+  }
+
+  String string() {
+    final length = varint();
+    if (length < 0 || offset + length > _bytes.length) {
+      throw const FormatException('Truncated HSI archive');
+    }
+    final value = utf8.decode(_bytes.sublist(offset, offset + length));
+    offset += length;
+    return value;
+  }
+}
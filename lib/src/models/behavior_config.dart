@@ -1,3 +1,5 @@
+import 'energy_report.dart' show PowerTable;
+
 /// Configuration for initializing the Synheart Behavioral SDK.
 class BehaviorConfig {
   /// Enable input interaction signals (keystroke timing, scroll dynamics, gestures).
@@ -36,6 +38,59 @@ class BehaviorConfig {
   /// Default: true
   final bool consentBehavior;
 
+  /// Cadence in seconds for live session snapshots delivered on
+  /// `SynheartBehavior.onSnapshot`. 0 disables live snapshots.
+  /// Default: 0
+  final int liveSnapshotIntervalSeconds;
+
+  /// Use the platform's fused gravity and linear-acceleration sensors
+  /// (Android TYPE_GRAVITY / TYPE_LINEAR_ACCELERATION, iOS CMDeviceMotion) for
+  /// motion features instead of filtering gravity out in software. Falls back
+  /// to software separation when the fused sensors are unavailable.
+  /// Default: false
+  final bool useFusedMotionSensors;
+
+  /// Confidence (0-1) at which the native stage 1 motion classifier decides a
+  /// window on its own. Such windows skip the 561-feature extraction and the
+  /// SVC model; the rest fall through to the full model. Only clearly moving
+  /// windows and a still, flat phone (laying) can exit early. 0 disables the
+  /// cascade. Android only.
+  /// Default: 0.0
+  final double motionCascadeThreshold;
+
+  /// Days of cross-session hourly/daily rollups to keep for
+  /// `SynheartBehavior.getTrends`. Only aggregates are kept, saved in
+  /// app-private storage (encrypted with [encryptSessionCheckpoints]), and
+  /// hourly detail is limited to the last 35 days. 0 disables the rollup
+  /// store; the maximum is 366. Android only.
+  /// Default: 0
+  final int rollupRetentionDays;
+
+  /// Checkpoint active sessions to app-private storage so they survive the
+  /// process being killed in the background. Restored sessions are listed in
+  /// `SynheartBehavior.restoredSessions` after `initialize`. Checkpoints are
+  /// deleted when the session ends. Android only.
+  /// Default: false
+  final bool enableSessionCheckpoints;
+
+  /// Encrypt session checkpoints at rest with AES-GCM. The key comes from
+  /// the host app through `SynheartBehaviorPlugin.checkpointKeyProvider`;
+  /// without one, checkpoints are not written at all. Android only.
+  /// Default: false
+  final bool encryptSessionCheckpoints;
+
+  /// Core cluster, sensor and battery figures for the per-stage energy
+  /// estimates of `SynheartBehavior.getEnergyReport`. Android only.
+  /// Default: PowerTable()
+  final PowerTable powerTable;
+
+  /// Emit tap, scroll and swipe events from the native window touch hook.
+  /// Leave off when gestures are wrapped in `BehaviorGestureDetector`, which
+  /// already reports them; enabling both counts every gesture twice. Android
+  /// only.
+  /// Default: false
+  final bool nativeGestureEvents;
+
   const BehaviorConfig({
     this.enableInputSignals = true,
     this.enableAttentionSignals = true,
@@ -47,6 +102,14 @@ class BehaviorConfig {
     this.deviceId,
     this.behaviorVersion = '1.0.0',
     this.consentBehavior = true,
+    this.liveSnapshotIntervalSeconds = 0,
+    this.useFusedMotionSensors = false,
+    this.motionCascadeThreshold = 0.0,
+    this.rollupRetentionDays = 0,
+    this.enableSessionCheckpoints = false,
+    this.encryptSessionCheckpoints = false,
+    this.powerTable = const PowerTable(),
+    this.nativeGestureEvents = false,
   });
 
   Map<String, dynamic> toJson() => {
@@ -60,5 +123,13 @@ class BehaviorConfig {
         'deviceId': deviceId,
         'behaviorVersion': behaviorVersion,
         'consentBehavior': consentBehavior,
+        'liveSnapshotIntervalSeconds': liveSnapshotIntervalSeconds,
+        'useFusedMotionSensors': useFusedMotionSensors,
+        'motionCascadeThreshold': motionCascadeThreshold,
+        'rollupRetentionDays': rollupRetentionDays,
+        'enableSessionCheckpoints': enableSessionCheckpoints,
+        'encryptSessionCheckpoints': encryptSessionCheckpoints,
+        'powerTable': powerTable.toJson(),
+        'nativeGestureEvents': nativeGestureEvents,
       };
 }
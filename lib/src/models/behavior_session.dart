@@ -71,14 +71,26 @@ class MotionDataPoint {
   /// Feature names match the format from features.txt (e.g., "tBodyAcc-mean()-X")
   final Map<String, double> features;
 
+  /// Label decided by the native stage 1 classifier (e.g. "MOVING"), or null
+  /// when the window went through full feature extraction. Early-exit windows
+  /// carry no features.
+  final String? cascadeState;
+
+  /// Stage 1 confidence in [0, 1] for [cascadeState].
+  final double? cascadeConfidence;
+
   MotionDataPoint({
     required this.timestamp,
     required this.features,
+    this.cascadeState,
+    this.cascadeConfidence,
   });
 
   Map<String, dynamic> toJson() => {
         'timestamp': timestamp,
         'features': features,
+        if (cascadeState != null) 'cascade_state': cascadeState,
+        if (cascadeConfidence != null) 'cascade_confidence': cascadeConfidence,
       };
 
   factory MotionDataPoint.fromJson(Map<String, dynamic> json) {
@@ -94,6 +106,8 @@ class MotionDataPoint {
               ),
             )
           : {},
+      cascadeState: json['cascade_state'] as String?,
+      cascadeConfidence: (json['cascade_confidence'] as num?)?.toDouble(),
     );
   }
 }
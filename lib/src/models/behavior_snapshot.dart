@@ -0,0 +1,91 @@
+import 'behavior_config.dart' show BehaviorConfig;
+import 'behavior_session.dart' show BehavioralMetrics;
+
+/// Live snapshot of an in-progress session, emitted at the cadence set by
+/// [BehaviorConfig.liveSnapshotIntervalSeconds].
+class BehaviorSnapshot {
+  /// Session the snapshot belongs to.
+  final String sessionId;
+
+  /// 1-based index of this snapshot within the session.
+  final int snapshotIndex;
+
+  /// Session start in ISO 8601 format.
+  final String startAt;
+
+  /// Time the snapshot was taken in ISO 8601 format.
+  final String endAt;
+
+  /// Total events in the session so far.
+  final int eventCount;
+
+  /// Events that arrived since the previous snapshot.
+  final int newEventCount;
+
+  /// Behavioral metrics (from Flux/Rust) for the session so far.
+  /// Null when Flux is unavailable on the device.
+  ///
+  /// Flux rescores the whole session, so it runs only once the session has
+  /// grown by a tenth since the last score; in between, the previous metrics
+  /// are repeated. [metricsEventCount] tells which events they cover.
+  final BehavioralMetrics? behavioralMetrics;
+
+  /// Events covered by [behavioralMetrics], at most [eventCount].
+  final int metricsEventCount;
+
+  /// Notification and call counters for the session so far.
+  final Map<String, dynamic> notificationSummary;
+
+  /// Time spent computing this snapshot on the native side.
+  final int computeTimeMs;
+
+  BehaviorSnapshot({
+    required this.sessionId,
+    required this.snapshotIndex,
+    required this.startAt,
+    required this.endAt,
+    required this.eventCount,
+    required this.newEventCount,
+    this.behavioralMetrics,
+    this.metricsEventCount = 0,
+    required this.notificationSummary,
+    required this.computeTimeMs,
+  });
+
+  Map<String, dynamic> toJson() => {
+        'session_id': sessionId,
+        'snapshot_index': snapshotIndex,
+        'start_at': startAt,
+        'end_at': endAt,
+        'event_count': eventCount,
+        'new_event_count': newEventCount,
+        if (behavioralMetrics != null)
+          'behavioral_metrics': behavioralMetrics!.toJson(),
+        if (behavioralMetrics != null) 'metrics_event_count': metricsEventCount,
+        'notification_summary': notificationSummary,
+        'performance_info': {'snapshot_compute_time_ms': computeTimeMs},
+      };
+
+  factory BehaviorSnapshot.fromJson(Map<String, dynamic> json) {
+    final performanceInfo = json['performance_info'] as Map?;
+    return BehaviorSnapshot(
+      sessionId: json['session_id'] as String,
+      snapshotIndex: (json['snapshot_index'] as num?)?.toInt() ?? 0,
+      startAt: json['start_at'] as String? ?? '',
+      endAt: json['end_at'] as String? ?? '',
+      eventCount: (json['event_count'] as num?)?.toInt() ?? 0,
+      newEventCount: (json['new_event_count'] as num?)?.toInt() ?? 0,
+      behavioralMetrics: json['behavioral_metrics'] != null
+          ? BehavioralMetrics.fromJson(
+              Map<String, dynamic>.from(json['behavioral_metrics'] as Map))
+          : null,
+      metricsEventCount: (json['metrics_event_count'] as num?)?.toInt() ??
+          (json['event_count'] as num?)?.toInt() ??
+          0,
+      notificationSummary: Map<String, dynamic>.from(
+          json['notification_summary'] as Map? ?? {}),
+      computeTimeMs:
+          (performanceInfo?['snapshot_compute_time_ms'] as num?)?.toInt() ?? 0,
+    );
+  }
+}
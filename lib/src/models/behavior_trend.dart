@@ -0,0 +1,87 @@
+import 'behavior_config.dart' show BehaviorConfig;
+
+/// Period covered by each [BehaviorTrendBucket].
+enum TrendGranularity { hour, day, week }
+
+/// Cross-session aggregate for one hour, local day or local week, from the
+/// rollup store enabled by [BehaviorConfig.rollupRetentionDays].
+///
+/// Sessions are counted in the period in which they end. Periods without
+/// sessions are returned with zero counts.
+class BehaviorTrendBucket {
+  /// Start of the period.
+  final DateTime start;
+
+  final int sessionCount;
+  final int totalDurationMs;
+  final int eventCount;
+  final int appSwitchCount;
+  final int notificationCount;
+  final int callCount;
+  final int clipboardCount;
+  final int deepFocusBlocks;
+
+  /// Sessions that ended with Flux scores; the averages below are over these.
+  final int scoredSessionCount;
+
+  /// Averages of the Flux scores over [scoredSessionCount] sessions (0 when
+  /// none were scored).
+  final double focusHint;
+  final double behavioralDistractionScore;
+  final double interactionIntensity;
+
+  BehaviorTrendBucket({
+    required this.start,
+    required this.sessionCount,
+    required this.totalDurationMs,
+    required this.eventCount,
+    required this.appSwitchCount,
+    required this.notificationCount,
+    required this.callCount,
+    required this.clipboardCount,
+    required this.deepFocusBlocks,
+    this.scoredSessionCount = 0,
+    required this.focusHint,
+    required this.behavioralDistractionScore,
+    required this.interactionIntensity,
+  });
+
+  factory BehaviorTrendBucket.fromJson(Map<String, dynamic> json) {
+    int count(String key) => (json[key] as num?)?.toInt() ?? 0;
+    double score(String key) => (json[key] as num?)?.toDouble() ?? 0.0;
+
+    return BehaviorTrendBucket(
+      start: DateTime.fromMillisecondsSinceEpoch(
+        (json['bucket_start_ms'] as num).toInt(),
+      ),
+      sessionCount: count('session_count'),
+      totalDurationMs: count('total_duration_ms'),
+      eventCount: count('event_count'),
+      appSwitchCount: count('app_switch_count'),
+      notificationCount: count('notification_count'),
+      callCount: count('call_count'),
+      clipboardCount: count('clipboard_count'),
+      deepFocusBlocks: count('deep_focus_blocks'),
+      scoredSessionCount: count('scored_session_count'),
+      focusHint: score('focus_hint'),
+      behavioralDistractionScore: score('behavioral_distraction_score'),
+      interactionIntensity: score('interaction_intensity'),
+    );
+  }
+
+  Map<String, dynamic> toJson() => {
+        'bucket_start_ms': start.millisecondsSinceEpoch,
+        'session_count': sessionCount,
+        'total_duration_ms': totalDurationMs,
+        'event_count': eventCount,
+        'app_switch_count': appSwitchCount,
+        'notification_count': notificationCount,
+        'call_count': callCount,
+        'clipboard_count': clipboardCount,
+        'deep_focus_blocks': deepFocusBlocks,
+        'scored_session_count': scoredSessionCount,
+        'focus_hint': focusHint,
+        'behavioral_distraction_score': behavioralDistractionScore,
+        'interaction_intensity': interactionIntensity,
+      };
+}
@@ -0,0 +1,123 @@
+/// Power figures used to turn the SDK's CPU time into battery charge
+/// (Android).
+///
+/// Defaults are typical for a mid-range big.LITTLE phone. For real estimates,
+/// calibrate them per device from its `power_profile.xml`.
+class PowerTable {
+  /// Active power of one little (efficiency) core in milliwatts.
+  /// Default: 120
+  final double littleClusterMw;
+
+  /// Active power of one mid core in milliwatts.
+  /// Default: 400
+  final double midClusterMw;
+
+  /// Active power of one big (performance) core in milliwatts.
+  /// Default: 1000
+  final double bigClusterMw;
+
+  /// Accelerometer plus gyroscope power while motion is collected.
+  /// Default: 0.8
+  final double sensorMw;
+
+  /// Nominal battery voltage.
+  /// Default: 3.85
+  final double batteryVoltage;
+
+  const PowerTable({
+    this.littleClusterMw = 120.0,
+    this.midClusterMw = 400.0,
+    this.bigClusterMw = 1000.0,
+    this.sensorMw = 0.8,
+    this.batteryVoltage = 3.85,
+  });
+
+  Map<String, dynamic> toJson() => {
+        'littleClusterMw': littleClusterMw,
+        'midClusterMw': midClusterMw,
+        'bigClusterMw': bigClusterMw,
+        'sensorMw': sensorMw,
+        'batteryVoltage': batteryVoltage,
+      };
+}
+
+/// CPU time and estimated battery cost of one pipeline stage.
+class StageEnergy {
+  final double cpuMs;
+  final int calls;
+  final double mahPerHour;
+
+  /// Fraction of the SDK's total estimated charge (0 to 1).
+  final double share;
+
+  const StageEnergy({
+    required this.cpuMs,
+    required this.calls,
+    required this.mahPerHour,
+    required this.share,
+  });
+
+  factory StageEnergy.fromJson(Map<String, dynamic> json) {
+    return StageEnergy(
+      cpuMs: (json['cpu_ms'] as num?)?.toDouble() ?? 0.0,
+      calls: (json['calls'] as num?)?.toInt() ?? 0,
+      mahPerHour: (json['mah_per_hour'] as num?)?.toDouble() ?? 0.0,
+      share: (json['share'] as num?)?.toDouble() ?? 0.0,
+    );
+  }
+
+  Map<String, dynamic> toJson() => {
+        'cpu_ms': cpuMs,
+        'calls': calls,
+        'mah_per_hour': mahPerHour,
+        'share': share,
+      };
+}
+
+/// Estimated battery cost of the SDK per pipeline stage (Android).
+///
+/// Stages: `sensor_wakeups`, `event_ingest`, `event_delivery`,
+/// `motion_extraction`, `flux` and `checkpoint`. CPU time is charged per
+/// thread, at the power of the core cluster that thread class is assumed to
+/// run on ([threadCpuMs]), using [BehaviorConfig.powerTable].
+class EnergyReport {
+  /// Wall time the figures cover.
+  final double observedHours;
+
+  final double totalMahPerHour;
+
+  /// Stage with the highest estimated charge, or "none".
+  final String dominantStage;
+
+  final Map<String, StageEnergy> stages;
+
+  /// CPU time per thread class (main, interactive, user_visible, background,
+  /// other).
+  final Map<String, double> threadCpuMs;
+
+  const EnergyReport({
+    required this.observedHours,
+    required this.totalMahPerHour,
+    required this.dominantStage,
+    required this.stages,
+    required this.threadCpuMs,
+  });
+
+  factory EnergyReport.fromJson(Map<String, dynamic> json) {
+    final stages = json['stages'] as Map? ?? const {};
+    final threads = json['threads'] as Map? ?? const {};
+    return EnergyReport(
+      observedHours: (json['observed_hours'] as num?)?.toDouble() ?? 0.0,
+      totalMahPerHour: (json['total_mah_per_hour'] as num?)?.toDouble() ?? 0.0,
+      dominantStage: json['dominant_stage'] as String? ?? 'none',
+      stages: stages.map((key, value) => MapEntry(
+            key.toString(),
+            StageEnergy.fromJson(Map<String, dynamic>.from(value as Map)),
+          )),
+      threadCpuMs: threads.map((key, value) => MapEntry(
+            key.toString(),
+            ((value as Map)['cpu_ms'] as num?)?.toDouble() ?? 0.0,
+          )),
+    );
+  }
+}
@@ -0,0 +1,162 @@
+/// Latency distribution of one hop of the event pipeline, in microseconds.
+///
+/// Quantiles are bucket upper bounds and overstate by at most 25%.
+class HopLatency {
+  final int count;
+  final double avgUs;
+  final int p50Us;
+  final int p95Us;
+  final int p99Us;
+  final double maxUs;
+
+  const HopLatency({
+    required this.count,
+    required this.avgUs,
+    required this.p50Us,
+    required this.p95Us,
+    required this.p99Us,
+    required this.maxUs,
+  });
+
+  factory HopLatency.fromJson(Map<String, dynamic> json) {
+    return HopLatency(
+      count: (json['count'] as num?)?.toInt() ?? 0,
+      avgUs: (json['avg_us'] as num?)?.toDouble() ?? 0.0,
+      p50Us: (json['p50_us'] as num?)?.toInt() ?? 0,
+      p95Us: (json['p95_us'] as num?)?.toInt() ?? 0,
+      p99Us: (json['p99_us'] as num?)?.toInt() ?? 0,
+      maxUs: (json['max_us'] as num?)?.toDouble() ?? 0.0,
+    );
+  }
+
+  Map<String, dynamic> toJson() => {
+        'count': count,
+        'avg_us': avgUs,
+        'p50_us': p50Us,
+        'p95_us': p95Us,
+        'p99_us': p99Us,
+        'max_us': maxUs,
+      };
+}
+
+/// Per-hop event latency against the per-event processing budget (Android).
+///
+/// Native hops, in the order an event passes them: `collector` (capture until
+/// the SDK receives the event), `session_store`, `channel`, `stats` and
+/// `native_total` (capture until every native hop finished). [dartStreamHop]
+/// runs from capture until the event is added to [SynheartBehavior.onEvent].
+class EventLatencyStats {
+  /// Per-event budget in microseconds.
+  final int budgetUs;
+
+  /// Events measured end to end on the native side.
+  final int events;
+
+  /// Events whose native total exceeded [budgetUs].
+  final int budgetViolations;
+
+  final Map<String, HopLatency> hops;
+
+  /// Capture until the Dart event stream (null before the first event).
+  final HopLatency? dartStreamHop;
+
+  /// Events whose capture-to-Dart latency exceeded [budgetUs].
+  final int dartBudgetViolations;
+
+  const EventLatencyStats({
+    required this.budgetUs,
+    required this.events,
+    required this.budgetViolations,
+    required this.hops,
+    this.dartStreamHop,
+    this.dartBudgetViolations = 0,
+  });
+
+  /// Share of native events over budget.
+  double get budgetViolationRate => events > 0 ? budgetViolations / events : 0;
+
+  factory EventLatencyStats.fromJson(Map<String, dynamic> json) {
+    final hops = json['hops'] as Map? ?? const {};
+    final dartHop = json['dart_stream'] as Map?;
+    return EventLatencyStats(
+      budgetUs: (json['budget_us'] as num?)?.toInt() ?? 500,
+      events: (json['events'] as num?)?.toInt() ?? 0,
+      budgetViolations: (json['budget_violations'] as num?)?.toInt() ?? 0,
+      hops: hops.map((key, value) => MapEntry(
+            key.toString(),
+            HopLatency.fromJson(Map<String, dynamic>.from(value as Map)),
+          )),
+      dartStreamHop: dartHop != null
+          ? HopLatency.fromJson(Map<String, dynamic>.from(dartHop))
+          : null,
+      dartBudgetViolations:
+          (json['dart_budget_violations'] as num?)?.toInt() ?? 0,
+    );
+  }
+
+  Map<String, dynamic> toJson() => {
+        'budget_us': budgetUs,
+        'events': events,
+        'budget_violations': budgetViolations,
+        'hops': hops.map((key, value) => MapEntry(key, value.toJson())),
+        if (dartStreamHop != null) 'dart_stream': dartStreamHop!.toJson(),
+        'dart_budget_violations': dartBudgetViolations,
+      };
+}
+
+/// Histogram of microsecond latencies with the native bucket layout: exact
+/// below 4 µs, then four buckets per power of two.
+class LatencyHistogram {
+  static const int _buckets = 128;
+
+  final List<int> _counts = List<int>.filled(_buckets, 0);
+  int _count = 0;
+  int _totalUs = 0;
+  int _maxUs = 0;
+
+  int get count => _count;
+
+  void record(int micros) {
+    if (micros < 0) return; // Clocks disagree; not a measurement
+    _count++;
+    _totalUs += micros;
+    if (micros > _maxUs) _maxUs = micros;
+    _counts[_bucketOf(micros)]++;
+  }
+
+  /// Upper bound (µs) of the bucket holding quantile [q].
+  int quantileUs(double q) {
+    if (_count == 0) return 0;
+    var target = (_count * q).floor();
+    if (target < 1) target = 1;
+    var seen = 0;
+    for (var bucket = 0; bucket < _buckets; bucket++) {
+      seen += _counts[bucket];
+      if (seen >= target) return _upperBoundUs(bucket);
+    }
+    return _upperBoundUs(_buckets - 1);
+  }
+
+  HopLatency toHopLatency() => HopLatency(
+        count: _count,
+        avgUs: _count > 0 ? _totalUs / _count : 0.0,
+        p50Us: quantileUs(0.50),
+        p95Us: quantileUs(0.95),
+        p99Us: quantileUs(0.99),
+        maxUs: _maxUs.toDouble(),
+      );
+
+  static int _bucketOf(int micros) {
+    if (micros < 4) return micros;
+    final msb = micros.bitLength - 1;
+    final sub = (micros >> (msb - 2)) & 3;
+    final bucket = (msb - 1) * 4 + sub;
+    return bucket < _buckets ? bucket : _buckets - 1;
+  }
+
+  static int _upperBoundUs(int bucket) {
+    if (bucket < 4) return bucket + 1;
+    final msb = bucket ~/ 4 + 1;
+    return (5 + bucket % 4) << (msb - 2);
+  }
+}
@@ -0,0 +1,128 @@
+/// Aggregation applied to each group of an [EventQuery].
+enum EventAggregation { count, sum, avg, min, max, quantile }
+
+/// Compares one event metric against a constant.
+///
+/// String values match the metric as a category and support only `==` and
+/// `!=`. Numbers (and booleans, as 1/0) support `==`, `!=`, `<`, `<=`, `>`
+/// and `>=`. Events without the metric never match.
+class EventPredicate {
+  final String field;
+  final String op;
+  final Object value;
+
+  const EventPredicate(this.field, this.op, this.value);
+
+  Map<String, dynamic> toJson() => {
+        'field': field,
+        'op': op,
+        'value': value,
+      };
+}
+
+/// Aggregate query evaluated natively over a session's event store.
+///
+/// Filters by event type, time range and an optional metric predicate, then
+/// groups by time bucket and/or one categorical metric. Only the aggregated
+/// rows cross the platform channel, never the events themselves.
+///
+/// ```dart
+/// // Taps per minute
+/// const EventQuery(eventType: 'tap', bucket: Duration(minutes: 1));
+///
+/// // Notifications by action per hour
+/// const EventQuery(
+///   eventType: 'notification',
+///   bucket: Duration(hours: 1),
+///   groupBy: 'action',
+/// );
+/// ```
+class EventQuery {
+  /// Event type to scan (e.g. "tap"). Null scans every type.
+  final String? eventType;
+
+  /// Inclusive start of the time range in milliseconds since epoch.
+  final int? startMs;
+
+  /// Inclusive end of the time range in milliseconds since epoch.
+  final int? endMs;
+
+  /// Optional metric filter.
+  final EventPredicate? where;
+
+  /// Time bucket width. Null puts the whole range in one bucket.
+  final Duration? bucket;
+
+  /// Categorical metric to group by (e.g. "action").
+  final String? groupBy;
+
+  final EventAggregation aggregation;
+
+  /// Numeric metric to aggregate. Required for every aggregation but count.
+  final String? field;
+
+  /// Quantile in [0, 1] for [EventAggregation.quantile].
+  final double quantile;
+
+  const EventQuery({
+    this.eventType,
+    this.startMs,
+    this.endMs,
+    this.where,
+    this.bucket,
+    this.groupBy,
+    this.aggregation = EventAggregation.count,
+    this.field,
+    this.quantile = 0.5,
+  });
+
+  Map<String, dynamic> toJson() => {
+        'eventType': eventType,
+        'startMs': startMs,
+        'endMs': endMs,
+        if (where != null) 'where': where!.toJson(),
+        'bucketMs': bucket?.inMilliseconds ?? 0,
+        'groupBy': groupBy,
+        'aggregation': aggregation.name,
+        'field': field,
+        'quantile': quantile,
+      };
+}
+
+/// One (time bucket, group) row of an [EventQuery] result.
+class EventAggregateRow {
+  /// Bucket start in milliseconds since epoch, or null without buckets.
+  final int? bucketStartMs;
+
+  /// Group value, or null without groupBy (or for events missing the field).
+  final String? group;
+
+  /// Number of matching events in this row.
+  final int count;
+
+  /// Aggregate value, or null when no matching event has the field.
+  final double? value;
+
+  const EventAggregateRow({
+    this.bucketStartMs,
+    this.group,
+    required this.count,
+    this.value,
+  });
+
+  factory EventAggregateRow.fromJson(Map<String, dynamic> json) {
+    return EventAggregateRow(
+      bucketStartMs: (json['bucket_start_ms'] as num?)?.toInt(),
+      group: json['group'] as String?,
+      count: (json['count'] as num).toInt(),
+      value: (json['value'] as num?)?.toDouble(),
+    );
+  }
+
+  Map<String, dynamic> toJson() => {
+        'bucket_start_ms': bucketStartMs,
+        'group': group,
+        'count': count,
+        'value': value,
+      };
+}
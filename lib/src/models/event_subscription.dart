@@ -0,0 +1,99 @@
+import 'behavior_event.dart';
+import 'event_query.dart' show EventPredicate;
+
+/// Filter for [SynheartBehavior.subscribe], evaluated natively (Android).
+///
+/// Events the filter rejects are dropped before they cross the platform
+/// channel, so they are never encoded or decoded. Checks run in order: event
+/// type, [where], sampling, then the rate limit.
+///
+/// ```dart
+/// // Notifications and typing only
+/// const EventFilter(eventTypes: {'notification', 'typing'});
+///
+/// // At most 2 scroll events per second
+/// const EventFilter(eventTypes: {'scroll'}, maxPerSecond: 2);
+/// ```
+class EventFilter {
+  /// Event types to deliver (e.g. "notification"). Null delivers every type.
+  final Set<String>? eventTypes;
+
+  /// Optional metric filter, with the same rules as [EventQuery.where].
+  final EventPredicate? where;
+
+  /// Deliver every Nth matching event of each type. Default: 1 (all).
+  final int sampleEvery;
+
+  /// Per-type rate limit in events per second. Events over the limit are
+  /// dropped. Default: null (unlimited).
+  final double? maxPerSecond;
+
+  const EventFilter({
+    this.eventTypes,
+    this.where,
+    this.sampleEvery = 1,
+    this.maxPerSecond,
+  });
+
+  Map<String, dynamic> toJson() => {
+        'eventTypes': eventTypes?.toList(),
+        if (where != null) 'where': where!.toJson(),
+        'sampleEvery': sampleEvery,
+        'maxPerSecond': maxPerSecond ?? 0,
+      };
+}
+
+/// Delivery counters of one [EventSubscription].
+class EventSubscriptionStats {
+  /// Events that passed the filter and were sent to Dart.
+  final int delivered;
+
+  /// Events the filter dropped on the native side.
+  final int filtered;
+
+  const EventSubscriptionStats({
+    required this.delivered,
+    required this.filtered,
+  });
+
+  factory EventSubscriptionStats.fromJson(Map<String, dynamic> json) {
+    return EventSubscriptionStats(
+      delivered: (json['delivered'] as num?)?.toInt() ?? 0,
+      filtered: (json['filtered'] as num?)?.toInt() ?? 0,
+    );
+  }
+
+  Map<String, dynamic> toJson() => {
+        'delivered': delivered,
+        'filtered': filtered,
+      };
+}
+
+/// A filtered event stream registered with the native pipeline.
+class EventSubscription {
+  /// Native subscription ID.
+  final int id;
+
+  final EventFilter filter;
+
+  /// Events accepted by [filter].
+  final Stream<BehaviorEvent> events;
+
+  final Future<EventSubscriptionStats> Function(int) _statsCallback;
+  final Future<void> Function(int) _cancelCallback;
+
+  EventSubscription({
+    required this.id,
+    required this.filter,
+    required this.events,
+    required Future<EventSubscriptionStats> Function(int) statsCallback,
+    required Future<void> Function(int) cancelCallback,
+  })  : _statsCallback = statsCallback,
+        _cancelCallback = cancelCallback;
+
+  /// Delivered and filtered counts since this subscription was registered.
+  Future<EventSubscriptionStats> getStats() => _statsCallback(id);
+
+  /// Remove the native filter and close [events].
+  Future<void> cancel() => _cancelCallback(id);
+}
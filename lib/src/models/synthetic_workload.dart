@@ -0,0 +1,279 @@
+/// Poisson scroll bursts with log-normal velocities.
+class ScrollWorkload {
+  final double burstsPerMinute;
+
+  /// Mean scrolls per burst (geometric).
+  final double scrollsPerBurst;
+
+  /// Mean gap between scrolls of a burst in milliseconds (exponential).
+  final double gapMs;
+
+  /// Median scroll velocity in px/s.
+  final double velocityMedian;
+
+  /// Log-space standard deviation of the velocity.
+  final double velocitySigma;
+
+  /// Probability that a scroll reverses direction.
+  final double reversalProbability;
+
+  const ScrollWorkload({
+    this.burstsPerMinute = 4,
+    this.scrollsPerBurst = 5,
+    this.gapMs = 700,
+    this.velocityMedian = 1200,
+    this.velocitySigma = 0.6,
+    this.reversalProbability = 0.15,
+  });
+
+  Map<String, dynamic> toJson() => {
+        'burstsPerMinute': burstsPerMinute,
+        'scrollsPerBurst': scrollsPerBurst,
+        'gapMs': gapMs,
+        'velocityMedian': velocityMedian,
+        'velocitySigma': velocitySigma,
+        'reversalProbability': reversalProbability,
+      };
+}
+
+/// Poisson typing bursts with log-normal inter-key times.
+class TypingWorkload {
+  final double burstsPerMinute;
+
+  /// Mean keystrokes per burst (geometric).
+  final double keysPerBurst;
+
+  /// Median time between keystrokes in milliseconds.
+  final double interKeyMedianMs;
+
+  /// Log-space standard deviation of inter-key times. Larger is burstier.
+  final double interKeySigma;
+
+  const TypingWorkload({
+    this.burstsPerMinute = 2,
+    this.keysPerBurst = 12,
+    this.interKeyMedianMs = 180,
+    this.interKeySigma = 0.5,
+  });
+
+  Map<String, dynamic> toJson() => {
+        'burstsPerMinute': burstsPerMinute,
+        'keysPerBurst': keysPerBurst,
+        'interKeyMedianMs': interKeyMedianMs,
+        'interKeySigma': interKeySigma,
+      };
+}
+
+/// Poisson notification arrivals with storms of a higher rate.
+///
+/// Each notification is later opened (log-normal delay) or reported as
+/// ignored after [ignoredAfterMs].
+class NotificationWorkload {
+  final double perHour;
+  final double stormsPerHour;
+
+  /// Arrival rate during a storm.
+  final double stormPerMinute;
+
+  /// Mean storm length in milliseconds (exponential).
+  final double stormDurationMs;
+
+  final double openProbability;
+  final double openDelayMedianMs;
+  final int ignoredAfterMs;
+
+  const NotificationWorkload({
+    this.perHour = 12,
+    this.stormsPerHour = 0.5,
+    this.stormPerMinute = 10,
+    this.stormDurationMs = 60000,
+    this.openProbability = 0.3,
+    this.openDelayMedianMs = 20000,
+    this.ignoredAfterMs = 30000,
+  });
+
+  Map<String, dynamic> toJson() => {
+        'perHour': perHour,
+        'stormsPerHour': stormsPerHour,
+        'stormPerMinute': stormPerMinute,
+        'stormDurationMs': stormDurationMs,
+        'openProbability': openProbability,
+        'openDelayMedianMs': openDelayMedianMs,
+        'ignoredAfterMs': ignoredAfterMs,
+      };
+}
+
+/// Poisson app switches with log-normal time in background.
+class AppSwitchWorkload {
+  final double perHour;
+  final double backgroundMedianMs;
+  final double backgroundSigma;
+
+  const AppSwitchWorkload({
+    this.perHour = 20,
+    this.backgroundMedianMs = 15000,
+    this.backgroundSigma = 1.0,
+  });
+
+  Map<String, dynamic> toJson() => {
+        'perHour': perHour,
+        'backgroundMedianMs': backgroundMedianMs,
+        'backgroundSigma': backgroundSigma,
+      };
+}
+
+/// How the phone is held and moved, for synthetic motion.
+enum SyntheticActivity { laying, sitting, walking, running }
+
+/// Accelerometer and gyroscope samples from activity profiles.
+///
+/// The [schedule] phases play in order and repeat.
+class MotionWorkload {
+  final List<(SyntheticActivity, Duration)> schedule;
+  final int sampleRateHz;
+
+  const MotionWorkload({
+    this.schedule = const [(SyntheticActivity.sitting, Duration(minutes: 1))],
+    this.sampleRateHz = 50,
+  });
+
+  Map<String, dynamic> toJson() => {
+        'schedule': [
+          for (final (activity, duration) in schedule)
+            {
+              'activity': activity.name,
+              'durationMs': duration.inMilliseconds,
+            },
+        ],
+        'sampleRateHz': sampleRateHz,
+      };
+}
+
+/// Seedable synthetic input for stress-testing the pipeline (Android).
+///
+/// Every non-null model generates events on a shared virtual clock, which
+/// runs at [speed] times real time (1–1000) for [duration]. The same
+/// workload and [seed] always generate the same sequence. Motion samples are
+/// used only while motion collection is on; at higher speeds each motion
+/// window holds proportionally more samples.
+///
+/// ```dart
+/// // A day of typing and notification storms in under two minutes
+/// const SyntheticWorkload(
+///   scroll: null,
+///   appSwitches: null,
+///   typing: TypingWorkload(burstsPerMinute: 6),
+///   notifications: NotificationWorkload(stormsPerHour: 2),
+///   speed: 1000,
+///   duration: Duration(hours: 24),
+/// );
+/// ```
+class SyntheticWorkload {
+  final int seed;
+  final ScrollWorkload? scroll;
+  final TypingWorkload? typing;
+  final NotificationWorkload? notifications;
+  final AppSwitchWorkload? appSwitches;
+  final MotionWorkload? motion;
+
+  /// Virtual time per real time, from 1 to 1000.
+  final double speed;
+
+  /// Virtual time to generate.
+  final Duration duration;
+
+  const SyntheticWorkload({
+    this.seed = 1,
+    this.scroll = const ScrollWorkload(),
+    this.typing = const TypingWorkload(),
+    this.notifications = const NotificationWorkload(),
+    this.appSwitches = const AppSwitchWorkload(),
+    this.motion,
+    this.speed = 1,
+    this.duration = const Duration(minutes: 1),
+  });
+
+  Map<String, dynamic> toJson() => {
+        'workload': {
+          'seed': seed,
+          if (scroll != null) 'scroll': scroll!.toJson(),
+          if (typing != null) 'typing': typing!.toJson(),
+          if (notifications != null) 'notifications': notifications!.toJson(),
+          if (appSwitches != null) 'appSwitches': appSwitches!.toJson(),
+          if (motion != null) 'motion': motion!.toJson(),
+        },
+        'speed': speed,
+        'durationSeconds': duration.inMilliseconds / 1000,
+      };
+}
+
+/// Limits a [SoakTest] judges its samples against.
+class SoakThresholds {
+  /// Leading share of samples that is not judged.
+  final double warmupFraction;
+
+  /// Fitted growth of a gauge, relative to its starting value, that counts
+  /// as unbounded.
+  final double maxGrowthFraction;
+
+  /// Absolute growth floor for memory gauges.
+  final int minGrowthBytes;
+
+  /// Absolute growth floor for count gauges.
+  final int minGrowthCount;
+
+  /// Late-to-early p95 ratio of a stage that counts as drift.
+  final double maxLatencyDrift;
+
+  /// Absolute p95 increase floor for drift, in microseconds.
+  final int minLatencyDriftUs;
+
+  const SoakThresholds({
+    this.warmupFraction = 0.25,
+    this.maxGrowthFraction = 0.2,
+    this.minGrowthBytes = 8 * 1024 * 1024,
+    this.minGrowthCount = 1000,
+    this.maxLatencyDrift = 2.0,
+    this.minLatencyDriftUs = 200,
+  });
+
+  Map<String, dynamic> toJson() => {
+        'warmupFraction': warmupFraction,
+        'maxGrowthFraction': maxGrowthFraction,
+        'minGrowthBytes': minGrowthBytes,
+        'minGrowthCount': minGrowthCount,
+        'maxLatencyDrift': maxLatencyDrift,
+        'minLatencyDriftUs': minLatencyDriftUs,
+      };
+}
+
+/// Long-run check for memory growth and latency drift (Android).
+///
+/// Runs [workload] (by default 72 virtual hours at 1000×, about 4.3 minutes)
+/// and samples memory (RSS, Java and native heap), retained structures,
+/// executor queue depths and per-stage latency every [sampleInterval] of
+/// virtual time. Events go to a session replaced every [sessionLength]; use
+/// [Duration.zero] to keep one session, whose events then grow by design.
+class SoakTest {
+  final SyntheticWorkload workload;
+  final Duration sampleInterval;
+  final Duration sessionLength;
+  final SoakThresholds thresholds;
+
+  const SoakTest({
+    this.workload = const SyntheticWorkload(
+      speed: 1000,
+      duration: Duration(hours: 72),
+    ),
+    this.sampleInterval = const Duration(minutes: 10),
+    this.sessionLength = const Duration(hours: 1),
+    this.thresholds = const SoakThresholds(),
+  });
+
+  Map<String, dynamic> toJson() => {
+        ...workload.toJson(),
+        'sampleIntervalSeconds': sampleInterval.inMilliseconds / 1000,
+        'sessionLengthSeconds': sessionLength.inMilliseconds / 1000,
+        'thresholds': thresholds.toJson(),
+      };
+}
@@ -143,9 +143,10 @@ class MotionStateInference {
     }
   }
 
-  /// Convert features map to ordered list of 561 doubles.
-  /// Uses the exact feature order from features.txt.
-  Future<List<double>> _featuresMapToList(Map<String, double> features) async {
+  /// Convert features map to an ordered Float32 vector of 561 features.
+  /// Uses the exact feature order from features.txt. The vector is the model
+  /// input as-is; native extraction already runs in float32, so nothing is lost.
+  Future<Float32List> _featuresMapToList(Map<String, double> features) async {
     if (features.length != 561) {
       throw ArgumentError('Expected 561 features, got ${features.length}');
     }
@@ -158,13 +159,14 @@ class MotionStateInference {
       print(
           'MotionStateInference: WARNING - Using alphabetical sort as fallback!');
       final sortedKeys = features.keys.toList()..sort();
-      return sortedKeys.map((key) => features[key]!).toList();
+      return Float32List.fromList(
+          sortedKeys.map((key) => features[key]!).toList());
     }
 
     // CRITICAL: Use the EXACT order from features.txt (index 1-561)
     // Do NOT sort or change the order - follow features.txt exactly as ML engineer specified
     // The index in features.txt (1-561) must match the array position (0-560)
-    final orderedFeatures = <double>[];
+    final orderedFeatures = Float32List(featureOrder.length);
     int missingCount = 0;
     final missingFeatures = <String>[];
     final bandEnergyAxisCounter =
@@ -204,11 +206,10 @@ class MotionStateInference {
       }
 
       if (featureValue != null) {
-        orderedFeatures.add(featureValue);
+        orderedFeatures[idx] = featureValue;
       } else {
-        // Feature missing - use 0.0 as fallback and log warning
+        // Feature missing - leave 0.0 as fallback and log warning
         // This maintains the correct index position even if feature is missing
-        orderedFeatures.add(0.0);
         missingCount++;
         missingFeatures
             .add('[$idx] $featureName'); // Include index for debugging
@@ -364,8 +365,8 @@ class MotionStateInference {
         }
       }
 
-      // Convert to Float32List - this is the exact input format the model expects
-      final inputData = Float32List.fromList(featureList);
+      // Already a Float32List - this is the exact input format the model expects
+      final inputData = featureList;
 
       // Validate input data before sending to model
       if (inputData.length != 561) {
@@ -613,9 +614,19 @@ class MotionStateInference {
     final List<String> states = [];
     final List<double> confidences = [];
 
+    int cascadeExits = 0;
     for (int i = 0; i < motionData.length; i++) {
       final dataPoint = motionData[i];
       try {
+        // Windows decided by the native stage 1 classifier skip the SVC
+        final cascadeState = dataPoint.cascadeState;
+        if (cascadeState != null) {
+          states.add(cascadeState.toLowerCase());
+          confidences.add(dataPoint.cascadeConfidence ?? 0.0);
+          cascadeExits++;
+          continue;
+        }
+
         // Get prediction directly from model
         final result = await _predictSingle(dataPoint.features);
         final predictedState = result.key;
@@ -659,6 +670,11 @@ class MotionStateInference {
       }
     }
 
+    if (cascadeExits > 0) {
+      print(
+          'MotionStateInference: $cascadeExits/${motionData.length} windows decided by stage 1, ${motionData.length - cascadeExits} ran the full model');
+    }
+
     // Calculate major state (most common)
     final stateCounts = <String, int>{};
     for (final state in states) {
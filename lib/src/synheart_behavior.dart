@@ -1,4 +1,5 @@
 import 'dart:async';
+import 'dart:developer' show Timeline;
 // dart:io was only used for Platform in _generateDeviceId (commented out)
 // import 'dart:io';
 import 'package:flutter/services.dart';
@@ -7,7 +8,12 @@ import 'models/behavior_config.dart';
 import 'models/behavior_event.dart';
 import 'models/behavior_session.dart'
     show BehaviorSession, BehaviorSessionSummary, MotionDataPoint;
+import 'models/behavior_snapshot.dart';
 import 'models/behavior_stats.dart';
+import 'models/energy_report.dart';
+import 'models/event_latency.dart';
+import 'models/event_subscription.dart';
+import 'models/synthetic_workload.dart';
 // Window features - commented out (not needed for real-time event tracking)
 // import 'models/behavior_window_features.dart';
 // import 'behavior_window_aggregator.dart';
@@ -23,15 +29,31 @@ import 'motion_state_inference.dart';
 class SynheartBehavior {
   static const MethodChannel _channel = MethodChannel('ai.synheart.behavior');
 
+  // Per-event processing budget (README: "Event processing: < 500 μs")
+  static const int _eventBudgetUs = 500;
+
+  // Identifies this isolate to native code; statics are reset by a hot restart
+  static final int _dartInstance = DateTime.now().microsecondsSinceEpoch;
+
   final BehaviorConfig _config;
-  final StreamController<BehaviorEvent> _eventController =
-      StreamController<BehaviorEvent>.broadcast();
+  // Native sends unfiltered events only while this stream has a listener
+  late final StreamController<BehaviorEvent> _eventController =
+      StreamController<BehaviorEvent>.broadcast(
+    onListen: () => _setEventStreamListening(true),
+    onCancel: () => _setEventStreamListening(false),
+  );
+  final StreamController<BehaviorSnapshot> _snapshotController =
+      StreamController<BehaviorSnapshot>.broadcast();
   // Window features - commented out (not needed for real-time event tracking)
   // final StreamController<BehaviorWindowFeatures> _shortWindowController =
   //     StreamController<BehaviorWindowFeatures>.broadcast();
   // final StreamController<BehaviorWindowFeatures> _longWindowController =
   //     StreamController<BehaviorWindowFeatures>.broadcast();
   final Map<String, BehaviorSession> _activeSessions = {};
+  final List<BehaviorSession> _restoredSessions = [];
+  final Map<int, StreamController<BehaviorEvent>> _subscriptionControllers = {};
+  final LatencyHistogram _dartStreamLatency = LatencyHistogram();
+  int _dartBudgetViolations = 0;
 
   // Window features - commented out (not needed for real-time event tracking)
   // final WindowAggregator _windowAggregator = WindowAggregator();
@@ -80,7 +102,11 @@ class SynheartBehavior {
       _channel.setMethodCallHandler(behavior._handleMethodCall);
 
       // Initialize native SDK
-      await _channel.invokeMethod('initialize', config?.toJson() ?? {});
+      final result = await _channel.invokeMethod('initialize', {
+        ...?config?.toJson(),
+        'dartInstance': _dartInstance,
+      });
+      behavior._adoptRestoredSessions(result);
 
       // Load motion state inference model
       try {
@@ -107,9 +133,17 @@ class SynheartBehavior {
 
   /// Stream of behavioral events emitted by the SDK.
   ///
-  /// Subscribe to this stream to receive real-time behavioral signals.
+  /// Subscribe to this stream to receive real-time behavioral signals. On
+  /// Android, native events are only sent while it has a listener; use
+  /// [subscribe] to receive a filtered subset instead.
   Stream<BehaviorEvent> get onEvent => _eventController.stream;
 
+  /// Stream of live snapshots for the active session.
+  ///
+  /// Only emits when [BehaviorConfig.liveSnapshotIntervalSeconds] is set; a
+  /// snapshot is skipped when no events arrived since the previous one.
+  Stream<BehaviorSnapshot> get onSnapshot => _snapshotController.stream;
+
   // Window features - commented out (not needed for real-time event tracking)
   // /// Stream of 30-second window features.
   // ///
@@ -172,7 +206,15 @@ class SynheartBehavior {
             // Even if no session, add events to window (they'll be used when session starts)
           }
 
+          _recordDartStreamLatency(eventData['capture_us']);
           _eventController.add(event);
+          // Subscriptions whose native filter accepted the event
+          final targets = eventData['subscriptions'];
+          if (targets is List) {
+            for (final id in targets) {
+              _subscriptionControllers[id]?.add(event);
+            }
+          }
           // Window features - commented out (not needed for real-time event tracking)
           // Always add to window aggregator (events are time-based, not session-based)
           // _windowAggregator.addEvent(event);
@@ -180,6 +222,15 @@ class SynheartBehavior {
           // Silently handle parsing errors to avoid console spam
         }
         break;
+      case 'onSnapshot':
+        try {
+          final snapshotData =
+              _convertMap(call.arguments as Map<dynamic, dynamic>);
+          _snapshotController.add(BehaviorSnapshot.fromJson(snapshotData));
+        } catch (e) {
+          // Silently handle parsing errors to avoid console spam
+        }
+        break;
       default:
         throw PlatformException(
           code: 'Unimplemented',
@@ -190,6 +241,10 @@ class SynheartBehavior {
 
   /// Start a new behavioral tracking session.
   ///
+  /// Sessions may overlap (for example an app-level session plus per-screen
+  /// sub-sessions). Each active session receives every event and can be ended
+  /// independently.
+  ///
   /// Returns a [BehaviorSession] object that can be used to end the session
   /// and retrieve a summary.
   Future<BehaviorSession> startSession({String? sessionId}) async {
@@ -307,7 +362,9 @@ class SynheartBehavior {
 
       _activeSessions.remove(sessionId);
       if (_currentSessionId == sessionId) {
-        _currentSessionId = null;
+        // Fall back to the most recently started session that is still active
+        _currentSessionId =
+            _activeSessions.isEmpty ? null : _activeSessions.keys.last;
       }
 
       return summary;
@@ -461,7 +518,12 @@ class SynheartBehavior {
       // _windowUpdateTimer = null;
 
       // Close event streams
+      for (final controller in _subscriptionControllers.values) {
+        await controller.close();
+      }
+      _subscriptionControllers.clear();
       await _eventController.close();
+      await _snapshotController.close();
       // Window features - commented out (not needed for real-time event tracking)
       // await _shortWindowController.close();
       // await _longWindowController.close();
@@ -489,6 +551,9 @@ class SynheartBehavior {
       );
     }
 
+    // Same monotonic clock as native capture times, so the native side can time
+    // this event's hops from here
+    final captureUs = Timeline.now;
     try {
       // Replace "current" session ID with actual session ID if available
       final eventToSend =
@@ -502,7 +567,10 @@ class SynheartBehavior {
                 )
               : event;
 
-      await _channel.invokeMethod('sendEvent', eventToSend.toJson());
+      await _channel.invokeMethod(
+        'sendEvent',
+        {...eventToSend.toJson(), 'capture_us': captureUs},
+      );
     } catch (e) {
       throw Exception('Failed to send event to native SDK: $e');
     }
@@ -573,6 +641,9 @@ class SynheartBehavior {
               return MotionDataPoint(
                 timestamp: map['timestamp'] as String,
                 features: features,
+                cascadeState: map['cascade_state'] as String?,
+                cascadeConfidence:
+                    (map['cascade_confidence'] as num?)?.toDouble(),
               );
             }).toList();
 
@@ -597,6 +668,346 @@ class SynheartBehavior {
     }
   }
 
+  /// Run an aggregate [EventQuery] over a session's events on the native side
+  /// (Android).
+  ///
+  /// [sessionId] - Optional session ID. If not provided, uses the current
+  /// active session.
+  ///
+  /// Returns one [EventAggregateRow] per (time bucket, group), ordered by
+  /// bucket and then by group.
+  Future<List<EventAggregateRow>> queryEvents(
+    EventQuery query, {
+    String? sessionId,
+  }) async {
+    if (!_initialized) {
+      throw Exception(
+        'SDK not initialized. Call SynheartBehavior.initialize() first.',
+      );
+    }
+
+    try {
+      final result = await _channel.invokeMethod('queryEvents', {
+        'query': query.toJson(),
+        'sessionId': sessionId ?? _currentSessionId,
+      });
+      return (result as List)
+          .map((row) =>
+              EventAggregateRow.fromJson(Map<String, dynamic>.from(row as Map)))
+          .toList();
+    } catch (e) {
+      throw Exception('Failed to query events: $e');
+    }
+  }
+
+  /// Get cross-session trends from the rollup store (Android).
+  ///
+  /// Requires [BehaviorConfig.rollupRetentionDays] > 0. Returns one
+  /// [BehaviorTrendBucket] per [granularity] period between [start] and [end]
+  /// (default: now), oldest first, limited to the retained periods.
+  Future<List<BehaviorTrendBucket>> getTrends({
+    required TrendGranularity granularity,
+    required DateTime start,
+    DateTime? end,
+  }) async {
+    if (!_initialized) {
+      throw Exception(
+        'SDK not initialized. Call SynheartBehavior.initialize() first.',
+      );
+    }
+
+    try {
+      final result = await _channel.invokeMethod('getTrends', {
+        'granularity': granularity.name,
+        'startMs': start.millisecondsSinceEpoch,
+        'endMs': (end ?? DateTime.now()).millisecondsSinceEpoch,
+      });
+      return (result as List)
+          .map((bucket) => BehaviorTrendBucket.fromJson(
+              Map<String, dynamic>.from(bucket as Map)))
+          .toList();
+    } catch (e) {
+      throw Exception('Failed to get trends: $e');
+    }
+  }
+
+  /// Subscribe to the events accepted by [filter] (Android).
+  ///
+  /// The filter runs in the native pipeline, so rejected events never cross
+  /// the platform channel. Cancel the returned [EventSubscription] to remove
+  /// it.
+  Future<EventSubscription> subscribe(EventFilter filter) async {
+    if (!_initialized) {
+      throw Exception(
+        'SDK not initialized. Call SynheartBehavior.initialize() first.',
+      );
+    }
+
+    try {
+      final id =
+          await _channel.invokeMethod<int>('subscribeEvents', filter.toJson());
+      final controller = StreamController<BehaviorEvent>.broadcast();
+      _subscriptionControllers[id!] = controller;
+      return EventSubscription(
+        id: id,
+        filter: filter,
+        events: controller.stream,
+        statsCallback: _getSubscriptionStats,
+        cancelCallback: _unsubscribe,
+      );
+    } catch (e) {
+      throw Exception('Failed to subscribe to events: $e');
+    }
+  }
+
+  Future<EventSubscriptionStats> _getSubscriptionStats(int id) async {
+    try {
+      final result = await _channel.invokeMethod('getSubscriptionStats');
+      final stats = (result as Map?)?['$id'];
+      return EventSubscriptionStats.fromJson(
+        stats is Map ? Map<String, dynamic>.from(stats) : const {},
+      );
+    } catch (e) {
+      throw Exception('Failed to get subscription stats: $e');
+    }
+  }
+
+  Future<void> _unsubscribe(int id) async {
+    final controller = _subscriptionControllers.remove(id);
+    if (controller == null) return;
+
+    try {
+      await _channel.invokeMethod('unsubscribeEvents', {'subscriptionId': id});
+    } catch (e) {
+      throw Exception('Failed to unsubscribe from events: $e');
+    } finally {
+      await controller.close();
+    }
+  }
+
+  /// Get per-hop event latency against the per-event budget (Android).
+  ///
+  /// Covers every native hop from the collector's capture time to the
+  /// method channel, plus the hop into the Dart event stream, with budget
+  /// violation counts.
+  Future<EventLatencyStats> getLatencyStats() async {
+    if (!_initialized) {
+      throw Exception(
+        'SDK not initialized. Call SynheartBehavior.initialize() first.',
+      );
+    }
+
+    try {
+      final result = await _channel.invokeMethod('getLatencyStats');
+      final json = _convertMap(result as Map<dynamic, dynamic>);
+      if (_dartStreamLatency.count > 0) {
+        json['dart_stream'] = _dartStreamLatency.toHopLatency().toJson();
+      }
+      json['dart_budget_violations'] = _dartBudgetViolations;
+      return EventLatencyStats.fromJson(json);
+    } catch (e) {
+      throw Exception('Failed to get latency stats: $e');
+    }
+  }
+
+  /// Get the estimated battery cost per pipeline stage (Android).
+  ///
+  /// Attributes the SDK's native CPU time to stages and threads and converts
+  /// it with [BehaviorConfig.powerTable]. Shows whether motion extraction,
+  /// Flux or event delivery dominates.
+  Future<EnergyReport> getEnergyReport() async {
+    if (!_initialized) {
+      throw Exception(
+        'SDK not initialized. Call SynheartBehavior.initialize() first.',
+      );
+    }
+
+    try {
+      final result = await _channel.invokeMethod('getEnergyReport');
+      return EnergyReport.fromJson(
+        _convertMap(result as Map<dynamic, dynamic>),
+      );
+    } catch (e) {
+      throw Exception('Failed to get energy report: $e');
+    }
+  }
+
+  /// Measure checkpoint storage throughput, plain and encrypted (Android).
+  ///
+  /// Writes and reads [megabytes] through the page cache in the app's cache
+  /// directory, then returns `plaintext` and `encrypted` maps with
+  /// `write_mb_s` and `read_mb_s`, plus `cipher_provider` and `key_source`.
+  /// Uses the host app's checkpoint key when one is registered, otherwise a
+  /// throwaway key. Runs at background priority.
+  Future<Map<String, dynamic>> benchmarkCheckpointStorage({
+    int megabytes = 16,
+  }) async {
+    if (!_initialized) {
+      throw Exception(
+        'SDK not initialized. Call SynheartBehavior.initialize() first.',
+      );
+    }
+
+    try {
+      final result = await _channel.invokeMethod(
+        'benchmarkCheckpointStorage',
+        {'megabytes': megabytes},
+      );
+      return _convertMap(result as Map<dynamic, dynamic>);
+    } catch (e) {
+      throw Exception('Failed to benchmark checkpoint storage: $e');
+    }
+  }
+
+  /// Measure the JSON boundary to Flux, platform against fast paths
+  /// (Android).
+  ///
+  /// Builds a Flux session of [events] synthetic events and returns
+  /// `flux_session` with write and parse throughput in `*_mb_s`, `hsi` with
+  /// parse throughput when the Flux library is available, per-value
+  /// `double_format_ns` and `double_parse_ns`, and `round_trip_mismatches`,
+  /// which should be 0. Runs at background priority.
+  Future<Map<String, dynamic>> benchmarkJsonCodec({int events = 2000}) async {
+    if (!_initialized) {
+      throw Exception(
+        'SDK not initialized. Call SynheartBehavior.initialize() first.',
+      );
+    }
+
+    try {
+      final result = await _channel.invokeMethod(
+        'benchmarkJsonCodec',
+        {'events': events},
+      );
+      return _convertMap(result as Map<dynamic, dynamic>);
+    } catch (e) {
+      throw Exception('Failed to benchmark JSON codec: $e');
+    }
+  }
+
+  /// Drive the pipeline with synthetic input for stress tests (Android).
+  ///
+  /// Generated events take the same path as collector events and reach
+  /// active sessions and [onEvent] subscribers. Replaces a workload that is
+  /// already running. Generation stops after the workload's duration or on
+  /// [stopSyntheticWorkload].
+  Future<void> startSyntheticWorkload(SyntheticWorkload workload) async {
+    if (!_initialized) {
+      throw Exception(
+        'SDK not initialized. Call SynheartBehavior.initialize() first.',
+      );
+    }
+
+    try {
+      await _channel.invokeMethod('startSyntheticWorkload', workload.toJson());
+    } catch (e) {
+      throw Exception('Failed to start synthetic workload: $e');
+    }
+  }
+
+  /// Stop the synthetic workload (Android).
+  ///
+  /// Returns `generated` counts per event type (and `motion_samples`),
+  /// `virtual_ms`, `wall_ms`, `speed` and `duration_ms`. Empty when no
+  /// workload ran.
+  Future<Map<String, dynamic>> stopSyntheticWorkload() async {
+    if (!_initialized) {
+      throw Exception(
+        'SDK not initialized. Call SynheartBehavior.initialize() first.',
+      );
+    }
+
+    try {
+      final result = await _channel.invokeMethod('stopSyntheticWorkload');
+      return _convertMap(result as Map<dynamic, dynamic>);
+    } catch (e) {
+      throw Exception('Failed to stop synthetic workload: $e');
+    }
+  }
+
+  /// Start a soak test under synthetic load (Android).
+  ///
+  /// Replaces a running synthetic workload. Poll [getSoakReport] until its
+  /// `workload.running` is false, then call [stopSyntheticWorkload], which
+  /// also ends the soak session.
+  Future<void> startSoakTest([SoakTest test = const SoakTest()]) async {
+    if (!_initialized) {
+      throw Exception(
+        'SDK not initialized. Call SynheartBehavior.initialize() first.',
+      );
+    }
+
+    try {
+      await _channel.invokeMethod('startSoakTest', test.toJson());
+    } catch (e) {
+      throw Exception('Failed to start soak test: $e');
+    }
+  }
+
+  /// Verdict of the current or last soak test so far (Android).
+  ///
+  /// Returns `passed`, `failures` (e.g. "session_events grows without
+  /// bound"), `samples`, and per-gauge (`first`, `last`, `max`,
+  /// `fitted_growth`, `unbounded`) and per-stage (`early_p95_us`,
+  /// `late_p95_us`, `drifted`) detail. `judged` is false until enough samples
+  /// exist. Empty when no soak test ran.
+  Future<Map<String, dynamic>> getSoakReport() async {
+    if (!_initialized) {
+      throw Exception(
+        'SDK not initialized. Call SynheartBehavior.initialize() first.',
+      );
+    }
+
+    try {
+      final result = await _channel.invokeMethod('getSoakReport');
+      return _convertMap(result as Map<dynamic, dynamic>);
+    } catch (e) {
+      throw Exception('Failed to get soak report: $e');
+    }
+  }
+
+  void _recordDartStreamLatency(dynamic captureUs) {
+    // Native capture time is on the same monotonic clock as Timeline.now
+    if (captureUs is! int) return;
+    final micros = Timeline.now - captureUs;
+    _dartStreamLatency.record(micros);
+    if (micros > _eventBudgetUs) _dartBudgetViolations++;
+  }
+
+  Future<void> _setEventStreamListening(bool listening) async {
+    try {
+      await _channel
+          .invokeMethod('setEventStreamListening', {'listening': listening});
+    } catch (_) {
+      // Platforms without native filtering send every event anyway
+    }
+  }
+
+  /// Sessions restored from native checkpoints at [initialize] (Android).
+  ///
+  /// Only populated when [BehaviorConfig.enableSessionCheckpoints] is set and
+  /// the previous process was killed with sessions still active. Each one is
+  /// active again and keeps collecting; end it as usual with
+  /// [BehaviorSession.end].
+  List<BehaviorSession> get restoredSessions =>
+      List.unmodifiable(_restoredSessions);
+
+  void _adoptRestoredSessions(dynamic result) {
+    if (result is! Map || result['restoredSessions'] is! List) return;
+    for (final entry in result['restoredSessions'] as List) {
+      final sessionMap = Map<String, dynamic>.from(entry as Map);
+      final sessionId = sessionMap['sessionId'] as String;
+      final session = BehaviorSession(
+        sessionId: sessionId,
+        startTimestamp: (sessionMap['startTimestamp'] as num).toInt(),
+        endCallback: _endSession,
+      );
+      _activeSessions[sessionId] = session;
+      _restoredSessions.add(session);
+      _currentSessionId = sessionId;
+    }
+  }
+
   /// Check if the SDK is currently initialized.
   bool get isInitialized => _initialized;
 
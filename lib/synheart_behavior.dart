@@ -3,11 +3,20 @@ library synheart_behavior;
 export 'src/synheart_behavior.dart';
 export 'src/models/behavior_config.dart';
 export 'src/models/behavior_event.dart';
+export 'src/models/event_query.dart';
+export 'src/models/event_subscription.dart';
+export 'src/models/event_latency.dart';
+export 'src/models/energy_report.dart';
 export 'src/models/behavior_session.dart';
+export 'src/models/behavior_snapshot.dart';
 export 'src/models/behavior_stats.dart';
+export 'src/models/behavior_trend.dart';
+export 'src/models/synthetic_workload.dart';
 // Window features - commented out (not needed for real-time event tracking)
 // export 'src/models/behavior_window_features.dart';
 // export 'src/behavior_window_aggregator.dart';
 export 'src/behavior_gesture_detector.dart';
 export 'src/motion_state_inference.dart';
 export 'src/flux_bridge.dart';
+export 'src/ab_comparison.dart';
+export 'src/hsi_archive.dart';
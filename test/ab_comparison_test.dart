@@ -0,0 +1,124 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:synheart_behavior/synheart_behavior.dart';
+
+List<Map<String, double>> _runs(List<double> nsPerOp, {double? ipc}) => [
+      for (final ns in nsPerOp)
+        {
+          'ns_per_op': ns,
+          if (ipc != null) 'ipc': ipc + ns / 1e6,
+        },
+    ];
+
+void main() {
+  const comparator = AbComparator(resamples: 500);
+
+  group('AbComparator', () {
+    test('reports a clear speedup as faster', () {
+      final result = comparator.compare(
+        'flux_snapshot',
+        _runs([100, 102, 98, 101, 99, 103, 97, 100]),
+        _runs([80, 81, 79, 82, 78, 80, 81, 79]),
+      );
+
+      expect(result.verdict, AbVerdict.faster);
+      final ns = result.metrics['ns_per_op']!;
+      expect(ns.baselineMedian, 100.0);
+      expect(ns.candidateMedian, 80.0);
+      expect(ns.ratio, closeTo(0.8, 1e-9));
+      expect(ns.ciHigh, lessThan(0.98));
+    });
+
+    test('reports a clear slowdown as slower', () {
+      final result = comparator.compare(
+        'event_ingest',
+        _runs([50, 51, 49, 50, 52, 48]),
+        _runs([60, 61, 59, 62, 58, 60]),
+      );
+
+      expect(result.verdict, AbVerdict.slower);
+      expect(result.metrics['ns_per_op']!.ciLow, greaterThan(1.02));
+    });
+
+    test('treats overlapping noise as inconclusive', () {
+      final result = comparator.compare(
+        'json_encode',
+        _runs([100, 120, 90, 110, 95, 105]),
+        _runs([101, 118, 92, 108, 97, 104]),
+      );
+
+      expect(result.verdict, AbVerdict.inconclusive);
+    });
+
+    test('higher IPC counts as faster', () {
+      final result = comparator.compare(
+        'feature_engine',
+        _runs([100, 100, 100, 100], ipc: 1.0),
+        _runs([100, 100, 100, 100], ipc: 1.5),
+      );
+
+      expect(result.metrics['ipc']!.verdict, AbVerdict.faster);
+      expect(result.metrics['ns_per_op']!.verdict, AbVerdict.inconclusive);
+    });
+
+    test('skips metrics missing on one side', () {
+      final result = comparator.compare(
+        'checkpoint',
+        [
+          {'ns_per_op': 10, 'allocs_per_op': 2},
+        ],
+        [
+          {'ns_per_op': 10},
+        ],
+      );
+
+      expect(result.metrics.keys, ['ns_per_op']);
+    });
+
+    test('same seed gives the same interval', () {
+      final a = _runs([100, 104, 97, 101, 99]);
+      final b = _runs([95, 99, 93, 98, 96]);
+
+      final first = comparator.compare('x', a, b).metrics['ns_per_op']!;
+      final second = comparator.compare('x', a, b).metrics['ns_per_op']!;
+
+      expect(second.ciLow, first.ciLow);
+      expect(second.ciHigh, first.ciHigh);
+    });
+
+    test('run interleaves baseline and candidate', () async {
+      final order = <String>[];
+      const runner = AbComparator(repetitions: 4, warmup: 1, resamples: 100);
+
+      final result = await runner.run(
+        'order',
+        () async {
+          order.add('A');
+          return {'ns_per_op': 10.0};
+        },
+        () async {
+          order.add('B');
+          return {'ns_per_op': 10.0};
+        },
+      );
+
+      expect(order, ['A', 'B', 'A', 'B', 'B', 'A', 'A', 'B', 'B', 'A']);
+      expect(result.repetitions, 4);
+      expect(result.verdict, AbVerdict.inconclusive);
+    });
+
+    test('toJson is machine readable', () {
+      final json = comparator
+          .compare(
+            'flux_snapshot',
+            _runs([100, 101, 99]),
+            _runs([70, 71, 69]),
+          )
+          .toJson();
+
+      expect(json['name'], 'flux_snapshot');
+      expect(json['verdict'], 'faster');
+      expect(json['metrics']['ns_per_op']['verdict'], 'faster');
+      expect(json['metrics']['ns_per_op'], contains('ci_low'));
+    });
+  });
+}
@@ -0,0 +1,97 @@
+import 'dart:convert';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:synheart_behavior/synheart_behavior.dart';
+
+Map<String, dynamic> _hsi(int i) => {
+      'hsi_version': '1.0',
+      'observed_at_utc': '2024-01-15T10:${(i % 60).toString().padLeft(2, '0')}'
+          ':00Z',
+      'computed_at_utc': '2024-01-15T11:00:00.123456Z',
+      'producer': {'name': 'synheart-flux', 'version': '0.1.0'},
+      'window_ids': ['w_$i'],
+      'axes': {
+        'behavior': {
+          'readings': [
+            {'axis': 'distraction', 'score': (i % 10) / 10 + 0.05},
+            {'axis': 'focus', 'score': 1 - (i % 7) / 100},
+            {'axis': 'burstiness', 'score': 0, 'confidence': 0.9},
+          ],
+        },
+      },
+      'meta': {
+        'deep_focus_blocks': i % 3,
+        'duration_sec': 120.5,
+        'note': null,
+        'flagged': i.isEven,
+      },
+    };
+
+void main() {
+  group('HsiArchive', () {
+    final documents = [for (var i = 0; i < 40; i++) _hsi(i)];
+
+    test('round-trips documents losslessly', () {
+      final decoded = HsiArchive.decode(HsiArchive.encode(documents));
+
+      expect(jsonEncode(decoded), jsonEncode(documents));
+      // Int scores stay ints, double scores stay doubles
+      final readings = decoded[3]['axes']['behavior']['readings'] as List;
+      expect(readings[2]['score'], isA<int>());
+      expect(readings[0]['score'], isA<double>());
+    });
+
+    test('keeps timestamps that do not re-format exactly as strings', () {
+      final document = {
+        'a': '2024-01-15T10:00:00+00:00',
+        'b': '2024-01-15T10:00:00.120000000Z',
+        'c': '2024-01-15T10:00:00.1234567Z',
+        'd': '2024-02-30T10:00:00Z',
+        'e': '2024-01-15 10:00:00',
+        'f': -0.0,
+      };
+
+      final decoded = HsiArchive.decode(HsiArchive.encode([document])).single;
+
+      expect(jsonEncode(decoded), jsonEncode(document));
+    });
+
+    test('scans one axis without decoding documents', () {
+      final archive = HsiArchive.encode(documents);
+
+      final focus = HsiArchive.scanAxis(archive, 'focus');
+
+      expect(focus, hasLength(40));
+      expect(focus[9].document, 9);
+      expect(focus[9].score, 1 - 2 / 100);
+      expect(HsiArchive.scanAxis(archive, 'missing'), isEmpty);
+      // Int scores are not columnized
+      expect(HsiArchive.axes(archive), ['distraction', 'focus']);
+    });
+
+    test('is smaller than the JSON it encodes', () {
+      final json = utf8.encode(jsonEncode(documents));
+
+      expect(HsiArchive.encode(documents).length, lessThan(json.length ~/ 2));
+    });
+
+    test('benchmark reports sizes and scan times', () {
+      final result = HsiArchive.benchmark(
+        [for (final document in documents) jsonEncode(document)],
+        iterations: 2,
+      );
+
+      expect(result['documents'], 40);
+      expect(result['archive_bytes'], lessThan(result['json_bytes']));
+      expect(result['gzip_scan_us'], greaterThanOrEqualTo(0));
+      expect(result['archive_scan_us'], greaterThanOrEqualTo(0));
+    });
+
+    test('rejects data that is not an archive', () {
+      expect(
+        () => HsiArchive.decode(utf8.encode('{"axes": {}}')),
+        throwsFormatException,
+      );
+    });
+  });
+}
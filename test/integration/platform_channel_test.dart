@@ -1,3 +1,5 @@
+import 'dart:developer' show Timeline;
+
 import 'package:flutter/services.dart';
 import 'package:flutter_test/flutter_test.dart';
 import 'package:synheart_behavior/synheart_behavior.dart';
@@ -19,6 +21,17 @@ void main() {
 
       switch (methodCall.method) {
         case 'initialize':
+          final config = methodCall.arguments as Map?;
+          if (config?['enableSessionCheckpoints'] == true) {
+            return {
+              'restoredSessions': [
+                {
+                  'sessionId': 'restored-session',
+                  'startTimestamp': 1700000000000,
+                },
+              ],
+            };
+          }
           return null;
 
         case 'startSession':
@@ -108,6 +121,149 @@ void main() {
         case 'updateConfig':
           return null;
 
+        case 'getTrends':
+          return [
+            {
+              'bucket_start_ms': 1735689600000,
+              'session_count': 4,
+              'total_duration_ms': 1200000,
+              'event_count': 320,
+              'app_switch_count': 6,
+              'notification_count': 9,
+              'call_count': 0,
+              'clipboard_count': 2,
+              'deep_focus_blocks': 1,
+              'focus_hint': 0.7,
+              'behavioral_distraction_score': 0.25,
+              'interaction_intensity': 0.4,
+            },
+          ];
+
+        case 'queryEvents':
+          return [
+            {
+              'bucket_start_ms': 1735725600000,
+              'group': 'ignored',
+              'count': 3,
+              'value': 3.0,
+            },
+            {
+              'bucket_start_ms': 1735725600000,
+              'group': 'opened',
+              'count': 1,
+              'value': 1.0,
+            },
+          ];
+
+        case 'setEventStreamListening':
+          return null;
+
+        case 'subscribeEvents':
+          return 7;
+
+        case 'getSubscriptionStats':
+          return {
+            '7': {'delivered': 1, 'filtered': 5},
+          };
+
+        case 'unsubscribeEvents':
+          return true;
+
+        case 'getEnergyReport':
+          return {
+            'observed_hours': 1.0,
+            'total_mah_per_hour': 0.8,
+            'dominant_stage': 'flux',
+            'stages': {
+              'flux': {
+                'cpu_ms': 900.0,
+                'calls': 40,
+                'mah_per_hour': 0.6,
+                'share': 0.75,
+              },
+            },
+            'threads': {
+              'user_visible': {'cpu_ms': 900.0, 'cluster': 'mid'},
+            },
+          };
+
+        case 'benchmarkCheckpointStorage':
+          return {
+            'bytes': 16 * 1024 * 1024,
+            'cipher_provider': 'AndroidOpenSSL',
+            'key_source': 'generated',
+            'plaintext': {'write_mb_s': 900.0, 'read_mb_s': 1800.0},
+            'encrypted': {'write_mb_s': 780.0, 'read_mb_s': 1500.0},
+          };
+
+        case 'benchmarkJsonCodec':
+          return {
+            'events': 500,
+            'doubles': 1400,
+            'flux_session': {
+              'chars': 120000,
+              'platform_write_mb_s': 40.0,
+              'fast_write_mb_s': 95.0,
+              'platform_parse_mb_s': 30.0,
+              'fast_parse_mb_s': 70.0,
+            },
+            'double_format_ns': {'platform': 410.0, 'fast': 95.0},
+            'double_parse_ns': {'platform': 350.0, 'fast': 60.0},
+            'round_trip_mismatches': 0,
+            'text_round_trip': true,
+          };
+
+        case 'startSyntheticWorkload':
+          return null;
+
+        case 'startSoakTest':
+          return null;
+
+        case 'getSoakReport':
+          return {
+            'samples': 433,
+            'judged': true,
+            'passed': false,
+            'failures': ['session_events grows without bound'],
+            'gauges': {
+              'session_events': {'first': 120, 'last': 9800, 'unbounded': true},
+            },
+            'stages': {
+              'native_total': {
+                'early_p95_us': 96,
+                'late_p95_us': 112,
+                'drifted': false,
+              },
+            },
+          };
+
+        case 'stopSyntheticWorkload':
+          return {
+            'virtual_ms': 60000,
+            'wall_ms': 60,
+            'speed': 1000.0,
+            'duration_ms': 60000,
+            'running': false,
+            'generated': {'scroll': 21, 'tap': 30, 'notification': 1},
+          };
+
+        case 'getLatencyStats':
+          return {
+            'budget_us': 500,
+            'events': 10,
+            'budget_violations': 1,
+            'hops': {
+              'native_total': {
+                'count': 10,
+                'avg_us': 140.0,
+                'p50_us': 112,
+                'p95_us': 640,
+                'p99_us': 640,
+                'max_us': 602.5,
+              },
+            },
+          };
+
         case 'dispose':
           return null;
 
@@ -205,6 +361,73 @@ void main() {
       expect(updateCall.arguments['eventBatchSize'], 25);
     });
 
+    test('queryEvents sends query and parses aggregate rows', () async {
+      final behavior = await SynheartBehavior.initialize();
+      await behavior.startSession(sessionId: 'query-session');
+      methodCalls.clear();
+
+      final rows = await behavior.queryEvents(
+        const EventQuery(
+          eventType: 'notification',
+          bucket: Duration(hours: 1),
+          groupBy: 'action',
+        ),
+      );
+
+      final queryCall =
+          methodCalls.firstWhere((call) => call.method == 'queryEvents');
+      expect(queryCall.arguments['sessionId'], 'query-session');
+      expect(queryCall.arguments['query']['eventType'], 'notification');
+      expect(queryCall.arguments['query']['bucketMs'], 3600000);
+      expect(queryCall.arguments['query']['groupBy'], 'action');
+      expect(queryCall.arguments['query']['aggregation'], 'count');
+      expect(rows.length, 2);
+      expect(rows.first.group, 'ignored');
+      expect(rows.first.count, 3);
+      expect(rows.first.bucketStartMs, 1735725600000);
+    });
+
+    test('getTrends sends range and parses trend buckets', () async {
+      final behavior = await SynheartBehavior.initialize(
+        config: const BehaviorConfig(rollupRetentionDays: 28),
+      );
+      methodCalls.clear();
+
+      final buckets = await behavior.getTrends(
+        granularity: TrendGranularity.day,
+        start: DateTime.fromMillisecondsSinceEpoch(1735084800000),
+        end: DateTime.fromMillisecondsSinceEpoch(1735776000000),
+      );
+
+      final trendsCall =
+          methodCalls.firstWhere((call) => call.method == 'getTrends');
+      expect(trendsCall.arguments['granularity'], 'day');
+      expect(trendsCall.arguments['startMs'], 1735084800000);
+      expect(trendsCall.arguments['endMs'], 1735776000000);
+      expect(buckets.length, 1);
+      expect(buckets.first.sessionCount, 4);
+      expect(buckets.first.focusHint, 0.7);
+      expect(buckets.first.start.millisecondsSinceEpoch, 1735689600000);
+    });
+
+    test('initialize adopts sessions restored from checkpoints', () async {
+      final behavior = await SynheartBehavior.initialize(
+        config: const BehaviorConfig(enableSessionCheckpoints: true),
+      );
+
+      expect(behavior.restoredSessions.length, 1);
+      final session = behavior.restoredSessions.first;
+      expect(session.sessionId, 'restored-session');
+      expect(session.startTimestamp, 1700000000000);
+      expect(behavior.currentSessionId, 'restored-session');
+
+      methodCalls.clear();
+      await session.end();
+      final endCall =
+          methodCalls.firstWhere((call) => call.method == 'endSession');
+      expect(endCall.arguments['sessionId'], 'restored-session');
+    });
+
     test('dispose cleans up platform resources', () async {
       final behavior = await SynheartBehavior.initialize();
       methodCalls.clear();
@@ -256,6 +479,45 @@ void main() {
       expect(events[1].eventType, BehaviorEventType.scroll);
     });
 
+    test('snapshot stream receives live snapshots from platform', () async {
+      final behavior = await SynheartBehavior.initialize(
+        config: const BehaviorConfig(liveSnapshotIntervalSeconds: 15),
+      );
+      expect(methodCalls[0].arguments['liveSnapshotIntervalSeconds'], 15);
+
+      final snapshots = <BehaviorSnapshot>[];
+      behavior.onSnapshot.listen(snapshots.add);
+
+      await TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+          .handlePlatformMessage(
+        channel.name,
+        channel.codec.encodeMethodCall(
+          MethodCall('onSnapshot', {
+            'session_id': 'live-session',
+            'snapshot_index': 1,
+            'start_at': DateTime.now().toUtc().toIso8601String(),
+            'end_at': DateTime.now().toUtc().toIso8601String(),
+            'event_count': 5,
+            'new_event_count': 5,
+            'behavioral_metrics': {
+              'focus_hint': 0.7,
+              'behavioral_distraction_score': 0.3,
+              'deep_focus_blocks': [],
+            },
+            'notification_summary': {'notification_count': 0},
+            'performance_info': {'snapshot_compute_time_ms': 2},
+          }),
+        ),
+        (_) {},
+      );
+
+      await Future.delayed(const Duration(milliseconds: 100));
+
+      expect(snapshots.length, 1);
+      expect(snapshots[0].sessionId, 'live-session');
+      expect(snapshots[0].behavioralMetrics!.focusHint, 0.7);
+    });
+
     test('handles platform exceptions gracefully', () async {
       TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
           .setMockMethodCallHandler(channel, (MethodCall methodCall) async {
@@ -271,6 +533,177 @@ void main() {
       );
     });
 
+    test('subscription receives the events its native filter accepted',
+        () async {
+      final behavior = await SynheartBehavior.initialize();
+      methodCalls.clear();
+
+      final subscription = await behavior.subscribe(
+        const EventFilter(eventTypes: {'notification'}, maxPerSecond: 1),
+      );
+      expect(subscription.id, 7);
+      expect(methodCalls.last.method, 'subscribeEvents');
+      expect(methodCalls.last.arguments['eventTypes'], ['notification']);
+      expect(methodCalls.last.arguments['maxPerSecond'], 1.0);
+
+      final events = <BehaviorEvent>[];
+      subscription.events.listen(events.add);
+
+      await _sendEvent(channel, {
+        'event': {
+          'event_id': 'evt_n1',
+          'session_id': 'test-session',
+          'timestamp': DateTime.now().toUtc().toIso8601String(),
+          'event_type': 'notification',
+          'metrics': {'action': 'opened'},
+        },
+        'subscriptions': [7],
+      });
+      // Sent only for the unfiltered stream, not routed to the subscription
+      await _sendEvent(channel, {
+        'event': {
+          'event_id': 'evt_t1',
+          'session_id': 'test-session',
+          'timestamp': DateTime.now().toUtc().toIso8601String(),
+          'event_type': 'tap',
+          'metrics': {'tap_duration_ms': 90},
+        },
+      });
+
+      await Future.delayed(const Duration(milliseconds: 100));
+
+      expect(events.length, 1);
+      expect(events[0].eventType, BehaviorEventType.notification);
+
+      final stats = await subscription.getStats();
+      expect(stats.delivered, 1);
+      expect(stats.filtered, 5);
+
+      await subscription.cancel();
+      expect(methodCalls.last.method, 'unsubscribeEvents');
+      expect(methodCalls.last.arguments['subscriptionId'], 7);
+    });
+
+    test('latency stats include the hop into the Dart stream', () async {
+      final behavior = await SynheartBehavior.initialize();
+      behavior.onEvent.listen((_) {});
+
+      await _sendEvent(channel, {
+        'event': {
+          'event_id': 'evt_l1',
+          'session_id': 'test-session',
+          'timestamp': DateTime.now().toUtc().toIso8601String(),
+          'event_type': 'tap',
+          'metrics': {'tap_duration_ms': 90},
+        },
+        'capture_us': Timeline.now - 200,
+      });
+      await Future.delayed(const Duration(milliseconds: 50));
+
+      final stats = await behavior.getLatencyStats();
+      expect(stats.events, 10);
+      expect(stats.budgetViolations, 1);
+      expect(stats.hops['native_total']!.p95Us, 640);
+      expect(stats.dartStreamHop!.count, 1);
+      expect(stats.dartStreamHop!.maxUs, greaterThanOrEqualTo(200));
+    });
+
+    test('energy report is parsed from platform', () async {
+      final behavior = await SynheartBehavior.initialize(
+        config: const BehaviorConfig(powerTable: PowerTable(sensorMw: 1.5)),
+      );
+      expect(methodCalls[0].arguments['powerTable']['sensorMw'], 1.5);
+
+      final report = await behavior.getEnergyReport();
+      expect(report.dominantStage, 'flux');
+      expect(report.stages['flux']!.mahPerHour, 0.6);
+      expect(report.threadCpuMs['user_visible'], 900.0);
+    });
+
+    test('checkpoint storage benchmark is forwarded to platform', () async {
+      final behavior = await SynheartBehavior.initialize(
+        config: const BehaviorConfig(
+          enableSessionCheckpoints: true,
+          encryptSessionCheckpoints: true,
+        ),
+      );
+      expect(methodCalls[0].arguments['encryptSessionCheckpoints'], true);
+
+      final result = await behavior.benchmarkCheckpointStorage(megabytes: 4);
+      expect(methodCalls.last.method, 'benchmarkCheckpointStorage');
+      expect(methodCalls.last.arguments['megabytes'], 4);
+      expect(result['encrypted']['write_mb_s'], 780.0);
+      expect(result['cipher_provider'], 'AndroidOpenSSL');
+    });
+
+    test('benchmarkJsonCodec passes event count', () async {
+      final behavior = await SynheartBehavior.initialize();
+
+      final result = await behavior.benchmarkJsonCodec(events: 500);
+      expect(methodCalls.last.method, 'benchmarkJsonCodec');
+      expect(methodCalls.last.arguments['events'], 500);
+      expect(result['flux_session']['fast_write_mb_s'], 95.0);
+      expect(result['round_trip_mismatches'], 0);
+    });
+
+    test('soak test starts and reports', () async {
+      final behavior = await SynheartBehavior.initialize();
+
+      await behavior.startSoakTest(const SoakTest(
+        sessionLength: Duration.zero,
+        thresholds: SoakThresholds(maxGrowthFraction: 0.5),
+      ));
+      expect(methodCalls.last.method, 'startSoakTest');
+      expect(methodCalls.last.arguments['durationSeconds'], 72 * 3600);
+      expect(methodCalls.last.arguments['speed'], 1000);
+      expect(methodCalls.last.arguments['sessionLengthSeconds'], 0);
+      expect(
+          methodCalls.last.arguments['thresholds']['maxGrowthFraction'], 0.5);
+
+      final report = await behavior.getSoakReport();
+      expect(methodCalls.last.method, 'getSoakReport');
+      expect(report['passed'], false);
+      expect(report['failures'], ['session_events grows without bound']);
+      expect(report['stages']['native_total']['drifted'], false);
+    });
+
+    test('synthetic workload starts and stops', () async {
+      final behavior = await SynheartBehavior.initialize();
+
+      await behavior.startSyntheticWorkload(const SyntheticWorkload(
+        seed: 3,
+        motion: MotionWorkload(),
+        speed: 1000,
+      ));
+      expect(methodCalls.last.method, 'startSyntheticWorkload');
+      expect(methodCalls.last.arguments['speed'], 1000);
+      expect(methodCalls.last.arguments['workload']['seed'], 3);
+      expect(methodCalls.last.arguments['workload']['motion']['sampleRateHz'],
+          50);
+
+      final stats = await behavior.stopSyntheticWorkload();
+      expect(methodCalls.last.method, 'stopSyntheticWorkload');
+      expect(stats['generated']['tap'], 30);
+      expect(stats['virtual_ms'], 60000);
+    });
+
+    test('onEvent listeners toggle native event delivery', () async {
+      final behavior = await SynheartBehavior.initialize();
+      methodCalls.clear();
+
+      final listener = behavior.onEvent.listen((_) {});
+      await Future.delayed(Duration.zero);
+      await listener.cancel();
+      await Future.delayed(Duration.zero);
+
+      expect(
+        methodCalls
+            .where((call) => call.method == 'setEventStreamListening')
+            .map((call) => call.arguments['listening']),
+        [true, false],
+      );
+    });
+
     test('session lifecycle end-to-end', () async {
       final behavior = await SynheartBehavior.initialize();
       final events = <BehaviorEvent>[];
@@ -315,6 +748,29 @@ void main() {
       expect(summary2.sessionId, 'session-2');
       expect(behavior.currentSessionId, isNull);
     });
+
+    test('overlapping sessions end independently', () async {
+      final behavior = await SynheartBehavior.initialize();
+
+      final appSession = await behavior.startSession(sessionId: 'app-session');
+      final screenSession =
+          await behavior.startSession(sessionId: 'screen-session');
+      expect(behavior.currentSessionId, 'screen-session');
+
+      final screenSummary = await screenSession.end();
+      expect(screenSummary.sessionId, 'screen-session');
+      expect(behavior.currentSessionId, 'app-session');
+      expect(
+        methodCalls
+            .where((call) => call.method == 'endSession')
+            .map((call) => call.arguments['sessionId']),
+        ['screen-session'],
+      );
+
+      final appSummary = await appSession.end();
+      expect(appSummary.sessionId, 'app-session');
+      expect(behavior.currentSessionId, isNull);
+    });
   });
 }
 
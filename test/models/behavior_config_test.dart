@@ -12,6 +12,15 @@ void main() {
       expect(config.sessionIdPrefix, isNull);
       expect(config.eventBatchSize, 10);
       expect(config.maxIdleGapSeconds, 10.0);
+      expect(config.liveSnapshotIntervalSeconds, 0);
+      expect(config.useFusedMotionSensors, false);
+      expect(config.motionCascadeThreshold, 0.0);
+      expect(config.rollupRetentionDays, 0);
+      expect(config.enableSessionCheckpoints, false);
+      expect(config.encryptSessionCheckpoints, false);
+      expect(config.powerTable.bigClusterMw, 1000.0);
+      expect(config.powerTable.batteryVoltage, 3.85);
+      expect(config.nativeGestureEvents, false);
     });
 
     test('creates with custom values', () {
@@ -48,6 +57,20 @@ void main() {
       expect(json['sessionIdPrefix'], 'TEST');
       expect(json['eventBatchSize'], 15);
       expect(json['maxIdleGapSeconds'], 10.0);
+      expect(json['liveSnapshotIntervalSeconds'], 0);
+      expect(json['useFusedMotionSensors'], false);
+      expect(json['motionCascadeThreshold'], 0.0);
+      expect(json['rollupRetentionDays'], 0);
+      expect(json['enableSessionCheckpoints'], false);
+      expect(json['encryptSessionCheckpoints'], false);
+      expect(json['nativeGestureEvents'], false);
+      expect(json['powerTable'], {
+        'littleClusterMw': 120.0,
+        'midClusterMw': 400.0,
+        'bigClusterMw': 1000.0,
+        'sensorMw': 0.8,
+        'batteryVoltage': 3.85,
+      });
     });
 
     test('handles null sessionIdPrefix', () {
@@ -453,4 +453,31 @@ void main() {
       expect(summary.durationMs, 5000);
     });
   });
+
+  group('MotionDataPoint', () {
+    test('fromJson reads stage 1 cascade decision', () {
+      final point = MotionDataPoint.fromJson({
+        'timestamp': '2025-01-01T10:00:00.000Z',
+        'features': <String, dynamic>{},
+        'cascade_state': 'MOVING',
+        'cascade_confidence': 0.97,
+      });
+
+      expect(point.features, isEmpty);
+      expect(point.cascadeState, 'MOVING');
+      expect(point.cascadeConfidence, 0.97);
+      expect(point.toJson()['cascade_state'], 'MOVING');
+    });
+
+    test('fromJson without cascade decision', () {
+      final point = MotionDataPoint.fromJson({
+        'timestamp': '2025-01-01T10:00:00.000Z',
+        'features': {'tBodyAcc-mean()-X': 0.25},
+      });
+
+      expect(point.features['tBodyAcc-mean()-X'], 0.25);
+      expect(point.cascadeState, isNull);
+      expect(point.toJson().containsKey('cascade_state'), false);
+    });
+  });
 }
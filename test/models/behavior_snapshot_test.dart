@@ -0,0 +1,78 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:synheart_behavior/synheart_behavior.dart';
+
+void main() {
+  group('BehaviorSnapshot', () {
+    test('fromJson parses snapshot with behavioral metrics', () {
+      final json = {
+        'session_id': 'live-session',
+        'snapshot_index': 3,
+        'start_at': '2026-01-01T10:00:00Z',
+        'end_at': '2026-01-01T10:00:45Z',
+        'event_count': 42,
+        'new_event_count': 7,
+        'behavioral_metrics': {
+          'interaction_intensity': 0.6,
+          'behavioral_distraction_score': 0.25,
+          'focus_hint': 0.75,
+          'deep_focus_blocks': [],
+        },
+        'notification_summary': {
+          'notification_count': 2,
+          'notification_ignored': 1,
+        },
+        'metrics_event_count': 35,
+        'performance_info': {'snapshot_compute_time_ms': 4},
+      };
+
+      final snapshot = BehaviorSnapshot.fromJson(json);
+
+      expect(snapshot.sessionId, 'live-session');
+      expect(snapshot.snapshotIndex, 3);
+      expect(snapshot.eventCount, 42);
+      expect(snapshot.newEventCount, 7);
+      expect(snapshot.behavioralMetrics, isNotNull);
+      expect(snapshot.behavioralMetrics!.focusHint, 0.75);
+      expect(snapshot.behavioralMetrics!.behavioralDistractionScore, 0.25);
+      expect(snapshot.metricsEventCount, 35);
+      expect(snapshot.notificationSummary['notification_count'], 2);
+      expect(snapshot.computeTimeMs, 4);
+    });
+
+    test('fromJson handles missing behavioral metrics', () {
+      final snapshot = BehaviorSnapshot.fromJson({
+        'session_id': 'live-session',
+        'snapshot_index': 1,
+      });
+
+      expect(snapshot.behavioralMetrics, isNull);
+      expect(snapshot.eventCount, 0);
+      expect(snapshot.notificationSummary, isEmpty);
+      expect(snapshot.computeTimeMs, 0);
+    });
+
+    test('toJson round-trips through fromJson', () {
+      final original = BehaviorSnapshot.fromJson({
+        'session_id': 'live-session',
+        'snapshot_index': 2,
+        'start_at': '2026-01-01T10:00:00Z',
+        'end_at': '2026-01-01T10:00:30Z',
+        'event_count': 10,
+        'new_event_count': 4,
+        'behavioral_metrics': {'focus_hint': 0.5},
+        'notification_summary': {'call_count': 1},
+        'performance_info': {'snapshot_compute_time_ms': 3},
+      });
+
+      final copy = BehaviorSnapshot.fromJson(original.toJson());
+
+      expect(copy.sessionId, original.sessionId);
+      expect(copy.snapshotIndex, 2);
+      expect(copy.newEventCount, 4);
+      expect(copy.behavioralMetrics!.focusHint, 0.5);
+      expect(copy.metricsEventCount, 10);
+      expect(copy.notificationSummary['call_count'], 1);
+      expect(copy.computeTimeMs, 3);
+    });
+  });
+}
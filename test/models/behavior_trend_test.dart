@@ -0,0 +1,67 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:synheart_behavior/synheart_behavior.dart';
+
+void main() {
+  group('BehaviorTrendBucket', () {
+    test('fromJson creates bucket correctly', () {
+      final bucket = BehaviorTrendBucket.fromJson({
+        'bucket_start_ms': 1735689600000,
+        'session_count': 3,
+        'total_duration_ms': 900000,
+        'event_count': 150,
+        'app_switch_count': 5,
+        'notification_count': 7,
+        'call_count': 1,
+        'clipboard_count': 2,
+        'deep_focus_blocks': 1,
+        'scored_session_count': 2,
+        'focus_hint': 0.6,
+        'behavioral_distraction_score': 0.3,
+        'interaction_intensity': 0.45,
+      });
+
+      expect(bucket.start.millisecondsSinceEpoch, 1735689600000);
+      expect(bucket.sessionCount, 3);
+      expect(bucket.totalDurationMs, 900000);
+      expect(bucket.eventCount, 150);
+      expect(bucket.notificationCount, 7);
+      expect(bucket.deepFocusBlocks, 1);
+      expect(bucket.scoredSessionCount, 2);
+      expect(bucket.focusHint, 0.6);
+      expect(bucket.behavioralDistractionScore, 0.3);
+    });
+
+    test('empty period defaults to zero', () {
+      final bucket = BehaviorTrendBucket.fromJson({
+        'bucket_start_ms': 1735689600000,
+        'session_count': 0,
+        'focus_hint': 0,
+      });
+
+      expect(bucket.sessionCount, 0);
+      expect(bucket.eventCount, 0);
+      expect(bucket.scoredSessionCount, 0);
+      expect(bucket.focusHint, 0.0);
+    });
+
+    test('toJson round-trips', () {
+      final json = {
+        'bucket_start_ms': 1735689600000,
+        'session_count': 2,
+        'total_duration_ms': 60000,
+        'event_count': 40,
+        'app_switch_count': 1,
+        'notification_count': 0,
+        'call_count': 0,
+        'clipboard_count': 0,
+        'deep_focus_blocks': 0,
+        'scored_session_count': 2,
+        'focus_hint': 0.5,
+        'behavioral_distraction_score': 0.2,
+        'interaction_intensity': 0.3,
+      };
+
+      expect(BehaviorTrendBucket.fromJson(json).toJson(), json);
+    });
+  });
+}
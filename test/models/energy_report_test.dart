@@ -0,0 +1,59 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:synheart_behavior/synheart_behavior.dart';
+
+void main() {
+  group('PowerTable', () {
+    test('toJson converts custom values', () {
+      const table = PowerTable(bigClusterMw: 1800.0, batteryVoltage: 3.7);
+
+      final json = table.toJson();
+      expect(json['littleClusterMw'], 120.0);
+      expect(json['bigClusterMw'], 1800.0);
+      expect(json['batteryVoltage'], 3.7);
+    });
+  });
+
+  group('EnergyReport', () {
+    test('fromJson creates report correctly', () {
+      final report = EnergyReport.fromJson({
+        'observed_hours': 0.5,
+        'sensor_active_ms': 1800000,
+        'total_mah_per_hour': 1.2,
+        'dominant_stage': 'motion_extraction',
+        'stages': {
+          'motion_extraction': {
+            'cpu_ms': 5400.0,
+            'calls': 360,
+            'mah_per_hour': 0.9,
+            'share': 0.75,
+          },
+          'flux': {
+            'cpu_ms': 120.0,
+            'calls': 12,
+            'mah_per_hour': 0.3,
+            'share': 0.25,
+          },
+        },
+        'threads': {
+          'main': {'cpu_ms': 80.0, 'cluster': 'big'},
+          'background': {'cpu_ms': 5440.0, 'cluster': 'little'},
+        },
+      });
+
+      expect(report.observedHours, 0.5);
+      expect(report.totalMahPerHour, 1.2);
+      expect(report.dominantStage, 'motion_extraction');
+      expect(report.stages['motion_extraction']!.calls, 360);
+      expect(report.stages['flux']!.share, 0.25);
+      expect(report.threadCpuMs['background'], 5440.0);
+    });
+
+    test('fromJson handles an empty report', () {
+      final report = EnergyReport.fromJson({});
+
+      expect(report.dominantStage, 'none');
+      expect(report.stages, isEmpty);
+      expect(report.threadCpuMs, isEmpty);
+    });
+  });
+}
@@ -0,0 +1,73 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:synheart_behavior/synheart_behavior.dart';
+
+void main() {
+  group('EventLatencyStats', () {
+    test('fromJson creates stats correctly', () {
+      final stats = EventLatencyStats.fromJson({
+        'budget_us': 500,
+        'events': 200,
+        'budget_violations': 4,
+        'hops': {
+          'collector': {
+            'count': 200,
+            'avg_us': 12.5,
+            'p50_us': 10,
+            'p95_us': 28,
+            'p99_us': 40,
+            'max_us': 61.2,
+          },
+        },
+        'dart_stream': {'count': 150, 'avg_us': 820.0, 'p95_us': 1536},
+        'dart_budget_violations': 90,
+      });
+
+      expect(stats.budgetUs, 500);
+      expect(stats.events, 200);
+      expect(stats.budgetViolations, 4);
+      expect(stats.budgetViolationRate, 0.02);
+      expect(stats.hops['collector']!.p95Us, 28);
+      expect(stats.hops['collector']!.maxUs, 61.2);
+      expect(stats.dartStreamHop!.count, 150);
+      expect(stats.dartStreamHop!.p50Us, 0);
+      expect(stats.dartBudgetViolations, 90);
+    });
+
+    test('fromJson handles missing hops', () {
+      final stats = EventLatencyStats.fromJson({});
+
+      expect(stats.budgetUs, 500);
+      expect(stats.hops, isEmpty);
+      expect(stats.dartStreamHop, isNull);
+      expect(stats.budgetViolationRate, 0);
+    });
+  });
+
+  group('LatencyHistogram', () {
+    test('reports bucket upper bounds for quantiles', () {
+      final histogram = LatencyHistogram();
+      for (var i = 0; i < 90; i++) {
+        histogram.record(3);
+      }
+      for (var i = 0; i < 10; i++) {
+        histogram.record(600);
+      }
+
+      final hop = histogram.toHopLatency();
+      expect(hop.count, 100);
+      expect(hop.p50Us, 4);
+      // 600 µs falls in [512, 640)
+      expect(hop.p95Us, 640);
+      expect(hop.maxUs, 600.0);
+      expect(hop.avgUs, closeTo(62.7, 1e-9));
+    });
+
+    test('ignores negative durations', () {
+      final histogram = LatencyHistogram();
+      histogram.record(-5);
+
+      expect(histogram.count, 0);
+      expect(histogram.quantileUs(0.5), 0);
+    });
+  });
+}
@@ -0,0 +1,72 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:synheart_behavior/synheart_behavior.dart';
+
+void main() {
+  group('EventQuery', () {
+    test('creates with default values', () {
+      const query = EventQuery();
+
+      expect(query.eventType, isNull);
+      expect(query.aggregation, EventAggregation.count);
+      expect(query.quantile, 0.5);
+
+      final json = query.toJson();
+      expect(json['bucketMs'], 0);
+      expect(json['aggregation'], 'count');
+      expect(json.containsKey('where'), false);
+    });
+
+    test('toJson converts correctly', () {
+      const query = EventQuery(
+        eventType: 'scroll',
+        startMs: 1000,
+        endMs: 2000,
+        where: EventPredicate('velocity', '>', 100),
+        bucket: Duration(minutes: 1),
+        aggregation: EventAggregation.quantile,
+        field: 'velocity',
+        quantile: 0.9,
+      );
+
+      final json = query.toJson();
+
+      expect(json['eventType'], 'scroll');
+      expect(json['startMs'], 1000);
+      expect(json['endMs'], 2000);
+      expect(json['where'], {'field': 'velocity', 'op': '>', 'value': 100});
+      expect(json['bucketMs'], 60000);
+      expect(json['aggregation'], 'quantile');
+      expect(json['field'], 'velocity');
+      expect(json['quantile'], 0.9);
+    });
+  });
+
+  group('EventAggregateRow', () {
+    test('fromJson creates row correctly', () {
+      final row = EventAggregateRow.fromJson({
+        'bucket_start_ms': 60000,
+        'group': 'copy',
+        'count': 4,
+        'value': 4,
+      });
+
+      expect(row.bucketStartMs, 60000);
+      expect(row.group, 'copy');
+      expect(row.count, 4);
+      expect(row.value, 4.0);
+    });
+
+    test('fromJson handles missing bucket, group and value', () {
+      final row = EventAggregateRow.fromJson({
+        'bucket_start_ms': null,
+        'group': null,
+        'count': 0,
+        'value': null,
+      });
+
+      expect(row.bucketStartMs, isNull);
+      expect(row.group, isNull);
+      expect(row.value, isNull);
+    });
+  });
+}
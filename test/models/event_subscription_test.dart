@@ -0,0 +1,56 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:synheart_behavior/synheart_behavior.dart';
+
+void main() {
+  group('EventFilter', () {
+    test('creates with default values', () {
+      const filter = EventFilter();
+
+      expect(filter.eventTypes, isNull);
+      expect(filter.sampleEvery, 1);
+      expect(filter.maxPerSecond, isNull);
+
+      final json = filter.toJson();
+      expect(json['eventTypes'], isNull);
+      expect(json['sampleEvery'], 1);
+      expect(json['maxPerSecond'], 0);
+      expect(json.containsKey('where'), false);
+    });
+
+    test('toJson converts correctly', () {
+      const filter = EventFilter(
+        eventTypes: {'notification'},
+        where: EventPredicate('action', '==', 'opened'),
+        sampleEvery: 3,
+        maxPerSecond: 2.5,
+      );
+
+      final json = filter.toJson();
+
+      expect(json['eventTypes'], ['notification']);
+      expect(json['where'], {'field': 'action', 'op': '==', 'value': 'opened'});
+      expect(json['sampleEvery'], 3);
+      expect(json['maxPerSecond'], 2.5);
+    });
+  });
+
+  group('EventSubscriptionStats', () {
+    test('fromJson creates stats correctly', () {
+      final stats = EventSubscriptionStats.fromJson({
+        'delivered': 12,
+        'filtered': 340,
+      });
+
+      expect(stats.delivered, 12);
+      expect(stats.filtered, 340);
+      expect(stats.toJson(), {'delivered': 12, 'filtered': 340});
+    });
+
+    test('fromJson defaults missing counters to zero', () {
+      final stats = EventSubscriptionStats.fromJson({});
+
+      expect(stats.delivered, 0);
+      expect(stats.filtered, 0);
+    });
+  });
+}
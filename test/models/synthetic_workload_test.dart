@@ -0,0 +1,80 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:synheart_behavior/synheart_behavior.dart';
+
+void main() {
+  group('SyntheticWorkload', () {
+    test('creates with default values', () {
+      const workload = SyntheticWorkload();
+
+      expect(workload.seed, 1);
+      expect(workload.speed, 1);
+      expect(workload.motion, isNull);
+
+      final json = workload.toJson();
+      final models = json['workload'] as Map<String, dynamic>;
+      expect(models['seed'], 1);
+      expect(models.keys,
+          containsAll(['scroll', 'typing', 'notifications', 'appSwitches']));
+      expect(models.containsKey('motion'), false);
+      expect(json['durationSeconds'], 60);
+    });
+
+    test('toJson omits disabled models', () {
+      const workload = SyntheticWorkload(
+        seed: 7,
+        scroll: null,
+        appSwitches: null,
+        typing: TypingWorkload(burstsPerMinute: 6, interKeySigma: 0.9),
+        notifications: NotificationWorkload(stormsPerHour: 2),
+        speed: 1000,
+        duration: Duration(hours: 24),
+      );
+
+      final json = workload.toJson();
+      final models = json['workload'] as Map<String, dynamic>;
+
+      expect(models.containsKey('scroll'), false);
+      expect(models.containsKey('appSwitches'), false);
+      expect(models['typing']['burstsPerMinute'], 6);
+      expect(models['typing']['interKeySigma'], 0.9);
+      expect(models['notifications']['stormsPerHour'], 2);
+      expect(models['notifications']['ignoredAfterMs'], 30000);
+      expect(json['speed'], 1000);
+      expect(json['durationSeconds'], 86400);
+    });
+
+    test('motion schedule converts correctly', () {
+      const motion = MotionWorkload(
+        schedule: [
+          (SyntheticActivity.walking, Duration(seconds: 30)),
+          (SyntheticActivity.running, Duration(seconds: 10)),
+        ],
+      );
+
+      final json = motion.toJson();
+
+      expect(json['sampleRateHz'], 50);
+      expect(json['schedule'], [
+        {'activity': 'walking', 'durationMs': 30000},
+        {'activity': 'running', 'durationMs': 10000},
+      ]);
+    });
+  });
+
+  group('SoakTest', () {
+    test('creates with default values', () {
+      const soak = SoakTest();
+
+      expect(soak.workload.speed, 1000);
+      expect(soak.workload.duration, const Duration(hours: 72));
+
+      final json = soak.toJson();
+      expect(json['durationSeconds'], 259200);
+      expect(json['sampleIntervalSeconds'], 600);
+      expect(json['sessionLengthSeconds'], 3600);
+      expect(json['thresholds']['maxGrowthFraction'], 0.2);
+      expect(json['thresholds']['minGrowthBytes'], 8 * 1024 * 1024);
+      expect((json['workload'] as Map).containsKey('scroll'), true);
+    });
+  });
+}
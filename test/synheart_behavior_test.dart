@@ -128,6 +128,7 @@ void main() {
       expect(args['sessionIdPrefix'], 'TEST');
       expect(args['eventBatchSize'], 20);
       expect(args['maxIdleGapSeconds'], 15.0);
+      expect(args['dartInstance'], isA<int>());
     });
   });
 